@@ -0,0 +1,138 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file DeepStackPool.cpp
+ * @date 2026
+ */
+
+#include "DeepStackPool.h"
+
+#include <boost/thread.hpp>
+
+#include <condition_variable>
+#include <exception>
+
+namespace dev {
+
+class DeepStackPool::Thread {
+public:
+    explicit Thread( size_t _stackSize ) {
+        boost::thread::attributes attrs;
+        attrs.set_stack_size( _stackSize );
+        m_thread = boost::thread( attrs, [this] { loop(); } );
+    }
+
+    ~Thread() {
+        {
+            Guard l( x_task );
+            m_stop = true;
+        }
+        m_taskChanged.notify_all();
+        m_thread.join();
+    }
+
+    void run( std::function< void() > const& _task ) {
+        UniqueGuard l( x_task );
+        m_task = &_task;
+        m_exception = nullptr;
+        m_taskChanged.notify_all();
+        m_taskChanged.wait( l, [this] { return m_task == nullptr; } );
+        if ( m_exception )
+            std::rethrow_exception( m_exception );
+    }
+
+private:
+    void loop() {
+        UniqueGuard l( x_task );
+        for ( ;; ) {
+            m_taskChanged.wait( l, [this] { return m_task != nullptr || m_stop; } );
+            if ( !m_task )
+                return;
+
+            l.unlock();
+            std::exception_ptr exception;
+            try {
+                ( *m_task )();
+            } catch ( ... ) {
+                // rethrown in the calling thread
+                exception = std::current_exception();
+            }
+            l.lock();
+
+            m_exception = exception;
+            m_task = nullptr;
+            m_taskChanged.notify_all();
+        }
+    }
+
+    Mutex x_task;
+    std::condition_variable m_taskChanged;
+    std::function< void() > const* m_task = nullptr;
+    std::exception_ptr m_exception;
+    bool m_stop = false;
+    boost::thread m_thread;  ///< last, starts after the rest is initialized
+};
+
+DeepStackPool::DeepStackPool( size_t _stackSize, size_t _maxIdle )
+    : m_stackSize( _stackSize ), m_maxIdle( _maxIdle ) {}
+
+DeepStackPool::~DeepStackPool() = default;
+
+void DeepStackPool::run( std::function< void() > const& _task ) {
+    std::unique_ptr< Thread > thread = acquire();
+    try {
+        thread->run( _task );
+    } catch ( ... ) {
+        release( std::move( thread ) );
+        throw;
+    }
+    release( std::move( thread ) );
+}
+
+size_t DeepStackPool::idle() const {
+    Guard l( x_idle );
+    return m_idle.size();
+}
+
+std::unique_ptr< DeepStackPool::Thread > DeepStackPool::acquire() {
+    {
+        Guard l( x_idle );
+        if ( !m_idle.empty() ) {
+            std::unique_ptr< Thread > thread = std::move( m_idle.back() );
+            m_idle.pop_back();
+            return thread;
+        }
+    }
+    m_threadsStarted.fetch_add( 1, std::memory_order_relaxed );
+    return std::unique_ptr< Thread >( new Thread( m_stackSize ) );
+}
+
+void DeepStackPool::release( std::unique_ptr< Thread > _thread ) {
+    {
+        Guard l( x_idle );
+        if ( m_idle.size() < m_maxIdle ) {
+            m_idle.push_back( std::move( _thread ) );
+            return;
+        }
+    }
+    // joined outside of the lock
+    _thread.reset();
+}
+
+}  // namespace dev
@@ -0,0 +1,73 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file DeepStackPool.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "Guards.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dev {
+
+/// Long-lived threads with large stacks for code that nests too deep for the caller's stack.
+/// run() hands the task to an idle thread and blocks until it finishes, exceptions thrown by
+/// the task are rethrown in the caller. Threads are started on demand, one per concurrent
+/// caller, and kept for the next task, so a warmed-up pool never creates threads.
+class DeepStackPool {
+public:
+    static const size_t c_defaultMaxIdle = 8;
+
+    explicit DeepStackPool( size_t _stackSize, size_t _maxIdle = c_defaultMaxIdle );
+    ~DeepStackPool();
+
+    DeepStackPool( DeepStackPool const& ) = delete;
+    DeepStackPool& operator=( DeepStackPool const& ) = delete;
+
+    /// Runs @a _task on a thread from the pool and waits for it.
+    void run( std::function< void() > const& _task );
+
+    size_t stackSize() const { return m_stackSize; }
+    /// @returns number of threads waiting for a task.
+    size_t idle() const;
+    /// @returns number of threads started since construction.
+    uint64_t threadsStarted() const { return m_threadsStarted.load( std::memory_order_relaxed ); }
+
+private:
+    class Thread;
+
+    std::unique_ptr< Thread > acquire();
+    void release( std::unique_ptr< Thread > _thread );
+
+    size_t const m_stackSize;
+    size_t const m_maxIdle;
+
+    mutable Mutex x_idle;
+    std::vector< std::unique_ptr< Thread > > m_idle;
+
+    std::atomic< uint64_t > m_threadsStarted{ 0 };
+};
+
+}  // namespace dev
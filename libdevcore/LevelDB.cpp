@@ -224,6 +224,24 @@ void LevelDB::forEachWithPrefix(
     }
 }
 
+void LevelDB::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    std::unique_ptr< leveldb::Iterator > itr( m_db->NewIterator( m_readOptions ) );
+    if ( itr == nullptr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
+    }
+    auto const endSlice = leveldb::Slice( _end.data(), _end.size() );
+    auto keepIterating = true;
+    for ( itr->Seek( leveldb::Slice( _begin.data(), _begin.size() ) );
+          keepIterating && itr->Valid() && itr->key().compare( endSlice ) < 0; itr->Next() ) {
+        auto const dbKey = itr->key();
+        auto const dbValue = itr->value();
+        Slice const key( dbKey.data(), dbKey.size() );
+        Slice const value( dbValue.data(), dbValue.size() );
+        keepIterating = f( key, value );
+    }
+}
+
 h256 LevelDB::hashBase() const {
     std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
     if ( it == nullptr ) {
@@ -56,6 +56,9 @@ public:
     void forEachWithPrefix(
         std::string& _prefix, std::function< bool( Slice, Slice ) > f ) const override;
 
+    // iterates keys in [_begin, _end) in key order, stops when f returns false
+    void forEachInRange( Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const;
+
     h256 hashBase() const override;
     h256 hashBaseWithPrefix( char _prefix ) const;
 
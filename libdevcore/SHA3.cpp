@@ -24,10 +24,190 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <array>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#define DEV_SHA3_AVX2 1
+#include <immintrin.h>
+#endif
+
 namespace dev {
 h256 const EmptySHA3 = sha3( bytesConstRef() );
 h256 const EmptyListSHA3 = sha3( rlpList() );
 
+namespace {
+
+#if DEV_SHA3_AVX2
+
+/// Bytes absorbed per Keccak-f[1600] permutation for 256-bit output.
+size_t const c_rate = 136;
+
+size_t blockCount( bytesConstRef _input ) {
+    // padding always takes at least one byte
+    return _input.size() / c_rate + 1;
+}
+
+uint64_t const c_roundConstants[24] = { 0x0000000000000001, 0x0000000000008082,
+    0x800000000000808a, 0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+    0x8000000080008081, 0x8000000000008009, 0x000000000000008a, 0x0000000000000088,
+    0x0000000080008009, 0x000000008000000a, 0x000000008000808b, 0x800000000000008b,
+    0x8000000000008089, 0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+    0x000000000000800a, 0x800000008000000a, 0x8000000080008081, 0x8000000000008080,
+    0x0000000080000001, 0x8000000080008008 };
+
+template < int _bits >
+__attribute__( ( target( "avx2" ) ) ) inline __m256i rotate( __m256i _lane ) {
+    return _mm256_or_si256(
+        _mm256_slli_epi64( _lane, _bits ), _mm256_srli_epi64( _lane, 64 - _bits ) );
+}
+
+__attribute__( ( target( "avx2" ) ) ) inline __m256i chi( __m256i _a, __m256i _b, __m256i _c ) {
+    return _mm256_xor_si256( _a, _mm256_andnot_si256( _b, _c ) );
+}
+
+/// Keccak-f[1600] on four states, lane i of state j is element j of @a _a[i].
+__attribute__( ( target( "avx2" ) ) ) void keccakF1600x4( __m256i* _a ) {
+    for ( uint64_t roundConstant : c_roundConstants ) {
+        // theta
+        __m256i c[5], d[5];
+        for ( int x = 0; x < 5; ++x )
+            c[x] = _mm256_xor_si256( _mm256_xor_si256( _a[x], _a[x + 5] ),
+                _mm256_xor_si256( _mm256_xor_si256( _a[x + 10], _a[x + 15] ), _a[x + 20] ) );
+        d[0] = _mm256_xor_si256( c[4], rotate< 1 >( c[1] ) );
+        d[1] = _mm256_xor_si256( c[0], rotate< 1 >( c[2] ) );
+        d[2] = _mm256_xor_si256( c[1], rotate< 1 >( c[3] ) );
+        d[3] = _mm256_xor_si256( c[2], rotate< 1 >( c[4] ) );
+        d[4] = _mm256_xor_si256( c[3], rotate< 1 >( c[0] ) );
+
+        // rho and pi, lane x + 5 * y moves to y + 5 * ( ( 2 * x + 3 * y ) % 5 )
+        __m256i b[25];
+        b[0] = _mm256_xor_si256( _a[0], d[0] );
+        b[10] = rotate< 1 >( _mm256_xor_si256( _a[1], d[1] ) );
+        b[20] = rotate< 62 >( _mm256_xor_si256( _a[2], d[2] ) );
+        b[5] = rotate< 28 >( _mm256_xor_si256( _a[3], d[3] ) );
+        b[15] = rotate< 27 >( _mm256_xor_si256( _a[4], d[4] ) );
+        b[16] = rotate< 36 >( _mm256_xor_si256( _a[5], d[0] ) );
+        b[1] = rotate< 44 >( _mm256_xor_si256( _a[6], d[1] ) );
+        b[11] = rotate< 6 >( _mm256_xor_si256( _a[7], d[2] ) );
+        b[21] = rotate< 55 >( _mm256_xor_si256( _a[8], d[3] ) );
+        b[6] = rotate< 20 >( _mm256_xor_si256( _a[9], d[4] ) );
+        b[7] = rotate< 3 >( _mm256_xor_si256( _a[10], d[0] ) );
+        b[17] = rotate< 10 >( _mm256_xor_si256( _a[11], d[1] ) );
+        b[2] = rotate< 43 >( _mm256_xor_si256( _a[12], d[2] ) );
+        b[12] = rotate< 25 >( _mm256_xor_si256( _a[13], d[3] ) );
+        b[22] = rotate< 39 >( _mm256_xor_si256( _a[14], d[4] ) );
+        b[23] = rotate< 41 >( _mm256_xor_si256( _a[15], d[0] ) );
+        b[8] = rotate< 45 >( _mm256_xor_si256( _a[16], d[1] ) );
+        b[18] = rotate< 15 >( _mm256_xor_si256( _a[17], d[2] ) );
+        b[3] = rotate< 21 >( _mm256_xor_si256( _a[18], d[3] ) );
+        b[13] = rotate< 8 >( _mm256_xor_si256( _a[19], d[4] ) );
+        b[14] = rotate< 18 >( _mm256_xor_si256( _a[20], d[0] ) );
+        b[24] = rotate< 2 >( _mm256_xor_si256( _a[21], d[1] ) );
+        b[9] = rotate< 61 >( _mm256_xor_si256( _a[22], d[2] ) );
+        b[19] = rotate< 56 >( _mm256_xor_si256( _a[23], d[3] ) );
+        b[4] = rotate< 14 >( _mm256_xor_si256( _a[24], d[4] ) );
+
+        // chi and iota
+        for ( int y = 0; y < 25; y += 5 ) {
+            _a[y] = chi( b[y], b[y + 1], b[y + 2] );
+            _a[y + 1] = chi( b[y + 1], b[y + 2], b[y + 3] );
+            _a[y + 2] = chi( b[y + 2], b[y + 3], b[y + 4] );
+            _a[y + 3] = chi( b[y + 3], b[y + 4], b[y] );
+            _a[y + 4] = chi( b[y + 4], b[y], b[y + 1] );
+        }
+        _a[0] = _mm256_xor_si256( _a[0], _mm256_set1_epi64x( int64_t( roundConstant ) ) );
+    }
+}
+
+/// Hashes four inputs with the same number of blocks in parallel.
+__attribute__( ( target( "avx2" ) ) ) void keccak256x4(
+    bytesConstRef const* _inputs, h256* o_outputs ) {
+    __m256i state[25];
+    for ( auto& lane : state )
+        lane = _mm256_setzero_si256();
+
+    size_t const blocks = blockCount( _inputs[0] );
+    uint64_t block[4][c_rate / 8];
+    for ( size_t i = 0; i < blocks; ++i ) {
+        size_t const offset = i * c_rate;
+        for ( size_t j = 0; j < 4; ++j ) {
+            // last block is padded, it holds less than c_rate bytes of input
+            size_t const size = std::min( c_rate, _inputs[j].size() - offset );
+            _byte_* const bytes = reinterpret_cast< _byte_* >( block[j] );
+            if ( size )
+                std::memcpy( bytes, _inputs[j].data() + offset, size );
+            if ( size < c_rate ) {
+                std::memset( bytes + size, 0, c_rate - size );
+                bytes[size] |= 0x01;
+                bytes[c_rate - 1] |= 0x80;
+            }
+        }
+        for ( size_t k = 0; k < c_rate / 8; ++k )
+            state[k] = _mm256_xor_si256( state[k],
+                _mm256_set_epi64x( int64_t( block[3][k] ), int64_t( block[2][k] ),
+                    int64_t( block[1][k] ), int64_t( block[0][k] ) ) );
+        keccakF1600x4( state );
+    }
+
+    for ( size_t k = 0; k < 4; ++k ) {
+        alignas( 32 ) uint64_t lanes[4];
+        _mm256_store_si256( reinterpret_cast< __m256i* >( lanes ), state[k] );
+        for ( size_t j = 0; j < 4; ++j )
+            std::memcpy( o_outputs[j].data() + 8 * k, &lanes[j], 8 );
+    }
+}
+
+bool hasAvx2() {
+    static bool const s_avx2 = __builtin_cpu_supports( "avx2" );
+    return s_avx2;
+}
+
+#endif
+
+/// Direct mapped memo of hashes of 64-byte inputs. Hashes never change, so entries are only
+/// replaced, never invalidated.
+class Sha3Memo64 {
+public:
+    h256 const& get( _byte_ const* _input ) {
+        Entry& entry = m_entries[index( _input )];
+        if ( !entry.used || std::memcmp( entry.input, _input, sizeof( entry.input ) ) != 0 ) {
+            ethash::hash256 const h = ethash::keccak256( _input, sizeof( entry.input ) );
+            std::memcpy( entry.input, _input, sizeof( entry.input ) );
+            entry.digest = h256( h.bytes, h256::ConstructFromPointer );
+            entry.used = true;
+        }
+        return entry.digest;
+    }
+
+private:
+    static const unsigned c_indexBits = 10;
+
+    struct Entry {
+        _byte_ input[64];
+        h256 digest;
+        bool used = false;
+    };
+
+    static size_t index( _byte_ const* _input ) {
+        uint64_t h = 0;
+        for ( size_t i = 0; i < 64; i += 8 ) {
+            uint64_t word;
+            std::memcpy( &word, _input + i, sizeof( word ) );
+            h = ( h ^ word ) * 0x9e3779b97f4a7c15;
+        }
+        return h >> ( 64 - c_indexBits );
+    }
+
+    std::array< Entry, size_t( 1 ) << c_indexBits > m_entries;
+};
+
+thread_local std::unique_ptr< Sha3Memo64 > t_sha3Memo64;
+
+}  // namespace
+
 bool sha3( bytesConstRef _input, bytesRef o_output ) noexcept {
     if ( o_output.size() != 32 )
         return false;
@@ -38,4 +218,35 @@ bool sha3( bytesConstRef _input, bytesRef o_output ) noexcept {
     bytesConstRef{ h.bytes, 32 }.copyTo( o_output );
     return true;
 }
+
+h256 sha3Cached64( _byte_ const* _input ) noexcept {
+    if ( !t_sha3Memo64 ) {
+        t_sha3Memo64.reset( new ( std::nothrow ) Sha3Memo64 );
+        if ( !t_sha3Memo64 )
+            return sha3( bytesConstRef( _input, 64 ) );
+    }
+    return t_sha3Memo64->get( _input );
+}
+
+void sha3Batch( bytesConstRef const* _inputs, h256* o_outputs, size_t _count ) noexcept {
+    MICROPROFILE_SCOPEI( "sha3", "sha3Batch", MP_MEDIUMBLUE );
+
+    size_t i = 0;
+    while ( i < _count ) {
+#if DEV_SHA3_AVX2
+        if ( i + 4 <= _count && hasAvx2() ) {
+            size_t const blocks = blockCount( _inputs[i] );
+            if ( blockCount( _inputs[i + 1] ) == blocks && blockCount( _inputs[i + 2] ) == blocks &&
+                 blockCount( _inputs[i + 3] ) == blocks ) {
+                keccak256x4( _inputs + i, o_outputs + i );
+                i += 4;
+                continue;
+            }
+        }
+#endif
+        ethash::hash256 const h = ethash::keccak256( _inputs[i].data(), _inputs[i].size() );
+        o_outputs[i] = h256( h.bytes, h256::ConstructFromPointer );
+        ++i;
+    }
+}
 }  // namespace dev
@@ -78,6 +78,15 @@ inline h256 sha3( h256 const& _input ) noexcept {
     return h256{ hash.bytes, h256::ConstructFromPointer };
 }
 
+/// Keccak hash of 64 bytes at @a _input. Solidity hashes a key and a slot number this way to
+/// locate every mapping entry, so the same inputs recur; they are served from a small memo of
+/// recent inputs kept per thread.
+h256 sha3Cached64( _byte_ const* _input ) noexcept;
+
+/// Calculates Keccak hashes of @a _count inputs into @a o_outputs. If the CPU supports AVX2,
+/// four inputs needing the same number of Keccak blocks are hashed at once.
+void sha3Batch( bytesConstRef const* _inputs, h256* o_outputs, size_t _count ) noexcept;
+
 /// Calculate SHA3-256 hash of the given input (presented as a FixedHash), returns a 256-bit hash.
 template < unsigned N >
 inline h256 sha3( FixedHash< N > const& _input ) noexcept {
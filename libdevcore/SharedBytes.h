@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SharedBytes.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "Common.h"
+
+#include <memory>
+
+namespace dev {
+
+/// Read-only view of bytes that keeps the buffer holding them alive. Copies and slices share
+/// the buffer, so code and return data are handed between call frames without copying. The
+/// bytes must not be modified while any view exists.
+class SharedBytes : public vector_ref< _byte_ const > {
+public:
+    SharedBytes() = default;
+
+    /// Takes over @a _bytes and views [_begin, _begin + _size) of them.
+    SharedBytes( bytes&& _bytes, size_t _begin, size_t _size ) {
+        assert( _begin + _size <= _bytes.size() );
+        auto buffer = std::make_shared< bytes const >( std::move( _bytes ) );
+        retarget( buffer->data() + _begin, _size );
+        m_owner = std::move( buffer );
+    }
+
+    /// Takes over all of @a _bytes.
+    explicit SharedBytes( bytes&& _bytes ) : SharedBytes( std::move( _bytes ), 0, _bytes.size() ) {}
+
+    /// Shares all of @a _bytes.
+    explicit SharedBytes( std::shared_ptr< bytes const > _bytes )
+        : vector_ref( _bytes ? _bytes->data() : nullptr, _bytes ? _bytes->size() : 0 ),
+          m_owner( std::move( _bytes ) ) {}
+
+    /// View of @a _data inside a buffer kept alive by @a _owner.
+    SharedBytes( std::shared_ptr< void const > _owner, bytesConstRef _data )
+        : vector_ref( _data ), m_owner( std::move( _owner ) ) {}
+
+    /// @returns view of [_begin, _begin + _size) of these bytes, cut at their end.
+    SharedBytes slice( size_t _begin, size_t _size ) const {
+        _begin = std::min( _begin, size() );
+        return SharedBytes( m_owner, { data() + _begin, std::min( _size, size() - _begin ) } );
+    }
+
+    std::shared_ptr< void const > const& owner() const { return m_owner; }
+
+private:
+    std::shared_ptr< void const > m_owner;
+};
+
+}  // namespace dev
@@ -411,6 +411,12 @@ public:
     }
     void remove( bytesConstRef _key ) { Super::remove( sha3( _key ) ); }
 
+    /// insert() and remove() for keys hashed in advance, @a _keyHash is sha3() of the key.
+    void insertHashed( h256 const& _keyHash, bytesConstRef, bytesConstRef _value ) {
+        Super::insert( _keyHash, _value );
+    }
+    void removeHashed( h256 const& _keyHash ) { Super::remove( _keyHash ); }
+
     // empty from the PoV of the iterator interface; still need a basic iterator impl though.
     class iterator {
     public:
@@ -466,6 +472,13 @@ public:
 
     void remove( bytesConstRef _key ) { Super::remove( sha3( _key ) ); }
 
+    /// insert() and remove() for keys hashed in advance, @a _keyHash is sha3() of the key.
+    void insertHashed( h256 const& _keyHash, bytesConstRef _key, bytesConstRef _value ) {
+        Super::insert( _keyHash, _value );
+        Super::db()->insertAux( _keyHash, _key );
+    }
+    void removeHashed( h256 const& _keyHash ) { Super::remove( _keyHash ); }
+
     // iterates over <key, value> pairs
     class iterator : public GenericTrieDB< _DB >::iterator {
     public:
@@ -0,0 +1,120 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file WorkerPool.cpp
+ * @date 2026
+ */
+
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <exception>
+
+namespace dev {
+
+/// State of one parallelFor() call. Workers hold it by shared pointer: one that picks up the
+/// loop after the caller returned finds no indexes left and never touches the caller's stack.
+struct WorkerPool::Loop {
+    size_t count;
+    std::function< void( size_t ) > const* f;
+    std::atomic< size_t > next{ 0 };
+    std::atomic< size_t > done{ 0 };
+
+    Mutex x_finished;
+    std::condition_variable m_finished;
+    std::exception_ptr exception;
+};
+
+WorkerPool::WorkerPool( size_t _threads ) {
+    m_threads.reserve( _threads );
+    for ( size_t i = 0; i < _threads; ++i )
+        m_threads.emplace_back( [this] { work(); } );
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        Guard l( x_tasks );
+        m_stop = true;
+    }
+    m_tasksChanged.notify_all();
+    for ( auto& thread : m_threads )
+        thread.join();
+}
+
+void WorkerPool::parallelFor(
+    size_t _count, std::function< void( size_t ) > const& _f, size_t _maxHelpers ) {
+    if ( _count == 0 )
+        return;
+
+    auto loop = std::make_shared< Loop >();
+    loop->count = _count;
+    loop->f = &_f;
+
+    size_t const helpers = std::min( { _maxHelpers, m_threads.size(), _count - 1 } );
+    if ( helpers ) {
+        {
+            Guard l( x_tasks );
+            for ( size_t i = 0; i < helpers; ++i )
+                m_tasks.push_back( loop );
+        }
+        m_tasksChanged.notify_all();
+    }
+
+    runLoop( *loop );
+
+    UniqueGuard l( loop->x_finished );
+    loop->m_finished.wait( l, [&] { return loop->done == _count; } );
+    if ( loop->exception )
+        std::rethrow_exception( loop->exception );
+}
+
+void WorkerPool::work() {
+    UniqueGuard l( x_tasks );
+    for ( ;; ) {
+        m_tasksChanged.wait( l, [this] { return m_stop || !m_tasks.empty(); } );
+        if ( m_stop )
+            return;
+        std::shared_ptr< Loop > loop = std::move( m_tasks.front() );
+        m_tasks.pop_front();
+
+        l.unlock();
+        runLoop( *loop );
+        loop.reset();
+        l.lock();
+    }
+}
+
+void WorkerPool::runLoop( Loop& _loop ) {
+    for ( size_t i; ( i = _loop.next++ ) < _loop.count; ) {
+        std::exception_ptr exception;
+        try {
+            ( *_loop.f )( i );
+        } catch ( ... ) {
+            exception = std::current_exception();
+        }
+
+        Guard l( _loop.x_finished );
+        if ( exception && !_loop.exception )
+            _loop.exception = exception;
+        if ( ++_loop.done == _loop.count )
+            _loop.m_finished.notify_all();
+    }
+}
+
+}  // namespace dev
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file WorkerPool.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "Guards.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dev {
+
+/// Fixed set of threads for splitting CPU-bound loops. parallelFor() hands out indexes to the
+/// workers and to the calling thread, so several callers can share the pool and a busy pool
+/// never blocks progress: the caller runs whatever the workers did not take.
+class WorkerPool {
+public:
+    explicit WorkerPool( size_t _threads );
+    ~WorkerPool();
+
+    WorkerPool( WorkerPool const& ) = delete;
+    WorkerPool& operator=( WorkerPool const& ) = delete;
+
+    /// Calls @a _f for every index in [0, _count) on the calling thread and up to
+    /// @a _maxHelpers workers (all by default), returns when all calls are done. The first
+    /// exception thrown by @a _f is rethrown after that.
+    void parallelFor( size_t _count, std::function< void( size_t ) > const& _f,
+        size_t _maxHelpers = size_t( -1 ) );
+
+    size_t threads() const { return m_threads.size(); }
+
+private:
+    struct Loop;
+
+    void work();
+    static void runLoop( Loop& _loop );
+
+    Mutex x_tasks;
+    std::condition_variable m_tasksChanged;
+    std::deque< std::shared_ptr< Loop > > m_tasks;
+    bool m_stop = false;
+    std::vector< std::thread > m_threads;
+};
+
+}  // namespace dev
@@ -35,6 +35,7 @@
 #include <libdevcore/Log.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/SHA3.h>
+#include <libdevcore/WorkerPool.h>
 #include <libscrypt.h>
 #include <secp256k1.h>
 #include <secp256k1_ecdh.h>
@@ -43,6 +44,10 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <array>
+#include <deque>
+#include <unordered_map>
+
 using namespace std;
 using namespace dev;
 using namespace dev::crypto;
@@ -57,6 +62,85 @@ secp256k1_context const* getCtx() {
     return s_ctx.get();
 }
 
+/// Recently recovered keys by signed hash, evicted in insertion order. Split into shards by hash,
+/// each under its own lock, so that parallel recoveries rarely wait for each other.
+class RecoveryCache {
+public:
+    static constexpr size_t c_maxSize = 8192;
+    static constexpr size_t c_shards = 64;
+
+    bool get( Signature const& _sig, h256 const& _hash, Public& o_public ) {
+        Shard& shard = shardOf( _hash );
+        Guard l( shard.x_entries );
+        auto it = shard.entries.find( _hash );
+        if ( it == shard.entries.end() || it->second.first != _sig )
+            return false;
+        o_public = it->second.second;
+        return true;
+    }
+
+    void store( Signature const& _sig, h256 const& _hash, Public const& _public ) {
+        Shard& shard = shardOf( _hash );
+        Guard l( shard.x_entries );
+        auto inserted = shard.entries.emplace( _hash, std::make_pair( _sig, _public ) );
+        if ( !inserted.second ) {
+            inserted.first->second = { _sig, _public };
+            return;
+        }
+        shard.order.push_back( _hash );
+        if ( shard.order.size() > c_maxSize / c_shards ) {
+            shard.entries.erase( shard.order.front() );
+            shard.order.pop_front();
+        }
+    }
+
+private:
+    struct Shard {
+        Mutex x_entries;
+        std::unordered_map< h256, std::pair< Signature, Public > > entries;
+        std::deque< h256 > order;
+    };
+
+    Shard& shardOf( h256 const& _hash ) { return m_shards[_hash[0] % c_shards]; }
+
+    std::array< Shard, c_shards > m_shards;
+};
+
+RecoveryCache& recoveryCache() {
+    static RecoveryCache s_cache;
+    return s_cache;
+}
+
+WorkerPool& recoveryPool() {
+    static WorkerPool s_pool( std::max( std::thread::hardware_concurrency(), 1u ) - 1 );
+    return s_pool;
+}
+
+Public recoverUncached( Signature const& _sig, h256 const& _message ) {
+    int v = _sig[64];
+    if ( v > 3 )
+        return {};
+
+    auto* ctx = getCtx();
+    secp256k1_ecdsa_recoverable_signature rawSig;
+    if ( !secp256k1_ecdsa_recoverable_signature_parse_compact( ctx, &rawSig, _sig.data(), v ) )
+        return {};
+
+    secp256k1_pubkey rawPubkey;
+    if ( !secp256k1_ecdsa_recover( ctx, &rawPubkey, &rawSig, _message.data() ) )
+        return {};
+
+    std::array< _byte_, 65 > serializedPubkey;
+    size_t serializedPubkeySize = serializedPubkey.size();
+    secp256k1_ec_pubkey_serialize( ctx, serializedPubkey.data(), &serializedPubkeySize, &rawPubkey,
+        SECP256K1_EC_UNCOMPRESSED );
+    assert( serializedPubkeySize == serializedPubkey.size() );
+    // Expect single byte header of value 0x04 -- uncompressed public key.
+    assert( serializedPubkey[0] == 0x04 );
+    // Create the Public skipping the header.
+    return Public{ &serializedPubkey[1], Public::ConstructFromPointer };
+}
+
 }  // namespace
 
 bool dev::SignatureStruct::isValid() const noexcept {
@@ -185,28 +269,22 @@ bytesSec dev::decryptAES128CTR( bytesConstRef _k, h128 const& _iv, bytesConstRef
 Public dev::recover( Signature const& _sig, h256 const& _message ) {
     MICROPROFILE_SCOPEI( "Common.cpp", "recover", MP_BROWN1 );
 
-    int v = _sig[64];
-    if ( v > 3 )
-        return {};
-
-    auto* ctx = getCtx();
-    secp256k1_ecdsa_recoverable_signature rawSig;
-    if ( !secp256k1_ecdsa_recoverable_signature_parse_compact( ctx, &rawSig, _sig.data(), v ) )
-        return {};
+    Public ret;
+    if ( recoveryCache().get( _sig, _message, ret ) )
+        return ret;
+    ret = recoverUncached( _sig, _message );
+    recoveryCache().store( _sig, _message, ret );
+    return ret;
+}
 
-    secp256k1_pubkey rawPubkey;
-    if ( !secp256k1_ecdsa_recover( ctx, &rawPubkey, &rawSig, _message.data() ) )
-        return {};
+void dev::recover( Signature const* _sigs, h256 const* _hashes, Public* o_publics, size_t _count,
+    WorkerPool* _pool ) {
+    MICROPROFILE_SCOPEI( "Common.cpp", "recover batch", MP_BROWN1 );
 
-    std::array< _byte_, 65 > serializedPubkey;
-    size_t serializedPubkeySize = serializedPubkey.size();
-    secp256k1_ec_pubkey_serialize( ctx, serializedPubkey.data(), &serializedPubkeySize, &rawPubkey,
-        SECP256K1_EC_UNCOMPRESSED );
-    assert( serializedPubkeySize == serializedPubkey.size() );
-    // Expect single byte header of value 0x04 -- uncompressed public key.
-    assert( serializedPubkey[0] == 0x04 );
-    // Create the Public skipping the header.
-    return Public{ &serializedPubkey[1], Public::ConstructFromPointer };
+    // secp256k1 contexts are read-only after creation, all threads share the precomputed one
+    ( _pool ? *_pool : recoveryPool() ).parallelFor( _count, [&]( size_t _i ) {
+        o_publics[_i] = recover( _sigs[_i], _hashes[_i] );
+    } );
 }
 
 static const u256 c_secp256k1n(
@@ -131,9 +131,17 @@ inline bytesSec decryptSymNoAuth(
     return decryptAES128CTR( _k.ref(), _iv, _cipher );
 }
 
-/// Recovers Public key from signed message hash.
+/// Recovers Public key from signed message hash. Recently recovered keys are cached, as the same
+/// signature is recovered on transaction arrival, in block creation and by ecrecover calls.
 Public recover( Signature const& _sig, h256 const& _hash );
 
+class WorkerPool;
+
+/// Recovers Public keys of @a _count signatures of @a _hashes into @a o_publics, the same as
+/// recover() of each, in parallel on @a _pool (on all hardware threads if not given).
+void recover( Signature const* _sigs, h256 const* _hashes, Public* o_publics, size_t _count,
+    WorkerPool* _pool = nullptr );
+
 /// Returns siganture of message hash.
 Signature sign( Secret const& _k, h256 const& _hash );
 
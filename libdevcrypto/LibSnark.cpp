@@ -26,8 +26,12 @@
 #include <libff/common/profiling.hpp>
 
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/FixedHash.h>
 #include <libdevcore/Log.h>
 
+#include <array>
+#include <memory>
+
 using namespace std;
 using namespace dev;
 using namespace dev::crypto;
@@ -68,12 +72,17 @@ h256 fromLibsnarkBigint( libff::bigint< libff::alt_bn128_q_limbs > const& _b ) {
     return x;
 }
 
+// Field modulus as a plain number, converted once after initLibSnark().
+u256 const& fqModulus() {
+    static u256 const s_modulus = u256( fromLibsnarkBigint( libff::alt_bn128_Fq::mod ) );
+    return s_modulus;
+}
+
 libff::alt_bn128_Fq decodeFqElement( dev::bytesConstRef _data ) {
     // h256::AlignLeft ensures that the h256 is zero-filled on the right if _data
     // is too short.
     h256 xbin( _data, h256::AlignLeft );
-    // TODO: Consider using a compiler time constant for comparison.
-    if ( u256( xbin ) >= u256( fromLibsnarkBigint( libff::alt_bn128_Fq::mod ) ) )
+    if ( u256( xbin ) >= fqModulus() )
         BOOST_THROW_EXCEPTION( InvalidEncoding() );
     return toLibsnarkBigint( xbin );
 }
@@ -115,6 +124,56 @@ libff::alt_bn128_G2 decodePointG2( dev::bytesConstRef _data ) {
     return p;
 }
 
+// Decoded, checked and precomputed G2 points of recent pairing inputs. Verifiers pair against
+// the same few verifying key points over and over, and the subgroup check and the line
+// coefficients of the Miller loop are the costly part of a pair.
+class G2PrecompCache {
+public:
+    enum class Kind { Invalid, Zero, Point };
+
+    struct Entry {
+        FixedHash< 128 > encoding;
+        Kind kind = Kind::Invalid;
+        libff::alt_bn128_ate_G2_precomp precomp;
+        bool used = false;
+    };
+
+    Entry const& get( dev::bytesConstRef _data ) {
+        FixedHash< 128 > const encoding( _data, FixedHash< 128 >::AlignLeft );
+        Entry& entry = m_entries[FixedHash< 128 >::hash()( encoding ) % m_entries.size()];
+        if ( entry.used && entry.encoding == encoding )
+            return entry;
+
+        // the entry is marked used only once filled, so an exception leaves nothing cached
+        entry.used = false;
+        entry.encoding = encoding;
+        entry.kind = fill( _data, entry.precomp );
+        entry.used = true;
+        return entry;
+    }
+
+private:
+    static Kind fill( dev::bytesConstRef _data, libff::alt_bn128_ate_G2_precomp& o_precomp ) {
+        libff::alt_bn128_G2 p;
+        try {
+            p = decodePointG2( _data );
+        } catch ( InvalidEncoding const& ) {
+            return Kind::Invalid;
+        }
+        if ( -libff::alt_bn128_G2::scalar_field::one() * p + p != libff::alt_bn128_G2::zero() )
+            // p is not an element of the group (has wrong order)
+            return Kind::Invalid;
+        if ( p.is_zero() )
+            return Kind::Zero;
+        o_precomp = libff::alt_bn128_precompute_G2( p );
+        return Kind::Point;
+    }
+
+    std::array< Entry, 16 > m_entries;
+};
+
+thread_local std::unique_ptr< G2PrecompCache > t_g2PrecompCache;
+
 }  // namespace
 
 pair< bool, bytes > dev::crypto::alt_bn128_pairing_product( dev::bytesConstRef _in ) {
@@ -129,18 +188,19 @@ pair< bool, bytes > dev::crypto::alt_bn128_pairing_product( dev::bytesConstRef _
 
     try {
         initLibSnark();
+        if ( !t_g2PrecompCache )
+            t_g2PrecompCache.reset( new G2PrecompCache );
         libff::alt_bn128_Fq12 x = libff::alt_bn128_Fq12::one();
         for ( size_t i = 0; i < pairs; ++i ) {
             bytesConstRef const pair = _in.cropped( i * pairSize, pairSize );
             libff::alt_bn128_G1 const g1 = decodePointG1( pair );
-            libff::alt_bn128_G2 const p = decodePointG2( pair.cropped( 2 * 32 ) );
-            if ( -libff::alt_bn128_G2::scalar_field::one() * p + p != libff::alt_bn128_G2::zero() )
-                // p is not an element of the group (has wrong order)
+            G2PrecompCache::Entry const& p = t_g2PrecompCache->get( pair.cropped( 2 * 32 ) );
+            if ( p.kind == G2PrecompCache::Kind::Invalid )
+                // invalid encoding or p is not an element of the group (has wrong order)
                 return { false, bytes() };
-            if ( p.is_zero() || g1.is_zero() )
+            if ( p.kind == G2PrecompCache::Kind::Zero || g1.is_zero() )
                 continue;  // the pairing is one
-            x = x * libff::alt_bn128_miller_loop(
-                        libff::alt_bn128_precompute_G1( g1 ), libff::alt_bn128_precompute_G2( p ) );
+            x = x * libff::alt_bn128_miller_loop( libff::alt_bn128_precompute_G1( g1 ), p.precomp );
         }
         bool const result =
             libff::alt_bn128_final_exponentiation( x ) == libff::alt_bn128_GT::one();
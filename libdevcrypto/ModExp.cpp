@@ -0,0 +1,216 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ModExp.cpp
+ * @date 2026
+ */
+
+#include "ModExp.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace std;
+using namespace dev;
+
+namespace {
+
+using uint128 = unsigned __int128;
+
+// Byte _i of a big endian number of _length bytes whose bytes come from _data.
+inline uint8_t paddedByte( bytesConstRef _data, size_t _i ) {
+    return _i < _data.size() ? _data[_i] : 0;
+}
+
+// Loads the low N limbs of a big endian number, least significant limb first.
+template < size_t N >
+void loadLimbs( bytesConstRef _data, size_t _length, uint64_t* o_limbs ) {
+    memset( o_limbs, 0, N * sizeof( uint64_t ) );
+    size_t const count = min( _length, N * 8 );
+    for ( size_t k = 0; k < count; ++k ) {
+        // k-th least significant byte
+        size_t const i = _length - 1 - k;
+        o_limbs[k / 8] |= uint64_t( paddedByte( _data, i ) ) << ( 8 * ( k % 8 ) );
+    }
+}
+
+// Number of leading zero bytes of a big endian number, at most _length.
+size_t leadingZeroBytes( bytesConstRef _data, size_t _length ) {
+    size_t const available = min( _length, _data.size() );
+    for ( size_t i = 0; i < available; ++i )
+        if ( _data[i] )
+            return i;
+    return _length;
+}
+
+template < size_t N >
+class Montgomery {
+public:
+    explicit Montgomery( uint64_t const* _mod ) {
+        memcpy( m_mod, _mod, sizeof( m_mod ) );
+
+        // -mod^-1 mod 2^64 by Newton iteration; mod * mod == 1 mod 8 gives three correct bits
+        uint64_t inv = m_mod[0];
+        for ( int i = 0; i < 5; ++i )
+            inv *= 2 - m_mod[0] * inv;
+        m_inv = -inv;
+
+        // R^2 mod mod, R = 2^(64 * N)
+        bigint mod;
+        for ( size_t i = N; i-- > 0; )
+            mod = ( mod << 64 ) | m_mod[i];
+        bigint const r2 = ( bigint( 1 ) << ( 128 * N ) ) % mod;
+        for ( size_t i = 0; i < N; ++i )
+            m_r2[i] = static_cast< uint64_t >(
+                ( r2 >> ( 64 * i ) ) & numeric_limits< uint64_t >::max() );
+    }
+
+    // o_out = _a * _b / R mod mod for _a < R and _b < mod, CIOS method. o_out may alias inputs.
+    void mul( uint64_t* o_out, uint64_t const* _a, uint64_t const* _b ) const {
+        uint64_t t[N + 2] = {};
+        for ( size_t i = 0; i < N; ++i ) {
+            uint64_t carry = 0;
+            for ( size_t j = 0; j < N; ++j ) {
+                uint128 const s = uint128( _a[j] ) * _b[i] + t[j] + carry;
+                t[j] = uint64_t( s );
+                carry = uint64_t( s >> 64 );
+            }
+            uint128 s = uint128( t[N] ) + carry;
+            t[N] = uint64_t( s );
+            t[N + 1] = uint64_t( s >> 64 );
+
+            uint64_t const q = t[0] * m_inv;
+            s = uint128( q ) * m_mod[0] + t[0];
+            carry = uint64_t( s >> 64 );
+            for ( size_t j = 1; j < N; ++j ) {
+                s = uint128( q ) * m_mod[j] + t[j] + carry;
+                t[j - 1] = uint64_t( s );
+                carry = uint64_t( s >> 64 );
+            }
+            s = uint128( t[N] ) + carry;
+            t[N - 1] = uint64_t( s );
+            t[N] = t[N + 1] + uint64_t( s >> 64 );
+        }
+
+        // t < 2 * mod here, so one subtraction is enough
+        if ( t[N] || !less( t, m_mod ) ) {
+            uint64_t borrow = 0;
+            for ( size_t j = 0; j < N; ++j ) {
+                uint128 const d = uint128( t[j] ) - m_mod[j] - borrow;
+                t[j] = uint64_t( d );
+                borrow = uint64_t( d >> 64 ) & 1;
+            }
+        }
+        memcpy( o_out, t, N * sizeof( uint64_t ) );
+    }
+
+    void toMontgomery( uint64_t* o_out, uint64_t const* _a ) const { mul( o_out, _a, m_r2 ); }
+
+    void fromMontgomery( uint64_t* o_out, uint64_t const* _a ) const {
+        uint64_t one[N] = { 1 };
+        mul( o_out, _a, one );
+    }
+
+private:
+    static bool less( uint64_t const* _a, uint64_t const* _b ) {
+        for ( size_t i = N; i-- > 0; )
+            if ( _a[i] != _b[i] )
+                return _a[i] < _b[i];
+        return false;
+    }
+
+    uint64_t m_mod[N];
+    uint64_t m_r2[N];
+    uint64_t m_inv;
+};
+
+template < size_t N >
+bool modexpFixed( bytesConstRef _base, size_t _baseLength, bytesConstRef _exp, size_t _expLength,
+    bytesConstRef _mod, size_t _modLength, bytes& o_result ) {
+    // the base is only reduced by the first multiplication, so it has to be below R
+    if ( _baseLength - leadingZeroBytes( _base, _baseLength ) > N * 8 )
+        return false;
+
+    uint64_t mod[N];
+    loadLimbs< N >( _mod, _modLength, mod );
+    Montgomery< N > const mont( mod );
+
+    uint64_t base[N];
+    loadLimbs< N >( _base, _baseLength, base );
+
+    // fixed 4-bit window: table[i] = base^i in Montgomery form
+    static constexpr size_t c_window = 4;
+    uint64_t table[1 << c_window][N];
+    uint64_t one[N] = { 1 };
+    mont.toMontgomery( table[0], one );
+    mont.toMontgomery( table[1], base );
+    for ( size_t i = 2; i < ( 1 << c_window ); ++i )
+        mont.mul( table[i], table[i - 1], table[1] );
+
+    uint64_t acc[N];
+    memcpy( acc, table[0], sizeof( acc ) );
+    bool started = false;
+    size_t const expFirst = leadingZeroBytes( _exp, _expLength );
+    for ( size_t i = expFirst; i < _expLength; ++i ) {
+        uint8_t const byte = paddedByte( _exp, i );
+        for ( int shift = 8 - c_window; shift >= 0; shift -= c_window ) {
+            unsigned const window = ( byte >> shift ) & ( ( 1 << c_window ) - 1 );
+            if ( started )
+                for ( size_t k = 0; k < c_window; ++k )
+                    mont.mul( acc, acc, acc );
+            if ( window ) {
+                mont.mul( acc, acc, table[window] );
+                started = true;
+            }
+        }
+    }
+
+    uint64_t result[N];
+    mont.fromMontgomery( result, acc );
+
+    o_result.assign( _modLength, 0 );
+    size_t const count = min( _modLength, N * 8 );
+    for ( size_t k = 0; k < count; ++k )
+        o_result[_modLength - 1 - k] = uint8_t( result[k / 8] >> ( 8 * ( k % 8 ) ) );
+    return true;
+}
+
+}  // namespace
+
+bool dev::crypto::modexpMontgomery( bytesConstRef _base, size_t _baseLength, bytesConstRef _exp,
+    size_t _expLength, bytesConstRef _mod, size_t _modLength, bytes& o_result ) {
+    if ( _modLength == 0 || ( paddedByte( _mod, _modLength - 1 ) & 1 ) == 0 )
+        return false;
+
+    size_t const modBytes = _modLength - leadingZeroBytes( _mod, _modLength );
+    if ( modBytes <= 32 )
+        return modexpFixed< 4 >( _base, _baseLength, _exp, _expLength, _mod, _modLength, o_result );
+    if ( modBytes <= 64 )
+        return modexpFixed< 8 >( _base, _baseLength, _exp, _expLength, _mod, _modLength, o_result );
+    if ( modBytes <= 128 )
+        return modexpFixed< 16 >(
+            _base, _baseLength, _exp, _expLength, _mod, _modLength, o_result );
+    if ( modBytes <= 256 )
+        return modexpFixed< 32 >(
+            _base, _baseLength, _exp, _expLength, _mod, _modLength, o_result );
+    if ( modBytes <= c_modexpMontgomeryMaxBytes )
+        return modexpFixed< 64 >(
+            _base, _baseLength, _exp, _expLength, _mod, _modLength, o_result );
+    return false;
+}
@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ModExp.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace dev {
+namespace crypto {
+
+/// Largest modulus handled by modexpMontgomery(), in bytes (4096 bits).
+static constexpr size_t c_modexpMontgomeryMaxBytes = 512;
+
+/// Computes _base ^ _exp mod _mod into @a o_result, a big endian number of _modLength bytes.
+/// Each operand is a big endian number of the given length whose bytes are taken from the
+/// matching view; bytes past the end of a view are zero, as for right-padded precompile input.
+/// Works in 256, 512, 1024, 2048 or 4096 bit Montgomery form, picked by the significant size of
+/// the modulus.
+/// @returns false, leaving @a o_result untouched, if the modulus is even (zero included),
+/// wider than 4096 bits or the base does not fit its width. Callers fall back to bigint then.
+bool modexpMontgomery( bytesConstRef _base, size_t _baseLength, bytesConstRef _exp,
+    size_t _expLength, bytesConstRef _mod, size_t _modLength, bytes& o_result );
+
+}  // namespace crypto
+}  // namespace dev
@@ -39,13 +39,18 @@ class PrecompiledContract {
 public:
     PrecompiledContract() = default;
     PrecompiledContract( PrecompiledPricer const& _cost, PrecompiledExecutor const& _exec,
-        u256 const& _startingBlock = 0, h160Set const& _allowedAddresses = h160Set() )
+        u256 const& _startingBlock = 0, h160Set const& _allowedAddresses = h160Set(),
+        bool _pure = false, std::string const& _name = std::string(), bool _memoize = false )
         : m_cost( _cost ),
           m_execute( _exec ),
           m_startingBlock( _startingBlock ),
-          m_allowed_addresses( _allowedAddresses ) {}
+          m_allowed_addresses( _allowedAddresses ),
+          m_pure( _pure ),
+          m_name( _name ),
+          m_memoize( _pure && _memoize ) {}
     PrecompiledContract( unsigned _base, unsigned _word, PrecompiledExecutor const& _exec,
-        u256 const& _startingBlock = 0, h160Set const& _allowedAddresses = h160Set() );
+        u256 const& _startingBlock = 0, h160Set const& _allowedAddresses = h160Set(),
+        bool _pure = false, std::string const& _name = std::string(), bool _memoize = false );
 
     bigint cost( bytesConstRef _in, ChainOperationParams const& _chainParams,
         u256 const& _blockNumber ) const {
@@ -60,11 +65,23 @@ public:
                ( m_allowed_addresses.count( _from ) != 0 && !_readOnly );
     }
 
+    /// @returns true if the output depends on the input only, not on state, files or config.
+    bool pure() const { return m_pure; }
+
+    /// Executor name from the config, used in statistics.
+    std::string const& name() const { return m_name; }
+
+    /// @returns true if results are worth keeping in PrecompiledCache, which implies pure().
+    bool memoize() const { return m_memoize; }
+
 private:
     PrecompiledPricer m_cost;
     PrecompiledExecutor m_execute;
     u256 m_startingBlock = 0;
     h160Set m_allowed_addresses;
+    bool m_pure = false;
+    std::string m_name;
+    bool m_memoize = false;
 };
 
 static constexpr int64_t c_infiniteBlockNumber = std::numeric_limits< int64_t >::max();
@@ -86,6 +103,8 @@ public:
     bool syncNode;
     bool archiveMode;
     bool syncFromCatchup;
+    bool logIndex = false;  ///< keep node-local on-disk index of logs for eth_getLogs
+    uint64_t logsPageLimit = 10000;  ///< most logs in a page of paginated eth_getLogs
 
     NodeInfo( std::string _name = "TestNode", u256 _id = 1, std::string _ip = "127.0.0.11",
         uint16_t _port = 11111, std::string _ip6 = "::1", uint16_t _port6 = 11111,
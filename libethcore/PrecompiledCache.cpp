@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PrecompiledCache.cpp
+ * @date 2026
+ */
+
+#include "PrecompiledCache.h"
+#include "ChainOperationParams.h"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string_view>
+
+namespace dev {
+namespace eth {
+
+std::atomic< bool > PrecompiledCache::s_enabled{ true };
+std::atomic< size_t > PrecompiledCache::s_memory{ 0 };
+std::mutex PrecompiledCache::s_countersMutex;
+std::map< std::string, std::unique_ptr< PrecompiledCache::Counters > >
+    PrecompiledCache::s_counters;
+
+PrecompiledCache::~PrecompiledCache() {
+    clear();
+}
+
+PrecompiledCache& PrecompiledCache::local() {
+    thread_local PrecompiledCache t_cache;
+    return t_cache;
+}
+
+PrecompiledCache::Counters& PrecompiledCache::counters( std::string const& _name ) {
+    auto it = m_counters.find( _name );
+    if ( it != m_counters.end() )
+        return *it->second;
+
+    std::lock_guard< std::mutex > lock( s_countersMutex );
+    auto& shared = s_counters[_name.empty() ? "unnamed" : _name];
+    if ( !shared )
+        shared.reset( new Counters );
+    m_counters.emplace( _name, shared.get() );
+    return *shared;
+}
+
+void PrecompiledCache::startBlock( u256 const& _blockNumber ) {
+    if ( m_started && m_blockNumber == _blockNumber )
+        return;
+    clear();
+    m_blockNumber = _blockNumber;
+    m_started = true;
+}
+
+void PrecompiledCache::clear() {
+    m_entries.clear();
+    s_memory.fetch_sub( m_memory, std::memory_order_relaxed );
+    m_memory = 0;
+}
+
+std::pair< bool, SharedBytes > PrecompiledCache::execute(
+    PrecompiledContract const& _contract, bytesConstRef _in, u256 const& _blockNumber ) {
+    Counters& counters = this->counters( _contract.name() );
+    counters.calls.fetch_add( 1, std::memory_order_relaxed );
+
+    bool const memoize = _contract.memoize() && enabled();
+    size_t hash = 0;
+    if ( memoize ) {
+        startBlock( _blockNumber );
+        hash = std::hash< std::string_view >()(
+                   { reinterpret_cast< char const* >( _in.data() ), _in.size() } ) ^
+               std::hash< Counters const* >()( &counters );
+        auto range = m_entries.equal_range( hash );
+        for ( auto it = range.first; it != range.second; ++it ) {
+            Entry const& entry = it->second;
+            if ( entry.precompiled == &counters && _in.contentsEqual( entry.input ) ) {
+                counters.hits.fetch_add( 1, std::memory_order_relaxed );
+                return { entry.success, SharedBytes( entry.output ) };
+            }
+        }
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto result = _contract.execute( _in );
+    std::chrono::nanoseconds const time = std::chrono::steady_clock::now() - start;
+    counters.executionTime.fetch_add( time.count(), std::memory_order_relaxed );
+
+    auto output = std::make_shared< bytes const >( std::move( result.second ) );
+    size_t const entryMemory = _in.size() + output->size();
+    if ( memoize && m_memory + entryMemory <= c_maxThreadMemory ) {
+        // reserve first, so that threads racing for the last bytes cannot overshoot together
+        size_t const total = s_memory.fetch_add( entryMemory, std::memory_order_relaxed );
+        if ( total + entryMemory <= c_maxMemory ) {
+            m_entries.emplace( hash, Entry{ &counters, _in.toBytes(), result.first, output } );
+            m_memory += entryMemory;
+        } else
+            s_memory.fetch_sub( entryMemory, std::memory_order_relaxed );
+    }
+    return { result.first, SharedBytes( std::move( output ) ) };
+}
+
+std::map< std::string, PrecompiledCache::Stats > PrecompiledCache::stats() {
+    std::map< std::string, Stats > ret;
+    std::lock_guard< std::mutex > lock( s_countersMutex );
+    for ( auto const& entry : s_counters ) {
+        Stats& stats = ret[entry.first];
+        stats.calls = entry.second->calls.load( std::memory_order_relaxed );
+        stats.hits = entry.second->hits.load( std::memory_order_relaxed );
+        stats.executionTime = entry.second->executionTime.load( std::memory_order_relaxed ) / 1000;
+    }
+    return ret;
+}
+
+}  // namespace eth
+}  // namespace dev
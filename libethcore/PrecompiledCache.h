@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PrecompiledCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/SharedBytes.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+class PrecompiledContract;
+
+/// Runs precompiled contracts, collecting per-precompile statistics, and memoizes the results of
+/// expensive pure ones within a block: a repeated call with the same input gets the output of
+/// the first one, shared rather than copied.
+/// Every thread has its own cache, so lookups take no locks. Entries are dropped when the thread
+/// starts executing another block or exits, and are not added once the thread uses
+/// c_maxThreadMemory or all threads together use c_maxMemory, so idle RPC and pool threads
+/// cannot hold more than that between them. Pure results do not depend on the block, so this
+/// only bounds the lifetime of entries; inputs are compared in full on every hit, so a hash
+/// collision cannot return a wrong result.
+class PrecompiledCache {
+public:
+    /// Inputs and outputs kept by the cache of one thread.
+    static constexpr size_t c_maxThreadMemory = 4 * 1024 * 1024;
+    /// Inputs and outputs kept by the caches of all threads.
+    static constexpr size_t c_maxMemory = 16 * 1024 * 1024;
+
+    PrecompiledCache() = default;
+    PrecompiledCache( PrecompiledCache const& ) = delete;
+    PrecompiledCache& operator=( PrecompiledCache const& ) = delete;
+    ~PrecompiledCache();
+
+    struct Stats {
+        uint64_t calls = 0;
+        uint64_t hits = 0;
+        /// microseconds spent in the executor, hits excluded
+        uint64_t executionTime = 0;
+    };
+
+    /// Cache of the calling thread.
+    static PrecompiledCache& local();
+
+    /// Executes @a _contract in block @a _blockNumber, or returns the result of an earlier call
+    /// with the same input in this block if the contract is memoized.
+    std::pair< bool, SharedBytes > execute(
+        PrecompiledContract const& _contract, bytesConstRef _in, u256 const& _blockNumber );
+
+    size_t size() const { return m_entries.size(); }
+    size_t memory() const { return m_memory; }
+    /// Memory used by the caches of all threads.
+    static size_t totalMemory() { return s_memory.load( std::memory_order_relaxed ); }
+
+    /// Turns memoization on or off in all threads; statistics are collected either way.
+    static void setEnabled( bool _enabled ) {
+        s_enabled.store( _enabled, std::memory_order_relaxed );
+    }
+    static bool enabled() { return s_enabled.load( std::memory_order_relaxed ); }
+
+    /// Statistics of all threads by precompile name.
+    static std::map< std::string, Stats > stats();
+
+private:
+    struct Counters {
+        std::atomic< uint64_t > calls{ 0 };
+        std::atomic< uint64_t > hits{ 0 };
+        std::atomic< uint64_t > executionTime{ 0 };  // nanoseconds
+    };
+
+    struct Entry {
+        Counters const* precompiled;
+        bytes input;
+        bool success;
+        std::shared_ptr< bytes const > output;
+    };
+
+    /// Counters of precompile @a _name, shared by all threads and never freed.
+    Counters& counters( std::string const& _name );
+
+    void startBlock( u256 const& _blockNumber );
+    void clear();
+
+    static std::atomic< bool > s_enabled;
+    static std::atomic< size_t > s_memory;
+    static std::mutex s_countersMutex;
+    static std::map< std::string, std::unique_ptr< Counters > > s_counters;
+
+    u256 m_blockNumber;
+    bool m_started = false;
+    size_t m_memory = 0;
+    // keyed by hash of the input and the precompile
+    std::unordered_multimap< size_t, Entry > m_entries;
+    std::unordered_map< std::string, Counters* > m_counters;
+};
+
+}  // namespace eth
+}  // namespace dev
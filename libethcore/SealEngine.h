@@ -27,6 +27,7 @@
 
 #include "BlockHeader.h"
 #include "Common.h"
+#include "PrecompiledCache.h"
 #include "libethcore/Counter.h"
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
@@ -108,12 +109,23 @@ public:
         Address const& _a, bytesConstRef _in, u256 const& ) const {
         return m_params.precompiled.at( _a ).execute( _in );
     }
+    /// Same through PrecompiledCache of the calling thread, so repeated calls of expensive pure
+    /// precompiles within a block share one output.
+    std::pair< bool, SharedBytes > executePrecompiledCached(
+        Address const& _a, bytesConstRef _in, u256 const& _blockNumber ) const {
+        return PrecompiledCache::local().execute(
+            m_params.precompiled.at( _a ), _in, _blockNumber );
+    }
 
     virtual bool precompiledExecutionAllowedFrom(
         Address const& _a, Address const& _from, bool _readOnly ) const {
         return m_params.precompiled.at( _a ).executionAllowedFrom( _from, _readOnly );
     }
 
+    bool precompiledIsPure( Address const& _a ) const {
+        return m_params.precompiled.at( _a ).pure();
+    }
+
 protected:
     virtual bool onOptionChanging( std::string const&, bytes const& ) { return true; }
 
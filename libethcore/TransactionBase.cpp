@@ -143,6 +143,28 @@ Address const& TransactionBase::safeSender() const noexcept {
     }
 }
 
+void TransactionBase::prefetchSenders( std::vector< TransactionBase const* > const& _txs ) {
+    MICROPROFILE_SCOPEI( "TransactionBase", "prefetchSenders", MP_GOLD2 );
+
+    std::vector< TransactionBase const* > pending;
+    std::vector< Signature > sigs;
+    h256s hashes;
+    for ( auto t : _txs )
+        if ( !t->m_sender.has_value() && !t->isInvalid() && t->hasSignature() &&
+             !t->hasZeroSignature() ) {
+            pending.push_back( t );
+            sigs.push_back( *t->m_vrs );
+            hashes.push_back( t->sha3( WithoutSignature ) );
+        }
+
+    std::vector< Public > publics( sigs.size() );
+    recover( sigs.data(), hashes.data(), publics.data(), sigs.size() );
+    for ( size_t i = 0; i < pending.size(); ++i )
+        if ( publics[i] )
+            pending[i]->m_sender =
+                right160( dev::sha3( bytesConstRef( publics[i].data(), sizeof( publics[i] ) ) ) );
+}
+
 Address const& TransactionBase::sender() const {
     if ( !m_sender.has_value() ) {
         if ( isInvalid() || hasZeroSignature() )
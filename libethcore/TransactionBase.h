@@ -124,6 +124,10 @@ public:
     /// Like sender() but will never throw. @returns a null Address if the signature is invalid.
     Address const& safeSender() const noexcept;
 
+    /// Recovers senders of already decoded transactions @a _txs in parallel. Ones whose key
+    /// can't be recovered are left as they are, so that sender() fails on them as usual.
+    static void prefetchSenders( std::vector< TransactionBase const* > const& _txs );
+
     /// Force the sender to a particular value. This will result in an invalid transaction RLP.
     void forceSender( Address const& _a ) { m_sender = _a; }
 
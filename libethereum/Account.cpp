@@ -45,7 +45,7 @@ std::unordered_map< u256, u256 > const& Account::originalStorageCache() const {
 void Account::setCode( bytes&& _code, u256 const& _version ) {
     auto const newHash = sha3( _code );
     if ( newHash != m_codeHash ) {
-        m_codeCache = std::move( _code );
+        m_codeCache = std::make_shared< bytes const >( std::move( _code ) );
         m_hasNewCode = true;
         m_codeHash = newHash;
     }
@@ -53,7 +53,7 @@ void Account::setCode( bytes&& _code, u256 const& _version ) {
 }
 
 void Account::resetCode() {
-    m_codeCache.clear();
+    m_codeCache.reset();
     m_hasNewCode = false;
     m_codeHash = EmptySHA3;
     // Reset the version, as it was set together with code
@@ -82,9 +82,11 @@ PrecompiledContract createPrecompiledContract( js::mObject const& _precompiled )
         if ( _precompiled.count( "startingBlock" ) )
             startingBlock = u256( _precompiled.at( "startingBlock" ).get_str() );
 
+        bool const pure = PrecompiledRegistrar::isPure( n );
+        bool const memoize = PrecompiledRegistrar::isMemoizable( n );
         if ( !_precompiled.count( "linear" ) )
             return PrecompiledContract( PrecompiledRegistrar::pricer( n ),
-                PrecompiledRegistrar::executor( n ), startingBlock );
+                PrecompiledRegistrar::executor( n ), startingBlock, h160Set(), pure, n, memoize );
 
         auto const& l = _precompiled.at( "linear" ).get_obj();
         unsigned base = toUnsigned( l.at( "base" ) );
@@ -111,8 +113,8 @@ PrecompiledContract createPrecompiledContract( js::mObject const& _precompiled )
             }
         }  // restrictAccessIt
 
-        return PrecompiledContract(
-            base, word, PrecompiledRegistrar::executor( n ), startingBlock, allowedAddresses );
+        return PrecompiledContract( base, word, PrecompiledRegistrar::executor( n ), startingBlock,
+            allowedAddresses, pure, n, memoize );
     } catch ( PricerNotFound const& ) {
         cwarn << "Couldn't create a precompiled contract account. Missing a pricer called:" << n;
         throw;
@@ -30,6 +30,8 @@
 #include <libdevcore/TrieDB.h>
 #include <libethcore/Common.h>
 
+#include <optional>
+
 namespace dev {
 class OverlayDB;
 namespace eth {
@@ -123,6 +125,8 @@ public:
           m_storageUsed( _storageUsed ),
           m_storageRoot( _contractRoot ) {
         assert( _contractRoot );
+        if ( _c == Unchanged )
+            m_loaded = LoadedRecord{ _nonce, _balance, _codeHash, _storageUsed };
     }
 
     /// Kill this account. Useful for the suicide opcode. Following this call, isAlive() returns
@@ -227,11 +231,18 @@ public:
     /// equal to codeHash() and must only be called when isFreshCode() returns false.
     void noteCode( bytesConstRef _code ) {
         assert( sha3( _code ) == m_codeHash );
-        m_codeCache = _code.toBytes();
+        m_codeCache = std::make_shared< bytes const >( _code.toBytes() );
+    }
+    /// Same, but shares @a _code instead of copying it.
+    void noteCode( std::shared_ptr< bytes const > _code ) {
+        assert( _code && sha3( *_code ) == m_codeHash );
+        m_codeCache = std::move( _code );
     }
 
     /// @returns the account's code.
-    bytes const& code() const { return m_codeCache; }
+    bytes const& code() const { return m_codeCache ? *m_codeCache : NullBytes; }
+    /// @returns the account's code for sharing with executions, nullptr if it is not known.
+    std::shared_ptr< bytes const > const& sharedCode() const { return m_codeCache; }
 
     u256 version() const { return m_version; }
 
@@ -261,7 +272,22 @@ public:
     /// Note that we've altered the account.
     void changed() { m_isUnchanged = false; }
 
+    /// @returns true if nonce, balance, code hash or storage usage differ from the record the
+    /// account was loaded with, or if it was not loaded from the database at all.
+    bool recordChanged() const {
+        return !m_loaded || m_loaded->nonce != m_nonce || m_loaded->balance != m_balance ||
+               m_loaded->codeHash != m_codeHash || m_loaded->storageUsed != m_storageUsed;
+    }
+
 private:
+    /// Fields of the account record as loaded from the database.
+    struct LoadedRecord {
+        u256 nonce;
+        u256 balance;
+        h256 codeHash;
+        s256 storageUsed;
+    };
+
     /// Is this account existant? If not, it represents a deleted account.
     bool m_isAlive = false;
 
@@ -295,8 +321,9 @@ private:
     mutable std::unordered_map< u256, u256 > m_storageOriginal;
 
     /// The associated code for this account. The SHA3 of this should be equal to m_codeHash unless
-    /// m_codeHash equals c_contractConceptionCodeHash.
-    bytes m_codeCache;
+    /// m_codeHash equals c_contractConceptionCodeHash. Never modified, so copies of the account
+    /// and executions of the code share it.
+    std::shared_ptr< bytes const > m_codeCache;
 
     /// Value for m_codeHash when this account is having its code determined.
     static const h256 c_contractConceptionCodeHash;
@@ -304,6 +331,9 @@ private:
     // is only valuable if account has code
     s256 m_storageUsed = 0;
 
+    /// The record this account was loaded with, empty for accounts created in memory.
+    std::optional< LoadedRecord > m_loaded;
+
     Counter< Account > c;
 
 protected:
@@ -34,6 +34,7 @@
 #include <libdevcore/TrieHash.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/SealEngine.h>
+#include <libevm/ExecutionBudget.h>
 #include <libevm/VMFactory.h>
 #include <boost/filesystem.hpp>
 #include <boost/timer.hpp>
@@ -845,6 +846,9 @@ ExecutionResult Block::execute(
         // shoul not happen as exception in execute() means that tx should not be in block
         cerror << DETAILED_ERROR;
         assert( false );
+    } catch ( const ExecutionBudgetExceeded& ) {
+        // only calls have a budget; they report it instead of a failed transaction
+        throw;
     } catch ( const std::exception& ex ) {
         h256 sha = _t.hasSignature() ? _t.sha3() : _t.sha3( WithoutSignature );
         LOG( m_logger ) << "Transaction " << sha << " WouldNotBeInBlock: " << ex.what();
@@ -1043,7 +1047,7 @@ bool Block::sealBlock( bytesConstRef _header ) {
 }
 
 void Block::startReadState() {
-    m_state = m_state.createStateReadOnlyCopy();
+    m_state = m_state.createReadOnlyOverlay();
 }
 
 h256 Block::stateRootBeforeTx( unsigned _i ) const {
@@ -295,6 +295,8 @@ public:
     /// Get the header information on the present block.
     BlockHeader const& info() const { return m_currentBlock; }
 
+    /// Turns the state into a read-only overlay of the latest version, @see
+    /// State::createReadOnlyOverlay().
     void startReadState();
 
 private:
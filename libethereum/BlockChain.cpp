@@ -225,6 +225,7 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
     if ( _we == WithExisting::Kill ) {
         cnote << "Killing blockchain & extras database (WithExisting::Kill).";
         fs::remove_all( chainPath / fs::path( "blocks_and_extras" ) );
+        fs::remove_all( chainPath / fs::path( "log_index" ) );
     }
 
     try {
@@ -238,6 +239,8 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
         m_db_splitter = std::make_unique< batched_io::db_splitter >( m_db );
         m_blocksDB = m_db_splitter->new_interface();
         m_extrasDB = m_db_splitter->new_interface();
+        if ( chainParams().nodeInfo.logIndex )
+            m_logIndex.reset( new LogIndex( chainPath / fs::path( "log_index" ) ) );
         // m_blocksDB.reset( new db::DBImpl( chainPath / fs::path( "blocks" ) ) );
         // m_extrasDB.reset( new db::DBImpl( extrasPath / fs::path( "extras" ) ) );
     } catch ( db::DatabaseError const& ex ) {
@@ -303,6 +306,9 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
     cdebug << cc::info( "Opened blockchain DB. Latest: " ) << currentHash() << ' '
            << m_lastBlockNumber;
 
+    if ( m_logIndex )
+        syncLogIndex();
+
     //    dump_blocks_and_extras_db( *this, 0 );
 
     if ( _applyPatches && TotalStorageUsedPatch::isInitOnChainNeeded( *m_db ) )
@@ -318,6 +324,7 @@ void BlockChain::reopen( ChainParams const& _p, bool _applyPatches, WithExisting
 void BlockChain::close() {
     ctrace << "Closing blockchain DB";
     // Not thread safe...
+    m_logIndex.reset();
     m_extrasDB = nullptr;
     m_blocksDB = nullptr;
     m_db_splitter.reset();
@@ -973,6 +980,19 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
     checkConsistency();
 #endif  // ETH_PARANOIA
 
+    if ( m_logIndex ) {
+        try {
+            BlockReceipts const blockReceipts( ( RLP( _receipts ) ) );
+            // only this block, catching up and removal of stale blocks are left to
+            // syncLogIndex() and backfillLogIndex()
+            DEV_GUARDED( x_logIndexWrite )
+            m_logIndex->indexBlock( _block.info.number(), blockReceipts.receipts );
+        } catch ( std::exception const& ex ) {
+            // index is auxiliary, eth_getLogs falls back to blooms for blocks it does not cover
+            cwarn << "Failed to index logs of block " << _block.info.number() << ": " << ex.what();
+        }
+    }
+
     _performanceLogger.onStageFinished( "checkBest" );
 
     unsigned const gasPerSecond = static_cast< double >( _block.info.gasUsed() ) /
@@ -999,6 +1019,62 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
     return ImportRoute{ dead, fresh, _block.transactions };
 }
 
+void BlockChain::catchUpLogIndex( uint64_t _number ) {
+    uint64_t first, last;
+    if ( !m_logIndex->range( first, last ) || last + 1 >= _number ||
+         _number - last > c_maxLogIndexCatchUp )
+        return;
+    for ( uint64_t n = last + 1; n < _number; ++n ) {
+        h256 const hash = numberHash( n );
+        if ( !hash || !isKnown( hash ) ||
+             !m_logIndex->indexBlock( n, receipts( hash ).receipts ) )
+            return;
+    }
+}
+
+bool BlockChain::removeStaleLogs( std::atomic_bool const& _stop ) const {
+    for ( bool more = true; more; ) {
+        if ( _stop )
+            return false;
+        DEV_GUARDED( x_logIndexWrite )
+        more = m_logIndex->removeStale();
+    }
+    return true;
+}
+
+void BlockChain::syncLogIndex() {
+    try {
+        // blocks indexed before the chain lost them, then blocks the index missed
+        DEV_GUARDED( x_logIndexWrite )
+        m_logIndex->retireBlocks( uint64_t( m_lastBlockNumber ) + 1 );
+        removeStaleLogs( std::atomic_bool( false ) );
+        DEV_GUARDED( x_logIndexWrite )
+        catchUpLogIndex( uint64_t( m_lastBlockNumber ) + 1 );
+    } catch ( std::exception const& ex ) {
+        cwarn << "Failed to bring log index up to date: " << ex.what();
+    }
+}
+
+uint64_t BlockChain::backfillLogIndex(
+    uint64_t _downTo, std::atomic_bool const& _stop ) const {
+    if ( !m_logIndex || !removeStaleLogs( _stop ) )
+        return 0;
+    uint64_t count = 0;
+    uint64_t first, last;
+    while ( !_stop && m_logIndex->range( first, last ) && first > _downTo ) {
+        h256 const hash = numberHash( first - 1 );
+        if ( !hash || !isKnown( hash ) )
+            break;  // rotated out or before chain start
+        bool indexed;
+        DEV_GUARDED( x_logIndexWrite )
+        indexed = m_logIndex->indexBlock( first - 1, receipts( hash ).receipts );
+        if ( !indexed )
+            break;
+        ++count;
+    }
+    return count;
+}
+
 void BlockChain::clearBlockBlooms( unsigned _begin, unsigned _end ) {
     //   ... c c c c c c c c c c C o o o o o o
     //   ...                               /=15        /=21
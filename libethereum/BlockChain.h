@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <unordered_map>
@@ -48,6 +49,7 @@
 #include "BlockQueue.h"
 #include "ChainParams.h"
 #include "LastBlockHashesFace.h"
+#include "LogIndex.h"
 #include "Transaction.h"
 #include "VerifiedBlock.h"
 
@@ -451,6 +453,14 @@ public:
     /// snapshot import.
     unsigned chainStartBlockNumber() const;
 
+    /// @returns on-disk log index or nullptr if it is disabled by nodeInfo.logIndex
+    LogIndex const* logIndex() const { return m_logIndex.get(); }
+    /// Removes keys of stale blocks from the log index, then indexes logs of blocks below already
+    /// indexed ones, down to block @a _downTo.
+    /// Can run while blocks are imported. Stops early if @a _stop becomes true.
+    /// @returns number of blocks indexed
+    uint64_t backfillLogIndex( uint64_t _downTo, std::atomic_bool const& _stop ) const;
+
     uint64_t pieceUsageBytes() const {
         if ( this->m_db->exists( ( db::Slice ) "pieceUsageBytes" ) ) {
             return std::stoull( this->m_db->lookup( ( db::Slice ) "pieceUsageBytes" ) );
@@ -490,6 +500,16 @@ private:
     void checkBlockIsNew( VerifiedBlockRef const& _block ) const;
     void checkBlockTimestamp( BlockHeader const& _header ) const;
 
+    /// Indexes logs of blocks below @a _number the index missed, e.g. imported right before a
+    /// crash. Longer gaps restart the index, --log-index-backfill fills them in.
+    void catchUpLogIndex( uint64_t _number );
+    /// Removes keys of stale blocks from the log index chunk by chunk, not blocking import.
+    /// @returns false if stopped by @a _stop before all of them are removed
+    bool removeStaleLogs( std::atomic_bool const& _stop ) const;
+    /// Brings the log index in line with the chain after it is opened.
+    void syncLogIndex();
+    static constexpr uint64_t c_maxLogIndexCatchUp = 1024;
+
     template < class T, class K, unsigned N >
     T queryExtras( K const& _h, std::unordered_map< K, T >& _m, boost::shared_mutex& _x,
         T const& _n, batched_io::db_face* _extrasDB = nullptr ) const {
@@ -595,6 +615,8 @@ private:
     std::unique_ptr< batched_io::db_splitter > m_db_splitter;      // new_interface()
     batched_io::db_operations_face* m_blocksDB;                    // working horse 1!
     batched_io::db_operations_face* m_extrasDB;                    // working horse 2!
+    std::unique_ptr< LogIndex > m_logIndex;  // node-local, not in blocks_and_extras
+    mutable Mutex x_logIndexWrite;           // import and backfill write to it
                                                  // assigned here later in Client::init()
 private:
     /// Hash of the last (valid) block on the longest chain.
@@ -54,13 +54,17 @@ ChainParams::ChainParams() {
         genesisState[Address( i )] = Account( 0, 1 );
     // Setup default precompiled contracts as equal to genesis of Frontier.
     precompiled.insert( make_pair( Address( 1 ),
-        PrecompiledContract( 3000, 0, PrecompiledRegistrar::executor( "ecrecover" ) ) ) );
-    precompiled.insert( make_pair(
-        Address( 2 ), PrecompiledContract( 60, 12, PrecompiledRegistrar::executor( "sha256" ) ) ) );
+        PrecompiledContract( 3000, 0, PrecompiledRegistrar::executor( "ecrecover" ), 0, h160Set(),
+            true, "ecrecover", PrecompiledRegistrar::isMemoizable( "ecrecover" ) ) ) );
+    precompiled.insert( make_pair( Address( 2 ),
+        PrecompiledContract(
+            60, 12, PrecompiledRegistrar::executor( "sha256" ), 0, h160Set(), true, "sha256" ) ) );
     precompiled.insert( make_pair( Address( 3 ),
-        PrecompiledContract( 600, 120, PrecompiledRegistrar::executor( "ripemd160" ) ) ) );
+        PrecompiledContract( 600, 120, PrecompiledRegistrar::executor( "ripemd160" ), 0, h160Set(),
+            true, "ripemd160" ) ) );
     precompiled.insert( make_pair( Address( 4 ),
-        PrecompiledContract( 15, 3, PrecompiledRegistrar::executor( "identity" ) ) ) );
+        PrecompiledContract( 15, 3, PrecompiledRegistrar::executor( "identity" ), 0, h160Set(),
+            true, "identity" ) ) );
 
     // fill empty stateRoot
     secp256k1_sha256_t ctx;
@@ -116,6 +120,8 @@ ChainParams ChainParams::loadConfig(
         bool syncNode = false;
         bool archiveMode = false;
         bool syncFromCatchup = false;
+        bool logIndex = false;
+        uint64_t logsPageLimit = cp.nodeInfo.logsPageLimit;
         std::string ip, ip6, keyShareName, sgxServerUrl;
         size_t t = 0;
         uint64_t port = 0, port6 = 0;
@@ -147,6 +153,14 @@ ChainParams ChainParams::loadConfig(
             syncFromCatchup = infoObj.at( "syncFromCatchup" ).get_bool();
         } catch ( ... ) {
         }
+        try {
+            logIndex = infoObj.at( "logIndex" ).get_bool();
+        } catch ( ... ) {
+        }
+        try {
+            logsPageLimit = std::max< uint64_t >( infoObj.at( "logsPageLimit" ).get_uint64(), 1 );
+        } catch ( ... ) {
+        }
 
         try {
             cp.rotateAfterBlock_ = infoObj.at( "rotateAfterBlock" ).get_int();
@@ -189,6 +203,8 @@ ChainParams ChainParams::loadConfig(
         cp.nodeInfo = { nodeName, nodeID, ip, static_cast< uint16_t >( port ), ip6,
             static_cast< uint16_t >( port6 ), sgxServerUrl, ecdsaKeyName, keyShareName,
             BLSPublicKeys, commonBLSPublicKeys, syncNode, archiveMode, syncFromCatchup };
+        cp.nodeInfo.logIndex = logIndex;
+        cp.nodeInfo.logsPageLimit = logsPageLimit;
 
         auto sChainObj = skaleObj.at( "sChain" ).get_obj();
         SChain s{};
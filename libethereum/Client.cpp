@@ -52,6 +52,7 @@
 
 #include <libskale/ContractStorageLimitPatch.h>
 #include <libskale/ContractStorageZeroValuePatch.h>
+#include <libskale/FilePool.h>
 #include <libskale/RevertableFSPatch.h>
 #include <libskale/State.h>
 #include <libskale/StorageDestructionPatch.h>
@@ -179,6 +180,8 @@ void Client::stopWorking() {
     else
         cerror << "Instance of SkaleHost was not properly created.";
 
+    stopFilterMatching();
+
     m_snapshotAgent->terminate();
 
     m_new_block_watch.uninstallAll();
@@ -281,6 +284,8 @@ void Client::init( WithExisting _forceAction, u256 _networkId ) {
 
     m_bq.setChain( bc() );
 
+    startFilterMatching();
+
     m_lastGetWork = std::chrono::system_clock::now() - chrono::seconds( 30 );
     m_tqReady = m_tq.onReady( [=]() {
         this->onTransactionQueueReady();
@@ -440,42 +445,162 @@ void Client::appendFromNewPending(
     Guard l( x_filtersWatches );
     io_changed.insert( PendingChangedFilter );
     m_specialFilters.at( PendingChangedFilter ).push_back( _sha3 );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number.
-        auto m = i.second.filter.matches( _receipt );
+    h256Hash candidates;
+    m_filterIndex.candidates( _receipt, candidates );
+    for ( h256 const& id : candidates ) {
+        auto it = m_filters.find( id );
+        if ( it == m_filters.end() )
+            continue;
+        auto m = it->second.filter.matches( _receipt );
         if ( m.size() ) {
             // filter catches them
             for ( LogEntry const& l : m )
-                i.second.changes_.push_back( LocalisedLogEntry( l ) );
-            io_changed.insert( i.first );
+                it->second.changes_.push_back( LocalisedLogEntry( l ) );
+            io_changed.insert( id );
         }
     }
 }
 
-void Client::appendFromBlock( h256 const& _block, BlockPolarity _polarity, h256Hash& io_changed ) {
-    // TODO: more precise check on whether the txs match.
-    auto receipts = bc().receipts( _block ).receipts;
-
-    Guard l( x_filtersWatches );
+void Client::appendFromBlockReceipts( h256 const& _block, BlockPolarity _polarity,
+    TransactionReceipts const& _receipts, h256Hash& io_changed ) {
     io_changed.insert( ChainChangedFilter );
     m_specialFilters.at( ChainChangedFilter ).push_back( _block );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number & looks like block may contain a matching log entry.
-        for ( size_t j = 0; j < receipts.size(); j++ ) {
-            auto tr = receipts[j];
-            auto m = i.second.filter.matches( tr );
+    if ( _receipts.empty() )
+        return;
+    BlockNumber blockNumber = ( BlockNumber ) bc().number( _block );
+    h256Hash candidates;
+    for ( size_t j = 0; j < _receipts.size(); j++ ) {
+        // only filters indexed by an address or topic 0 of this receipt's logs are checked
+        candidates.clear();
+        m_filterIndex.candidates( _receipts[j], candidates );
+        h256 transactionHash;
+        for ( h256 const& id : candidates ) {
+            auto it = m_filters.find( id );
+            if ( it == m_filters.end() )
+                continue;
+            auto m = it->second.filter.matches( _receipts[j] );
             if ( m.size() ) {
-                auto transactionHash = transaction( _block, j ).sha3();
+                if ( !transactionHash )
+                    transactionHash = transaction( _block, j ).sha3();
                 // filter catches them
                 for ( LogEntry const& l : m )
-                    i.second.changes_.push_back( LocalisedLogEntry( l, _block,
-                        ( BlockNumber ) bc().number( _block ), transactionHash, j, 0, _polarity ) );
-                io_changed.insert( i.first );
+                    it->second.changes_.push_back( LocalisedLogEntry(
+                        l, _block, blockNumber, transactionHash, j, 0, _polarity ) );
+                io_changed.insert( id );
             }
         }
     }
 }
 
+void Client::queueFilterMatching( h256s const& _deadBlocks, h256s const& _liveBlocks ) {
+    if ( _deadBlocks.empty() && _liveBlocks.empty() )
+        return;
+    {
+        std::lock_guard< std::mutex > l( x_filterMatch );
+        if ( m_filterMatchThread.joinable() && !m_filterMatchStop ) {
+            m_filterMatchQueue.emplace_back( _deadBlocks, _liveBlocks );
+            m_filterMatchSignal.notify_all();
+            return;
+        }
+    }
+    // matching thread is not running, do it inline
+    matchFilters( _deadBlocks, _liveBlocks );
+}
+
+void Client::matchFilters( h256s const& _deadBlocks, h256s const& _liveBlocks ) {
+    // receipts are read without x_filtersWatches, only blocks whose bloom may match are read
+    std::vector< std::pair< h256, TransactionReceipts > > dead, live;
+    auto fnLoad = [&]( h256s const& _blocks,
+                      std::vector< std::pair< h256, TransactionReceipts > >& o_receipts ) {
+        for ( h256 const& h : _blocks ) {
+            bool mayMatch = false;
+            LogBloom bloom = bc().info( h ).logBloom();
+            DEV_GUARDED( x_filtersWatches )
+            mayMatch = m_filterIndex.mayMatch( bloom );
+            o_receipts.emplace_back(
+                h, mayMatch ? bc().receipts( h ).receipts : TransactionReceipts() );
+        }
+    };
+    fnLoad( _deadBlocks, dead );
+    fnLoad( _liveBlocks, live );
+
+    // one lock for match and note, so changes cannot be cleared by somebody else in between
+    h256Hash changeds;
+    Guard l( x_filtersWatches );
+    for ( auto const& i : dead )
+        appendFromBlockReceipts( i.first, BlockPolarity::Dead, i.second, changeds );
+    for ( auto const& i : live )
+        appendFromBlockReceipts( i.first, BlockPolarity::Live, i.second, changeds );
+    noteChangedLocked( changeds );
+}
+
+void Client::filterMatchingLoop() {
+    setThreadName( "filterMatch" );
+    for ( ;; ) {
+        std::pair< h256s, h256s > job;
+        {
+            std::unique_lock< std::mutex > l( x_filterMatch );
+            m_filterMatchSignal.wait(
+                l, [this]() { return m_filterMatchStop || !m_filterMatchQueue.empty(); } );
+            if ( m_filterMatchQueue.empty() )
+                return;  // stopped and drained
+            job = std::move( m_filterMatchQueue.front() );
+            m_filterMatchQueue.pop_front();
+            m_filterMatchBusy = true;
+        }
+        try {
+            matchFilters( job.first, job.second );
+        } catch ( const std::exception& ex ) {
+            cerror << "Log filter matching failed: " << ex.what();
+        } catch ( ... ) {
+            cerror << "Log filter matching failed with unknown exception";
+        }
+        {
+            std::lock_guard< std::mutex > l( x_filterMatch );
+            m_filterMatchBusy = false;
+        }
+        m_filterMatchSignal.notify_all();
+    }
+}
+
+void Client::waitFilterMatching() const {
+    if ( std::this_thread::get_id() == m_filterMatchThread.get_id() )
+        return;
+    std::unique_lock< std::mutex > l( x_filterMatch );
+    m_filterMatchSignal.wait(
+        l, [this]() { return m_filterMatchQueue.empty() && !m_filterMatchBusy; } );
+}
+
+void Client::startFilterMatching() {
+    std::lock_guard< std::mutex > l( x_filterMatch );
+    if ( m_filterMatchThread.joinable() )
+        return;
+    m_filterMatchStop = false;
+    m_filterMatchThread = std::thread( [this]() { filterMatchingLoop(); } );
+}
+
+void Client::stopFilterMatching() {
+    {
+        std::lock_guard< std::mutex > l( x_filterMatch );
+        if ( !m_filterMatchThread.joinable() )
+            return;
+        m_filterMatchStop = true;
+    }
+    m_filterMatchSignal.notify_all();
+    m_filterMatchThread.join();  // queued jobs are finished first
+    m_filterMatchThread = std::thread();
+}
+
+LocalisedLogEntries Client::peekWatch( unsigned _watchId ) const {
+    waitFilterMatching();
+    return ClientBase::peekWatch( _watchId );
+}
+
+LocalisedLogEntries Client::checkWatch( unsigned _watchId ) {
+    waitFilterMatching();
+    return ClientBase::checkWatch( _watchId );
+}
+
 unsigned static const c_syncMin = 1;
 unsigned static const c_syncMax = 1000;
 double static const c_targetDuration = 1;
@@ -583,6 +708,8 @@ size_t Client::importTransactionsAsBlock(
     size_t cntSucceeded = 0;
     cntSucceeded = syncTransactions(
         _transactions, _gasPrice, _timestamp, bIsPartial ? &vecMissing : nullptr );
+    // filestorage writes of the block reach the disk before the block is imported
+    skale::FilePool::instance().sync();
     sealUnconditionally( false );
     importWorkingBlock();
 
@@ -683,7 +810,7 @@ size_t Client::syncTransactions(
     return goodReceipts;
 }
 
-void Client::onDeadBlocks( h256s const& _blocks, h256Hash& io_changed ) {
+void Client::onDeadBlocks( h256s const& _blocks ) {
     // insert transactions that we are declaring the dead part of the chain
     for ( auto const& h : _blocks ) {
         LOG( m_loggerDetail ) << cc::warn( "Dead block: " ) << h;
@@ -695,18 +822,12 @@ void Client::onDeadBlocks( h256s const& _blocks, h256Hash& io_changed ) {
             m_tq.import( t, IfDropped::Retry );
         }
     }
-
-    for ( auto const& h : _blocks )
-        appendFromBlock( h, BlockPolarity::Dead, io_changed );
 }
 
-void Client::onNewBlocks( h256s const& _blocks, h256Hash& io_changed ) {
+void Client::onNewBlocks( h256s const& /*_blocks*/ ) {
     assert( m_skaleHost );
 
     m_skaleHost->noteNewBlocks();
-
-    for ( auto const& h : _blocks )
-        appendFromBlock( h, BlockPolarity::Live, io_changed );
 }
 
 void Client::resyncStateFromChain() {
@@ -770,8 +891,7 @@ void Client::setSchainExitTime( uint64_t _timestamp ) const {
 
 void Client::onChainChanged( ImportRoute const& _ir ) {
     //  ctrace << "onChainChanged()";
-    h256Hash changeds;
-    onDeadBlocks( _ir.deadBlocks, changeds );
+    onDeadBlocks( _ir.deadBlocks );
 
     // this should be already done in SkaleHost::createBlock()
     //    for ( auto const& t : _ir.goodTranactions ) {
@@ -779,10 +899,10 @@ void Client::onChainChanged( ImportRoute const& _ir ) {
     //        m_tq.dropGood( t );
     //    }
 
-    onNewBlocks( _ir.liveBlocks, changeds );
+    onNewBlocks( _ir.liveBlocks );
     if ( !isMajorSyncing() )
         resyncStateFromChain();
-    noteChanged( changeds );
+    queueFilterMatching( _ir.deadBlocks, _ir.liveBlocks );
 }
 
 bool Client::remoteActive() const {
@@ -958,6 +1078,10 @@ void Client::importWorkingBlock() {
 
 void Client::noteChanged( h256Hash const& _filters ) {
     Guard l( x_filtersWatches );
+    noteChangedLocked( _filters );
+}
+
+void Client::noteChangedLocked( h256Hash const& _filters ) {
     if ( _filters.size() )
         LOG( m_loggerWatch ) << cc::notice( "noteChanged: " ) << filtersToString( _filters );
     // accrue all changes left in each filter into the watches.
@@ -1088,10 +1212,16 @@ Block Client::blockByNumber( BlockNumber _h ) const {
 }
 #endif
 
-Block Client::latestBlock() const {
+Block Client::latestBlock( bool _startReadState ) const {
     // TODO Why it returns not-filled block??! (see Block ctor)
     try {
-        DEV_GUARDED( m_blockImportMutex ) { return Block( bc(), bc().currentHash(), m_state ); }
+        DEV_GUARDED( m_blockImportMutex ) {
+            Block ret( bc(), bc().currentHash(), m_state );
+            // under the same lock, so that no import commits a newer state in between
+            if ( _startReadState )
+                ret.startReadState();
+            return ret;
+        }
         assert( false );
         return Block( bc() );
     } catch ( Exception& ex ) {
@@ -1251,10 +1381,12 @@ ExecutionResult Client::call( Address const& _from, u256 _value, Address _dest,
         }
 #endif
 
-        Block temp = latestBlock();
-
-        // TODO there can be race conditions between prev and next line!
-        State readStateForLock = temp.mutableState().createStateReadOnlyCopy();
+        Block temp = latestBlock( true );
+        auto reads = std::make_shared< skale::StateReadSet >();
+        temp.mutableState().recordReads( reads );
+        // address of a created contract depends on the nonce from the queue
+        if ( !_dest )
+            reads->noteUnkeyed();
         u256 nonce = max< u256 >( temp.transactionsFrom( _from ), m_tq.maxNonce( _from ) );
         u256 gas = _gas == Invalid256 ? gasLimitRemaining() : _gas;
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
@@ -1265,6 +1397,7 @@ ExecutionResult Client::call( Address const& _from, u256 _value, Address _dest,
         if ( _ff == FudgeFactor::Lenient )
             temp.mutableState().addBalance( _from, ( u256 )( t.gas() * t.gasPrice() + t.value() ) );
         ret = temp.execute( bc().lastBlockHashes(), t, skale::Permanence::Reverted );
+        ret.stateReads = std::move( reads );
     } catch ( InvalidNonce const& in ) {
         LOG( m_logger ) << "exception in client call(1):"
                         << boost::current_exception_diagnostic_information() << std::endl;
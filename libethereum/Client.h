@@ -26,6 +26,7 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
@@ -127,6 +128,11 @@ public:
     /// Retrieve pending transactions
     Transactions pending() const override;
 
+    /// Watch queries see all blocks imported before the call, even if their filter matching is
+    /// still queued.
+    LocalisedLogEntries peekWatch( unsigned _watchId ) const override;
+    LocalisedLogEntries checkWatch( unsigned _watchId ) override;
+
     /// Queues a block for import.
     ImportResult queueBlock( bytes const& _block, bool _isSafe = false );
 
@@ -244,7 +250,9 @@ public:
     /// Queues a function to be executed in the main thread (that owns the blockchain, etc).
     void executeInMainThread( std::function< void() > const& _function );
 
-    Block latestBlock() const;
+    /// Latest block of the chain. With @a _startReadState its state is opened for reading too,
+    /// and stays the state of this block even if another one is imported meanwhile.
+    Block latestBlock( bool _startReadState = false ) const;
 
     /// should be called after the constructor of the most derived class finishes.
     void startWorking() {
@@ -364,13 +372,27 @@ protected:
     void appendFromNewPending(
         TransactionReceipt const& _receipt, h256Hash& io_changed, h256 _sha3 );
 
-    /// Collate the changed filters for the hash of the given block.
-    /// Insert any filters that are activated into @a o_changed.
-    void appendFromBlock( h256 const& _blockHash, BlockPolarity _polarity, h256Hash& io_changed );
+    /// Collate the changed filters for the given block from its receipts, loaded only if its
+    /// bloom may match, with x_filtersWatches held. Insert activated filters into @a io_changed.
+    void appendFromBlockReceipts( h256 const& _blockHash, BlockPolarity _polarity,
+        TransactionReceipts const& _receipts, h256Hash& io_changed );
 
     /// Record that the set of filters @a _filters have changed.
     /// This doesn't actually make any callbacks, but increments some counters in m_watches.
     void noteChanged( h256Hash const& _filters );
+    /// As noteChanged() but with x_filtersWatches held.
+    void noteChangedLocked( h256Hash const& _filters );
+
+    /// Queues matching of live log filters against imported and dead blocks.
+    void queueFilterMatching( h256s const& _deadBlocks, h256s const& _liveBlocks );
+    /// Body of m_filterMatchThread.
+    void filterMatchingLoop();
+    /// Matches one queued chain change against live filters and notes changes.
+    void matchFilters( h256s const& _deadBlocks, h256s const& _liveBlocks );
+    /// Waits until queued filter matching is done, does nothing on m_filterMatchThread itself.
+    void waitFilterMatching() const;
+    void startFilterMatching();
+    void stopFilterMatching();
 
     /// Submit
     virtual bool submitSealed( bytes const& _s );
@@ -395,10 +417,10 @@ protected:
     void rejigSealing();
 
     /// Called on chain changes
-    void onDeadBlocks( h256s const& _blocks, h256Hash& io_changed );
+    void onDeadBlocks( h256s const& _blocks );
 
     /// Called on chain changes
-    virtual void onNewBlocks( h256s const& _blocks, h256Hash& io_changed );
+    virtual void onNewBlocks( h256s const& _blocks );
 
     /// Called after processing blocks by onChainChanged(_ir)
     void resyncStateFromChain();
@@ -487,6 +509,15 @@ protected:
     std::condition_variable m_signalled;
     Mutex x_signalled;
 
+    /// Log filters are matched against new blocks on this thread, so block import does not wait
+    /// for them.
+    std::thread m_filterMatchThread;
+    mutable std::mutex x_filterMatch;
+    mutable std::condition_variable m_filterMatchSignal;
+    std::deque< std::pair< h256s, h256s > > m_filterMatchQueue;  ///< (dead, live) block hashes
+    bool m_filterMatchBusy = false;
+    bool m_filterMatchStop = false;
+
     Handler<> m_tqReady;
     Handler< h256 const& > m_tqReplaced;
     Handler<> m_bqReady;
@@ -25,11 +25,15 @@
 #include "ClientBase.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "BlockChain.h"
 #include "Executive.h"
 
+#include <libdevcore/WorkerPool.h>
+#include <libevm/ExecutionBudget.h>
+
 using namespace std;
 using std::make_pair;
 using std::pair;
@@ -41,6 +45,31 @@ using skale::State;
 
 static const int64_t c_maxGasEstimate = 50000000;
 
+namespace {
+
+/// Threads shared by all estimations for trying gas limits at once.
+struct EstimateGasPool {
+    Mutex x_pool;
+    std::shared_ptr< WorkerPool > pool =
+        std::make_shared< WorkerPool >( ClientBase::c_defaultEstimateGasThreads );
+    std::atomic< unsigned > probes{ ClientBase::c_defaultEstimateGasProbes };
+
+    static EstimateGasPool& instance() {
+        static EstimateGasPool s_pool;
+        return s_pool;
+    }
+};
+
+}  // namespace
+
+void ClientBase::setEstimateGasConcurrency( unsigned _probesPerRequest, unsigned _threads ) {
+    EstimateGasPool& estimate = EstimateGasPool::instance();
+    estimate.probes = std::max( _probesPerRequest, 1u );
+    auto pool = std::make_shared< WorkerPool >( _threads );
+    DEV_GUARDED( estimate.x_pool )
+    estimate.pool.swap( pool );
+}
+
 ClientWatch::ClientWatch() : lastPoll( std::chrono::system_clock::now() ) {}
 
 ClientWatch::ClientWatch(
@@ -78,21 +107,22 @@ void ClientWatch::append_changes( const LocalisedLogEntry& entry ) {
         fnOnNewChanges_( iw_ );
 }
 
-std::pair< bool, ExecutionResult > ClientBase::estimateGasStep( int64_t _gas, Block& _latestBlock,
-    Address const& _from, Address const& _destination, u256 const& _value, u256 const& _gasPrice,
-    bytes const& _data ) {
-    u256 nonce = _latestBlock.transactionsFrom( _from );
+std::pair< bool, ExecutionResult > ClientBase::estimateGasStep( int64_t _gas,
+    Block const& _latestBlock, u256 const& _nonce, Address const& _from,
+    Address const& _destination, u256 const& _value, u256 const& _gasPrice, bytes const& _data ) {
     Transaction t;
     if ( _destination )
-        t = Transaction( _value, _gasPrice, _gas, _destination, _data, nonce );
+        t = Transaction( _value, _gasPrice, _gas, _destination, _data, _nonce );
     else
-        t = Transaction( _value, _gasPrice, _gas, _data, nonce );
+        t = Transaction( _value, _gasPrice, _gas, _data, _nonce );
     t.forceSender( _from );
     t.forceChainId( chainId() );
     t.checkOutExternalGas( ~u256( 0 ) );
     EnvInfo const env( _latestBlock.info(), bc().lastBlockHashes(), 0, _gas );
     // Make a copy of state!! It will be deleted after step!
-    State tempState = _latestBlock.mutableState();
+    // Steps run in parallel, so the block is only read. Its state is an overlay, copies share what
+    // the other steps have read.
+    State tempState = _latestBlock.state();
     tempState.addBalance( _from, ( u256 )( t.gas() * t.gasPrice() + t.value() ) );
     ExecutionResult executionResult =
         tempState.execute( env, *bc().sealEngine(), t, Permanence::Reverted ).first;
@@ -121,40 +151,94 @@ std::pair< u256, ExecutionResult > ClientBase::estimateGas( Address const& _from
             upperBound = bk.info().gasLimit().convert_to< int64_t >();
         }
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
+        u256 const nonce = bk.transactionsFrom( _from );
+
+        // probes running in the pool spend the budget of the request
+        ExecutionBudget* const budget = ExecutionBudget::current();
+        auto step = [&]( int64_t _gas ) {
+            ExecutionBudget::Scope scope( budget );
+            return estimateGasStep( _gas, bk, nonce, _from, _dest, _value, gasPrice, _data );
+        };
 
         // We execute transaction with maximum gas limit
         // to calculate how many of gas will be used.
         // Then we execute transaction with this gas limit
         // and check if it will be enough.
-        // If not run binary search to find optimal gas limit.
-
-        auto estimatedStep =
-            estimateGasStep( upperBound, bk, _from, _dest, _value, gasPrice, _data );
-        if ( estimatedStep.first ) {
-            auto executionResult = estimatedStep.second;
-            auto gasUsed = executionResult.gasUsed.convert_to< int64_t >();
-
-            estimatedStep = estimateGasStep( gasUsed, bk, _from, _dest, _value, gasPrice, _data );
-            if ( estimatedStep.first ) {
-                return make_pair( gasUsed, executionResult );
+        auto estimatedStep = step( upperBound );
+        if ( !estimatedStep.first )
+            return make_pair( upperBound, estimatedStep.second );
+        ExecutionResult upperResult = estimatedStep.second;
+        auto gasUsed = upperResult.gasUsed.convert_to< int64_t >();
+        if ( step( gasUsed ).first )
+            return make_pair( gasUsed, upperResult );
+
+        // The search assumes that more gas never makes execution fail, so the answer is the
+        // least passing limit above a failing one. Instead of bisecting all of
+        // (lowerBound, upperBound] try limits derived from the execution first: gas used before
+        // the refund, and that plus the stipend with 1/64 of gas kept by each call. A passing
+        // candidate whose predecessor fails is the answer, otherwise bisection goes on from the
+        // narrowed bounds.
+        lowerBound = std::max( lowerBound, gasUsed );
+        int64_t const peak = gasUsed + upperResult.gasRefunded.convert_to< int64_t >();
+        int64_t const withCalls = ( peak + EVMSchedule().callStipend ) * 64 / 63 + 1;
+        for ( int64_t candidate : { peak, withCalls } ) {
+            if ( candidate <= lowerBound || candidate >= upperBound )
+                continue;
+            estimatedStep = step( candidate );
+            if ( !estimatedStep.first ) {
+                lowerBound = candidate;
+                continue;
             }
-            while ( lowerBound + 1 < upperBound ) {
-                int64_t middle = ( lowerBound + upperBound ) / 2;
-                estimatedStep =
-                    estimateGasStep( middle, bk, _from, _dest, _value, gasPrice, _data );
+            upperBound = candidate;
+            upperResult = estimatedStep.second;
+            if ( candidate - 1 > lowerBound ) {
+                estimatedStep = step( candidate - 1 );
                 if ( estimatedStep.first ) {
-                    upperBound = middle;
-                } else {
-                    lowerBound = middle;
-                }
-                if ( _callback ) {
-                    _callback( GasEstimationProgress{ lowerBound, upperBound } );
-                }
+                    upperBound = candidate - 1;
+                    upperResult = estimatedStep.second;
+                } else
+                    lowerBound = candidate - 1;
             }
+            break;
         }
 
-        return make_pair( upperBound,
-            estimateGasStep( upperBound, bk, _from, _dest, _value, gasPrice, _data ).second );
+        // k-ary search: k limits splitting the bounds evenly are tried at once, the pool caps
+        // threads of all estimations and the caller runs what the pool does not take. With k = 1
+        // this is bisection.
+        EstimateGasPool& estimate = EstimateGasPool::instance();
+        unsigned const probes = estimate.probes;
+        std::shared_ptr< WorkerPool > pool;
+        DEV_GUARDED( estimate.x_pool )
+        pool = estimate.pool;
+        std::vector< int64_t > limits;
+        std::vector< std::pair< bool, ExecutionResult > > results;
+        while ( lowerBound + 1 < upperBound ) {
+            int64_t const span = upperBound - lowerBound;
+            size_t const count = size_t( std::min< int64_t >( probes, span - 1 ) );
+            limits.resize( count );
+            for ( size_t i = 0; i < count; ++i )
+                limits[i] = lowerBound + span * int64_t( i + 1 ) / int64_t( count + 1 );
+            results.assign( count, {} );
+            pool->parallelFor(
+                count, [&]( size_t _i ) { results[_i] = step( limits[_i] ); }, probes - 1 );
+
+            size_t passed = 0;
+            while ( passed < count && !results[passed].first )
+                ++passed;
+            if ( passed < count ) {
+                upperBound = limits[passed];
+                upperResult = std::move( results[passed].second );
+            }
+            if ( passed > 0 )
+                lowerBound = limits[passed - 1];
+            if ( _callback ) {
+                _callback( GasEstimationProgress{ lowerBound, upperBound } );
+            }
+        }
+
+        return make_pair( upperBound, upperResult );
+    } catch ( ExecutionBudgetExceeded const& ) {
+        throw;
     } catch ( ... ) {
         // TODO: Some sort of notification of failure.
         return make_pair( u256(), ExecutionResult() );
@@ -201,25 +285,39 @@ LocalisedLogEntries ClientBase::logs( unsigned _watchId ) const {
     return logs( f );
 }
 
-LocalisedLogEntries ClientBase::logs( LogFilter const& _f ) const {
+LocalisedLogEntries ClientBase::pendingLogs( LogFilter const& _f ) const {
     LocalisedLogEntries ret;
+    if ( ( unsigned ) _f.latest() <= bc().number() )
+        return ret;
+    Block temp = postSeal();
+    for ( unsigned i = 0; i < temp.pending().size(); ++i ) {
+        // Might have a transaction that contains a matching log.
+        TransactionReceipt const& tr = temp.receipt( i );
+        LogEntries le = _f.matches( tr );
+        for ( unsigned j = 0; j < le.size(); ++j )
+            ret.push_back( LocalisedLogEntry( le[j] ) );
+    }
+    return ret;
+}
+
+LocalisedLogEntries ClientBase::logs( LogFilter const& _f ) const {
     unsigned begin = min( bc().number() + 1, ( unsigned ) _f.latest() );
     unsigned end = min( bc().number(), min( begin, ( unsigned ) _f.earliest() ) );
 
     // Handle pending transactions differently as they're not on the block chain.
-    if ( begin > bc().number() ) {
-        Block temp = postSeal();
-        for ( unsigned i = 0; i < temp.pending().size(); ++i ) {
-            // Might have a transaction that contains a matching log.
-            TransactionReceipt const& tr = temp.receipt( i );
-            LogEntries le = _f.matches( tr );
-            for ( unsigned j = 0; j < le.size(); ++j )
-                ret.insert( ret.begin(), LocalisedLogEntry( le[j] ) );
-        }
+    LocalisedLogEntries ret = pendingLogs( _f );
+    if ( begin > bc().number() )
         begin = bc().number();
-    }
 
     // Handle blocks from main chain
+    LogIndex const* index = bc().logIndex();
+    if ( index && index->covers( end, begin ) ) {
+        appendLogsAt( _f,
+            index->candidates( _f, LogPosition( end ), begin, numeric_limits< size_t >::max() ),
+            ret );
+        return ret;
+    }
+
     set< unsigned > matchingBlocks;
     if ( !_f.isRangeFilter() )
         for ( auto const& i : _f.bloomPossibilities() ) {
@@ -232,54 +330,148 @@ LocalisedLogEntries ClientBase::logs( LogFilter const& _f ) const {
             matchingBlocks.insert( i );
 
     for ( auto n : matchingBlocks )
-        prependLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, ret );
+        appendLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, ret );
 
-    reverse( ret.begin(), ret.end() );
     return ret;
 }
 
-void ClientBase::prependLogsFromBlock( LogFilter const& _f, h256 const& _blockHash,
+LocalisedLogEntries ClientBase::logs(
+    LogFilter const& _f, std::string& io_cursor, size_t _limit ) const {
+    LocalisedLogEntries ret;
+    if ( _limit == 0 )
+        BOOST_THROW_EXCEPTION( std::invalid_argument( "limit must be positive" ) );
+    // a huge page would be as unbounded as the answer without pagination
+    _limit = min< size_t >( _limit, bc().chainParams().nodeInfo.logsPageLimit );
+
+    // pending logs have no stable position, so pages always end at the last block
+    unsigned begin = min( bc().number(), ( unsigned ) _f.latest() );
+    unsigned end = min( begin, ( unsigned ) _f.earliest() );
+    LogPosition start( end );
+    if ( !io_cursor.empty() ) {
+        LogPosition const pos = LogPosition::fromCursor( io_cursor );
+        if ( start < pos )
+            start = pos;
+    }
+    io_cursor.clear();
+    if ( start.blockNumber > begin )
+        return ret;
+
+    LogIndex const* index = bc().logIndex();
+    if ( index && index->covers( start.blockNumber, begin ) ) {
+        // candidates are a superset of matching logs, so ask until the page is full
+        for ( ;; ) {
+            size_t const want = _limit - ret.size();
+            vector< LogPosition > positions = index->candidates( _f, start, begin, want + 1 );
+            bool const more = positions.size() > want;
+            if ( more ) {
+                start = positions.back();
+                positions.pop_back();
+            }
+            appendLogsAt( _f, positions, ret );
+            if ( !more )
+                break;
+            if ( ret.size() == _limit ) {
+                io_cursor = start.toCursor();
+                break;
+            }
+        }
+        return ret;
+    }
+
+    // without index scan block by block, stopping once the page is full
+    set< unsigned > matchingBlocks;
+    if ( !_f.isRangeFilter() )
+        for ( auto const& i : _f.bloomPossibilities() ) {
+            std::vector< unsigned > matchingBlocksVector =
+                bc().withBlockBloom( i, unsigned( start.blockNumber ), begin );
+            matchingBlocks.insert( matchingBlocksVector.begin(), matchingBlocksVector.end() );
+        }
+    else
+        for ( unsigned i = unsigned( start.blockNumber ); i <= begin; i++ )
+            matchingBlocks.insert( i );
+
+    for ( auto n : matchingBlocks ) {
+        LocalisedLogEntries blockLogs;
+        appendLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, blockLogs );
+        for ( LocalisedLogEntry& e : blockLogs ) {
+            LogPosition const pos( n, e.transactionIndex, e.logIndex );
+            if ( pos < start )
+                continue;
+            if ( ret.size() == _limit ) {
+                io_cursor = pos.toCursor();
+                return ret;
+            }
+            ret.push_back( std::move( e ) );
+        }
+    }
+    return ret;
+}
+
+void ClientBase::appendLogsFromBlock( LogFilter const& _f, h256 const& _blockHash,
     BlockPolarity _polarity, LocalisedLogEntries& io_logs ) const {
     auto receipts = bc().receipts( _blockHash ).receipts;
+    BlockNumber const number = ( BlockNumber ) bc().number( _blockHash );
+    bytes const block = bc().block( _blockHash );
+    RLP const transactions = RLP( block )[1];
     unsigned logIndex = 0;
     for ( size_t i = 0; i < receipts.size(); i++ ) {
-        TransactionReceipt receipt = receipts[i];
-        auto th = transaction( _blockHash, i ).sha3();
-        if ( _f.isRangeFilter() ) {
-            for ( const auto& e : receipt.log() ) {
-                io_logs.insert( io_logs.begin(),
-                    LocalisedLogEntry( e, _blockHash, ( BlockNumber ) bc().number( _blockHash ), th,
-                        i, logIndex++, _polarity ) );
-            }
+        TransactionReceipt const& receipt = receipts[i];
+        if ( !_f.isRangeFilter() && !_f.matches( receipt.bloom() ) ) {
+            logIndex += receipt.log().size();
             continue;
         }
+        h256 th;
+        for ( const auto& e : receipt.log() ) {
+            if ( _f.isRangeFilter() || _f.matches( e ) ) {
+                if ( !th && i < transactions.itemCount() )
+                    // allow invalid
+                    th = Transaction( transactions[i].data(), CheckTransaction::Cheap, true )
+                             .sha3();
+                io_logs.push_back(
+                    LocalisedLogEntry( e, _blockHash, number, th, i, logIndex, _polarity ) );
+            }
+            ++logIndex;
+        }
+    }
+}
 
-        if ( _f.matches( receipt.bloom() ) )
-            for ( const auto& e : receipt.log() ) {
-                auto addresses = _f.getAddresses();
-                if ( addresses.empty() || std::find( addresses.begin(), addresses.end(),
-                                              e.address ) != addresses.end() ) {
-                    bool isGood = true;
-                    for ( unsigned j = 0; j < 4; ++j ) {
-                        auto topics = _f.getTopics()[j];
-                        if ( !topics.empty() &&
-                             ( e.topics.size() < j || ( std::find( topics.begin(), topics.end(),
-                                                            e.topics[j] ) == topics.end() ) ) ) {
-                            isGood = false;
-                        }
-                    }
-                    if ( isGood )
-                        io_logs.insert(
-                            io_logs.begin(), LocalisedLogEntry( e, _blockHash,
-                                                 ( BlockNumber ) bc().number( _blockHash ), th, i,
-                                                 logIndex++, _polarity ) );
-                    else
-                        ++logIndex;
-                } else
-                    ++logIndex;
+void ClientBase::appendLogsAt( LogFilter const& _f, std::vector< LogPosition > const& _positions,
+    LocalisedLogEntries& io_logs ) const {
+    // positions are sorted, so every block is loaded once
+    for ( auto it = _positions.begin(); it != _positions.end(); ) {
+        uint64_t const n = it->blockNumber;
+        h256 const blockHash = bc().numberHash( unsigned( n ) );
+        auto const receipts = bc().receipts( blockHash ).receipts;
+        bytes const block = bc().block( blockHash );
+        RLP const transactions = RLP( block )[1];
+        vector< unsigned > firstLogOfReceipt( receipts.size() );
+        unsigned logCount = 0;
+        for ( size_t i = 0; i < receipts.size(); ++i ) {
+            firstLogOfReceipt[i] = logCount;
+            logCount += receipts[i].log().size();
+        }
+        h256 th;
+        unsigned thIndex = unsigned( -1 );
+        for ( ; it != _positions.end() && it->blockNumber == n; ++it ) {
+            unsigned const i = it->transactionIndex;
+            // block may be rotated out of the DB, then its receipts are empty
+            if ( i >= receipts.size() || it->logIndex < firstLogOfReceipt[i] ||
+                 it->logIndex - firstLogOfReceipt[i] >= receipts[i].log().size() )
+                continue;
+            LogEntry const& e = receipts[i].log()[it->logIndex - firstLogOfReceipt[i]];
+            if ( !_f.matches( e ) )
+                continue;
+            if ( thIndex != i ) {
+                thIndex = i;
+                // allow invalid
+                th = i < transactions.itemCount() ?
+                         Transaction( transactions[i].data(), CheckTransaction::Cheap, true )
+                             .sha3() :
+                         h256();
             }
-        else
-            logIndex += receipt.log().size();
+            io_logs.push_back( LocalisedLogEntry( e, blockHash, ( BlockNumber ) n, th, i,
+                it->logIndex, BlockPolarity::Live ) );
+        }
     }
 }
 
@@ -291,6 +483,7 @@ unsigned ClientBase::installWatch(
         if ( !m_filters.count( h ) ) {
             LOG( m_loggerWatch ) << "FFF" << _f << h;
             m_filters.insert( make_pair( h, _f ) );
+            m_filterIndex.insert( h, _f );
         }
     }
     return installWatch( h, _r, fnOnNewChanges, isWS );
@@ -332,6 +525,7 @@ bool ClientBase::uninstallWatch( unsigned _i ) {
     if ( fit != m_filters.end() )
         if ( !--fit->second.refCount ) {
             LOG( m_loggerWatch ) << "*X*" << fit->first << ":" << fit->second.filter;
+            m_filterIndex.erase( fit->first, fit->second.filter );
             m_filters.erase( fit );
         }
     return true;
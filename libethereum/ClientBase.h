@@ -28,6 +28,8 @@
 #include "CommonNet.h"
 #include "Interface.h"
 #include "LogFilter.h"
+#include "LogFilterIndex.h"
+#include "LogIndex.h"
 #include "TransactionQueue.h"
 #include <chrono>
 
@@ -94,6 +96,14 @@ public:
         Address _dest, bytes const& _data, int64_t _maxGas, u256 _gasPrice,
         GasEstimationCallback const& _callback ) override;
 
+    static constexpr unsigned c_defaultEstimateGasProbes = 4;
+    static constexpr unsigned c_defaultEstimateGasThreads = 2;
+
+    /// Sets how many gas limits one estimation tries at once when it has to search, 1 for
+    /// bisection, and the number of threads shared by all estimations for that. Estimations
+    /// never wait for threads: probes the pool does not take run on the calling thread.
+    static void setEstimateGasConcurrency( unsigned _probesPerRequest, unsigned _threads );
+
     u256 balanceAt( Address _a ) const override;
     u256 countAt( Address _a ) const override;
     u256 stateAt( Address _a, u256 _l ) const override;
@@ -103,8 +113,14 @@ public:
 
     LocalisedLogEntries logs( unsigned _watchId ) const override;
     LocalisedLogEntries logs( LogFilter const& _filter ) const override;
-    virtual void prependLogsFromBlock( LogFilter const& _filter, h256 const& _blockHash,
+    LocalisedLogEntries logs(
+        LogFilter const& _filter, std::string& io_cursor, size_t _limit ) const override;
+    LocalisedLogEntries pendingLogs( LogFilter const& _filter ) const override;
+    virtual void appendLogsFromBlock( LogFilter const& _filter, h256 const& _blockHash,
         BlockPolarity _polarity, LocalisedLogEntries& io_logs ) const;
+    /// Appends logs at @a _positions (sorted) that match @a _filter.
+    void appendLogsAt( LogFilter const& _filter, std::vector< LogPosition > const& _positions,
+        LocalisedLogEntries& io_logs ) const;
 
     /// Install, uninstall and query watches.
     unsigned installWatch( LogFilter const& _filter, Reaping _r = Reaping::Automatic,
@@ -206,6 +222,7 @@ protected:
     mutable Mutex x_filtersWatches;                         ///< Our lock.
     std::unordered_map< h256, InstalledFilter > m_filters;  ///< The dictionary of filters that are
                                                             ///< active.
+    LogFilterIndex m_filterIndex;  ///< m_filters by address and topic 0, guarded by x_filtersWatches
     std::unordered_map< h256, h256s > m_specialFilters =
         std::unordered_map< h256, std::vector< h256 > >{ { PendingChangedFilter, {} },
             { ChainChangedFilter, {} } };
@@ -216,9 +233,9 @@ protected:
     Logger m_loggerWatch{ createLogger( VerbosityDebug, "watch" ) };
 
 private:
-    std::pair< bool, ExecutionResult > estimateGasStep( int64_t _gas, Block& _latestBlock,
-        Address const& _from, Address const& _destination, u256 const& _value,
-        u256 const& _gasPrice, bytes const& _data );
+    std::pair< bool, ExecutionResult > estimateGasStep( int64_t _gas, Block const& _latestBlock,
+        u256 const& _nonce, Address const& _from, Address const& _destination,
+        u256 const& _value, u256 const& _gasPrice, bytes const& _data );
 };
 
 }  // namespace eth
@@ -24,51 +24,215 @@
 
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
-#include <map>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace dev {
 namespace eth {
 
 /**
- * @brief Simple thread-safe cache to store a mapping from code hash to code size.
- * If the cache is full, a random element is removed.
+ * @brief Thread-safe cache of contract code and code size keyed by code hash.
+ * Code is immutable for a given hash, so entries never need invalidation.
+ * The cache is split into shards by hash to keep threads from contending on one lock. Lookups
+ * take a shard's lock in shared mode and only mark the entry as recently used, eviction uses
+ * the CLOCK algorithm within a shard. Bounded by number of entries and by memory used for code.
  */
 class CodeSizeCache {
 public:
-    void store( h256 const& _hash, size_t size ) {
-        UniqueGuard g( x_cache );
-        if ( m_cache.size() >= c_maxSize )
-            removeRandomElement();
-        m_cache[_hash] = size;
+    static const size_t c_shards = 16;
+    static const size_t c_maxSize = 50000;
+    static const size_t c_maxCodeMemory = 64 * 1024 * 1024;
+
+    CodeSizeCache( size_t _maxSize = c_maxSize, size_t _maxCodeMemory = c_maxCodeMemory ) {
+        for ( auto& shard : m_shards )
+            shard.reset( new Shard( ( _maxSize + c_shards - 1 ) / c_shards,
+                ( _maxCodeMemory + c_shards - 1 ) / c_shards ) );
+    }
+    CodeSizeCache( CodeSizeCache const& ) = delete;
+    CodeSizeCache& operator=( CodeSizeCache const& ) = delete;
+
+    void store( h256 const& _hash, size_t size ) { shard( _hash ).store( _hash, size, nullptr ); }
+    /// Stores @a _code together with its size.
+    void storeCode( h256 const& _hash, bytes const& _code ) {
+        shard( _hash ).store( _hash, _code.size(), std::make_shared< bytes const >( _code ) );
+    }
+    /// Same, but shares @a _code instead of copying it.
+    void storeCode( h256 const& _hash, std::shared_ptr< bytes const > _code ) {
+        size_t const size = _code->size();
+        shard( _hash ).store( _hash, size, std::move( _code ) );
     }
+
     bool contains( h256 const& _hash ) const {
-        UniqueGuard g( x_cache );
-        return m_cache.count( _hash );
+        size_t size;
+        return shard( _hash ).get( _hash, size, nullptr );
+    }
+    /// @returns false if the size of @a _hash is not cached.
+    bool get( h256 const& _hash, size_t& o_size ) const {
+        return count( shard( _hash ).get( _hash, o_size, nullptr ) );
     }
-    size_t get( h256 const& _hash ) const {
-        UniqueGuard g( x_cache );
-        return m_cache.at( _hash );
+    /// @returns cached code, or nullptr if only the size or nothing is cached for @a _hash.
+    std::shared_ptr< bytes const > code( h256 const& _hash ) const {
+        std::shared_ptr< bytes const > ret;
+        size_t size;
+        shard( _hash ).get( _hash, size, &ret );
+        count( ret != nullptr );
+        return ret;
     }
 
+    size_t size() const {
+        size_t ret = 0;
+        for ( auto const& shard : m_shards )
+            ret += shard->size();
+        return ret;
+    }
+    size_t codeMemory() const {
+        size_t ret = 0;
+        for ( auto const& shard : m_shards )
+            ret += shard->codeMemory();
+        return ret;
+    }
+    uint64_t hits() const { return m_hits.load( std::memory_order_relaxed ); }
+    uint64_t misses() const { return m_misses.load( std::memory_order_relaxed ); }
+
     static CodeSizeCache& instance() {
         static CodeSizeCache cache;
         return cache;
     }
 
 private:
-    /// Removes a random element from the cache.
-    void removeRandomElement() {
-        if ( !m_cache.empty() ) {
-            auto it = m_cache.lower_bound( h256::random() );
-            if ( it == m_cache.end() )
-                it = m_cache.begin();
-            m_cache.erase( it );
+    struct Slot {
+        h256 hash;
+        size_t size = 0;
+        std::shared_ptr< bytes const > code;
+        mutable std::atomic< bool > referenced{ false };
+    };
+
+    class Shard {
+    public:
+        Shard( size_t _maxSize, size_t _maxCodeMemory )
+            : m_slots( std::max< size_t >( _maxSize, 1 ) ), m_maxCodeMemory( _maxCodeMemory ) {
+            m_index.reserve( m_slots.size() );
+        }
+
+        bool get( h256 const& _hash, size_t& o_size, std::shared_ptr< bytes const >* o_code ) const {
+            ReadGuard l( x_shard );
+            auto it = m_index.find( _hash );
+            if ( it == m_index.end() )
+                return false;
+            Slot const& slot = m_slots[it->second];
+            // relaxed store under shared lock, CLOCK tolerates a lost update
+            if ( !slot.referenced.load( std::memory_order_relaxed ) )
+                slot.referenced.store( true, std::memory_order_relaxed );
+            o_size = slot.size;
+            if ( o_code )
+                *o_code = slot.code;
+            return true;
+        }
+
+        void store( h256 const& _hash, size_t _size, std::shared_ptr< bytes const > _code ) {
+            size_t const codeSize = _code ? _code->size() : 0;
+            if ( codeSize > m_maxCodeMemory )
+                _code.reset();
+            WriteGuard l( x_shard );
+            auto it = m_index.find( _hash );
+            if ( it != m_index.end() ) {
+                Slot& slot = m_slots[it->second];
+                slot.size = _size;
+                if ( _code && !slot.code ) {
+                    slot.code = std::move( _code );
+                    m_codeMemory += codeSize;
+                    evictCode( it->second );
+                }
+                return;
+            }
+
+            size_t index;
+            if ( m_used < m_slots.size() )
+                index = m_used++;
+            else
+                index = evictOne();
+            Slot& slot = m_slots[index];
+            slot.hash = _hash;
+            slot.size = _size;
+            slot.code = std::move( _code );
+            slot.referenced.store( false, std::memory_order_relaxed );
+            m_codeMemory += slot.code ? codeSize : 0;
+            m_index.emplace( _hash, index );
+            evictCode( index );
+        }
+
+        size_t size() const {
+            ReadGuard l( x_shard );
+            return m_index.size();
         }
+        size_t codeMemory() const {
+            ReadGuard l( x_shard );
+            return m_codeMemory;
+        }
+
+    private:
+        /// Advances the clock hand past recently used slots, frees and @returns the next slot.
+        size_t evictOne() {
+            for ( ;; ) {
+                Slot& slot = m_slots[m_hand];
+                size_t const index = m_hand;
+                m_hand = ( m_hand + 1 ) % m_used;
+                if ( slot.referenced.load( std::memory_order_relaxed ) )
+                    slot.referenced.store( false, std::memory_order_relaxed );
+                else {
+                    m_index.erase( slot.hash );
+                    dropCode( slot );
+                    return index;
+                }
+            }
+        }
+
+        /// Drops code of other slots in clock order until code fits into memory limit.
+        void evictCode( size_t _keep ) {
+            while ( m_codeMemory > m_maxCodeMemory ) {
+                Slot& slot = m_slots[m_hand];
+                size_t const index = m_hand;
+                m_hand = ( m_hand + 1 ) % m_used;
+                if ( index == _keep || !slot.code )
+                    continue;
+                if ( slot.referenced.load( std::memory_order_relaxed ) )
+                    slot.referenced.store( false, std::memory_order_relaxed );
+                else
+                    dropCode( slot );
+            }
+        }
+
+        void dropCode( Slot& _slot ) {
+            if ( _slot.code )
+                m_codeMemory -= _slot.code->size();
+            _slot.code.reset();
+        }
+
+        mutable SharedMutex x_shard;
+        std::vector< Slot > m_slots;
+        std::unordered_map< h256, size_t > m_index;
+        size_t m_used = 0;
+        size_t m_hand = 0;
+        size_t m_codeMemory = 0;
+        size_t const m_maxCodeMemory;
+    };
+
+    /// Code hashes are uniformly distributed, any byte selects a shard.
+    Shard& shard( h256 const& _hash ) const { return *m_shards[_hash[31] % c_shards]; }
+
+    bool count( bool _hit ) const {
+        ( _hit ? m_hits : m_misses ).fetch_add( 1, std::memory_order_relaxed );
+        return _hit;
     }
 
-    static const size_t c_maxSize = 50000;
-    mutable Mutex x_cache;
-    std::map< h256, size_t > m_cache;
+    std::array< std::unique_ptr< Shard >, c_shards > m_shards;
+    mutable std::atomic< uint64_t > m_hits{ 0 };
+    mutable std::atomic< uint64_t > m_misses{ 0 };
 };
 
 }  // namespace eth
@@ -27,6 +27,7 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/microprofile.h>
 #include <libethcore/CommonJS.h>
+#include <libevm/ExecutionBudget.h>
 #include <libevm/LegacyVM.h>
 #include <libevm/VMFactory.h>
 
@@ -323,15 +324,16 @@ bool Executive::call( CallParameters const& _p, u256 const& _gasPrice, Address c
                           // go().
         } else {
             m_gas = ( u256 )( _p.gas - g );
-            bytes output;
+            SharedBytes output;
             bool success;
             // dev::eth::g_state = m_s.delegateWrite();
             dev::eth::g_overlayFS = m_s.fs();
-            tie( success, output ) =
-                m_sealEngine.executePrecompiled( _p.codeAddress, _p.data, m_envInfo.number() );
+            if ( !m_sealEngine.precompiledIsPure( _p.codeAddress ) )
+                m_s.noteUnkeyedRead();
+            tie( success, output ) = m_sealEngine.executePrecompiledCached(
+                _p.codeAddress, _p.data, m_envInfo.number() );
             // m_s = dev::eth::g_state.delegateWrite();
-            size_t outputSize = output.size();
-            m_output = owning_bytes_ref{ std::move( output ), 0, outputSize };
+            m_output = owning_bytes_ref{ std::move( output ) };
             if ( !success ) {
                 m_gas = 0;
                 m_excepted = TransactionException::OutOfGas;
@@ -342,13 +344,14 @@ bool Executive::call( CallParameters const& _p, u256 const& _gasPrice, Address c
         m_gas = _p.gas;
         if ( m_s.addressHasCode( _p.codeAddress ) ) {
             MICROPROFILE_SCOPEI( "Executive", "call create ExtVM", MP_DARKTURQUOISE );
-            bytes const& c = m_s.code( _p.codeAddress );
+            // code is shared with the state, not copied for each call
+            SharedBytes c( m_s.sharedCode( _p.codeAddress ) );
             h256 codeHash = m_s.codeHash( _p.codeAddress );
             // Contract will be executed with the version stored in account
             auto const version = m_s.version( _p.codeAddress );
             m_ext = make_shared< ExtVM >( m_s, m_envInfo, m_sealEngine, _p.receiveAddress,
-                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash,
-                version, m_depth, false, _p.staticCall, m_readOnly );
+                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, std::move( c ),
+                codeHash, version, m_depth, false, _p.staticCall, m_readOnly );
         }
     }
 
@@ -460,6 +463,10 @@ bool Executive::go( OnOpFunc const& _onOp ) {
         Timer t;
 #endif
         try {
+            // checked on every frame, so VMs that do not charge instructions are limited in time
+            if ( auto* budget = ExecutionBudget::current() )
+                budget->charge( 0 );
+
             // Create VM instance. Force Interpreter if tracing requested.
             auto vm = VMFactory::create();
             if ( m_isCreation ) {
@@ -514,6 +521,10 @@ bool Executive::go( OnOpFunc const& _onOp ) {
                   << diagnostic_information( _e );
             revert();
             throw;
+        } catch ( ExecutionBudgetExceeded const& ) {
+            // the RPC call is aborted as a whole
+            revert();
+            throw;
         } catch ( Exception const& _e ) {
             // TODO: AUDIT: check that this can never reasonably happen. Consider what to do if it
             // does.
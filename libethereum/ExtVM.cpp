@@ -25,7 +25,8 @@
 
 #include <exception>
 
-#include <boost/thread.hpp>
+#include <libdevcore/DeepStackPool.h>
+#include <libevm/ExecutionBudget.h>
 
 #include "LastBlockHashesFace.h"
 
@@ -59,27 +60,15 @@ static unsigned const c_offloadPoint =
     ( c_defaultStackSize - c_entryOverhead ) / c_singleExecutionStackSize;
 
 void goOnOffloadedStack( Executive& _e, OnOpFunc const& _onOp ) {
-    // Set new stack size enouth to handle the rest of the calls up to the limit.
-    boost::thread::attributes attrs;
-    attrs.set_stack_size( ( c_depthLimit - c_offloadPoint ) * c_singleExecutionStackSize );
-
-    // Create new thread with big stack and join immediately.
-    // TODO: It is possible to switch the implementation to Boost.Context or similar when the API is
-    // stable.
-    boost::exception_ptr exception;
-    boost::thread{
-        attrs,
-        [&] {
-            try {
-                _e.go( _onOp );
-            } catch ( ... ) {
-                exception = boost::current_exception();  // Catch all exceptions to be rethrown in
-                                                         // parent thread.
-            }
-        }
-    }.join();
-    if ( exception )
-        boost::rethrow_exception( exception );
+    // Threads with stack enough to handle the rest of the calls up to the limit, kept between
+    // offloads so that deep call chains do not start a thread each time.
+    static DeepStackPool s_pool( ( c_depthLimit - c_offloadPoint ) * c_singleExecutionStackSize );
+    // the budget of an RPC call is per thread, the offloaded frames spend it all the same
+    ExecutionBudget* const budget = ExecutionBudget::current();
+    s_pool.run( [&] {
+        ExecutionBudget::Scope scope( budget );
+        _e.go( _onOp );
+    } );
 }
 
 void go( unsigned _depth, Executive& _e, OnOpFunc const& _onOp ) {
@@ -180,6 +169,7 @@ void ExtVM::suicide( Address _a ) {
 }
 
 h256 ExtVM::blockHash( u256 _number ) {
+    noteBlockContextRead();
     u256 const currentNumber = envInfo().number();
 
     if ( _number >= currentNumber || _number < ( std::max< u256 >( 256, currentNumber ) - 256 ) )
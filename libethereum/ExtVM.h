@@ -36,13 +36,13 @@ class SealEngineFace;
 /// Externality interface for the Virtual Machine providing access to world state.
 class ExtVM : public ExtVMFace {
 public:
-    /// Full constructor.
+    /// Full constructor, @a _code is shared with the caller.
     ExtVM( skale::State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine,
         Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice,
-        bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash, u256 const& _version,
+        bytesConstRef _data, SharedBytes _code, h256 const& _codeHash, u256 const& _version,
         unsigned _depth, bool _isCreate, bool _staticCall, bool _readOnly = true )
         : ExtVMFace( _envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data,
-              _code.toBytes(), _codeHash, _version, _depth, _isCreate, _staticCall ),
+              std::move( _code ), _codeHash, _version, _depth, _isCreate, _staticCall ),
           m_s( _s ),
           m_sealEngine( _sealEngine ),
           m_evmSchedule( initEvmSchedule( envInfo().number(), _version ) ),
@@ -53,6 +53,15 @@ public:
         assert( m_s.addressInUse( _myAddress ) );
     }
 
+    /// Full constructor, copies @a _code.
+    ExtVM( skale::State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine,
+        Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice,
+        bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash, u256 const& _version,
+        unsigned _depth, bool _isCreate, bool _staticCall, bool _readOnly = true )
+        : ExtVM( _s, _envInfo, _sealEngine, _myAddress, _caller, _origin, _value, _gasPrice, _data,
+              SharedBytes( _code.toBytes() ), _codeHash, _version, _depth, _isCreate, _staticCall,
+              _readOnly ) {}
+
     /// Read storage location.
     virtual u256 store( u256 _n ) override final { return m_s.storage( myAddress, _n ); }
 
@@ -104,6 +113,8 @@ public:
     /// Hash of a block if within the last 256 blocks, or h256() otherwise.
     h256 blockHash( u256 _number ) override;
 
+    void noteBlockContextRead() override final { m_s.noteUnkeyedRead(); }
+
 private:
     EVMSchedule const& initEvmSchedule( int64_t _blockNumber, u256 const& _version ) const {
         // If _version is latest for the block, select corresponding latest schedule.
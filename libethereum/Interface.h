@@ -145,6 +145,14 @@ public:
 
     virtual LocalisedLogEntries logs( unsigned _watchId ) const = 0;
     virtual LocalisedLogEntries logs( LogFilter const& _filter ) const = 0;
+    /// Returns at most @a _limit logs of mined blocks, in chain order, starting from @a io_cursor
+    /// (empty for the first page). Sets @a io_cursor to the start of the next page, or to empty
+    /// string if there are no more logs. @a _limit is capped by nodeInfo.logsPageLimit.
+    virtual LocalisedLogEntries logs(
+        LogFilter const& _filter, std::string& io_cursor, size_t _limit ) const = 0;
+    /// Logs of the pending block, empty if @a _filter ends before it. logs( _filter ) returns
+    /// them ahead of logs of mined blocks.
+    virtual LocalisedLogEntries pendingLogs( LogFilter const& _filter ) const = 0;
 
     /// Install, uninstall and query watches.
     virtual unsigned installWatch( LogFilter const& _filter, Reaping _r = Reaping::Automatic,
@@ -147,3 +147,15 @@ LogEntries LogFilter::matches( TransactionReceipt const& _m ) const {
         }
     return ret;
 }
+
+bool LogFilter::matches( LogEntry const& _e ) const {
+    if ( !m_addresses.empty() &&
+         find( m_addresses.begin(), m_addresses.end(), _e.address ) == m_addresses.end() )
+        return false;
+    for ( unsigned i = 0; i < 4; ++i )
+        if ( !m_topics[i].empty() &&
+             ( _e.topics.size() <= i ||
+                 find( m_topics[i].begin(), m_topics[i].end(), _e.topics[i] ) == m_topics[i].end() ) )
+            return false;
+    return true;
+}
@@ -72,6 +72,8 @@ public:
     bool matches( LogBloom _bloom ) const;
     bool matches( Block const& _b, unsigned _i ) const;
     LogEntries matches( TransactionReceipt const& _r ) const;
+    /// @returns true if a single log entry has one of the addresses and matching topics
+    bool matches( LogEntry const& _e ) const;
 
     LogFilter address( Address _a ) {
         if ( std::find( m_addresses.begin(), m_addresses.end(), _a ) == m_addresses.end() )
@@ -0,0 +1,117 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogFilterIndex.cpp
+ * @date 2026
+ */
+
+#include "LogFilterIndex.h"
+
+#include <libdevcore/SHA3.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+void LogFilterIndex::insert( h256 const& _id, LogFilter const& _f ) {
+    std::vector< Address > addresses = _f.getAddresses();
+    std::array< std::vector< h256 >, 4 > topics = _f.getTopics();
+    if ( !addresses.empty() ) {
+        for ( Address const& a : addresses ) {
+            Bucket& b = m_byAddress[a];
+            if ( b.ids.empty() )
+                b.bloom = LogBloom().shiftBloom< 3 >( dev::sha3( a ) );
+            b.ids.insert( _id );
+        }
+    } else if ( !topics[0].empty() ) {
+        for ( h256 const& t : topics[0] ) {
+            Bucket& b = m_byTopic0[t];
+            if ( b.ids.empty() )
+                b.bloom = LogBloom().shiftBloom< 3 >( dev::sha3( t ) );
+            b.ids.insert( _id );
+        }
+    } else
+        m_unindexed.insert( _id );
+    ++m_filterCount;
+}
+
+void LogFilterIndex::erase( h256 const& _id, LogFilter const& _f ) {
+    std::vector< Address > addresses = _f.getAddresses();
+    std::array< std::vector< h256 >, 4 > topics = _f.getTopics();
+    if ( !addresses.empty() ) {
+        for ( Address const& a : addresses ) {
+            auto it = m_byAddress.find( a );
+            if ( it == m_byAddress.end() )
+                continue;
+            it->second.ids.erase( _id );
+            if ( it->second.ids.empty() )
+                m_byAddress.erase( it );
+        }
+    } else if ( !topics[0].empty() ) {
+        for ( h256 const& t : topics[0] ) {
+            auto it = m_byTopic0.find( t );
+            if ( it == m_byTopic0.end() )
+                continue;
+            it->second.ids.erase( _id );
+            if ( it->second.ids.empty() )
+                m_byTopic0.erase( it );
+        }
+    } else
+        m_unindexed.erase( _id );
+    if ( m_filterCount )
+        --m_filterCount;
+}
+
+void LogFilterIndex::clear() {
+    m_byAddress.clear();
+    m_byTopic0.clear();
+    m_unindexed.clear();
+    m_filterCount = 0;
+}
+
+void LogFilterIndex::candidates( TransactionReceipt const& _r, h256Hash& o_ids ) const {
+    LogEntries const& entries = _r.log();
+    if ( entries.empty() )
+        return;
+    o_ids.insert( m_unindexed.begin(), m_unindexed.end() );
+    for ( LogEntry const& e : entries ) {
+        auto itAddress = m_byAddress.find( e.address );
+        if ( itAddress != m_byAddress.end() )
+            o_ids.insert( itAddress->second.ids.begin(), itAddress->second.ids.end() );
+        if ( !e.topics.empty() ) {
+            auto itTopic = m_byTopic0.find( e.topics[0] );
+            if ( itTopic != m_byTopic0.end() )
+                o_ids.insert( itTopic->second.ids.begin(), itTopic->second.ids.end() );
+        }
+    }
+}
+
+bool LogFilterIndex::mayMatch( LogBloom const& _bloom ) const {
+    if ( m_filterCount == 0 || _bloom == LogBloom() )
+        return false;  // nothing installed or block has no logs at all
+    if ( !m_unindexed.empty() )
+        return true;
+    for ( auto const& entry : m_byAddress )
+        if ( _bloom.contains( entry.second.bloom ) )
+            return true;
+    for ( auto const& entry : m_byTopic0 )
+        if ( _bloom.contains( entry.second.bloom ) )
+            return true;
+    return false;
+}
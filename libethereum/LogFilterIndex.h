@@ -0,0 +1,65 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogFilterIndex.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/// Inverted index of installed log filters.
+/// A filter with addresses is indexed by each of its addresses, a filter without addresses but
+/// with topic 0 alternatives is indexed by each of them, all other filters are kept in a short
+/// list of filters which have to be checked against every log entry.
+/// Candidates returned by the index still have to be confirmed with LogFilter::matches().
+class LogFilterIndex {
+public:
+    void insert( h256 const& _id, LogFilter const& _f );
+    void erase( h256 const& _id, LogFilter const& _f );
+    void clear();
+
+    /// Adds ids of all filters which may match at least one log entry of @a _r into @a o_ids.
+    void candidates( TransactionReceipt const& _r, h256Hash& o_ids ) const;
+
+    /// @returns false if no installed filter can match anything in a block with bloom @a _bloom.
+    bool mayMatch( LogBloom const& _bloom ) const;
+
+    bool empty() const { return m_filterCount == 0; }
+    size_t size() const { return m_filterCount; }
+
+private:
+    struct Bucket {
+        LogBloom bloom;  ///< bloom bits of the key, precomputed for block bloom checks
+        h256Hash ids;
+    };
+    std::unordered_map< Address, Bucket > m_byAddress;
+    std::unordered_map< h256, Bucket > m_byTopic0;
+    h256Hash m_unindexed;
+    size_t m_filterCount = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,329 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogIndex.cpp
+ * @date 2026
+ */
+
+#include "LogIndex.h"
+
+#include <libdevcore/CommonJS.h>
+
+#include <boost/filesystem.hpp>
+
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace {
+
+const char c_prefixAddress = 'a';
+const char c_prefixTopic = 't';
+const char c_prefixAll = 'l';
+const char c_keyRange[] = "\x00range";  // RLP [first, last]
+const char c_keyStale[] = "\x00stale";  // RLP [first, last]
+const size_t c_positionSize = 8 + 4 + 4;
+const uint64_t c_removeChunkBlocks = 1000;
+
+void appendPosition( string& _key, LogPosition const& _pos ) {
+    _byte_ buf[c_positionSize];
+    bytesRef blockNumber( buf, 8 ), transactionIndex( buf + 8, 4 ), logIndex( buf + 12, 4 );
+    toBigEndian( _pos.blockNumber, blockNumber );
+    toBigEndian( _pos.transactionIndex, transactionIndex );
+    toBigEndian( _pos.logIndex, logIndex );
+    _key.append( reinterpret_cast< char const* >( buf ), c_positionSize );
+}
+
+LogPosition positionFromKeyTail( db::Slice _key ) {
+    bytesConstRef tail(
+        reinterpret_cast< _byte_ const* >( _key.data() ) + _key.size() - c_positionSize,
+        c_positionSize );
+    return LogPosition( fromBigEndian< uint64_t >( tail.cropped( 0, 8 ) ),
+        fromBigEndian< uint32_t >( tail.cropped( 8, 4 ) ),
+        fromBigEndian< uint32_t >( tail.cropped( 12, 4 ) ) );
+}
+
+string addressPrefix( Address const& _a ) {
+    string ret( 1, c_prefixAddress );
+    ret.append( reinterpret_cast< char const* >( _a.data() ), Address::size );
+    return ret;
+}
+
+string topicPrefix( unsigned _index, h256 const& _t ) {
+    string ret( 1, c_prefixTopic );
+    ret.push_back( char( _index ) );
+    ret.append( reinterpret_cast< char const* >( _t.data() ), h256::size );
+    return ret;
+}
+
+db::Slice rangeKey() {
+    return db::Slice( c_keyRange, sizeof( c_keyRange ) - 1 );
+}
+
+db::Slice staleKey() {
+    return db::Slice( c_keyStale, sizeof( c_keyStale ) - 1 );
+}
+
+void writePair( db::WriteBatchFace& _batch, db::Slice _key, uint64_t _first, uint64_t _last ) {
+    RLPStream s( 2 );
+    s << _first << _last;
+    bytes const& value = s.out();
+    _batch.insert(
+        _key, db::Slice( reinterpret_cast< char const* >( value.data() ), value.size() ) );
+}
+
+}  // namespace
+
+string LogPosition::toCursor() const {
+    string key;
+    appendPosition( key, *this );
+    return toJS( asBytes( key ) );
+}
+
+LogPosition LogPosition::fromCursor( string const& _cursor ) {
+    bytes b = jsToBytes( _cursor );
+    if ( b.size() != c_positionSize )
+        throw std::invalid_argument( "bad log cursor" );
+    return positionFromKeyTail(
+        db::Slice( reinterpret_cast< char const* >( b.data() ), b.size() ) );
+}
+
+LogIndex::LogIndex( boost::filesystem::path const& _path ) {
+    boost::filesystem::create_directories( _path );
+    m_db.reset( new db::LevelDB( _path ) );
+    string const r = m_db->lookup( rangeKey() );
+    if ( !r.empty() ) {
+        RLP rlp( r );
+        m_ranges.first = rlp[0].toInt< uint64_t >();
+        m_ranges.last = rlp[1].toInt< uint64_t >();
+        m_ranges.hasRange = true;
+    }
+    string const stale = m_db->lookup( staleKey() );
+    if ( !stale.empty() ) {
+        RLP rlp( stale );
+        m_ranges.staleFirst = rlp[0].toInt< uint64_t >();
+        m_ranges.staleLast = rlp[1].toInt< uint64_t >();
+        m_ranges.hasStale = true;
+    }
+}
+
+LogIndex::~LogIndex() {}
+
+void LogIndex::Ranges::retire( uint64_t _from, uint64_t _to ) {
+    if ( hasStale ) {
+        _from = min( _from, staleFirst );
+        _to = max( _to, staleLast );
+    }
+    hasStale = true;
+    staleFirst = _from;
+    staleLast = _to;
+    // keys of the stale range are removed as a whole, so coverage must stay out of it
+    if ( hasRange && first <= _to && _from <= last ) {
+        staleLast = max( _to, last );
+        if ( first < _from )
+            last = _from - 1;
+        else
+            hasRange = false;
+    }
+}
+
+void LogIndex::writeRanges( db::WriteBatchFace& _batch, Ranges const& _ranges ) {
+    if ( _ranges.hasRange )
+        writePair( _batch, rangeKey(), _ranges.first, _ranges.last );
+    else
+        _batch.kill( rangeKey() );
+    if ( _ranges.hasStale )
+        writePair( _batch, staleKey(), _ranges.staleFirst, _ranges.staleLast );
+    else
+        _batch.kill( staleKey() );
+}
+
+LogIndex::Ranges LogIndex::ranges() const {
+    Guard l( x_ranges );
+    return m_ranges;
+}
+
+bool LogIndex::indexBlock( uint64_t _number, TransactionReceipts const& _receipts ) {
+    Ranges r = ranges();
+    if ( r.isStale( _number ) )
+        return false;  // old keys of it are still there
+    if ( r.hasRange && _number >= r.first && _number <= r.last )
+        // imported again after a reorg, blocks above it are stale as well
+        r.retire( _number, r.last );
+    else if ( r.hasRange && _number + 1 != r.first && _number != r.last + 1 )
+        // gap, e.g. after snapshot restore: coverage restarts, old keys are removed later
+        r.retire( r.first, r.last );
+
+    bool const index = !r.isStale( _number );
+    if ( index ) {
+        if ( !r.hasRange ) {
+            r.hasRange = true;
+            r.first = r.last = _number;
+        } else if ( _number + 1 == r.first ) {
+            r.first = _number;
+        } else {
+            r.last = _number;
+        }
+    }
+
+    unique_ptr< db::WriteBatchFace > batch = m_db->createWriteBatch();
+    string key;
+    uint32_t logIndex = 0;
+    for ( size_t i = 0; index && i < _receipts.size(); ++i )
+        for ( LogEntry const& e : _receipts[i].log() ) {
+            LogPosition pos( _number, uint32_t( i ), logIndex++ );
+            h256s const topics(
+                e.topics.begin(), e.topics.begin() + min< size_t >( e.topics.size(), 4 ) );
+            // the per-position key keeps address and topics to find the other keys on removal
+            RLPStream stream( 2 );
+            stream << e.address << topics;
+            bytes const& value = stream.out();
+            key.assign( 1, c_prefixAll );
+            appendPosition( key, pos );
+            batch->insert( db::Slice( key ),
+                db::Slice( reinterpret_cast< char const* >( value.data() ), value.size() ) );
+            key = addressPrefix( e.address );
+            appendPosition( key, pos );
+            batch->insert( db::Slice( key ), db::Slice() );
+            for ( size_t j = 0; j < topics.size(); ++j ) {
+                key = topicPrefix( unsigned( j ), topics[j] );
+                appendPosition( key, pos );
+                batch->insert( db::Slice( key ), db::Slice() );
+            }
+        }
+    writeRanges( *batch, r );
+
+    // coverage shrinks before the batch is committed and grows after
+    Ranges before = r;
+    if ( index ) {
+        if ( r.first == r.last )
+            before.hasRange = false;
+        else if ( r.first == _number )
+            ++before.first;
+        else
+            --before.last;
+    }
+    DEV_GUARDED( x_ranges )
+    m_ranges = before;
+    m_db->commit( std::move( batch ) );
+    DEV_GUARDED( x_ranges )
+    m_ranges = r;
+    return index;
+}
+void LogIndex::retireBlocks( uint64_t _from ) {
+    Ranges r = ranges();
+    if ( !r.hasRange || r.last < _from )
+        return;
+    r.retire( max( _from, r.first ), r.last );
+    unique_ptr< db::WriteBatchFace > batch = m_db->createWriteBatch();
+    writeRanges( *batch, r );
+    DEV_GUARDED( x_ranges )
+    m_ranges = r;
+    m_db->commit( std::move( batch ) );
+}
+
+bool LogIndex::removeStale() {
+    // from the top down, the stored stale range always matches the keys left
+    Ranges r = ranges();
+    if ( !r.hasStale )
+        return false;
+    uint64_t chunkFirst = r.staleFirst;
+    if ( r.staleLast - chunkFirst >= c_removeChunkBlocks )
+        chunkFirst = r.staleLast - c_removeChunkBlocks + 1;
+
+    unique_ptr< db::WriteBatchFace > batch = m_db->createWriteBatch();
+    string begin( 1, c_prefixAll ), end( 1, c_prefixAll ), key;
+    appendPosition( begin, LogPosition( chunkFirst ) );
+    appendPosition( end, LogPosition( r.staleLast + 1 ) );
+    m_db->forEachInRange( db::Slice( begin ), db::Slice( end ),
+        [&]( db::Slice _key, db::Slice _value ) -> bool {
+            batch->kill( _key );
+            LogPosition const pos = positionFromKeyTail( _key );
+            RLP const rlp( bytesConstRef(
+                reinterpret_cast< _byte_ const* >( _value.data() ), _value.size() ) );
+            key = addressPrefix( rlp[0].toHash< Address >() );
+            appendPosition( key, pos );
+            batch->kill( db::Slice( key ) );
+            h256s const topics = rlp[1].toVector< h256 >();
+            for ( size_t j = 0; j < topics.size(); ++j ) {
+                key = topicPrefix( unsigned( j ), topics[j] );
+                appendPosition( key, pos );
+                batch->kill( db::Slice( key ) );
+            }
+            return true;
+        } );
+    r.hasStale = chunkFirst != r.staleFirst;
+    r.staleLast = chunkFirst - 1;
+    writeRanges( *batch, r );
+    m_db->commit( std::move( batch ) );
+    DEV_GUARDED( x_ranges )
+    m_ranges = r;
+    return r.hasStale;
+}
+
+bool LogIndex::covers( uint64_t _from, uint64_t _to ) const {
+    Guard l( x_ranges );
+    return m_ranges.hasRange && m_ranges.first <= _from && _to <= m_ranges.last;
+}
+
+bool LogIndex::range( uint64_t& o_first, uint64_t& o_last ) const {
+    Guard l( x_ranges );
+    o_first = m_ranges.first;
+    o_last = m_ranges.last;
+    return m_ranges.hasRange;
+}
+
+vector< LogPosition > LogIndex::candidates(
+    LogFilter const& _filter, LogPosition const& _start, uint64_t _to, size_t _limit ) const {
+    // one dimension drives the scan, the most specific one: addresses, then the first position
+    // with topics, then all logs; other dimensions are checked by the caller on real entries
+    vector< string > prefixes;
+    vector< Address > addresses = _filter.getAddresses();
+    array< vector< h256 >, 4 > topics = _filter.getTopics();
+    if ( !addresses.empty() ) {
+        for ( Address const& a : addresses )
+            prefixes.push_back( addressPrefix( a ) );
+    } else {
+        for ( unsigned j = 0; j < 4 && prefixes.empty(); ++j )
+            for ( h256 const& t : topics[j] )
+                prefixes.push_back( topicPrefix( j, t ) );
+    }
+    if ( prefixes.empty() )
+        prefixes.push_back( string( 1, c_prefixAll ) );
+
+    set< LogPosition > ret;
+    for ( string const& prefix : prefixes ) {
+        string begin = prefix, end = prefix;
+        appendPosition( begin, _start );
+        appendPosition( end, LogPosition( _to + 1 ) );
+        size_t n = 0;
+        m_db->forEachInRange( db::Slice( begin ), db::Slice( end ),
+            [&]( db::Slice _key, db::Slice ) -> bool {
+                ret.insert( positionFromKeyTail( _key ) );
+                // positions of every prefix are sorted, so its first _limit are enough
+                return ++n < _limit;
+            } );
+    }
+    vector< LogPosition > vec( ret.begin(), ret.end() );
+    if ( vec.size() > _limit )
+        vec.resize( _limit );
+    return vec;
+}
@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogIndex.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <libdevcore/Guards.h>
+#include <libdevcore/LevelDB.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <memory>
+#include <tuple>
+
+namespace dev {
+namespace eth {
+
+/// Position of a log entry in the chain, logs are returned by eth_getLogs in this order.
+struct LogPosition {
+    uint64_t blockNumber = 0;
+    uint32_t transactionIndex = 0;
+    uint32_t logIndex = 0;  ///< index of log in block
+
+    LogPosition() = default;
+    LogPosition( uint64_t _blockNumber, uint32_t _transactionIndex = 0, uint32_t _logIndex = 0 )
+        : blockNumber( _blockNumber ), transactionIndex( _transactionIndex ), logIndex( _logIndex ) {}
+
+    bool operator<( LogPosition const& _other ) const {
+        return std::tie( blockNumber, transactionIndex, logIndex ) <
+               std::tie( _other.blockNumber, _other.transactionIndex, _other.logIndex );
+    }
+    bool operator==( LogPosition const& _other ) const {
+        return blockNumber == _other.blockNumber &&
+               transactionIndex == _other.transactionIndex && logIndex == _other.logIndex;
+    }
+
+    /// Position right after this one, used to resume iteration.
+    LogPosition next() const { return LogPosition( blockNumber, transactionIndex, logIndex + 1 ); }
+
+    /// Opaque pagination cursor as returned to RPC clients.
+    std::string toCursor() const;
+    /// @throws std::invalid_argument if @a _cursor was not produced by toCursor()
+    static LogPosition fromCursor( std::string const& _cursor );
+};
+
+/// Secondary on-disk index of log entries:
+/// (address, position) and (topic index, topic, position) keys for every log, plus a key per
+/// position for filters without addresses and topics. Log contents are read from block receipts,
+/// only the per-position keys have a value: address and topics of the log, to remove its keys.
+/// The index is node-local and lives outside of blocks_and_extras, so it does not take part in
+/// snapshot hashes.
+/// It covers a contiguous range of blocks, queries outside of it must use other means.
+/// Blocks dropped from it are marked stale and their keys are removed later in chunks by
+/// removeStale(), so that dropping never delays block import.
+class LogIndex {
+public:
+    explicit LogIndex( boost::filesystem::path const& _path );
+    ~LogIndex();
+
+    /// Indexes all logs of block @a _number. Blocks are expected to be added right after the last
+    /// indexed one (import) or right before the first one (backfill). An indexed block marks
+    /// itself and the blocks above it stale, as after a reorg; any other block marks the indexed
+    /// ones stale and restarts coverage from it. Stale blocks are not indexed again until
+    /// removeStale() removes them.
+    /// Calls of it, retireBlocks() and removeStale() must not run concurrently.
+    /// @returns false if the block was not indexed
+    bool indexBlock( uint64_t _number, TransactionReceipts const& _receipts );
+    /// Marks blocks from @a _from up stale, e.g. ones no longer in the chain.
+    void retireBlocks( uint64_t _from );
+    /// Removes keys of at most a chunk of stale blocks.
+    /// @returns true if stale blocks remain
+    bool removeStale();
+
+    /// @returns true if every block of [_from, _to] is indexed
+    bool covers( uint64_t _from, uint64_t _to ) const;
+    /// @returns false if nothing is indexed yet, otherwise sets the indexed block range
+    bool range( uint64_t& o_first, uint64_t& o_last ) const;
+
+    /// @returns up to @a _limit positions in [_start, end of block _to] in ascending order,
+    /// a superset of logs matching @a _filter
+    std::vector< LogPosition > candidates(
+        LogFilter const& _filter, LogPosition const& _start, uint64_t _to, size_t _limit ) const;
+
+private:
+    /// Indexed and stale block ranges, never overlapping.
+    struct Ranges {
+        bool hasRange = false;
+        uint64_t first = 0;
+        uint64_t last = 0;
+        bool hasStale = false;
+        uint64_t staleFirst = 0;
+        uint64_t staleLast = 0;
+
+        bool isStale( uint64_t _number ) const {
+            return hasStale && staleFirst <= _number && _number <= staleLast;
+        }
+        /// Adds [_from, _to] to stale blocks, indexed ones the stale range overlaps go with it.
+        void retire( uint64_t _from, uint64_t _to );
+    };
+
+    void writeRanges( db::WriteBatchFace& _batch, Ranges const& _ranges );
+    Ranges ranges() const;
+
+    std::unique_ptr< db::LevelDB > m_db;
+    mutable Mutex x_ranges;
+    Ranges m_ranges;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -33,9 +33,12 @@
 #include <libdevcrypto/Common.h>
 #include <libdevcrypto/Hash.h>
 #include <libdevcrypto/LibSnark.h>
+#include <libdevcrypto/ModExp.h>
 #include <libethcore/ChainOperationParams.h>
 #include <libethcore/Common.h>
+#include <libethereum/PrecompiledConfig.h>
 #include <libethereum/SkaleHost.h>
+#include <libskale/FilePool.h>
 #include <libskale/State.h>
 #include <boost/algorithm/hex.hpp>
 
@@ -81,6 +84,19 @@ PrecompiledPricer const& PrecompiledRegistrar::pricer( std::string const& _name
     return get()->m_pricers[_name];
 }
 
+bool PrecompiledRegistrar::isPure( std::string const& _name ) {
+    static std::set< std::string > const pure{ "ecrecover", "sha256", "ripemd160", "identity",
+        "modexp", "alt_bn128_G1_add", "alt_bn128_G1_mul", "alt_bn128_pairing_product" };
+    return pure.count( _name ) != 0;
+}
+
+bool PrecompiledRegistrar::isMemoizable( std::string const& _name ) {
+    // hashes and identity are linear in the input, as are hashing and comparing it for a lookup
+    static std::set< std::string > const memoizable{ "ecrecover", "modexp", "alt_bn128_G1_add",
+        "alt_bn128_G1_mul", "alt_bn128_pairing_product" };
+    return memoizable.count( _name ) != 0;
+}
+
 namespace {
 
 ETH_REGISTER_PRECOMPILED( ecrecover )( bytesConstRef _in ) {
@@ -146,10 +162,31 @@ bigint parseBigEndianRightPadded( bytesConstRef _in, bigint const& _begin, bigin
     return ret;
 }
 
+// Lengths of the modexp operands, read from the 96 byte header. The executor and the pricer
+// both start from it.
+struct ModexpHeader {
+    bigint baseLength;
+    bigint expLength;
+    bigint modLength;
+};
+
+ModexpHeader parseModexpHeader( bytesConstRef _in ) {
+    return { parseBigEndianRightPadded( _in, 0, 32 ), parseBigEndianRightPadded( _in, 32, 32 ),
+        parseBigEndianRightPadded( _in, 64, 32 ) };
+}
+
+// Part of _in that holds _count bytes starting with _begin offset; the rest is right-padding.
+bytesConstRef croppedRightPadded( bytesConstRef _in, size_t _begin, size_t _count ) {
+    if ( _begin >= _in.count() )
+        return {};
+    return _in.cropped( _begin, min( _count, _in.count() - _begin ) );
+}
+
 ETH_REGISTER_PRECOMPILED( modexp )( bytesConstRef _in ) {
-    bigint const baseLength( parseBigEndianRightPadded( _in, 0, 32 ) );
-    bigint const expLength( parseBigEndianRightPadded( _in, 32, 32 ) );
-    bigint const modLength( parseBigEndianRightPadded( _in, 64, 32 ) );
+    ModexpHeader const header = parseModexpHeader( _in );
+    bigint const& baseLength = header.baseLength;
+    bigint const& expLength = header.expLength;
+    bigint const& modLength = header.modLength;
     assert( modLength <= numeric_limits< size_t >::max() / 8 );   // Otherwise gas should be too
                                                                   // expensive.
     assert( baseLength <= numeric_limits< size_t >::max() / 8 );  // Otherwise, gas should be too
@@ -158,14 +195,26 @@ ETH_REGISTER_PRECOMPILED( modexp )( bytesConstRef _in ) {
         return { true, bytes{} };  // This is a special case where expLength can be very big.
     assert( expLength <= numeric_limits< size_t >::max() / 8 );
 
+    size_t const baseSize{ baseLength };
+    size_t const expSize{ expLength };
+    size_t const modSize{ modLength };
+    size_t const expOffset = 96 + baseSize;
+    size_t const modOffset = expOffset + expSize;
+
+    bytes ret;
+    if ( dev::crypto::modexpMontgomery( croppedRightPadded( _in, 96, baseSize ), baseSize,
+             croppedRightPadded( _in, expOffset, expSize ), expSize,
+             croppedRightPadded( _in, modOffset, modSize ), modSize, ret ) )
+        return { true, ret };
+
+    // even or too wide modulus
     bigint const base( parseBigEndianRightPadded( _in, 96, baseLength ) );
     bigint const exp( parseBigEndianRightPadded( _in, 96 + baseLength, expLength ) );
     bigint const mod( parseBigEndianRightPadded( _in, 96 + baseLength + expLength, modLength ) );
 
     bigint const result = mod != 0 ? boost::multiprecision::powm( base, exp, mod ) : bigint{ 0 };
 
-    size_t const retLength( modLength );
-    bytes ret( retLength );
+    ret.resize( modSize );
     toBigEndian( result, ret );
 
     return { true, ret };
@@ -195,12 +244,11 @@ bigint multComplexity( bigint const& _x ) {
 
 ETH_REGISTER_PRECOMPILED_PRICER( modexp )
 ( bytesConstRef _in, ChainOperationParams const&, u256 const& ) {
-    bigint const baseLength( parseBigEndianRightPadded( _in, 0, 32 ) );
-    bigint const expLength( parseBigEndianRightPadded( _in, 32, 32 ) );
-    bigint const modLength( parseBigEndianRightPadded( _in, 64, 32 ) );
+    ModexpHeader const header = parseModexpHeader( _in );
 
-    bigint const maxLength( max( modLength, baseLength ) );
-    bigint const adjustedExpLength( expLengthAdjust( baseLength + 96, expLength, _in ) );
+    bigint const maxLength( max( header.modLength, header.baseLength ) );
+    bigint const adjustedExpLength(
+        expLengthAdjust( header.baseLength + 96, header.expLength, _in ) );
 
     return multComplexity( maxLength ) * max< bigint >( adjustedExpLength, 1 ) / 20;
 }
@@ -254,14 +302,6 @@ static void convertBytesToString(
     _out = std::string( ( char* ) byteFilename.data(), _stringLength );
 }
 
-static size_t stat_compute_file_size( const char* _strFileName ) {
-    std::ifstream file( _strFileName, ios::binary );
-    file.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-    file.seekg( 0, std::ios::end );
-    size_t n = size_t( file.tellg() );
-    return n;
-}
-
 boost::filesystem::path getFileStorageDir( const Address& _address ) {
     return dev::getDataDir() / "filestorage" / _address.hex();
 }
@@ -328,7 +368,7 @@ ETH_REGISTER_PRECOMPILED( uploadChunk )( bytesConstRef _in ) {
         size_t const dataLength = byteDataLength.convert_to< size_t >();
 
         const fs::path filePath = getFileStorageDir( Address( address ) ) / filename;
-        if ( position + dataLength > stat_compute_file_size( filePath.c_str() ) ) {
+        if ( position + dataLength > skale::FilePool::instance().fileSize( filePath.string() ) ) {
             throw std::runtime_error(
                 "uploadChunk() failed because chunk gets out of the file bounds" );
         }
@@ -379,17 +419,14 @@ ETH_REGISTER_PRECOMPILED( readChunk )( bytesConstRef _in ) {
              0 ) {
             throw std::runtime_error( "readChunk() failed because file couldn't be read" );
         }
-        if ( position > stat_compute_file_size( filePath.c_str() ) ||
-             position + chunkLength > stat_compute_file_size( filePath.c_str() ) ) {
+        size_t const fileSize = skale::FilePool::instance().fileSize( filePath.string() );
+        if ( position > fileSize || position + chunkLength > fileSize ) {
             throw std::runtime_error(
                 "readChunk() failed because chunk gets out of the file bounds" );
         }
 
-        std::ifstream infile( filePath.string(), std::ios_base::binary );
-        infile.seekg( static_cast< long >( position ) );
         bytes buffer( chunkLength );
-        infile.read(
-            reinterpret_cast< char* >( &buffer[0] ), static_cast< long >( buffer.size() ) );
+        skale::FilePool::instance().read( filePath.string(), position, buffer.data(), chunkLength );
         return { true, buffer };
     } catch ( std::exception& ex ) {
         std::string strError = ex.what();
@@ -421,7 +458,7 @@ ETH_REGISTER_PRECOMPILED( getFileSize )( bytesConstRef _in ) {
             throw std::runtime_error( "getFileSize() failed because file couldn't be read" );
         }
 
-        size_t const fileSize = stat_compute_file_size( filePath.c_str() );
+        size_t const fileSize = skale::FilePool::instance().fileSize( filePath.string() );
         bytes response = toBigEndian( static_cast< u256 >( fileSize ) );
         return { true, response };
     } catch ( std::exception& ex ) {
@@ -565,14 +602,28 @@ ETH_REGISTER_PRECOMPILED( calculateFileHash )( bytesConstRef _in ) {
     return { false, response };
 }
 
+// Snapshot of the readable configuration, rebuilt only when the config file is reloaded.
+static std::shared_ptr< PrecompiledConfig const > stat_get_precompiled_config() {
+    if ( !g_configAccesssor )
+        throw std::runtime_error( "Config accessor was not initialized" );
+    size_t const nGeneration = g_configAccesssor->getConfigGeneration();
+
+    static std::mutex g_mtx;
+    static std::shared_ptr< PrecompiledConfig const > g_config;
+    static size_t g_nGeneration = 0;
+    std::lock_guard< std::mutex > lock( g_mtx );
+    if ( !g_config || g_nGeneration != nGeneration ) {
+        g_config =
+            std::make_shared< PrecompiledConfig const >( g_configAccesssor->getConfigJSON() );
+        g_nGeneration = nGeneration;
+    }
+    return g_config;
+}
+
 ETH_REGISTER_PRECOMPILED( logTextMessage )( bytesConstRef _in ) {
     try {
-        if ( !g_configAccesssor )
-            throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
         bool bLoggingIsEnabledForContracts =
-            joConfig["skaleConfig"]["contractSettings"]["common"]["enableContractLogMessages"]
-                .get< bool >();
+            stat_get_precompiled_config()->contractLogMessagesEnabled();
         if ( !bLoggingIsEnabledForContracts ) {
             u256 code = 1;
             bytes response = toBigEndian( code );
@@ -673,39 +724,6 @@ ETH_REGISTER_PRECOMPILED( logTextMessage )( bytesConstRef _in ) {
     return { false, response };  // 1st false - means bad error occur
 }
 
-static const std::list< std::string > g_listReadableConfigParts{ "sealEngine",
-    //"genesis.*"
-    //"params.*",
-
-    "skaleConfig.nodeInfo.wallets.ima.commonBLSPublicKey*",
-    "skaleConfig.nodeInfo.wallets.ima.BLSPublicKey*",
-
-    "skaleConfig.nodeInfo.nodeName", "skaleConfig.nodeInfo.nodeID",
-    "skaleConfig.nodeInfo.basePort*", "skaleConfig.nodeInfo.*RpcPort*",
-    "skaleConfig.nodeInfo.acceptors", "skaleConfig.nodeInfo.max-connections",
-    "skaleConfig.nodeInfo.max-http-queues", "skaleConfig.nodeInfo.ws-mode",
-
-    "skaleConfig.contractSettings.*",
-
-    "skaleConfig.sChain.emptyBlockIntervalMs",
-
-    "skaleConfig.sChain.schainName", "skaleConfig.sChain.schainID",
-
-    "skaleConfig.sChain.nodes.*" };
-
-static bool stat_is_accessible_json_path( const std::string& strPath ) {
-    if ( strPath.empty() )
-        return false;
-    std::list< std::string >::const_iterator itWalk = g_listReadableConfigParts.cbegin(),
-                                             itEnd = g_listReadableConfigParts.cend();
-    for ( ; itWalk != itEnd; ++itWalk ) {
-        const std::string strWildCard = ( *itWalk );
-        if ( skutils::tools::wildcmp( strWildCard.c_str(), strPath.c_str() ) )
-            return true;
-    }
-    return false;
-}
-
 static size_t stat_calc_string_bytes_count_in_pages_32( size_t len_str ) {
     size_t rv = 32, blocks = len_str / 32 + ( ( ( len_str % 32 ) != 0 ) ? 1 : 0 );
     rv += blocks * 32;
@@ -736,48 +754,16 @@ static bytes stat_string_to_bytes_with_length( std::string& s ) {
     return rv;
 }
 
-static dev::u256 stat_parse_u256_hex_or_dec( const std::string& strValue ) {
-    if ( strValue.empty() )
-        return dev::u256( 0 );
-    const size_t cnt = strValue.length();
-    if ( cnt >= 2 && strValue[0] == '0' && ( strValue[1] == 'x' || strValue[1] == 'X' ) ) {
-        dev::u256 uValue( strValue.c_str() );
-        return uValue;
-    }
-    dev::u256 uValue = 0;
-    for ( size_t i = 0; i < cnt; ++i ) {
-        char chr = strValue[i];
-        if ( !( '0' <= chr && chr <= '9' ) )
-            throw std::runtime_error( "Bad u256 value \"" + strValue + "\" cannot be parsed" );
-        int nDigit = int( chr - '0' );
-        uValue *= 10;
-        uValue += nDigit;
-    }
-    return uValue;
-}
-
 ETH_REGISTER_PRECOMPILED( getConfigVariableUint256 )( bytesConstRef _in ) {
     try {
         size_t lengthName;
         std::string rawName;
         convertBytesToString( _in, 0, rawName, lengthName );
-        if ( !stat_is_accessible_json_path( rawName ) )
+        if ( !PrecompiledConfig::isReadablePath( rawName ) )
             throw std::runtime_error(
                 "Security poicy violation, inaccessible configuration JSON path: " + rawName );
 
-        if ( !g_configAccesssor )
-            throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
-        std::string strValue = skutils::tools::trim_copy(
-            joValue.is_string() ? joValue.get< std::string >() : joValue.dump() );
-
-        // dev::u256 uValue( strValue.c_str() );
-        dev::u256 uValue = stat_parse_u256_hex_or_dec( strValue );
-        // std::cout << "------------ Loaded config var \""
-        //          << rawName << "\" value is " << uValue
-        //          << "\n";
+        dev::u256 uValue = stat_get_precompiled_config()->uint256( rawName );
 
         bytes response = toBigEndian( uValue );
         return { true, response };
@@ -801,18 +787,11 @@ ETH_REGISTER_PRECOMPILED( getConfigVariableAddress )( bytesConstRef _in ) {
         size_t lengthName;
         std::string rawName;
         convertBytesToString( _in, 0, rawName, lengthName );
-        if ( !stat_is_accessible_json_path( rawName ) )
+        if ( !PrecompiledConfig::isReadablePath( rawName ) )
             throw std::runtime_error(
                 "Security poicy violation, inaccessible configuration JSON path: " + rawName );
 
-        if ( !g_configAccesssor )
-            throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
-        std::string strValue = skutils::tools::trim_copy(
-            joValue.is_string() ? joValue.get< std::string >() : joValue.dump() );
-        dev::u256 uValue( strValue.c_str() );
+        dev::u256 uValue = stat_get_precompiled_config()->address( rawName );
 
         bytes response = toBigEndian( uValue );
         return { true, response };
@@ -836,16 +815,11 @@ ETH_REGISTER_PRECOMPILED( getConfigVariableString )( bytesConstRef _in ) {
         size_t lengthName;
         std::string rawName;
         convertBytesToString( _in, 0, rawName, lengthName );
-        if ( !stat_is_accessible_json_path( rawName ) )
+        if ( !PrecompiledConfig::isReadablePath( rawName ) )
             throw std::runtime_error(
                 "Security poicy violation, inaccessible configuration JSON path: " + rawName );
 
-        if ( !g_configAccesssor )
-            throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
-        std::string strValue = joValue.is_string() ? joValue.get< std::string >() : joValue.dump();
+        std::string strValue = stat_get_precompiled_config()->text( rawName );
         bytes response = stat_string_to_bytes_with_length( strValue );
         return { true, response };
     } catch ( std::exception& ex ) {
@@ -869,60 +843,31 @@ ETH_REGISTER_PRECOMPILED( fnReserved0x16 )( bytesConstRef /*_in*/ ) {
     return { false, response };  // 1st false - means bad error occur
 }
 
-static dev::u256 stat_s2a( const std::string& saIn ) {
-    std::string sa;
-    if ( !( saIn.length() > 2 && saIn[0] == '0' && ( saIn[1] == 'x' || saIn[1] == 'X' ) ) )
-        sa = "0x" + saIn;
-    else
-        sa = saIn;
-    dev::u256 u( sa.c_str() );
-    return u;
-}
-
 ETH_REGISTER_PRECOMPILED( getConfigPermissionFlag )( bytesConstRef _in ) {
     try {
         dev::u256 uValue;
         uValue = 0;
 
-        auto rawAddressParameter = _in.cropped( 12, 20 ).toBytes();
-        std::string addressParameter;
-        boost::algorithm::hex( rawAddressParameter.begin(), rawAddressParameter.end(),
-            back_inserter( addressParameter ) );
-        dev::u256 uParameter = stat_s2a( addressParameter );
+        dev::u256 uParameter;
+        if ( _in.size() >= 32 )
+            uParameter = fromBigEndian< dev::u256 >( _in.cropped( 12, 20 ) );
+        else {
+            auto rawAddressParameter = _in.cropped( 12, 20 ).toBytes();
+            std::string addressParameter;
+            boost::algorithm::hex( rawAddressParameter.begin(), rawAddressParameter.end(),
+                back_inserter( addressParameter ) );
+            uParameter = PrecompiledConfig::parseAddress( addressParameter );
+        }
 
         size_t lengthName;
         std::string rawName;
         convertBytesToString( _in, 32, rawName, lengthName );
-        if ( !stat_is_accessible_json_path( rawName ) )
+        if ( !PrecompiledConfig::isReadablePath( rawName ) )
             throw std::runtime_error(
                 "Security poicy violation, inaccessible configuration JSON path: " + rawName );
 
-        if ( !g_configAccesssor )
-            throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
-        if ( joValue.is_object() ) {
-            auto itWalk = joValue.cbegin(), itEnd = joValue.cend();
-            for ( ; itWalk != itEnd; ++itWalk ) {
-                std::string strKey = itWalk.key();
-                dev::u256 uKey = stat_s2a( strKey );
-                if ( uKey == uParameter ) {
-                    nlohmann::json joFlag = itWalk.value();
-                    if ( joFlag.is_number_integer() ) {
-                        if ( joFlag.get< int >() != 0 )
-                            uValue = 1;
-                    } else if ( joFlag.is_number_float() ) {
-                        if ( joFlag.get< double >() != 0.0 )
-                            uValue = 1;
-                    } else if ( joFlag.is_boolean() ) {
-                        if ( joFlag.get< bool >() )
-                            uValue = 1;
-                    }
-                    break;
-                }
-            }
-        }
+        if ( stat_get_precompiled_config()->permissionFlag( rawName, uParameter ) )
+            uValue = 1;
 
         bytes response = toBigEndian( uValue );
         return { true, response };
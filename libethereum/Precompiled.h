@@ -86,6 +86,14 @@ public:
     /// Unregister a pricer. Shouldn't generally be necessary.
     static void unregisterPricer( std::string const& _name ) { get()->m_pricers.erase( _name ); }
 
+    /// @returns true if @a _name is one of the Ethereum precompiles, whose output depends on the
+    /// input only.
+    static bool isPure( std::string const& _name );
+
+    /// @returns true if @a _name is pure and costs much more than looking its input up in
+    /// PrecompiledCache.
+    static bool isMemoizable( std::string const& _name );
+
 private:
     static PrecompiledRegistrar* get() {
         if ( !s_this )
@@ -0,0 +1,234 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PrecompiledConfig.cpp
+ * @date 2026
+ */
+
+#include "PrecompiledConfig.h"
+
+#include <skutils/utils.h>
+
+#include <list>
+#include <stdexcept>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace {
+
+const std::list< std::string > g_listReadableConfigParts{ "sealEngine",
+    //"genesis.*"
+    //"params.*",
+
+    "skaleConfig.nodeInfo.wallets.ima.commonBLSPublicKey*",
+    "skaleConfig.nodeInfo.wallets.ima.BLSPublicKey*",
+
+    "skaleConfig.nodeInfo.nodeName", "skaleConfig.nodeInfo.nodeID",
+    "skaleConfig.nodeInfo.basePort*", "skaleConfig.nodeInfo.*RpcPort*",
+    "skaleConfig.nodeInfo.acceptors", "skaleConfig.nodeInfo.max-connections",
+    "skaleConfig.nodeInfo.max-http-queues", "skaleConfig.nodeInfo.ws-mode",
+
+    "skaleConfig.contractSettings.*",
+
+    "skaleConfig.sChain.emptyBlockIntervalMs",
+
+    "skaleConfig.sChain.schainName", "skaleConfig.sChain.schainID",
+
+    "skaleConfig.sChain.nodes.*" };
+
+dev::u256 stat_parse_u256_hex_or_dec( const std::string& strValue ) {
+    if ( strValue.empty() )
+        return dev::u256( 0 );
+    const size_t cnt = strValue.length();
+    if ( cnt >= 2 && strValue[0] == '0' && ( strValue[1] == 'x' || strValue[1] == 'X' ) ) {
+        dev::u256 uValue( strValue.c_str() );
+        return uValue;
+    }
+    dev::u256 uValue = 0;
+    for ( size_t i = 0; i < cnt; ++i ) {
+        char chr = strValue[i];
+        if ( !( '0' <= chr && chr <= '9' ) )
+            throw std::runtime_error( "Bad u256 value \"" + strValue + "\" cannot be parsed" );
+        int nDigit = int( chr - '0' );
+        uValue *= 10;
+        uValue += nDigit;
+    }
+    return uValue;
+}
+
+dev::u256 stat_s2a( const std::string& saIn ) {
+    std::string sa;
+    if ( !( saIn.length() > 2 && saIn[0] == '0' && ( saIn[1] == 'x' || saIn[1] == 'X' ) ) )
+        sa = "0x" + saIn;
+    else
+        sa = saIn;
+    dev::u256 u( sa.c_str() );
+    return u;
+}
+
+// Errors are kept as text and thrown again on lookup; what() is all the precompiles log.
+std::string errorText( std::exception const& _ex ) {
+    std::string strError = _ex.what();
+    if ( strError.empty() )
+        strError = "exception without description";
+    return strError;
+}
+
+}  // namespace
+
+PrecompiledConfig::PrecompiledConfig( nlohmann::json const& _config ) : m_config( _config ) {
+    flatten( m_config, "" );
+
+    try {
+        // non-const copy, as missing keys are read through operator[]
+        nlohmann::json joConfig = m_config;
+        m_contractLogMessagesEnabled =
+            joConfig["skaleConfig"]["contractSettings"]["common"]["enableContractLogMessages"]
+                .get< bool >();
+    } catch ( std::exception const& ex ) {
+        m_contractLogMessagesError = errorText( ex );
+    }
+}
+
+bool PrecompiledConfig::isReadablePath( std::string const& _path ) {
+    if ( _path.empty() )
+        return false;
+    for ( std::string const& strWildCard : g_listReadableConfigParts )
+        if ( skutils::tools::wildcmp( strWildCard.c_str(), _path.c_str() ) )
+            return true;
+    return false;
+}
+
+u256 PrecompiledConfig::parseAddress( std::string const& _address ) {
+    return stat_s2a( _address );
+}
+
+PrecompiledConfig::Entry PrecompiledConfig::makeEntry( nlohmann::json const& _value ) {
+    Entry entry;
+    entry.text = _value.is_string() ? _value.get< std::string >() : _value.dump();
+    std::string const strTrimmed = skutils::tools::trim_copy( entry.text );
+
+    try {
+        entry.uint256 = stat_parse_u256_hex_or_dec( strTrimmed );
+    } catch ( std::exception const& ex ) {
+        entry.uint256Error = errorText( ex );
+    }
+    try {
+        entry.address = dev::u256( strTrimmed.c_str() );
+    } catch ( std::exception const& ex ) {
+        entry.addressError = errorText( ex );
+    }
+
+    if ( _value.is_object() ) {
+        for ( auto it = _value.cbegin(); it != _value.cend(); ++it ) {
+            dev::u256 uKey;
+            try {
+                uKey = stat_s2a( it.key() );
+            } catch ( std::exception const& ex ) {
+                // keys after this one cannot be reached
+                entry.permissionFlagsError = errorText( ex );
+                break;
+            }
+            nlohmann::json const& joFlag = it.value();
+            bool bFlag = false;
+            if ( joFlag.is_number_integer() )
+                bFlag = joFlag.get< int >() != 0;
+            else if ( joFlag.is_number_float() )
+                bFlag = joFlag.get< double >() != 0.0;
+            else if ( joFlag.is_boolean() )
+                bFlag = joFlag.get< bool >();
+            // the first key with this address wins
+            entry.permissionFlags.emplace( h256( uKey ), bFlag );
+        }
+    }
+    return entry;
+}
+
+void PrecompiledConfig::flatten( nlohmann::json const& _value, std::string const& _path ) {
+    if ( isReadablePath( _path ) )
+        m_entries.emplace( _path, makeEntry( _value ) );
+
+    std::string const strPrefix = _path.empty() ? _path : _path + ".";
+    if ( _value.is_object() ) {
+        for ( auto it = _value.cbegin(); it != _value.cend(); ++it ) {
+            // such keys cannot be addressed by a dotted path
+            if ( it.key().empty() || it.key().find( '.' ) != std::string::npos )
+                continue;
+            flatten( it.value(), strPrefix + it.key() );
+        }
+    } else if ( _value.is_array() && !_path.empty() ) {
+        for ( size_t i = 0; i < _value.size(); ++i )
+            flatten( _value[i], strPrefix + std::to_string( i ) );
+        for ( char const* strSize : { "count", "size", "length" } ) {
+            std::string const strSizePath = strPrefix + strSize;
+            if ( isReadablePath( strSizePath ) )
+                m_entries.emplace( strSizePath, makeEntry( _value.size() ) );
+        }
+    }
+}
+
+PrecompiledConfig::Entry const& PrecompiledConfig::entry(
+    std::string const& _path, Entry& o_miss ) const {
+    auto it = m_entries.find( _path );
+    if ( it != m_entries.end() )
+        return it->second;
+    o_miss =
+        makeEntry( skutils::json_config_file_accessor::stat_extract_at_path( m_config, _path ) );
+    return o_miss;
+}
+
+u256 PrecompiledConfig::uint256( std::string const& _path ) const {
+    Entry miss;
+    Entry const& e = entry( _path, miss );
+    if ( !e.uint256Error.empty() )
+        throw std::runtime_error( e.uint256Error );
+    return e.uint256;
+}
+
+u256 PrecompiledConfig::address( std::string const& _path ) const {
+    Entry miss;
+    Entry const& e = entry( _path, miss );
+    if ( !e.addressError.empty() )
+        throw std::runtime_error( e.addressError );
+    return e.address;
+}
+
+std::string PrecompiledConfig::text( std::string const& _path ) const {
+    Entry miss;
+    return entry( _path, miss ).text;
+}
+
+bool PrecompiledConfig::permissionFlag( std::string const& _path, u256 const& _address ) const {
+    Entry miss;
+    Entry const& e = entry( _path, miss );
+    auto it = e.permissionFlags.find( h256( _address ) );
+    if ( it != e.permissionFlags.end() )
+        return it->second;
+    if ( !e.permissionFlagsError.empty() )
+        throw std::runtime_error( e.permissionFlagsError );
+    return false;
+}
+
+bool PrecompiledConfig::contractLogMessagesEnabled() const {
+    if ( !m_contractLogMessagesError.empty() )
+        throw std::runtime_error( m_contractLogMessagesError );
+    return m_contractLogMessagesEnabled;
+}
@@ -0,0 +1,99 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PrecompiledConfig.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <json.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/// Immutable snapshot of the configuration values readable by the getConfigVariable* and
+/// getConfigPermissionFlag precompiles.
+/// Every readable path of the config is flattened into a map from the dotted path to its
+/// already converted values, so a lookup is one hash probe. Paths missing from the map (array
+/// indexes written as "[0]", absent keys and so on) are walked through the stored config as
+/// before, and give the same values or errors.
+class PrecompiledConfig {
+public:
+    explicit PrecompiledConfig( nlohmann::json const& _config );
+
+    /// @returns true if contracts may read @a _path.
+    static bool isReadablePath( std::string const& _path );
+
+    /// Parses a hex address with or without 0x, as permission flag keys are written.
+    static u256 parseAddress( std::string const& _address );
+
+    /// Value for getConfigVariableUint256: decimal or 0x-prefixed hex.
+    /// @throws std::runtime_error if there is no such path or the value does not parse.
+    u256 uint256( std::string const& _path ) const;
+
+    /// Value for getConfigVariableAddress.
+    /// @throws std::runtime_error if there is no such path or the value does not parse.
+    u256 address( std::string const& _path ) const;
+
+    /// Value for getConfigVariableString: the string itself or the JSON dump of other values.
+    /// @throws std::runtime_error if there is no such path.
+    std::string text( std::string const& _path ) const;
+
+    /// Flag of @a _address in the object at @a _path, false if the value is not an object.
+    /// @throws std::runtime_error if there is no such path or a key met before @a _address
+    /// is not an address.
+    bool permissionFlag( std::string const& _path, u256 const& _address ) const;
+
+    /// skaleConfig.contractSettings.common.enableContractLogMessages
+    /// @throws std::runtime_error if it is missing or not a boolean.
+    bool contractLogMessagesEnabled() const;
+
+    /// Number of flattened paths.
+    size_t size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::string text;
+        u256 uint256;
+        std::string uint256Error;
+        u256 address;
+        std::string addressError;
+        /// first flag for every address key of an object, up to the first key which is not one
+        std::unordered_map< h256, bool > permissionFlags;
+        std::string permissionFlagsError;
+    };
+
+    static Entry makeEntry( nlohmann::json const& _value );
+    void flatten( nlohmann::json const& _value, std::string const& _path );
+    Entry const& entry( std::string const& _path, Entry& o_miss ) const;
+
+    nlohmann::json m_config;
+    std::unordered_map< std::string, Entry > m_entries;
+    bool m_contractLogMessagesEnabled = false;
+    std::string m_contractLogMessagesError;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -57,6 +57,7 @@ using namespace std;
 
 #include <skutils/console_colors.h>
 #include <skutils/task_performance.h>
+#include <skutils/task_trace.h>
 #include <skutils/utils.h>
 
 using namespace dev;
@@ -331,11 +332,10 @@ h256 SkaleHost::receiveTransaction( std::string _rlp ) {
 
     //
     static std::atomic_size_t g_nReceiveTransactionsTaskNumber = 0;
-    size_t nReceiveTransactionsTaskNumber = g_nReceiveTransactionsTaskNumber++;
-    std::string strPerformanceQueueName = "bc/receive_transaction";
-    std::string strPerformanceActionName =
-        skutils::tools::format( "receive task %zu", nReceiveTransactionsTaskNumber );
-    skutils::task::performance::action a( strPerformanceQueueName, strPerformanceActionName );
+    static const skutils::task::trace::id_type g_idTraceReceiveTransaction =
+        skutils::task::trace::intern( "bc/receive_transaction" );
+    skutils::task::trace::scope a( g_idTraceReceiveTransaction, g_idTraceReceiveTransaction,
+        _rlp.size(), g_nReceiveTransactionsTaskNumber++ );
     //
     m_debugTracer.tracepoint( "receive_transaction" );
     {
@@ -410,16 +410,10 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
     //
     static std::atomic_size_t g_nFetchTransactionsTaskNumber = 0;
-    size_t nFetchTransactionsTaskNumber = g_nFetchTransactionsTaskNumber++;
-    std::string strPerformanceQueueName_fetch_transactions = "bc/fetch_transactions";
-    std::string strPerformanceActionName_fetch_transactions =
-        skutils::tools::format( "fetch task %zu", nFetchTransactionsTaskNumber );
-    skutils::task::performance::json jsn = skutils::task::performance::json::object();
-    jsn["limit"] = toJS( _limit );
-    jsn["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::action a_fetch_transactions(
-        strPerformanceQueueName_fetch_transactions, strPerformanceActionName_fetch_transactions,
-        jsn );
+    static const skutils::task::trace::id_type g_idTraceFetchTransactions =
+        skutils::task::trace::intern( "bc/fetch_transactions" );
+    skutils::task::trace::scope a_fetch_transactions( g_idTraceFetchTransactions,
+        g_idTraceFetchTransactions, _limit, g_nFetchTransactionsTaskNumber++ );
     //
     m_debugTracer.tracepoint( "fetch_transactions" );
 
@@ -455,6 +449,7 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
 
     //
+    a_fetch_transactions.set_response_size( txns.size() );
     a_fetch_transactions.finish();
     //
 
@@ -497,20 +492,10 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
         std::lock_guard< std::mutex > localGuard( m_receivedMutex );
         //
         static std::atomic_size_t g_nDropBadTransactionsTaskNumber = 0;
-        size_t nDropBadTransactionsTaskNumber = g_nDropBadTransactionsTaskNumber++;
-        std::string strPerformanceQueueName_drop_bad_transactions = "bc/fetch_transactions";
-        std::string strPerformanceActionName_drop_bad_transactions =
-            skutils::tools::format( "fetch task %zu", nDropBadTransactionsTaskNumber );
-        skutils::task::performance::json jsn = skutils::task::performance::json::object();
-        skutils::task::performance::json jarrDroppedTransactions =
-            skutils::task::performance::json::array();
-        for ( auto sha : to_delete ) {
-            jarrDroppedTransactions.push_back( toJS( sha ) );
-        }
-        jsn["droppedTransactions"] = jarrDroppedTransactions;
-        skutils::task::performance::action a_drop_bad_transactions(
-            strPerformanceQueueName_drop_bad_transactions,
-            strPerformanceActionName_drop_bad_transactions, jsn );
+        static const skutils::task::trace::id_type g_idTraceDropBadTransactions =
+            skutils::task::trace::intern( "bc/drop_bad_transactions" );
+        skutils::task::trace::scope a_drop_bad_transactions( g_idTraceFetchTransactions,
+            g_idTraceDropBadTransactions, to_delete.size(), g_nDropBadTransactionsTaskNumber++ );
         //
         for ( auto sha : to_delete ) {
             m_debugTracer.tracepoint( "drop_bad" );
@@ -579,25 +564,10 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
     boost::chrono::high_resolution_clock::time_point skaledTimeStart;
     skaledTimeStart = boost::chrono::high_resolution_clock::now();
     static std::atomic_size_t g_nCreateBlockTaskNumber = 0;
-    size_t nCreateBlockTaskNumber = g_nCreateBlockTaskNumber++;
-    std::string strPerformanceQueueName_create_block = "bc/create_block";
-    std::string strPerformanceActionName_create_block =
-        skutils::tools::format( "b-create %zu", nCreateBlockTaskNumber );
-    skutils::task::performance::json jsn_create_block = skutils::task::performance::json::object();
-    jsn_create_block["blockID"] = toJS( _blockID );
-    jsn_create_block["timeStamp"] = toJS( _timeStamp );
-    jsn_create_block["gasPrice"] = toJS( _gasPrice );
-    jsn_create_block["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::json jarrApprovedTransactions =
-        skutils::task::performance::json::array();
-    for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
-        const bytes& data = *it;
-        h256 sha = sha3( data );
-        jarrApprovedTransactions.push_back( toJS( sha ) );
-    }
-    jsn_create_block["approvedTransactions"] = jarrApprovedTransactions;
-    skutils::task::performance::action a_create_block( strPerformanceQueueName_create_block,
-        strPerformanceActionName_create_block, jsn_create_block );
+    static const skutils::task::trace::id_type g_idTraceCreateBlock =
+        skutils::task::trace::intern( "bc/create_block" );
+    skutils::task::trace::scope a_create_block( g_idTraceCreateBlock, g_idTraceCreateBlock,
+        _approvedTransactions.size(), g_nCreateBlockTaskNumber++ );
 
     std::lock_guard< std::recursive_mutex > lock( m_pending_createMutex );
 
@@ -660,14 +630,29 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
     DEV_GUARDED( m_client.m_blockImportMutex ) {
         m_debugTracer.tracepoint( "drop_good_transactions" );
 
-        skutils::task::performance::json jarrProcessedTxns =
-            skutils::task::performance::json::array();
+        // decode consensus-born transactions once and recover their senders at once,
+        // not one by one below
+        h256s hashes;
+        hashes.reserve( _approvedTransactions.size() );
+        std::vector< std::unique_ptr< Transaction > > consensusBorn(
+            _approvedTransactions.size() );
+        std::vector< TransactionBase const* > toRecover;
+        for ( size_t i = 0; i < _approvedTransactions.size(); ++i ) {
+            hashes.push_back( sha3( _approvedTransactions[i] ) );
+            if ( m_m_transaction_cache.find( hashes.back().asArray() ) !=
+                 m_m_transaction_cache.cend() )
+                continue;
+            consensusBorn[i] = std::make_unique< Transaction >(
+                _approvedTransactions[i], CheckTransaction::Cheap, true );
+            toRecover.push_back( consensusBorn[i].get() );
+        }
+        Transaction::prefetchSenders( toRecover );
 
         for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
             const bytes& data = *it;
-            h256 sha = sha3( data );
+            size_t const index = it - _approvedTransactions.begin();
+            h256 const& sha = hashes[index];
             LOG( m_traceLogger ) << cc::debug( "Arrived txn: " ) << sha << std::endl;
-            jarrProcessedTxns.push_back( toJS( sha ) );
 #ifdef DEBUG_TX_BALANCE
             if ( sent.count( sha ) != m_transaction_cache.count( sha.asArray() ) ) {
                 std::cerr << cc::error( "createBlock assert" ) << std::endl;
@@ -694,7 +679,12 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
                 // for test std::thread( [t, this]() { m_client.importTransaction( t ); }
                 // ).detach();
             } else {
-                Transaction t( data, CheckTransaction::Everything, true );
+                // decoding again only if the sender wasn't recovered, for the same outcome
+                // as with CheckTransaction::Everything
+                Transaction t = consensusBorn[index] &&
+                                        consensusBorn[index]->safeSender() != ZeroAddress ?
+                                    *consensusBorn[index] :
+                                    Transaction( data, CheckTransaction::Everything, true );
                 t.checkOutExternalGas( m_client.chainParams().externalGasDifficulty );
                 out_txns.push_back( t );
                 LOG( m_debugLogger ) << "Will import consensus-born txn!";
@@ -719,15 +709,10 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
         a_create_block.finish();
         //
         static std::atomic_size_t g_nImportBlockTaskNumber = 0;
-        size_t nImportBlockTaskNumber = g_nImportBlockTaskNumber++;
-        std::string strPerformanceQueueName_import_block = "bc/import_block";
-        std::string strPerformanceActionName_import_block =
-            skutils::tools::format( "b-import %zu", nImportBlockTaskNumber );
-        skutils::task::performance::json jsn_import_block =
-            skutils::task::performance::json::object();
-        jsn_import_block["txns"] = jarrProcessedTxns;
-        skutils::task::performance::action a_import_block( strPerformanceQueueName_import_block,
-            strPerformanceActionName_import_block, jsn_import_block );
+        static const skutils::task::trace::id_type g_idTraceImportBlock =
+            skutils::task::trace::intern( "bc/import_block" );
+        skutils::task::trace::scope a_import_block( g_idTraceImportBlock, g_idTraceImportBlock,
+            out_txns.size(), g_nImportBlockTaskNumber++ );
         //
         m_debugTracer.tracepoint( "import_block" );
 
@@ -923,17 +908,11 @@ void SkaleHost::broadcastFunc() {
                         MICROPROFILE_SCOPEI(
                             "SkaleHost", "broadcastFunc.broadcast", MP_CHARTREUSE1 );
                         std::string rlp = toJS( txn.rlp() );
-                        std::string h = toJS( txn.sha3() );
                         //
-                        std::string strPerformanceQueueName = "bc/broadcast";
-                        std::string strPerformanceActionName =
-                            skutils::tools::format( "broadcast %zu", nBroadcastTaskNumber++ );
-                        skutils::task::performance::json jsn =
-                            skutils::task::performance::json::object();
-                        jsn["rlp"] = rlp;
-                        jsn["hash"] = h;
-                        skutils::task::performance::action a(
-                            strPerformanceQueueName, strPerformanceActionName, jsn );
+                        static const skutils::task::trace::id_type g_idTraceBroadcast =
+                            skutils::task::trace::intern( "bc/broadcast" );
+                        skutils::task::trace::scope a( g_idTraceBroadcast, g_idTraceBroadcast,
+                            rlp.size(), nBroadcastTaskNumber++ );
                         //
                         m_debugTracer.tracepoint( "broadcast" );
                         m_broadcaster->broadcast( rlp );
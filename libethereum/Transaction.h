@@ -29,6 +29,12 @@
 #include <libethcore/Common.h>
 #include <libethcore/TransactionBase.h>
 
+#include <memory>
+
+namespace skale {
+class StateReadSet;
+}
+
 namespace dev {
 namespace eth {
 
@@ -75,6 +81,8 @@ struct ExecutionResult {
     u256 gasRefunded = 0;
     unsigned depositSize = 0;  ///< Amount of code of the creation's attempted deposit.
     u256 gasForDeposit;        ///< Amount of gas remaining for the code deposit phase.
+    /// Committed state the execution read, set by calls at the latest block.
+    std::shared_ptr< skale::StateReadSet const > stateReads;
 };
 
 std::ostream& operator<<( std::ostream& _out, ExecutionResult const& _er );
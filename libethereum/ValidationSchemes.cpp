@@ -195,12 +195,15 @@ void validateConfigJson( js::mObject const& _obj ) {
             { "pg-trace", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "pg-threads", { { js::int_type }, JsonFieldPresence::Optional } },
             { "pg-threads-limit", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "pg-stream-buffer-size", { { js::int_type }, JsonFieldPresence::Optional } },
             { "web3-trace", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "web3-shutdown", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "unsafe-transactions", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "max-connections", { { js::int_type }, JsonFieldPresence::Optional } },
             { "max-http-queues", { { js::int_type }, JsonFieldPresence::Optional } },
             { "ws-mode", { { js::str_type }, JsonFieldPresence::Optional } },
+            { "ws-max-pending-notifications",
+                { { js::int_type }, JsonFieldPresence::Optional } },
             { "ws-log", { { js::str_type }, JsonFieldPresence::Optional } },
             { "log-value-size-limit", { { js::int_type }, JsonFieldPresence::Optional } },
             { "log-json-string-limit", { { js::int_type }, JsonFieldPresence::Optional } },
@@ -215,6 +218,8 @@ void validateConfigJson( js::mObject const& _obj ) {
             { "syncNode", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "archiveMode", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "syncFromCatchup", { { js::bool_type }, JsonFieldPresence::Optional } },
+            { "logIndex", { { js::bool_type }, JsonFieldPresence::Optional } },
+            { "logsPageLimit", { { js::int_type }, JsonFieldPresence::Optional } },
             { "wallets", { { js::obj_type }, JsonFieldPresence::Optional } } } );
 
     std::string keyShareName = "";
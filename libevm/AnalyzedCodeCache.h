@@ -0,0 +1,237 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file AnalyzedCodeCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/// Straight-line run of instructions whose constant gas and stack bounds interpreter-fast
+/// checks once on entry instead of per instruction.
+struct BasicBlock {
+    uint32_t gas = 0;         ///< constant gas of its instructions
+    uint32_t begin = 0;       ///< offset of its first instruction
+    uint32_t end = 0;         ///< offset after its last instruction
+    int32_t stackNeeded = 0;  ///< stack items it needs on entry
+    int32_t stackGrowth = 0;  ///< most stack items it adds on top of those on entry
+};
+
+/// Result of the interpreters' analysis pass over contract code: the code with synthetic
+/// instructions rewritten, padded with zero bytes, plus its constant pool and jump tables.
+/// Never modified after analysis, so one instance is shared by all executions of the code.
+struct AnalyzedCode {
+    bytes code;
+    std::vector< u256 > pool;
+    std::vector< uint64_t > jumpDests;
+    std::vector< uint64_t > beginSubs;
+    std::vector< BasicBlock > blocks;  ///< in code order, interpreter-fast only
+    std::vector< uint32_t > blockAt;   ///< index in blocks of the block starting at an offset
+    size_t codeSize = 0;               ///< size of original code
+
+    size_t memoryUsage() const {
+        return sizeof( AnalyzedCode ) + code.capacity() + pool.capacity() * sizeof( u256 ) +
+               ( jumpDests.capacity() + beginSubs.capacity() ) * sizeof( uint64_t ) +
+               blocks.capacity() * sizeof( BasicBlock ) + blockAt.capacity() * sizeof( uint32_t );
+    }
+};
+
+using AnalyzedCodePtr = std::shared_ptr< AnalyzedCode const >;
+
+/// Process-wide cache of analyzed code keyed by code hash, bounded by memory usage with LRU
+/// eviction. Every interpreter rewrites code in its own way, so entries are also keyed by
+/// interpreter kind.
+class AnalyzedCodeCache {
+public:
+    enum class Kind : uint8_t { Legacy = 0, Interpreter = 1, InterpreterFast = 2 };
+
+    static const size_t c_defaultMaxMemory = 32 * 1024 * 1024;
+
+    explicit AnalyzedCodeCache( size_t _maxMemory = c_defaultMaxMemory )
+        : m_maxMemory( _maxMemory ) {}
+    AnalyzedCodeCache( AnalyzedCodeCache const& ) = delete;
+    AnalyzedCodeCache& operator=( AnalyzedCodeCache const& ) = delete;
+
+    static AnalyzedCodeCache& instance() {
+        static AnalyzedCodeCache s_cache;
+        return s_cache;
+    }
+
+    /// @returns analyzed code for @a _codeHash, calls @a _analyze (without lock held) on miss.
+    /// Zero hash means the hash is unknown, such code is analyzed every time.
+    template < class F >
+    AnalyzedCodePtr getOrAnalyze(
+        Kind _kind, h256 const& _codeHash, size_t _codeSize, F&& _analyze ) {
+        if ( !_codeHash ) {
+            m_misses.fetch_add( 1, std::memory_order_relaxed );
+            return _analyze();
+        }
+        Key const key{ _codeHash, _kind };
+        DEV_GUARDED( x_entries ) {
+            auto it = m_entries.find( key );
+            // size check protects against callers passing a hash that does not match the code
+            if ( it != m_entries.end() && it->second.code->codeSize == _codeSize ) {
+                m_lru.splice( m_lru.begin(), m_lru, it->second.lruPos );
+                m_hits.fetch_add( 1, std::memory_order_relaxed );
+                return it->second.code;
+            }
+        }
+        m_misses.fetch_add( 1, std::memory_order_relaxed );
+        AnalyzedCodePtr code = _analyze();
+        insert( key, code );
+        return code;
+    }
+
+    /// Hash of the code an EVMC VM is about to run on this thread, as evmc_message has no place
+    /// for it. It is matched by code pointer and size, so a VM running other code ignores it.
+    class CodeHashHint {
+    public:
+        CodeHashHint( bytesConstRef _code, h256 const& _codeHash )
+            : m_code( _code ), m_codeHash( _codeHash ), m_previous( current() ) {
+            current() = this;
+        }
+        ~CodeHashHint() { current() = m_previous; }
+
+        CodeHashHint( CodeHashHint const& ) = delete;
+        CodeHashHint& operator=( CodeHashHint const& ) = delete;
+
+        /// @returns zero hash if no hint was given for this code.
+        static h256 codeHash( uint8_t const* _code, size_t _codeSize ) {
+            CodeHashHint const* hint = current();
+            if ( hint && hint->m_code.data() == _code && hint->m_code.size() == _codeSize )
+                return hint->m_codeHash;
+            return h256();
+        }
+
+    private:
+        static CodeHashHint*& current() {
+            static thread_local CodeHashHint* t_current = nullptr;
+            return t_current;
+        }
+
+        bytesConstRef const m_code;
+        h256 const m_codeHash;
+        CodeHashHint* const m_previous;
+    };
+
+    uint64_t hits() const { return m_hits.load( std::memory_order_relaxed ); }
+    uint64_t misses() const { return m_misses.load( std::memory_order_relaxed ); }
+    uint64_t evictions() const { return m_evictions.load( std::memory_order_relaxed ); }
+
+    size_t size() const {
+        Guard l( x_entries );
+        return m_entries.size();
+    }
+    size_t memoryUsage() const {
+        Guard l( x_entries );
+        return m_memoryUsage;
+    }
+    size_t maxMemory() const {
+        Guard l( x_entries );
+        return m_maxMemory;
+    }
+
+    void setMaxMemory( size_t _maxMemory ) {
+        Guard l( x_entries );
+        m_maxMemory = _maxMemory;
+        evictLocked();
+    }
+
+    void clear() {
+        Guard l( x_entries );
+        m_entries.clear();
+        m_lru.clear();
+        m_memoryUsage = 0;
+        m_hits = 0;
+        m_misses = 0;
+        m_evictions = 0;
+    }
+
+private:
+    struct Key {
+        h256 hash;
+        Kind kind;
+        bool operator==( Key const& _other ) const {
+            return kind == _other.kind && hash == _other.hash;
+        }
+    };
+    struct KeyHash {
+        size_t operator()( Key const& _key ) const {
+            return std::hash< h256 >()( _key.hash ) ^ size_t( _key.kind );
+        }
+    };
+    struct Entry {
+        AnalyzedCodePtr code;
+        std::list< Key >::iterator lruPos;
+    };
+
+    void insert( Key const& _key, AnalyzedCodePtr const& _code ) {
+        size_t const usage = _code->memoryUsage();
+        Guard l( x_entries );
+        if ( usage > m_maxMemory )
+            return;
+        auto it = m_entries.find( _key );
+        if ( it != m_entries.end() ) {
+            // analyzed concurrently by another thread, or replaced because of size mismatch
+            m_memoryUsage -= it->second.code->memoryUsage();
+            it->second.code = _code;
+            m_lru.splice( m_lru.begin(), m_lru, it->second.lruPos );
+        } else {
+            m_lru.push_front( _key );
+            m_entries.emplace( _key, Entry{ _code, m_lru.begin() } );
+        }
+        m_memoryUsage += usage;
+        evictLocked();
+    }
+
+    void evictLocked() {
+        while ( m_memoryUsage > m_maxMemory && !m_lru.empty() ) {
+            auto it = m_entries.find( m_lru.back() );
+            m_memoryUsage -= it->second.code->memoryUsage();
+            m_entries.erase( it );
+            m_lru.pop_back();
+            m_evictions.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    mutable Mutex x_entries;
+    std::unordered_map< Key, Entry, KeyHash > m_entries;
+    std::list< Key > m_lru;  ///< most recently used first
+    size_t m_memoryUsage = 0;
+    size_t m_maxMemory;
+
+    std::atomic< uint64_t > m_hits{ 0 };
+    std::atomic< uint64_t > m_misses{ 0 };
+    std::atomic< uint64_t > m_evictions{ 0 };
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -4,11 +4,34 @@
 #include "EVMC.h"
 
 #include <libdevcore/Log.h>
+#include <libevm/AnalyzedCodeCache.h>
+#include <libevm/ExecutionBudget.h>
 #include <libevm/VMFactory.h>
+#include <libskale-interpreter/interpreter.h>
+
+#include <exception>
+#include <utility>
 
 namespace dev {
 namespace eth {
 namespace {
+/// ExecutionBudgetExceeded thrown while charging instructions of skale-interpreter.
+thread_local std::exception_ptr t_budgetExceeded;
+
+int chargeInterpreterBudget( uint64_t _steps ) noexcept {
+    ExecutionBudget* budget = ExecutionBudget::current();
+    if ( !budget )
+        return 1;
+    try {
+        budget->charge( _steps );
+        return 1;
+    } catch ( ExecutionBudgetExceeded const& ) {
+        // it cannot pass through the VM, EVMC::exec rethrows it once the VM returns
+        t_budgetExceeded = std::current_exception();
+        return 0;
+    }
+}
+
 evmc_revision toRevision( EVMSchedule const& _schedule ) noexcept {
     if ( _schedule.haveChainID )
         return EVMC_ISTANBUL;
@@ -32,6 +55,10 @@ EVMC::EVMC( evmc_instance* _instance ) noexcept : evmc::vm( _instance ) {
     assert( _instance != nullptr );
     assert( is_abi_compatible() );
 
+    static bool const s_budgetHooked =
+        ( skale_interpreter_set_budget_hook( chargeInterpreterBudget ), true );
+    ( void ) s_budgetHooked;
+
     // Set the options.
     for ( auto& pair : evmcOptions() ) {
         auto result = set_option( pair.first.c_str(), pair.second.c_str() );
@@ -73,10 +100,16 @@ owning_bytes_ref EVMC::exec( u256& io_gas, ExtVMFace& _ext, const OnOpFunc& _onO
         toEvmC( _ext.myAddress ), toEvmC( _ext.caller ), _ext.data.data(), _ext.data.size(),
         toEvmC( _ext.value ), toEvmC( 0x0_cppui256 ) };
     EvmCHost host{ _ext };
-    auto r = execute( host, mode, msg, _ext.code.data(), _ext.code.size() );
-    // FIXME: Copy the output for now, but copyless version possible.
-    auto output =
-        owning_bytes_ref{ { &r.output_data[0], &r.output_data[r.output_size] }, 0, r.output_size };
+    AnalyzedCodeCache::CodeHashHint codeHashHint( _ext.code, _ext.codeHash );
+    // The output is not copied: it is kept alive by the result shared with the caller.
+    auto const result = std::make_shared< evmc::result >(
+        execute( host, mode, msg, _ext.code.data(), _ext.code.size() ) );
+    if ( host.budgetExceeded() )
+        std::rethrow_exception( host.budgetExceeded() );
+    if ( t_budgetExceeded )
+        std::rethrow_exception( std::exchange( t_budgetExceeded, nullptr ) );
+    evmc_result const& r = *result;
+    owning_bytes_ref output{ SharedBytes( result, { r.output_data, r.output_size } ) };
 
     switch ( r.status_code ) {
     case EVMC_SUCCESS:
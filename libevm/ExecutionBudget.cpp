@@ -0,0 +1,82 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ExecutionBudget.cpp
+ * @date 2026
+ */
+
+#include "ExecutionBudget.h"
+
+namespace dev {
+namespace eth {
+
+thread_local ExecutionBudget* ExecutionBudget::t_current = nullptr;
+std::mutex ExecutionBudget::s_countersMutex;
+std::map< std::string, std::unique_ptr< ExecutionBudget::Counters > >
+    ExecutionBudget::s_counters;
+
+ExecutionBudget::ExecutionBudget( std::string const& _method, Limits const& _limits )
+    : m_limits( _limits ),
+      m_deadline( std::chrono::steady_clock::now() + std::chrono::milliseconds( _limits.timeMs ) ),
+      m_counters( counters( _method ) ) {
+    m_counters.requests.fetch_add( 1, std::memory_order_relaxed );
+}
+
+ExecutionBudget::~ExecutionBudget() {
+    m_counters.instructions.fetch_add( instructions(), std::memory_order_relaxed );
+}
+
+ExecutionBudget::Counters& ExecutionBudget::counters( std::string const& _method ) {
+    std::lock_guard< std::mutex > lock( s_countersMutex );
+    auto& counters = s_counters[_method];
+    if ( !counters )
+        counters.reset( new Counters );
+    return *counters;
+}
+
+void ExecutionBudget::charge( uint64_t _instructions ) {
+    uint64_t const total =
+        m_instructions.fetch_add( _instructions, std::memory_order_relaxed ) + _instructions;
+    if ( m_limits.instructions && total > m_limits.instructions )
+        exceeded( "instruction limit of " + std::to_string( m_limits.instructions ) );
+    if ( m_limits.timeMs && std::chrono::steady_clock::now() > m_deadline )
+        exceeded( "time limit of " + std::to_string( m_limits.timeMs ) + " ms" );
+}
+
+void ExecutionBudget::exceeded( std::string const& _comment ) {
+    // parallel executions of the request may all notice it
+    if ( !m_exceeded.exchange( true ) )
+        m_counters.exceeded.fetch_add( 1, std::memory_order_relaxed );
+    BOOST_THROW_EXCEPTION( ExecutionBudgetExceeded() << errinfo_comment( _comment ) );
+}
+
+std::map< std::string, ExecutionBudget::Stats > ExecutionBudget::stats() {
+    std::map< std::string, Stats > ret;
+    std::lock_guard< std::mutex > lock( s_countersMutex );
+    for ( auto const& entry : s_counters ) {
+        Stats& stats = ret[entry.first];
+        stats.requests = entry.second->requests.load( std::memory_order_relaxed );
+        stats.exceeded = entry.second->exceeded.load( std::memory_order_relaxed );
+        stats.instructions = entry.second->instructions.load( std::memory_order_relaxed );
+    }
+    return ret;
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ExecutionBudget.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Exceptions.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dev {
+namespace eth {
+
+/// Thrown when a read-only call runs out of its ExecutionBudget. This is not a VMException:
+/// the call is aborted as a whole instead of failing the current frame.
+struct ExecutionBudgetExceeded : virtual Exception {
+    const char* what() const noexcept override { return "ExecutionBudgetExceeded"; }
+};
+
+/// Instructions and wall-clock time one RPC request may spend in the EVM.
+/// The budget is installed for the calling thread with a Scope; the interpreters charge it every
+/// c_chargeInterval instructions and Executive on every frame, so without a Scope, as in block
+/// execution, only a null check is done. charge() is thread-safe, so a request executing in
+/// several threads shares one budget.
+class ExecutionBudget {
+public:
+    /// Instructions LegacyVM and skale-interpreter execute between two charges.
+    static constexpr uint64_t c_chargeInterval = 4096;
+
+    /// Zero means no limit.
+    struct Limits {
+        uint64_t instructions = 0;
+        uint64_t timeMs = 0;
+
+        bool unlimited() const { return !instructions && !timeMs; }
+    };
+
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t exceeded = 0;
+        uint64_t instructions = 0;
+    };
+
+    /// Starts the clock of request @a _method.
+    ExecutionBudget( std::string const& _method, Limits const& _limits );
+    ~ExecutionBudget();
+
+    ExecutionBudget( ExecutionBudget const& ) = delete;
+    ExecutionBudget& operator=( ExecutionBudget const& ) = delete;
+
+    /// Adds @a _instructions to the instructions executed so far and throws
+    /// ExecutionBudgetExceeded if any limit is exceeded.
+    void charge( uint64_t _instructions );
+
+    uint64_t instructions() const { return m_instructions.load( std::memory_order_relaxed ); }
+    Limits const& limits() const { return m_limits; }
+
+    /// Budget of the calling thread, nullptr if it has none.
+    static ExecutionBudget* current() { return t_current; }
+
+    /// Makes @a _budget the budget of the calling thread until destroyed, nullptr removes it.
+    class Scope {
+    public:
+        explicit Scope( ExecutionBudget* _budget ) : m_previous( t_current ) {
+            t_current = _budget;
+        }
+        ~Scope() { t_current = m_previous; }
+
+        Scope( Scope const& ) = delete;
+        Scope& operator=( Scope const& ) = delete;
+
+    private:
+        ExecutionBudget* const m_previous;
+    };
+
+    /// Statistics of all budgeted requests by method.
+    static std::map< std::string, Stats > stats();
+
+private:
+    struct Counters {
+        std::atomic< uint64_t > requests{ 0 };
+        std::atomic< uint64_t > exceeded{ 0 };
+        std::atomic< uint64_t > instructions{ 0 };
+    };
+
+    /// Counters of @a _method, never freed.
+    static Counters& counters( std::string const& _method );
+
+    [[noreturn]] void exceeded( std::string const& _comment );
+
+    static thread_local ExecutionBudget* t_current;
+    static std::mutex s_countersMutex;
+    static std::map< std::string, std::unique_ptr< Counters > > s_counters;
+
+    Limits const m_limits;
+    std::chrono::steady_clock::time_point const m_deadline;
+    Counters& m_counters;
+    std::atomic< uint64_t > m_instructions{ 0 };
+    std::atomic< bool > m_exceeded{ false };
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -16,6 +16,7 @@
 */
 
 #include "ExtVMFace.h"
+#include "ExecutionBudget.h"
 
 #include <evmc/helpers.h>
 
@@ -123,6 +124,8 @@ void EvmCHost::emit_log( evmc::address const& _addr, uint8_t const* _data, size_
 }
 
 evmc_tx_context EvmCHost::get_tx_context() noexcept {
+    // asked for origin and gas price too, it is noted as a read of the block context all the same
+    m_extVM.noteBlockContextRead();
     evmc_tx_context result = {};
     result.tx_gas_price = toEvmC( m_extVM.gasPrice );
     result.tx_origin = toEvmC( m_extVM.origin );
@@ -151,35 +154,28 @@ evmc::result EvmCHost::create( evmc_message const& _msg ) noexcept {
     // ExtVM::create takes the sender address from .myAddress.
     assert( fromEvmC( _msg.sender ) == m_extVM.myAddress );
 
-    CreateResult result = m_extVM.create( value, gas, init, opcode, salt, {} );
-    evmc_result evmcResult = {};
-    evmcResult.status_code = result.status;
-    evmcResult.gas_left = static_cast< int64_t >( gas );
-
-    if ( result.status == EVMC_SUCCESS )
-        evmcResult.create_address = toEvmC( result.address );
-    else {
-        // Pass the output to the EVM without a copy. The EVM will delete it
-        // when finished with it.
-
-        // First assign reference. References are not invalidated when vector
-        // of bytes is moved. See `.takeBytes()` below.
-        evmcResult.output_data = result.output.data();
-        evmcResult.output_size = result.output.size();
-
-        // Place a new vector of bytes containing output in result's reserved memory.
-        auto* data = evmc_get_optional_storage( &evmcResult );
-        static_assert( sizeof( bytes ) <= sizeof( *data ), "Vector is too big" );
-        new ( data ) bytes( result.output.takeBytes() );
-        // Set the destructor to delete the vector.
-        evmcResult.release = []( evmc_result const* _result ) {
-            auto* data = evmc_get_const_optional_storage( _result );
-            auto& output = reinterpret_cast< bytes const& >( *data );
-            // Explicitly call vector's destructor to release its data.
-            // This is normal pattern when placement new operator is used.
-            output.~bytes();
-        };
+    try {
+        CreateResult result = m_extVM.create( value, gas, init, opcode, salt, {} );
+        evmc_result evmcResult = {};
+        evmcResult.status_code = result.status;
+        evmcResult.gas_left = static_cast< int64_t >( gas );
+
+        if ( result.status == EVMC_SUCCESS )
+            evmcResult.create_address = toEvmC( result.address );
+        else
+            // Pass the output to the EVM without a copy.
+            shareOutput( evmcResult, result.output );
+        return evmc::result{ evmcResult };
+    } catch ( ExecutionBudgetExceeded const& ) {
+        return budgetExceeded();
     }
+}
+
+evmc::result EvmCHost::budgetExceeded() noexcept {
+    // it cannot pass through the VM, EVMC::exec rethrows it once the VM returns
+    m_budgetExceeded = std::current_exception();
+    evmc_result evmcResult = {};
+    evmcResult.status_code = EVMC_FAILURE;
     return evmc::result{ evmcResult };
 }
 
@@ -202,36 +198,22 @@ evmc::result EvmCHost::call( evmc_message const& _msg ) noexcept {
     params.staticCall = ( _msg.flags & EVMC_STATIC ) != 0;
     params.onOp = {};
 
-    CallResult result = m_extVM.call( params );
-    evmc_result evmcResult = {};
-    evmcResult.status_code = result.status;
-    evmcResult.gas_left = static_cast< int64_t >( params.gas );
-
-    // Pass the output to the EVM without a copy. The EVM will delete it
-    // when finished with it.
-
-    // First assign reference. References are not invalidated when vector
-    // of bytes is moved. See `.takeBytes()` below.
-    evmcResult.output_data = result.output.data();
-    evmcResult.output_size = result.output.size();
-
-    // Place a new vector of bytes containing output in result's reserved memory.
-    auto* data = evmc_get_optional_storage( &evmcResult );
-    static_assert( sizeof( bytes ) <= sizeof( *data ), "Vector is too big" );
-    new ( data ) bytes( result.output.takeBytes() );
-    // Set the destructor to delete the vector.
-    evmcResult.release = []( evmc_result const* _result ) {
-        auto* data = evmc_get_const_optional_storage( _result );
-        auto& output = reinterpret_cast< bytes const& >( *data );
-        // Explicitly call vector's destructor to release its data.
-        // This is normal pattern when placement new operator is used.
-        output.~bytes();
-    };
-    return evmc::result{ evmcResult };
+    try {
+        CallResult result = m_extVM.call( params );
+        evmc_result evmcResult = {};
+        evmcResult.status_code = result.status;
+        evmcResult.gas_left = static_cast< int64_t >( params.gas );
+
+        // Pass the output to the EVM without a copy.
+        shareOutput( evmcResult, result.output );
+        return evmc::result{ evmcResult };
+    } catch ( ExecutionBudgetExceeded const& ) {
+        return budgetExceeded();
+    }
 }
 
 ExtVMFace::ExtVMFace( EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-    u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+    u256 _value, u256 _gasPrice, bytesConstRef _data, SharedBytes _code, h256 const& _codeHash,
     u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall )
     : m_envInfo( _envInfo ),
       myAddress( _myAddress ),
@@ -22,6 +22,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonData.h>
 #include <libdevcore/SHA3.h>
+#include <libdevcore/SharedBytes.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/ChainOperationParams.h>
 #include <libethcore/Common.h>
@@ -30,6 +31,7 @@
 #include <evmc/evmc.hpp>
 
 #include <boost/optional.hpp>
+#include <exception>
 #include <functional>
 #include <set>
 
@@ -49,8 +51,11 @@ namespace eth {
 /// ignored, part of it copied, or all of it copied). The decision what to do
 /// with it was moved out of VM interface making VMs "stateless".
 ///
+/// The buffer is shared, not copied, when the output is passed on as EVMC result or kept as
+/// return data of the caller (see SharedBytes).
+///
 /// The type is movable, but not copyable. Default constructor available.
-class owning_bytes_ref : public vector_ref< _byte_ const > {
+class owning_bytes_ref : public SharedBytes {
 public:
     owning_bytes_ref() = default;
 
@@ -58,27 +63,33 @@ public:
     /// @param _begin  The index of the first referenced byte.
     /// @param _size   The number of referenced bytes.
     owning_bytes_ref( bytes&& _bytes, size_t _begin, size_t _size )
-        : m_bytes( std::move( _bytes ) ) {
-        // Set the reference *after* the buffer is moved to avoid
-        // pointer invalidation.
-        retarget( &m_bytes[_begin], _size );
-    }
+        : SharedBytes( std::move( _bytes ), _begin, _size ) {}
+
+    explicit owning_bytes_ref( SharedBytes&& _bytes ) : SharedBytes( std::move( _bytes ) ) {}
 
     owning_bytes_ref( owning_bytes_ref const& ) = delete;
     owning_bytes_ref( owning_bytes_ref&& ) = default;
     owning_bytes_ref& operator=( owning_bytes_ref const& ) = delete;
     owning_bytes_ref& operator=( owning_bytes_ref&& ) = default;
-
-    /// Moves the bytes vector out of here. The object cannot be used any more.
-    bytes&& takeBytes() {
-        reset();  // Reset reference just in case.
-        return std::move( m_bytes );
-    }
-
-private:
-    bytes m_bytes;
 };
 
+/// Passes @a _output to an EVM in @a o_result without a copy: the result keeps the buffer
+/// alive until released.
+inline void shareOutput( evmc_result& o_result, SharedBytes const& _output ) noexcept {
+    using Owner = std::shared_ptr< void const >;
+
+    o_result.output_data = _output.data();
+    o_result.output_size = _output.size();
+
+    auto* data = evmc_get_optional_storage( &o_result );
+    static_assert( sizeof( Owner ) <= sizeof( *data ), "Owner is too big" );
+    new ( data ) Owner( _output.owner() );
+    o_result.release = []( evmc_result const* _result ) {
+        auto* data = evmc_get_const_optional_storage( _result );
+        reinterpret_cast< Owner const& >( *data ).~Owner();
+    };
+}
+
 struct SubState {
     std::set< Address > suicides;  ///< Any accounts that have suicided.
     LogEntries logs;               ///< Any logs.
@@ -193,7 +204,7 @@ class ExtVMFace {
 public:
     /// Full constructor.
     ExtVMFace( EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-        u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+        u256 _value, u256 _gasPrice, bytesConstRef _data, SharedBytes _code, h256 const& _codeHash,
         u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall );
 
     ExtVMFace( ExtVMFace const& ) = delete;
@@ -246,6 +257,10 @@ public:
     /// Get the execution environment information.
     EnvInfo const& envInfo() const { return m_envInfo; }
 
+    /// Called when code reads the block context: coinbase, timestamp, number, difficulty, gas limit
+    /// or a block hash.
+    virtual void noteBlockContextRead() {}
+
     /// Return the EVM gas-price schedule for this execution context.
     virtual EVMSchedule const& evmSchedule() const { return DefaultSchedule; }
 
@@ -260,7 +275,7 @@ public:
     u256 value;         ///< Value (in Wei) that was passed to this address.
     u256 gasPrice;      ///< Price of gas (that we already paid).
     bytesConstRef data;       ///< Current input data.
-    bytes code;               ///< Current code that is executing.
+    SharedBytes code;         ///< Current code that is executing.
     h256 codeHash;            ///< SHA3 hash of the executing code
     u256 version;             ///< Version of the VM to execute code
     u256 salt;                ///< Values used in new address construction by CREATE2
@@ -303,11 +318,16 @@ public:
     void emit_log( const evmc::address& _addr, const uint8_t* _data, size_t _dataSize,
         const evmc::bytes32 _topics[], size_t _numTopics ) noexcept override;
 
+    /// ExecutionBudgetExceeded thrown by a nested frame, if any.
+    std::exception_ptr budgetExceeded() const { return m_budgetExceeded; }
+
 private:
     evmc::result create( evmc_message const& _msg ) noexcept;
+    evmc::result budgetExceeded() noexcept;
 
 private:
     ExtVMFace& m_extVM;
+    std::exception_ptr m_budgetExceeded;
 };
 
 inline evmc::address toEvmC( Address const& _addr ) {
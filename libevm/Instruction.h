@@ -168,10 +168,17 @@ enum class Instruction : uint8_t {
     LOG4,         ///< Makes a log entry; 4 topics.
 
     // these are generated by the interpreter - should never be in user code
-    PUSHC = 0xac,  ///< push value from constant pool
-    JUMPC,         ///< alter the program counter - pre-verified
-    JUMPCI,        ///< conditionally alter the program counter - pre-verified
-    UNDEFINED,     ///< Replaces PUSHC/JUMPC/JUMPCI in the original code
+    PUSH2JUMP = 0xa5,  ///< PUSH2 and JUMP to it - pre-verified
+    PUSH2JUMPI,        ///< PUSH2 and JUMPI to it - pre-verified
+    ISZEROPUSH2JUMPI,  ///< ISZERO, PUSH2 and JUMPI to it - pre-verified
+    PUSH1MSTORE,       ///< PUSH1 and MSTORE to it
+    SWAP1POP,          ///< SWAP1 and POP
+    DUP2DUP2,          ///< DUP2 twice
+    SWAP2SWAP1,        ///< SWAP2 and SWAP1
+    PUSHC,             ///< push value from constant pool
+    JUMPC,             ///< alter the program counter - pre-verified
+    JUMPCI,            ///< conditionally alter the program counter - pre-verified
+    UNDEFINED,         ///< Replaces synthetic instructions in the original code
 
     JUMPTO = 0xb0,  ///< alter the program counter to a jumpdest
     JUMPIF,         ///< conditionally alter the program counter
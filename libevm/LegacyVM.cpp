@@ -16,6 +16,7 @@
 */
 
 #include "LegacyVM.h"
+#include "Uint256.h"
 
 using namespace std;
 using namespace dev;
@@ -25,16 +26,6 @@ uint64_t LegacyVM::memNeed( u256 const& _offset, u256 const& _size ) {
     return toInt63( _size ? u512( _offset ) + _size : u512( 0 ) );
 }
 
-template < class S >
-S divWorkaround( S const& _a, S const& _b ) {
-    return ( S )( s512( _a ) / s512( _b ) );
-}
-
-template < class S >
-S modWorkaround( S const& _a, S const& _b ) {
-    return ( S )( s512( _a ) % s512( _b ) );
-}
-
 
 //
 // for decoding destinations of JUMPTO, JUMPV, JUMPSUB and JUMPSUBV
@@ -166,8 +157,20 @@ void LegacyVM::updateGas() {
 void LegacyVM::updateMem( uint64_t _newMem ) {
     m_newMemSize = ( _newMem + 31 ) / 32 * 32;
     updateGas();
-    if ( m_newMemSize > m_mem.size() )
+    if ( m_newMemSize > m_mem.size() ) {
+        // grow capacity geometrically, gas is charged for the logical size only
+        if ( m_newMemSize > m_mem.capacity() )
+            m_mem.reserve( std::max< uint64_t >( m_newMemSize, 2 * m_mem.capacity() ) );
         m_mem.resize( m_newMemSize );
+    }
+}
+
+/// Copies returned memory out, so that the memory buffer stays with the instance for reuse.
+owning_bytes_ref LegacyVM::copyMemory( uint64_t _offset, uint64_t _size ) const {
+    if ( !_size )
+        return owning_bytes_ref();
+    auto const begin = m_mem.begin() + _offset;
+    return owning_bytes_ref{ bytes( begin, begin + _size ), 0, _size };
 }
 
 void LegacyVM::logGasMem() {
@@ -181,6 +184,7 @@ void LegacyVM::fetchInstruction() {
     m_OP = Instruction( m_code[m_PC] );
     const InstructionMetric& metric = c_metrics[static_cast< size_t >( m_OP )];
     adjustStack( metric.args, metric.ret );
+    ++m_steps;
 
     // FEES...
     m_runGas = toInt63( m_schedule->tierStepGas[static_cast< unsigned >( metric.gasPriceTier )] );
@@ -188,6 +192,12 @@ void LegacyVM::fetchInstruction() {
     m_copyMemSize = 0;
 }
 
+void LegacyVM::chargeBudget() {
+    uint64_t const steps = m_steps - m_chargedSteps;
+    m_chargedSteps = m_steps;
+    m_budget->charge( steps );
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -203,6 +213,18 @@ owning_bytes_ref LegacyVM::exec( u256& _io_gas, ExtVMFace& _ext, OnOpFunc const&
                                         // in the trace
     m_PC = 0;
 
+    // instance may come from VMPool, start from clean interpreter state
+    m_SP = m_SPP = m_stackEnd;
+#if EIP_615
+    m_RP = m_return - 1;
+#endif
+    m_nSteps = 0;
+    m_budget = ExecutionBudget::current();
+    m_steps = m_chargedSteps = 0;
+    m_runGas = m_newMemSize = m_copyMemSize = 0;
+    m_mem.clear();
+    m_returnData = SharedBytes();
+
     try {
         // trampoline to minimize depth of call stack when calling out
         m_bounce = &LegacyVM::initEntry;
@@ -216,6 +238,8 @@ owning_bytes_ref LegacyVM::exec( u256& _io_gas, ExtVMFace& _ext, OnOpFunc const&
     }
 
     *m_io_gas_p = m_io_gas;
+    if ( m_budget )
+        chargeBudget();
     return std::move( m_output );
 }
 
@@ -272,7 +296,7 @@ void LegacyVM::interpretCases() {
 
             uint64_t b = ( uint64_t ) m_SP[0];
             uint64_t s = ( uint64_t ) m_SP[1];
-            m_output = owning_bytes_ref{ std::move( m_mem ), b, s };
+            m_output = copyMemory( b, s );
             m_bounce = 0;
         }
         BREAK
@@ -289,7 +313,7 @@ void LegacyVM::interpretCases() {
 
             uint64_t b = ( uint64_t ) m_SP[0];
             uint64_t s = ( uint64_t ) m_SP[1];
-            owning_bytes_ref output{ move( m_mem ), b, s };
+            owning_bytes_ref output = copyMemory( b, s );
             throwRevertInstruction( move( output ) );
         }
         BREAK;
@@ -366,7 +390,10 @@ void LegacyVM::interpretCases() {
 
             uint64_t inOff = ( uint64_t ) m_SP[0];
             uint64_t inSize = ( uint64_t ) m_SP[1];
-            m_SPP[0] = ( u256 ) sha3( bytesConstRef( m_mem.data() + inOff, inSize ) );
+            if ( inSize == 64 )
+                m_SPP[0] = ( u256 ) sha3Cached64( m_mem.data() + inOff );
+            else
+                m_SPP[0] = ( u256 ) sha3( bytesConstRef( m_mem.data() + inOff, inSize ) );
         }
         NEXT
 
@@ -444,7 +471,7 @@ void LegacyVM::interpretCases() {
             updateIOGas();
 
             u256 base = m_SP[0];
-            m_SPP[0] = exp256( base, expon );
+            m_SPP[0] = uint256::exp( base, expon );
         }
         NEXT
 
@@ -482,7 +509,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? divWorkaround( m_SP[0], m_SP[1] ) : 0;
+            m_SPP[0] = uint256::div( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -490,7 +517,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? s2u( divWorkaround( u2s( m_SP[0] ), u2s( m_SP[1] ) ) ) : 0;
+            m_SPP[0] = uint256::sdiv( m_SP[0], m_SP[1] );
             --m_SP;
         }
         NEXT
@@ -499,7 +526,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? modWorkaround( m_SP[0], m_SP[1] ) : 0;
+            m_SPP[0] = uint256::mod( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -507,7 +534,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? s2u( modWorkaround( u2s( m_SP[0] ), u2s( m_SP[1] ) ) ) : 0;
+            m_SPP[0] = uint256::smod( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -661,7 +688,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[2] ? u256( ( u512( m_SP[0] ) + u512( m_SP[1] ) ) % m_SP[2] ) : 0;
+            m_SPP[0] = uint256::addmod( m_SP[0], m_SP[1], m_SP[2] );
         }
         NEXT
 
@@ -669,7 +696,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[2] ? u256( ( u512( m_SP[0] ) * u512( m_SP[1] ) ) % m_SP[2] ) : 0;
+            m_SPP[0] = uint256::mulmod( m_SP[0], m_SP[1], m_SP[2] );
         }
         NEXT
 
@@ -693,7 +720,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_PC = decodeJumpDest( m_code.data(), m_PC );
+            m_PC = decodeJumpDest( m_code, m_PC );
         }
         CONTINUE
 
@@ -702,7 +729,7 @@ void LegacyVM::interpretCases() {
             updateIOGas();
 
             if ( m_SP[0] )
-                m_PC = decodeJumpDest( m_code.data(), m_PC );
+                m_PC = decodeJumpDest( m_code, m_PC );
             else
                 ++m_PC;
         }
@@ -711,7 +738,7 @@ void LegacyVM::interpretCases() {
         CASE( JUMPV ) {
             ON_OP();
             updateIOGas();
-            m_PC = decodeJumpvDest( m_code.data(), m_PC, byte( m_SP[0] ) );
+            m_PC = decodeJumpvDest( m_code, m_PC, byte( m_SP[0] ) );
         }
         CONTINUE
 
@@ -719,7 +746,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC++;
-            m_PC = decodeJumpDest( m_code.data(), m_PC );
+            m_PC = decodeJumpDest( m_code, m_PC );
         }
         CONTINUE
 
@@ -727,7 +754,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC;
-            m_PC = decodeJumpvDest( m_code.data(), m_PC, byte( m_SP[0] ) );
+            m_PC = decodeJumpvDest( m_code, m_PC, byte( m_SP[0] ) );
         }
         CONTINUE
 
@@ -1207,7 +1234,7 @@ void LegacyVM::interpretCases() {
             updateMem( memNeed( m_SP[0], m_SP[2] ) );
             updateIOGas();
 
-            copyDataToMemory( &m_returnData, m_SP );
+            copyDataToMemory( m_returnData, m_SP );
         }
         NEXT
 
@@ -1229,7 +1256,7 @@ void LegacyVM::interpretCases() {
             updateMem( memNeed( m_SP[0], m_SP[2] ) );
             updateIOGas();
 
-            copyDataToMemory( &m_ext->code, m_SP );
+            copyDataToMemory( m_ext->code, m_SP );
         }
         NEXT
 
@@ -1250,6 +1277,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            // not a read of the block context, eth_call resolves the default into its cache key
             m_SPP[0] = m_ext->gasPrice;
         }
         NEXT
@@ -1267,6 +1295,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            m_ext->noteBlockContextRead();
             m_SPP[0] = ( u160 ) m_ext->envInfo().author();
         }
         NEXT
@@ -1275,6 +1304,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            m_ext->noteBlockContextRead();
             m_SPP[0] = m_ext->envInfo().timestamp();
         }
         NEXT
@@ -1283,6 +1313,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            m_ext->noteBlockContextRead();
             m_SPP[0] = m_ext->envInfo().number();
         }
         NEXT
@@ -1291,6 +1322,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            m_ext->noteBlockContextRead();
             m_SPP[0] = m_ext->envInfo().difficulty();
         }
         NEXT
@@ -1299,6 +1331,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            m_ext->noteBlockContextRead();
             m_SPP[0] = m_ext->envInfo().gasLimit();
         }
         NEXT
@@ -1546,6 +1579,9 @@ void LegacyVM::interpretCases() {
             m_runGas = 1;
             ON_OP();
             updateIOGas();
+            // every loop passes a JUMPDEST, so long executions are checked here
+            if ( m_budget && m_steps - m_chargedSteps >= ExecutionBudget::c_chargeInterval )
+                chargeBudget();
         }
         NEXT
 
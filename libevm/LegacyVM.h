@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "AnalyzedCodeCache.h"
+#include "ExecutionBudget.h"
 #include "Instruction.h"
 #include "LegacyVMConfig.h"
 #include "VMFace.h"
@@ -42,6 +44,18 @@ public:
         return stack;
     };
 
+    /// Prepares the instance for reuse by VMPool: drops buffers grown above @a _maxRetained
+    /// bytes and the reference to analyzed code, smaller buffers serve the next execution.
+    void recycle( size_t _maxRetained ) {
+        if ( m_mem.capacity() > _maxRetained )
+            bytes().swap( m_mem );
+        m_returnData = SharedBytes();
+        m_output = owning_bytes_ref();
+        m_analyzed.reset();
+        m_code = nullptr;
+        m_pool = nullptr;
+    }
+
 private:
     u256* m_io_gas_p = 0;
     uint64_t m_io_gas = 0;
@@ -50,25 +64,32 @@ private:
 
     static std::array< InstructionMetric, 256 > c_metrics;
     static void initMetrics();
-    static u256 exp256( u256 _base, u256 _exponent );
-    void copyCode( int );
     typedef void ( LegacyVM::*MemFnPtr )();
     MemFnPtr m_bounce = 0;
     MemFnPtr m_onFail = 0;
     uint64_t m_nSteps = 0;
     EVMSchedule const* m_schedule = nullptr;
 
+    // budget of the RPC request being executed, nullptr in block execution
+    ExecutionBudget* m_budget = nullptr;
+    uint64_t m_steps = 0;
+    uint64_t m_chargedSteps = 0;
+
     // return bytes
     owning_bytes_ref m_output;
 
     // space for memory
     bytes m_mem;
 
-    // space for code
-    bytes m_code;
+    // analyzed code shared with other executions, and raw pointers into it
+    AnalyzedCodePtr m_analyzed;
+    _byte_ const* m_code = nullptr;
+
+    /// RETURNDATA of the last direct subcall, shares the memory of the callee.
+    SharedBytes m_returnData;
 
-    /// RETURNDATA buffer for memory returned from direct subcalls.
-    bytes m_returnData;
+    /// Parameters of the current subcall, kept here to avoid allocating them on every call.
+    CallParameters m_callParams;
 
     // space for data stack, grows towards smaller addresses from the end
     u256 m_stack[1024];
@@ -84,7 +105,7 @@ private:
 #endif
 
     // constant pool
-    std::vector< u256 > m_pool;
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -103,6 +124,7 @@ private:
     // initialize interpreter
     void initEntry();
     void optimize();
+    static AnalyzedCodePtr analyze( bytesConstRef _code );
 
     // interpreter loop & switch
     void interpretCases();
@@ -110,6 +132,7 @@ private:
     // interpreter cases that call out
     void caseCreate();
     bool caseCallSetup( CallParameters*, bytesRef& o_output );
+    owning_bytes_ref copyMemory( uint64_t _offset, uint64_t _size ) const;
     void caseCall();
 
     void copyDataToMemory( bytesConstRef _data, u256* _sp );
@@ -124,8 +147,6 @@ private:
     void throwBufferOverrun( bigint const& _enfOfAccess );
     void throwStorageOverflow( const std::string& _addr );
 
-    std::vector< uint64_t > m_beginSubs;
-    std::vector< uint64_t > m_jumpDests;
     int64_t verifyJumpDest( u256 const& _dest, bool _throw = true );
 
     void onOperation();
@@ -139,6 +160,7 @@ private:
     void updateMem( uint64_t _newMem );
     void logGasMem();
     void fetchInstruction();
+    void chargeBudget();
 
     uint64_t decodeJumpDest( const _byte_* const _code, uint64_t& _pc );
     uint64_t decodeJumpvDest( const _byte_* const _code, uint64_t& _pc, _byte_ _voff );
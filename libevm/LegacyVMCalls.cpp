@@ -98,7 +98,7 @@ int64_t LegacyVM::verifyJumpDest( u256 const& _dest, bool _throw ) {
         // check for within bounds and to a jump destination
         // use binary search of array because hashtable collisions are exploitable
         uint64_t pc = uint64_t( _dest );
-        if ( std::binary_search( m_jumpDests.begin(), m_jumpDests.end(), pc ) )
+        if ( std::binary_search( m_analyzed->jumpDests.begin(), m_analyzed->jumpDests.end(), pc ) )
             return pc;
     }
     if ( _throw )
@@ -130,8 +130,7 @@ void LegacyVM::caseCreate() {
     updateMem( memNeed( initOff, initSize ) );
     updateIOGas();
 
-    // Clear the return data buffer. This will not free the memory.
-    m_returnData.clear();
+    m_returnData = SharedBytes();
 
     if ( m_ext->balance( m_ext->myAddress ) >= endowment && m_ext->depth < 1024 ) {
         *m_io_gas_p = m_io_gas;
@@ -148,7 +147,7 @@ void LegacyVM::caseCreate() {
 
         CreateResult result = m_ext->create( endowment, gas, initCode, m_OP, salt, m_onOp );
         m_SPP[0] = ( u160 ) result.address;  // Convert address to integer.
-        m_returnData = result.output.toBytes();
+        m_returnData = std::move( result.output );
 
         *m_io_gas_p -= ( createGas - gas );
         m_io_gas = uint64_t( *m_io_gas_p );
@@ -160,25 +159,20 @@ void LegacyVM::caseCreate() {
 void LegacyVM::caseCall() {
     m_bounce = &LegacyVM::interpretCases;
 
-    // TODO: Please check if that does not actually increases the stack size.
-    //       That was the case before.
-    unique_ptr< CallParameters > callParams( new CallParameters() );
+    // Parameters live in the instance: no allocation and no growth of the native stack.
+    m_callParams = CallParameters();
+    CallParameters* callParams = &m_callParams;
 
-    // Clear the return data buffer. This will not free the memory.
-    m_returnData.clear();
+    m_returnData = SharedBytes();
 
     bytesRef output;
-    if ( caseCallSetup( callParams.get(), output ) ) {
+    if ( caseCallSetup( callParams, output ) ) {
         CallResult result = m_ext->call( *callParams );
         result.output.copyTo( output );
 
-        // Here we have 2 options:
-        // 1. Keep the whole returned memory buffer (owning_bytes_ref):
-        //    higher memory footprint, no memory copy.
-        // 2. Copy only the return data from the returned memory buffer:
-        //    minimal memory footprint, additional memory copy.
-        // Option 2 used:
-        m_returnData = result.output.toBytes();
+        // Keep the returned memory buffer shared with the callee: no memory copy, the buffer
+        // lives until the next subcall.
+        m_returnData = std::move( result.output );
 
         m_SPP[0] = result.status == EVMC_SUCCESS ? 1 : 0;
     } else
@@ -35,36 +35,43 @@ void LegacyVM::initMetrics() {
     ( void ) done;
 }
 
-void LegacyVM::copyCode( int _extraBytes ) {
-    // Copy code so that it can be safely modified and extend code by
-    // _extraBytes zero bytes to allow reading virtual data at the end
-    // of the code without bounds checks.
-    auto extendedSize = m_ext->code.size() + _extraBytes;
-    m_code.reserve( extendedSize );
-    m_code = m_ext->code;
-    m_code.resize( extendedSize );
+namespace {
+bool isJumpDest( std::vector< uint64_t > const& _jumpDests, u256 const& _dest ) {
+    return _dest <= 0x7FFFFFFFFFFFFFFF &&
+           std::binary_search( _jumpDests.begin(), _jumpDests.end(), uint64_t( _dest ) );
 }
+}  // namespace
 
-void LegacyVM::optimize() {
-    copyCode( 33 );
+AnalyzedCodePtr LegacyVM::analyze( bytesConstRef _code ) {
+    auto ret = std::make_shared< AnalyzedCode >();
+    AnalyzedCode& a = *ret;
 
-    size_t const nBytes = m_ext->code.size();
+    // Copy code so that it can be safely modified and extend code by
+    // 33 zero bytes to allow reading virtual data at the end
+    // of the code without bounds checks.
+    a.codeSize = _code.size();
+    a.code.reserve( _code.size() + 33 );
+    a.code.assign( _code.begin(), _code.end() );
+    a.code.resize( _code.size() + 33 );
+    bytes& code = a.code;
+
+    size_t const nBytes = _code.size();
 
     // build a table of jump destinations for use in verifyJumpDest
 
     TRACE_STR( 1, "Build JUMPDEST table" )
     for ( size_t pc = 0; pc < nBytes; ++pc ) {
-        Instruction op = Instruction( m_code[pc] );
+        Instruction op = Instruction( code[pc] );
         TRACE_OP( 2, pc, op );
 
         // make synthetic ops in user code trigger invalid instruction if run
         if ( op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI ) {
             TRACE_OP( 1, pc, op );
-            m_code[pc] = ( _byte_ ) Instruction::INVALID;
+            code[pc] = ( _byte_ ) Instruction::INVALID;
         }
 
         if ( op == Instruction::JUMPDEST ) {
-            m_jumpDests.push_back( pc );
+            a.jumpDests.push_back( pc );
         } else if ( ( byte ) Instruction::PUSH1 <= ( byte ) op &&
                     ( byte ) op <= ( byte ) Instruction::PUSH32 ) {
             pc += ( _byte_ ) op - ( _byte_ ) Instruction::PUSH1 + 1;
@@ -76,9 +83,9 @@ void LegacyVM::optimize() {
             pc += 4;
         } else if ( op == Instruction::JUMPV || op == Instruction::JUMPSUBV ) {
             ++pc;
-            pc += 4 * m_code[pc];  // number of 4-byte dests followed by table
+            pc += 4 * code[pc];  // number of 4-byte dests followed by table
         } else if ( op == Instruction::BEGINSUB ) {
-            m_beginSubs.push_back( pc );
+            a.beginSubs.push_back( pc );
         } else if ( op == Instruction::BEGINDATA ) {
             break;
         }
@@ -90,16 +97,16 @@ void LegacyVM::optimize() {
     TRACE_STR( 1, "Do first pass optimizations" )
     for ( size_t pc = 0; pc < nBytes; ++pc ) {
         u256 val = 0;
-        Instruction op = Instruction( m_code[pc] );
+        Instruction op = Instruction( code[pc] );
 
         if ( ( byte ) Instruction::PUSH1 <= ( byte ) op &&
              ( byte ) op <= ( byte ) Instruction::PUSH32 ) {
             byte nPush = ( byte ) op - ( byte ) Instruction::PUSH1 + 1;
 
             // decode pushed bytes to integral value
-            val = m_code[pc + 1];
+            val = code[pc + 1];
             for ( uint64_t i = pc + 2, n = nPush; --n; ++i ) {
-                val = ( val << 8 ) | m_code[i];
+                val = ( val << 8 ) | code[i];
             }
 
 #if EVM_USE_CONSTANT_POOL
@@ -108,16 +115,16 @@ void LegacyVM::optimize() {
             // place offset in code as 2 bytes MSB-first
             // followed by one byte count of remaining pushed bytes
             if ( 5 < nPush ) {
-                uint16_t pool_off = m_pool.size();
+                uint16_t pool_off = a.pool.size();
                 TRACE_VAL( 1, "stash", val );
                 TRACE_VAL( 1, "... in pool at offset", pool_off );
-                m_pool.push_back( val );
+                a.pool.push_back( val );
 
                 TRACE_PRE_OPT( 1, pc, op );
-                m_code[pc] = byte( op = Instruction::PUSHC );
-                m_code[pc + 3] = nPush - 2;
-                m_code[pc + 2] = pool_off & 0xff;
-                m_code[pc + 1] = pool_off >> 8;
+                code[pc] = byte( op = Instruction::PUSHC );
+                code[pc + 3] = nPush - 2;
+                code[pc + 2] = pool_off & 0xff;
+                code[pc + 1] = pool_off >> 8;
                 TRACE_POST_OPT( 1, pc, op );
             }
 
@@ -129,21 +136,21 @@ void LegacyVM::optimize() {
             // outer loop is N = number of bytes in code array
             // so complexity is N log M, worst case is N log N
             size_t i = pc + nPush + 1;
-            op = Instruction( m_code[i] );
+            op = Instruction( code[i] );
             if ( op == Instruction::JUMP ) {
                 TRACE_VAL( 1, "Replace const JUMP with JUMPC to", val )
                 TRACE_PRE_OPT( 1, i, op );
 
-                if ( 0 <= verifyJumpDest( val, false ) )
-                    m_code[i] = _byte_( op = Instruction::JUMPC );
+                if ( isJumpDest( a.jumpDests, val ) )
+                    code[i] = _byte_( op = Instruction::JUMPC );
 
                 TRACE_POST_OPT( 1, i, op );
             } else if ( op == Instruction::JUMPI ) {
                 TRACE_VAL( 1, "Replace const JUMPI with JUMPCI to", val )
                 TRACE_PRE_OPT( 1, i, op );
 
-                if ( 0 <= verifyJumpDest( val, false ) )
-                    m_code[i] = _byte_( op = Instruction::JUMPCI );
+                if ( isJumpDest( a.jumpDests, val ) )
+                    code[i] = _byte_( op = Instruction::JUMPCI );
 
                 TRACE_POST_OPT( 1, i, op );
             }
@@ -154,6 +161,14 @@ void LegacyVM::optimize() {
     }
     TRACE_STR( 1, "Finished optimizations" )
 #endif
+    return ret;
+}
+
+void LegacyVM::optimize() {
+    m_analyzed = AnalyzedCodeCache::instance().getOrAnalyze( AnalyzedCodeCache::Kind::Legacy,
+        m_ext->codeHash, m_ext->code.size(), [this]() { return analyze( m_ext->code ); } );
+    m_code = m_analyzed->code.data();
+    m_pool = m_analyzed->pool.data();
 }
 
 
@@ -165,22 +180,3 @@ void LegacyVM::initEntry() {
     initMetrics();
     optimize();
 }
-
-
-// Implementation of EXP.
-//
-// This implements exponentiation by squaring algorithm.
-// Is faster than boost::multiprecision::powm() because it avoids explicit
-// mod operation.
-// Do not inline it.
-u256 LegacyVM::exp256( u256 _base, u256 _exponent ) {
-    using boost::multiprecision::limb_type;
-    u256 result = 1;
-    while ( _exponent ) {
-        if ( static_cast< limb_type >( _exponent ) & 1 )  // If exponent is odd.
-            result *= _base;
-        _base *= _base;
-        _exponent >>= 1;
-    }
-    return result;
-}
@@ -0,0 +1,451 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file Uint256.h
+ * @date 2026
+ * Fixed width 256-bit arithmetic for the interpreters' hot opcodes.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace dev {
+namespace eth {
+
+/// Trivially copyable 256-bit unsigned integer of four 64-bit limbs, least significant first.
+/// Implements EVM arithmetic with wrap-around semantics and without heap or generic-backend
+/// overhead of boost::multiprecision; converts to and from u256 by copying limbs.
+struct Uint256 {
+    uint64_t w[4];
+
+    static Uint256 fromU256( u256 const& _v );
+    u256 toU256() const;
+
+    bool isZero() const { return ( w[0] | w[1] | w[2] | w[3] ) == 0; }
+    bool isNegative() const { return w[3] >> 63; }
+    /// @returns true if value fits into 64 bits
+    bool isSmall() const { return ( w[1] | w[2] | w[3] ) == 0; }
+
+    bool operator==( Uint256 const& _o ) const {
+        return w[0] == _o.w[0] && w[1] == _o.w[1] && w[2] == _o.w[2] && w[3] == _o.w[3];
+    }
+    bool operator!=( Uint256 const& _o ) const { return !( *this == _o ); }
+};
+
+static_assert( std::is_trivially_copyable< Uint256 >::value, "Uint256 must be trivially copyable" );
+static_assert( sizeof( boost::multiprecision::limb_type ) == sizeof( uint64_t ),
+    "Uint256 conversions expect 64-bit boost limbs" );
+
+namespace uint256 {
+
+using u128 = unsigned __int128;
+
+/// @returns ( _hi, _lo ) / _d, requires _hi < _d
+inline uint64_t div128by64( uint64_t _hi, uint64_t _lo, uint64_t _d, uint64_t& o_rem ) {
+#if defined( __x86_64__ )
+    // a single instruction, while u128 division is a libgcc call
+    uint64_t q;
+    __asm__( "divq %4" : "=a"( q ), "=d"( o_rem ) : "a"( _lo ), "d"( _hi ), "rm"( _d ) );
+    return q;
+#else
+    u128 const num = ( u128( _hi ) << 64 ) | _lo;
+    o_rem = uint64_t( num % _d );
+    return uint64_t( num / _d );
+#endif
+}
+
+/// @returns floor( ( 2^128 - 1 ) / _d ) - 2^64 for normalized @a _d (top bit set)
+inline uint64_t reciprocal2by1( uint64_t _d ) {
+    uint64_t rem;
+    return div128by64( ~_d, ~uint64_t( 0 ), _d, rem );
+}
+
+/// Division of ( _hi, _lo ) by normalized @a _d with its precomputed reciprocal @a _v,
+/// requires _hi < _d (Moller, Granlund "Improved division by invariant integers", alg. 4).
+inline uint64_t div2by1( uint64_t _hi, uint64_t _lo, uint64_t _d, uint64_t _v, uint64_t& o_rem ) {
+    u128 const q = u128( _v ) * _hi + ( ( u128( _hi ) << 64 ) | _lo );
+    uint64_t q1 = uint64_t( q >> 64 ) + 1;
+    uint64_t const q0 = uint64_t( q );
+    uint64_t r = _lo - q1 * _d;
+    if ( r > q0 ) {
+        --q1;
+        r += _d;
+    }
+    if ( r >= _d ) {
+        ++q1;
+        r -= _d;
+    }
+    o_rem = r;
+    return q1;
+}
+
+/// Schoolbook division of @a _m limbs by @a _n limbs (Knuth, TAOCP vol. 2, 4.3.1, algorithm D).
+/// Requires _m >= _n >= 1, _v[_n - 1] != 0 and _m <= 8. Writes _m - _n + 1 limbs of quotient
+/// to @a o_q (may be null) and _n limbs of remainder to @a o_r.
+inline void divModLimbs(
+    uint64_t const* _u, int _m, uint64_t const* _v, int _n, uint64_t* o_q, uint64_t* o_r ) {
+    if ( _n == 1 ) {
+        uint64_t rem = 0;
+        for ( int i = _m - 1; i >= 0; --i ) {
+            uint64_t const q = div128by64( rem, _u[i], _v[0], rem );
+            if ( o_q )
+                o_q[i] = q;
+        }
+        o_r[0] = rem;
+        return;
+    }
+
+    // normalize so that the top bit of divisor is set
+    int const s = __builtin_clzll( _v[_n - 1] );
+    uint64_t vn[4];
+    uint64_t un[9];
+    for ( int i = _n - 1; i > 0; --i )
+        vn[i] = ( _v[i] << s ) | ( s ? _v[i - 1] >> ( 64 - s ) : 0 );
+    vn[0] = _v[0] << s;
+    un[_m] = s ? _u[_m - 1] >> ( 64 - s ) : 0;
+    for ( int i = _m - 1; i > 0; --i )
+        un[i] = ( _u[i] << s ) | ( s ? _u[i - 1] >> ( 64 - s ) : 0 );
+    un[0] = _u[0] << s;
+    uint64_t const reciprocal = reciprocal2by1( vn[_n - 1] );
+
+    for ( int j = _m - _n; j >= 0; --j ) {
+        // estimate quotient limb from the top two limbs, it is at most one too large afterwards
+        uint64_t qhat, rhat;
+        bool rhatOverflow = false;
+        if ( un[j + _n] >= vn[_n - 1] ) {
+            // top limbs are equal, quotient limb would overflow
+            qhat = ~uint64_t( 0 );
+            u128 const r = u128( un[j + _n - 1] ) + vn[_n - 1];
+            rhat = uint64_t( r );
+            rhatOverflow = r >> 64;
+        } else {
+            qhat = div2by1( un[j + _n], un[j + _n - 1], vn[_n - 1], reciprocal, rhat );
+        }
+        while ( !rhatOverflow &&
+                u128( qhat ) * vn[_n - 2] > ( ( u128( rhat ) << 64 ) | un[j + _n - 2] ) ) {
+            --qhat;
+            u128 const r = u128( rhat ) + vn[_n - 1];
+            rhat = uint64_t( r );
+            rhatOverflow = r >> 64;
+        }
+
+        // multiply and subtract
+        uint64_t mulCarry = 0;
+        uint64_t borrow = 0;
+        for ( int i = 0; i < _n; ++i ) {
+            u128 const p = u128( qhat ) * vn[i] + mulCarry;
+            mulCarry = uint64_t( p >> 64 );
+            uint64_t const lo = uint64_t( p );
+            uint64_t const t = un[i + j] - lo;
+            uint64_t const b1 = un[i + j] < lo;
+            un[i + j] = t - borrow;
+            borrow = b1 + ( t < borrow );
+        }
+        uint64_t const t = un[j + _n] - mulCarry;
+        uint64_t const b1 = un[j + _n] < mulCarry;
+        un[j + _n] = t - borrow;
+        borrow = b1 + ( t < borrow );
+
+        uint64_t q = qhat;
+        if ( borrow ) {
+            // estimate was one too large, add divisor back
+            --q;
+            uint64_t carry = 0;
+            for ( int i = 0; i < _n; ++i ) {
+                u128 const sum = u128( un[i + j] ) + vn[i] + carry;
+                un[i + j] = uint64_t( sum );
+                carry = uint64_t( sum >> 64 );
+            }
+            un[j + _n] += carry;
+        }
+        if ( o_q )
+            o_q[j] = q;
+    }
+
+    for ( int i = 0; i < _n - 1; ++i )
+        o_r[i] = ( un[i] >> s ) | ( s ? un[i + 1] << ( 64 - s ) : 0 );
+    o_r[_n - 1] = un[_n - 1] >> s;
+}
+
+inline int significantLimbs( uint64_t const* _x, int _size ) {
+    while ( _size > 0 && _x[_size - 1] == 0 )
+        --_size;
+    return _size;
+}
+
+/// @returns remainder of @a _size limbs of @a _x divided by non-zero @a _mod
+inline Uint256 modLimbs( uint64_t const* _x, int _size, Uint256 const& _mod ) {
+    Uint256 r{};
+    int const m = significantLimbs( _x, _size );
+    int const n = significantLimbs( _mod.w, 4 );
+    if ( m < n ) {
+        std::memcpy( r.w, _x, m * sizeof( uint64_t ) );
+        return r;
+    }
+    divModLimbs( _x, m, _mod.w, n, nullptr, r.w );
+    return r;
+}
+
+inline Uint256 add( Uint256 const& _a, Uint256 const& _b ) {
+    Uint256 r;
+    uint64_t carry = 0;
+    for ( int i = 0; i < 4; ++i ) {
+        u128 const s = u128( _a.w[i] ) + _b.w[i] + carry;
+        r.w[i] = uint64_t( s );
+        carry = uint64_t( s >> 64 );
+    }
+    return r;
+}
+
+inline Uint256 sub( Uint256 const& _a, Uint256 const& _b ) {
+    Uint256 r;
+    uint64_t borrow = 0;
+    for ( int i = 0; i < 4; ++i ) {
+        uint64_t const t = _a.w[i] - _b.w[i];
+        uint64_t const b1 = _a.w[i] < _b.w[i];
+        r.w[i] = t - borrow;
+        borrow = b1 + ( t < borrow );
+    }
+    return r;
+}
+
+inline Uint256 negate( Uint256 const& _a ) {
+    return sub( Uint256{}, _a );
+}
+
+inline Uint256 mul( Uint256 const& _a, Uint256 const& _b ) {
+    Uint256 r{};
+    for ( int i = 0; i < 4; ++i ) {
+        uint64_t carry = 0;
+        for ( int j = 0; i + j < 4; ++j ) {
+            u128 const p = u128( _a.w[i] ) * _b.w[j] + r.w[i + j] + carry;
+            r.w[i + j] = uint64_t( p );
+            carry = uint64_t( p >> 64 );
+        }
+    }
+    return r;
+}
+
+/// Full 512-bit product in eight limbs, least significant first.
+inline void mulFull( Uint256 const& _a, Uint256 const& _b, uint64_t* o_r ) {
+    std::memset( o_r, 0, 8 * sizeof( uint64_t ) );
+    for ( int i = 0; i < 4; ++i ) {
+        uint64_t carry = 0;
+        for ( int j = 0; j < 4; ++j ) {
+            u128 const p = u128( _a.w[i] ) * _b.w[j] + o_r[i + j] + carry;
+            o_r[i + j] = uint64_t( p );
+            carry = uint64_t( p >> 64 );
+        }
+        o_r[i + 4] = carry;
+    }
+}
+
+/// @returns 0 on division by zero as EVM does
+inline Uint256 div( Uint256 const& _a, Uint256 const& _b ) {
+    Uint256 q{};
+    int const n = significantLimbs( _b.w, 4 );
+    int const m = significantLimbs( _a.w, 4 );
+    if ( n == 0 || m < n )
+        return q;
+    Uint256 r;
+    divModLimbs( _a.w, m, _b.w, n, q.w, r.w );
+    return q;
+}
+
+/// @returns 0 on division by zero as EVM does
+inline Uint256 mod( Uint256 const& _a, Uint256 const& _b ) {
+    if ( _b.isZero() )
+        return Uint256{};
+    return modLimbs( _a.w, 4, _b );
+}
+
+inline Uint256 sdiv( Uint256 const& _a, Uint256 const& _b ) {
+    bool const negA = _a.isNegative();
+    bool const negB = _b.isNegative();
+    Uint256 const q = div( negA ? negate( _a ) : _a, negB ? negate( _b ) : _b );
+    return negA != negB ? negate( q ) : q;
+}
+
+/// Sign of result follows dividend.
+inline Uint256 smod( Uint256 const& _a, Uint256 const& _b ) {
+    bool const negA = _a.isNegative();
+    Uint256 const r = mod( negA ? negate( _a ) : _a, _b.isNegative() ? negate( _b ) : _b );
+    return negA ? negate( r ) : r;
+}
+
+inline Uint256 addmod( Uint256 const& _a, Uint256 const& _b, Uint256 const& _m ) {
+    if ( _m.isZero() )
+        return Uint256{};
+    uint64_t s[5];
+    uint64_t carry = 0;
+    for ( int i = 0; i < 4; ++i ) {
+        u128 const t = u128( _a.w[i] ) + _b.w[i] + carry;
+        s[i] = uint64_t( t );
+        carry = uint64_t( t >> 64 );
+    }
+    s[4] = carry;
+    return modLimbs( s, 5, _m );
+}
+
+inline Uint256 mulmod( Uint256 const& _a, Uint256 const& _b, Uint256 const& _m ) {
+    if ( _m.isZero() )
+        return Uint256{};
+    uint64_t p[8];
+    mulFull( _a, _b, p );
+    return modLimbs( p, 8, _m );
+}
+
+inline Uint256 exp( Uint256 _base, Uint256 const& _exponent ) {
+    Uint256 r{ { 1, 0, 0, 0 } };
+    int const n = significantLimbs( _exponent.w, 4 );
+    for ( int i = 0; i < n; ++i ) {
+        uint64_t e = _exponent.w[i];
+        // top limb stops early when its remaining bits are zero
+        for ( int bit = 0; bit < 64 && ( i + 1 < n || e ); ++bit, e >>= 1 ) {
+            if ( e & 1 )
+                r = mul( r, _base );
+            _base = mul( _base, _base );
+        }
+    }
+    return r;
+}
+
+inline Uint256 shl( Uint256 const& _x, uint64_t _shift ) {
+    Uint256 r{};
+    if ( _shift >= 256 )
+        return r;
+    unsigned const limbs = unsigned( _shift / 64 );
+    unsigned const bits = unsigned( _shift % 64 );
+    for ( unsigned i = 3; i + 1 > limbs; --i ) {
+        r.w[i] = _x.w[i - limbs] << bits;
+        if ( bits && i > limbs )
+            r.w[i] |= _x.w[i - limbs - 1] >> ( 64 - bits );
+    }
+    return r;
+}
+
+inline Uint256 shr( Uint256 const& _x, uint64_t _shift ) {
+    Uint256 r{};
+    if ( _shift >= 256 )
+        return r;
+    unsigned const limbs = unsigned( _shift / 64 );
+    unsigned const bits = unsigned( _shift % 64 );
+    for ( unsigned i = 0; i + limbs < 4; ++i ) {
+        r.w[i] = _x.w[i + limbs] >> bits;
+        if ( bits && i + limbs + 1 < 4 )
+            r.w[i] |= _x.w[i + limbs + 1] << ( 64 - bits );
+    }
+    return r;
+}
+
+inline Uint256 sar( Uint256 const& _x, uint64_t _shift ) {
+    if ( !_x.isNegative() )
+        return shr( _x, _shift );
+    Uint256 const allBits{ { ~0ULL, ~0ULL, ~0ULL, ~0ULL } };
+    if ( _shift >= 256 )
+        return allBits;
+    // ~( ~x >> shift ) fills vacated bits with ones
+    Uint256 const inverted{ { ~_x.w[0], ~_x.w[1], ~_x.w[2], ~_x.w[3] } };
+    Uint256 r = shr( inverted, _shift );
+    for ( uint64_t& limb : r.w )
+        limb = ~limb;
+    return r;
+}
+
+/// Extends sign of the number of ( @a _byteIndex + 1 ) low bytes of @a _x.
+inline Uint256 signextend( uint64_t _byteIndex, Uint256 const& _x ) {
+    if ( _byteIndex >= 31 )
+        return _x;
+    unsigned const testBit = unsigned( _byteIndex ) * 8 + 7;
+    unsigned const limb = testBit / 64;
+    uint64_t const bitMask = uint64_t( 1 ) << ( testBit % 64 );
+    bool const negative = _x.w[limb] & bitMask;
+    uint64_t const lowMask = bitMask | ( bitMask - 1 );
+    Uint256 r = _x;
+    r.w[limb] = negative ? ( r.w[limb] | ~lowMask ) : ( r.w[limb] & lowMask );
+    for ( unsigned i = limb + 1; i < 4; ++i )
+        r.w[i] = negative ? ~0ULL : 0;
+    return r;
+}
+
+/// @returns byte @a _index of big-endian representation of @a _x, 0 if out of range
+inline Uint256 byteAt( uint64_t _index, Uint256 const& _x ) {
+    Uint256 r{};
+    if ( _index < 32 ) {
+        unsigned const bitFromLow = unsigned( 31 - _index ) * 8;
+        r.w[0] = ( _x.w[bitFromLow / 64] >> ( bitFromLow % 64 ) ) & 0xff;
+    }
+    return r;
+}
+
+}  // namespace uint256
+
+inline Uint256 Uint256::fromU256( u256 const& _v ) {
+    Uint256 r{};
+    auto const& backend = _v.backend();
+    std::memcpy( r.w, backend.limbs(), backend.size() * sizeof( uint64_t ) );
+    return r;
+}
+
+inline u256 Uint256::toU256() const {
+    u256 r;
+    auto& backend = r.backend();
+    backend.resize( 4, 4 );
+    std::memcpy( backend.limbs(), w, sizeof( w ) );
+    backend.normalize();
+    return r;
+}
+
+namespace uint256 {
+
+// u256 front-ends for the interpreters, operands are converted at the boundary
+
+inline u256 div( u256 const& _a, u256 const& _b ) {
+    return div( Uint256::fromU256( _a ), Uint256::fromU256( _b ) ).toU256();
+}
+inline u256 mod( u256 const& _a, u256 const& _b ) {
+    return mod( Uint256::fromU256( _a ), Uint256::fromU256( _b ) ).toU256();
+}
+inline u256 sdiv( u256 const& _a, u256 const& _b ) {
+    return sdiv( Uint256::fromU256( _a ), Uint256::fromU256( _b ) ).toU256();
+}
+inline u256 smod( u256 const& _a, u256 const& _b ) {
+    return smod( Uint256::fromU256( _a ), Uint256::fromU256( _b ) ).toU256();
+}
+inline u256 addmod( u256 const& _a, u256 const& _b, u256 const& _m ) {
+    return addmod( Uint256::fromU256( _a ), Uint256::fromU256( _b ), Uint256::fromU256( _m ) )
+        .toU256();
+}
+inline u256 mulmod( u256 const& _a, u256 const& _b, u256 const& _m ) {
+    return mulmod( Uint256::fromU256( _a ), Uint256::fromU256( _b ), Uint256::fromU256( _m ) )
+        .toU256();
+}
+inline u256 exp( u256 const& _base, u256 const& _exponent ) {
+    return exp( Uint256::fromU256( _base ), Uint256::fromU256( _exponent ) ).toU256();
+}
+
+}  // namespace uint256
+
+}  // namespace eth
+}  // namespace dev
@@ -18,6 +18,7 @@
 #include "VMFactory.h"
 #include "EVMC.h"
 #include "LegacyVM.h"
+#include "VMPool.h"
 
 #include <libskale-interpreter/interpreter.h>
 
@@ -51,6 +52,7 @@ struct VMKindTableEntry {
 /// so linear search only to parse command line arguments is not a problem.
 VMKindTableEntry vmKindsTable[] = {
     { VMKind::Interpreter, "interpreter" },
+    { VMKind::InterpreterFast, "interpreter-fast" },
     { VMKind::Legacy, "legacy" },
 };
 
@@ -168,17 +170,22 @@ VMPtr VMFactory::create() {
 VMPtr VMFactory::create( VMKind _kind ) {
     static const auto default_delete = []( VMFace* _vm ) noexcept { delete _vm; };
     static const auto null_delete = []( VMFace* ) noexcept {};
+    static const auto pool_delete = []( VMFace* _vm ) noexcept {
+        VMPool< LegacyVM >::give( static_cast< LegacyVM* >( _vm ) );
+    };
 
     switch ( _kind ) {
     case VMKind::Interpreter:
         return { new EVMC{ evmc_create_interpreter() }, default_delete };
+    case VMKind::InterpreterFast:
+        return { new EVMC{ evmc_create_interpreter_fast() }, default_delete };
     case VMKind::DLL:
         assert( g_evmcDll != nullptr );
         // Return "fake" owning pointer to global EVMC DLL VM.
         return { g_evmcDll.get(), null_delete };
     case VMKind::Legacy:
     default:
-        return { new LegacyVM, default_delete };
+        return { VMPool< LegacyVM >::take(), pool_delete };
     }
 }
 }  // namespace eth
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file VMPool.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dev {
+namespace eth {
+
+/// Per-thread free list of interpreter instances. Interpreters keep their memory, return data
+/// and stack buffers between executions, so a reused instance does not allocate once its
+/// buffers have grown to the size the workload needs. Nested calls take instances in LIFO
+/// order, which makes every call depth reuse the same instance and its buffers.
+///
+/// @a VM must be default constructible and provide recycle( size_t _maxRetained ), called
+/// before an instance goes back to the free list.
+template < class VM >
+class VMPool {
+public:
+    /// Instances kept per thread; deeper call chains allocate the rest.
+    static const size_t c_maxPooled = 64;
+    /// Buffers larger than this are freed instead of being kept in the pool.
+    static const size_t c_maxRetainedMemory = 1024 * 1024;
+
+    static VM* take() {
+        auto& vms = freeList().vms;
+        if ( vms.empty() )
+            return new VM;
+        VM* vm = vms.back();
+        vms.pop_back();
+        return vm;
+    }
+
+    static void give( VM* _vm ) noexcept {
+        auto& vms = freeList().vms;
+        if ( vms.size() >= c_maxPooled ) {
+            delete _vm;
+            return;
+        }
+        _vm->recycle( c_maxRetainedMemory );
+        vms.push_back( _vm );
+    }
+
+    /// @returns number of idle instances in the calling thread's free list.
+    static size_t idle() { return freeList().vms.size(); }
+
+private:
+    struct FreeList {
+        FreeList() { vms.reserve( c_maxPooled ); }
+        ~FreeList() {
+            for ( VM* vm : vms )
+                delete vm;
+        }
+        std::vector< VM* > vms;
+    };
+
+    static FreeList& freeList() {
+        thread_local FreeList t_freeList;
+        return t_freeList;
+    }
+};
+
+}  // namespace eth
+}  // namespace dev
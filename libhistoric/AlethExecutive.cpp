@@ -10,6 +10,7 @@
 #include "libethereum/Block.h"
 #include "libethereum/BlockChain.h"
 #include "libethereum/Interface.h"
+#include "libevm/ExecutionBudget.h"
 #include "libevm/LegacyVM.h"
 #include "libevm/VMFactory.h"
 #include <libhistoric/HistoricState.h>
@@ -314,6 +315,9 @@ bool AlethExecutive::go( OnOpFunc const& _onOp ) {
         Timer t;
 #endif
         try {
+            if ( auto* budget = ExecutionBudget::current() )
+                budget->charge( 0 );
+
             // Create VM instance. Force Interpreter if tracing requested.
             auto vm = VMFactory::create();
             if ( m_isCreation ) {
@@ -356,6 +360,9 @@ bool AlethExecutive::go( OnOpFunc const& _onOp ) {
                    << *boost::get_error_info< errinfo_evmcStatusCode >( _e ) << ")";
             revert();
             throw;
+        } catch ( ExecutionBudgetExceeded const& ) {
+            revert();
+            throw;
         } catch ( Exception const& _e ) {
             // TODO: AUDIT: check that this can never reasonably happen. Consider what to do if it
             // does.
@@ -6,7 +6,8 @@
 // Copyright 2013-2019 Aleth Authors.
 // Licensed under the GNU General Public License, Version 3.
 #include "AlethExtVM.h"
-#include "boost/thread.hpp"
+#include "libdevcore/DeepStackPool.h"
+#include "libevm/ExecutionBudget.h"
 #include "libethereum/LastBlockHashesFace.h"
 #include "libhistoric/AlethExecutive.h"
 #include <exception>
@@ -41,27 +42,15 @@ static unsigned const c_offloadPoint =
     ( c_defaultStackSize - c_entryOverhead ) / c_singleExecutionStackSize;
 
 void goOnOffloadedStack( AlethExecutive& _e, OnOpFunc const& _onOp ) {
-    // Set new stack size enouth to handle the rest of the calls up to the limit.
-    boost::thread::attributes attrs;
-    attrs.set_stack_size( ( c_depthLimit - c_offloadPoint ) * c_singleExecutionStackSize );
-
-    // Create new thread with big stack and join immediately.
-    // TODO: It is possible to switch the implementation to Boost.Context or similar when the API is
-    // stable.
-    boost::exception_ptr exception;
-    boost::thread{
-        attrs,
-        [&] {
-            try {
-                _e.go( _onOp );
-            } catch ( ... ) {
-                exception = boost::current_exception();  // Catch all exceptions to be rethrown in
-                                                         // parent thread.
-            }
-        }
-    }.join();
-    if ( exception )
-        boost::rethrow_exception( exception );
+    // Threads with stack enough to handle the rest of the calls up to the limit, kept between
+    // offloads so that deep call chains do not start a thread each time.
+    static DeepStackPool s_pool( ( c_depthLimit - c_offloadPoint ) * c_singleExecutionStackSize );
+    // the budget of an RPC call is per thread, the offloaded frames spend it all the same
+    ExecutionBudget* const budget = ExecutionBudget::current();
+    s_pool.run( [&] {
+        ExecutionBudget::Scope scope( budget );
+        _e.go( _onOp );
+    } );
 }
 
 void go( unsigned _depth, AlethExecutive& _e, OnOpFunc const& _onOp ) {
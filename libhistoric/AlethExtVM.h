@@ -29,13 +29,13 @@ class SealEngineFace;
 /// Externality interface for the Virtual Machine providing access to world state.
 class AlethExtVM : public ExtVMFace {
 public:
-    /// Full constructor.
+    /// Full constructor, @a _code is shared with the caller.
     AlethExtVM( HistoricState& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine,
         Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice,
-        bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash, u256 const& _version,
+        bytesConstRef _data, SharedBytes _code, h256 const& _codeHash, u256 const& _version,
         unsigned _depth, bool _isCreate, bool _staticCall )
         : ExtVMFace( _envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data,
-              _code.toBytes(), _codeHash, _version, _depth, _isCreate, _staticCall ),
+              std::move( _code ), _codeHash, _version, _depth, _isCreate, _staticCall ),
           m_s( _s ),
           m_sealEngine( _sealEngine ),
           m_evmSchedule( initEvmSchedule( envInfo().number(), _version ) ) {
@@ -45,6 +45,15 @@ public:
         assert( m_s.addressInUse( _myAddress ) );
     }
 
+    /// Full constructor, copies @a _code.
+    AlethExtVM( HistoricState& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine,
+        Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice,
+        bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash, u256 const& _version,
+        unsigned _depth, bool _isCreate, bool _staticCall )
+        : AlethExtVM( _s, _envInfo, _sealEngine, _myAddress, _caller, _origin, _value, _gasPrice,
+              _data, SharedBytes( _code.toBytes() ), _codeHash, _version, _depth, _isCreate,
+              _staticCall ) {}
+
     /// Read storage location.
     u256 store( u256 _n ) final { return m_s.storage( myAddress, _n ); }
 
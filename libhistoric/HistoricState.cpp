@@ -494,10 +494,16 @@ bytes const& HistoricState::code( Address const& _addr ) const {
         return NullBytes;
 
     if ( a->code().empty() ) {
-        // Load the code from the backend.
         HistoricAccount* mutableAccount = const_cast< HistoricAccount* >( a );
+        auto& codeCache = CodeSizeCache::instance();
+        if ( auto cached = codeCache.code( a->codeHash() ) ) {
+            mutableAccount->noteCode( ref( *cached ) );
+            return a->code();
+        }
+
+        // Load the code from the backend.
         mutableAccount->noteCode( m_db.lookup( a->codeHash() ) );
-        CodeSizeCache::instance().store( a->codeHash(), a->code().size() );
+        codeCache.storeCode( a->codeHash(), a->code() );
     }
 
     return a->code();
@@ -523,14 +529,12 @@ size_t HistoricState::codeSize( Address const& _a ) const {
         if ( a->hasNewCode() )
             return a->code().size();
         auto& codeSizeCache = CodeSizeCache::instance();
-        h256 codeHash = a->codeHash();
-        if ( codeSizeCache.contains( codeHash ) )
-            return codeSizeCache.get( codeHash );
-        else {
-            size_t size = code( _a ).size();
-            codeSizeCache.store( codeHash, size );
+        size_t size;
+        if ( codeSizeCache.get( a->codeHash(), size ) )
             return size;
-        }
+        size = code( _a ).size();
+        codeSizeCache.store( a->codeHash(), size );
+        return size;
     } else
         return 0;
 }
@@ -767,12 +771,27 @@ AddressHash HistoricState::commitExternalChangesIntoTrieDB(
 
                 SecureTrieDB< h256, OverlayDB > storageDB( _state.db(), storageRoot );
 
-                for ( auto const& j : i.second.storageOverlay() ) {
+                // hash all keys of the account at once, sha3Batch hashes several in parallel
+                auto const& storageOverlay = i.second.storageOverlay();
+                std::vector< h256 > keys;
+                std::vector< bytesConstRef > keyRefs;
+                keys.reserve( storageOverlay.size() );
+                keyRefs.reserve( storageOverlay.size() );
+                for ( auto const& j : storageOverlay )
+                    keys.push_back( h256( j.first ) );
+                for ( h256 const& key : keys )
+                    keyRefs.push_back( key.ref() );
+                std::vector< h256 > keyHashes( keys.size() );
+                sha3Batch( keyRefs.data(), keyHashes.data(), keys.size() );
+
+                size_t k = 0;
+                for ( auto const& j : storageOverlay ) {
                     if ( j.second ) {
-                        storageDB.insert( j.first, rlp( j.second ) );
-
+                        bytes const value = rlp( j.second );
+                        storageDB.insertHashed( keyHashes[k], keyRefs[k], &value );
                     } else
-                        storageDB.remove( j.first );
+                        storageDB.removeHashed( keyHashes[k] );
+                    ++k;
                 }
                 assert( storageDB.root() );
                 s.append( storageDB.root() );
@@ -18,6 +18,10 @@
 #include "VM.h"
 #include "interpreter.h"
 
+#include <libevm/ExecutionBudget.h>
+#include <libevm/Uint256.h>
+#include <libevm/VMPool.h>
+
 #include <skale/version.h>
 
 namespace {
@@ -30,20 +34,16 @@ evmc_capabilities_flagset getCapabilities( evmc_instance* _instance ) noexcept {
     return EVMC_CAPABILITY_EVM1;
 }
 
-void delete_output( const evmc_result* result ) {
-    delete[] result->output_data;
-}
-
-evmc_result execute( evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
+evmc_result execute( bool _fast, evmc_context* _context, evmc_revision _rev,
     const evmc_message* _msg, uint8_t const* _code, size_t _codeSize ) noexcept {
-    ( void ) _instance;
-    std::unique_ptr< dev::eth::VM > vm{ new dev::eth::VM };
+    std::unique_ptr< dev::eth::VM, void ( * )( dev::eth::VM* ) > vm{
+        dev::eth::VMPool< dev::eth::VM >::take(), &dev::eth::VMPool< dev::eth::VM >::give };
 
     evmc_result result = {};
     dev::eth::owning_bytes_ref output;
 
     try {
-        output = vm->exec( _context, _rev, _msg, _code, _codeSize );
+        output = vm->exec( _context, _rev, _msg, _code, _codeSize, _fast );
         result.status_code = EVMC_SUCCESS;
         result.gas_left = vm->m_io_gas;
     } catch ( dev::eth::RevertInstruction& ex ) {
@@ -72,17 +72,24 @@ evmc_result execute( evmc_instance* _instance, evmc_context* _context, evmc_revi
         result.status_code = EVMC_INTERNAL_ERROR;
     }
 
-    if ( !output.empty() ) {
-        // Make a copy of the output.
-        auto outputData = new uint8_t[output.size()];
-        std::memcpy( outputData, output.data(), output.size() );
-        result.output_data = outputData;
-        result.output_size = output.size();
-        result.release = delete_output;
-    }
+    // The output stays in the memory of the execution, shared with the caller.
+    if ( !output.empty() )
+        dev::eth::shareOutput( result, output );
 
     return result;
 }
+
+evmc_result execute( evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
+    const evmc_message* _msg, uint8_t const* _code, size_t _codeSize ) noexcept {
+    ( void ) _instance;
+    return execute( false, _context, _rev, _msg, _code, _codeSize );
+}
+
+evmc_result executeFast( evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
+    const evmc_message* _msg, uint8_t const* _code, size_t _codeSize ) noexcept {
+    ( void ) _instance;
+    return execute( true, _context, _rev, _msg, _code, _codeSize );
+}
 }  // namespace
 
 extern "C" evmc_instance* evmc_create_interpreter() noexcept {
@@ -98,23 +105,32 @@ extern "C" evmc_instance* evmc_create_interpreter() noexcept {
     return &s_instance;
 }
 
+extern "C" void skale_interpreter_set_budget_hook( skale_interpreter_budget_fn _hook ) noexcept {
+    dev::eth::VM::s_budgetHook.store( _hook, std::memory_order_relaxed );
+}
+
+extern "C" evmc_instance* evmc_create_interpreter_fast() noexcept {
+    static evmc_instance s_instance{
+        EVMC_ABI_VERSION, "interpreter-fast", skale_version, ::destroy, ::executeFast,
+        getCapabilities,
+        nullptr,  // set_tracer
+        nullptr,  // set_option
+    };
+    static bool metricsInited = dev::eth::VM::initMetrics();
+    ( void ) metricsInited;
+
+    return &s_instance;
+}
+
 
 namespace dev {
 namespace eth {
+std::atomic< skale_interpreter_budget_fn > VM::s_budgetHook{ nullptr };
+
 uint64_t VM::memNeed( u256 const& _offset, u256 const& _size ) {
     return toInt63( _size ? u512( _offset ) + _size : u512( 0 ) );
 }
 
-template < class S >
-S divWorkaround( S const& _a, S const& _b ) {
-    return ( S )( s512( _a ) / s512( _b ) );
-}
-
-template < class S >
-S modWorkaround( S const& _a, S const& _b ) {
-    return ( S )( s512( _a ) % s512( _b ) );
-}
-
 
 //
 // for decoding destinations of JUMPTO, JUMPV, JUMPSUB and JUMPSUBV
@@ -170,7 +186,7 @@ uint64_t VM::gasForMem( u512 const& _size ) {
 
 void VM::updateIOGas() {
     if ( m_io_gas < m_runGas )
-        throwOutOfGas();
+        outOfGas();
     m_io_gas -= m_runGas;
 }
 
@@ -179,14 +195,53 @@ void VM::updateGas() {
         m_runGas += toInt63( gasForMem( m_newMemSize ) - gasForMem( m_mem.size() ) );
     m_runGas += ( VMSchedule::copyGas * ( ( m_copyMemSize + 31 ) / 32 ) );
     if ( m_io_gas < m_runGas )
-        throwOutOfGas();
+        outOfGas();
+}
+
+void VM::outOfGas() {
+    // the block may have been charged for instructions the original code would not reach
+    if ( m_blockChecked ) {
+        leaveBlock();
+        if ( m_io_gas >= m_runGas )
+            return;
+    }
+    throwOutOfGas();
+}
+
+//
+// Enter the basic block at _pc. If its gas and stack bounds fit, they are charged and checked
+// here and its instructions only do their dynamic part, otherwise they are checked one by one
+// as in the original code. Either way gas used and exceptions are those of the original code.
+//
+void VM::beginBlock( uint64_t _pc ) {
+    m_block = &m_blocks[m_blockAt[_pc]];
+    int64_t const stack = m_stackEnd - m_SPP;
+    m_blockChecked = m_io_gas >= m_block->gas && stack >= m_block->stackNeeded &&
+                     stack + m_block->stackGrowth <= VMSchedule::stackLimit;
+    if ( m_blockChecked ) {
+        m_io_gas -= m_block->gas;
+        m_metrics = &s_blockMetrics[m_rev];
+    } else
+        m_metrics = &s_metrics[m_rev];
 }
 
 void VM::updateMem( uint64_t _newMem ) {
     m_newMemSize = ( _newMem + 31 ) / 32 * 32;
     updateGas();
-    if ( m_newMemSize > m_mem.size() )
+    if ( m_newMemSize > m_mem.size() ) {
+        // grow capacity geometrically, gas is charged for the logical size only
+        if ( m_newMemSize > m_mem.capacity() )
+            m_mem.reserve( std::max< uint64_t >( m_newMemSize, 2 * m_mem.capacity() ) );
         m_mem.resize( m_newMemSize );
+    }
+}
+
+/// Copies returned memory out, so that the memory buffer stays with the instance for reuse.
+owning_bytes_ref VM::copyMemory( uint64_t _offset, uint64_t _size ) const {
+    if ( !_size )
+        return owning_bytes_ref();
+    auto const begin = m_mem.begin() + _offset;
+    return owning_bytes_ref{ bytes( begin, begin + _size ), 0, _size };
 }
 
 void VM::logGasMem() {
@@ -200,7 +255,13 @@ void VM::logGasMem() {
 void VM::fetchInstruction() {
     m_OP = Instruction( m_code[m_PC] );
     auto const metric = ( *m_metrics )[static_cast< size_t >( m_OP )];
-    adjustStack( metric.num_stack_arguments, metric.num_stack_returned_items );
+    if ( m_blockChecked ) {
+        m_SP = m_SPP;
+        m_SPP += metric.num_stack_arguments;
+        m_SPP -= metric.num_stack_returned_items;
+    } else
+        adjustStack( metric.num_stack_arguments, metric.num_stack_returned_items );
+    ++m_steps;
 
     // FEES...
     m_runGas = metric.gas_cost;
@@ -220,7 +281,7 @@ evmc_tx_context const& VM::getTxContext() {
 // interpreter entry point
 
 owning_bytes_ref VM::exec( evmc_context* _context, evmc_revision _rev, const evmc_message* _msg,
-    uint8_t const* _code, size_t _codeSize ) {
+    uint8_t const* _code, size_t _codeSize, bool _fast ) {
     m_context = _context;
     m_rev = _rev;
     m_metrics = &s_metrics[m_rev];
@@ -229,6 +290,19 @@ owning_bytes_ref VM::exec( evmc_context* _context, evmc_revision _rev, const evm
     m_PC = 0;
     m_pCode = _code;
     m_codeSize = _codeSize;
+    m_fast = _fast;
+
+    // instance may come from VMPool, start from clean interpreter state
+    m_tx_context.reset();
+    m_SP = m_SPP = m_stackEnd;
+    m_nSteps = 0;
+    m_budgetHook = s_budgetHook.load( std::memory_order_relaxed );
+    m_steps = m_chargedSteps = 0;
+    m_runGas = m_newMemSize = m_copyMemSize = 0;
+    m_block = nullptr;
+    m_blockChecked = false;
+    m_mem.clear();
+    m_returnData = SharedBytes();
 
     // trampoline to minimize depth of call stack when calling out
     m_bounce = &VM::initEntry;
@@ -236,9 +310,18 @@ owning_bytes_ref VM::exec( evmc_context* _context, evmc_revision _rev, const evm
         ( this->*m_bounce )();
     while ( m_bounce );
 
+    if ( m_budgetHook )
+        chargeBudget();
     return std::move( m_output );
 }
 
+void VM::chargeBudget() {
+    uint64_t const steps = m_steps - m_chargedSteps;
+    m_chargedSteps = m_steps;
+    if ( !m_budgetHook( steps ) )
+        BOOST_THROW_EXCEPTION( InternalVMError() );
+}
+
 //
 // main interpreter loop and switch
 //
@@ -292,7 +375,7 @@ void VM::interpretCases() {
 
             uint64_t b = ( uint64_t ) m_SP[0];
             uint64_t s = ( uint64_t ) m_SP[1];
-            m_output = owning_bytes_ref{ std::move( m_mem ), b, s };
+            m_output = copyMemory( b, s );
             m_bounce = 0;
         }
         BREAK
@@ -309,7 +392,7 @@ void VM::interpretCases() {
 
             uint64_t b = ( uint64_t ) m_SP[0];
             uint64_t s = ( uint64_t ) m_SP[1];
-            owning_bytes_ref output{ std::move( m_mem ), b, s };
+            owning_bytes_ref output = copyMemory( b, s );
             throwRevertInstruction( std::move( output ) );
         }
         BREAK;
@@ -389,8 +472,12 @@ void VM::interpretCases() {
             uint64_t inOff = ( uint64_t ) m_SP[0];
             uint64_t inSize = ( uint64_t ) m_SP[1];
 
-            const auto h = ethash::keccak256( m_mem.data() + inOff, inSize );
-            m_SPP[0] = static_cast< u256 >( h256{ h.bytes, h256::ConstructFromPointer } );
+            if ( inSize == 64 )
+                m_SPP[0] = static_cast< u256 >( sha3Cached64( m_mem.data() + inOff ) );
+            else {
+                const auto h = ethash::keccak256( m_mem.data() + inOff, inSize );
+                m_SPP[0] = static_cast< u256 >( h256{ h.bytes, h256::ConstructFromPointer } );
+            }
         }
         NEXT
 
@@ -496,7 +583,7 @@ void VM::interpretCases() {
             updateIOGas();
 
             u256 base = m_SP[0];
-            m_SPP[0] = exp256( base, expon );
+            m_SPP[0] = uint256::exp( base, expon );
         }
         NEXT
 
@@ -534,7 +621,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? divWorkaround( m_SP[0], m_SP[1] ) : 0;
+            m_SPP[0] = uint256::div( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -542,7 +629,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? s2u( divWorkaround( u2s( m_SP[0] ), u2s( m_SP[1] ) ) ) : 0;
+            m_SPP[0] = uint256::sdiv( m_SP[0], m_SP[1] );
             --m_SP;
         }
         NEXT
@@ -551,7 +638,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? modWorkaround( m_SP[0], m_SP[1] ) : 0;
+            m_SPP[0] = uint256::mod( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -559,7 +646,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? s2u( modWorkaround( u2s( m_SP[0] ), u2s( m_SP[1] ) ) ) : 0;
+            m_SPP[0] = uint256::smod( m_SP[0], m_SP[1] );
         }
         NEXT
 
@@ -713,7 +800,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[2] ? u256( ( u512( m_SP[0] ) + u512( m_SP[1] ) ) % m_SP[2] ) : 0;
+            m_SPP[0] = uint256::addmod( m_SP[0], m_SP[1], m_SP[2] );
         }
         NEXT
 
@@ -721,7 +808,7 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[2] ? u256( ( u512( m_SP[0] ) * u512( m_SP[1] ) ) % m_SP[2] ) : 0;
+            m_SPP[0] = uint256::mulmod( m_SP[0], m_SP[1], m_SP[2] );
         }
         NEXT
 
@@ -908,7 +995,7 @@ void VM::interpretCases() {
             updateMem( memNeed( m_SP[0], m_SP[2] ) );
             updateIOGas();
 
-            copyDataToMemory( &m_returnData, m_SP );
+            copyDataToMemory( m_returnData, m_SP );
         }
         NEXT
 
@@ -1056,7 +1143,6 @@ void VM::interpretCases() {
         NEXT
 
         CASE( PUSHC ) {
-#if EVM_USE_CONSTANT_POOL
             ON_OP();
             updateIOGas();
 
@@ -1069,9 +1155,6 @@ void VM::interpretCases() {
             m_PC += m_code[m_PC];
             m_SPP[0] = m_pool[off];
             TRACE_VAL( 2, "Retrieved pooled const", m_SPP[0] );
-#else
-            throwBadInstruction();
-#endif
         }
         CONTINUE
 
@@ -1140,38 +1223,146 @@ void VM::interpretCases() {
             updateIOGas();
             if ( m_SP[1] )
                 m_PC = verifyJumpDest( m_SP[0] );
-            else
+            else {
                 ++m_PC;
+                if ( m_fast )
+                    beginBlock( m_PC );
+            }
         }
         CONTINUE
 
         CASE( JUMPC ) {
-#if EVM_REPLACE_CONST_JUMP
             ON_OP();
             updateIOGas();
 
             m_PC = uint64_t( m_SP[0] );
-#else
-            throwBadInstruction();
-#endif
         }
         CONTINUE
 
         CASE( JUMPCI ) {
-#if EVM_REPLACE_CONST_JUMP
             ON_OP();
             updateIOGas();
 
             if ( m_SP[1] )
                 m_PC = uint64_t( m_SP[0] );
-            else
+            else {
                 ++m_PC;
-#else
-            throwBadInstruction();
-#endif
+                if ( m_fast )
+                    beginBlock( m_PC );
+            }
         }
         CONTINUE
 
+        //
+        // Superinstructions, generated only for interpreter-fast. Every instruction of the
+        // sequence is fetched as usual, so stack and gas are accounted as for the original
+        // code, only the dispatch between them and verification of jumps are saved.
+        // Values consumed within the sequence are not written to the stack.
+        //
+
+        CASE( PUSH2JUMP ) {
+            ON_OP();
+            updateIOGas();
+            uint64_t const dest = ( m_code[m_PC + 1] << 8 ) | m_code[m_PC + 2];
+            m_PC += 3;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            m_PC = dest;
+        }
+        CONTINUE
+
+        CASE( PUSH2JUMPI ) {
+            ON_OP();
+            updateIOGas();
+            uint64_t const dest = ( m_code[m_PC + 1] << 8 ) | m_code[m_PC + 2];
+            m_PC += 3;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            if ( m_SP[1] )
+                m_PC = dest;
+            else
+                beginBlock( ++m_PC );
+        }
+        CONTINUE
+
+        CASE( ISZEROPUSH2JUMPI ) {
+            ON_OP();
+            updateIOGas();
+            bool const jump = !m_SP[0];
+            ++m_PC;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            uint64_t const dest = ( m_code[m_PC + 1] << 8 ) | m_code[m_PC + 2];
+            m_PC += 3;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            if ( jump )
+                m_PC = dest;
+            else
+                beginBlock( ++m_PC );
+        }
+        CONTINUE
+
+        CASE( PUSH1MSTORE ) {
+            ON_OP();
+            updateIOGas();
+            uint64_t const offset = m_code[m_PC + 1];
+            m_PC += 2;
+
+            fetchInstruction();
+            ON_OP();
+            updateMem( offset + 32 );
+            updateIOGas();
+            *( h256* ) &m_mem[offset] = ( h256 ) m_SP[1];
+        }
+        NEXT
+
+        CASE( SWAP1POP ) {
+            ON_OP();
+            updateIOGas();
+            m_SP[1] = m_SP[0];
+            ++m_PC;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+        }
+        NEXT
+
+        CASE( DUP2DUP2 ) {
+            ON_OP();
+            updateIOGas();
+            new ( m_SPP ) u256( m_SP[1] );
+            ++m_PC;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            new ( m_SPP ) u256( m_SP[1] );
+        }
+        NEXT
+
+        CASE( SWAP2SWAP1 ) {
+            ON_OP();
+            updateIOGas();
+            std::swap( m_SP[0], m_SP[2] );
+            ++m_PC;
+
+            fetchInstruction();
+            ON_OP();
+            updateIOGas();
+            std::swap( m_SP[0], m_SP[1] );
+        }
+        NEXT
+
         CASE( DUP1 )
         CASE( DUP2 )
         CASE( DUP3 )
@@ -1272,7 +1463,10 @@ void VM::interpretCases() {
             ON_OP();
             updateIOGas();
 
+            // ends its basic block, so the gas of the rest of the code is not charged yet
             m_SPP[0] = m_io_gas;
+            if ( m_fast )
+                beginBlock( m_PC + 1 );
         }
         NEXT
 
@@ -1280,6 +1474,11 @@ void VM::interpretCases() {
             m_runGas = VMSchedule::jumpdestGas;
             ON_OP();
             updateIOGas();
+            if ( m_fast )
+                beginBlock( m_PC + 1 );
+            // every loop passes a JUMPDEST, so long executions are checked here
+            if ( m_budgetHook && m_steps - m_chargedSteps >= ExecutionBudget::c_chargeInterval )
+                chargeBudget();
         }
         NEXT
 
@@ -18,7 +18,9 @@
 #pragma once
 
 #include "VMConfig.h"
+#include "interpreter.h"
 
+#include <libevm/AnalyzedCodeCache.h>
 #include <libevm/VMFace.h>
 
 #include <evmc/evmc.h>
@@ -26,6 +28,8 @@
 
 #include <boost/optional.hpp>
 
+#include <atomic>
+
 namespace dev {
 namespace eth {
 
@@ -63,11 +67,30 @@ public:
 
     VM() = default;
 
+    /// @param _fast  run code with superinstructions and gas and stack checked per basic block,
+    ///               as interpreter-fast does
     owning_bytes_ref exec( evmc_context* _context, evmc_revision _rev, const evmc_message* _msg,
-        uint8_t const* _code, size_t _codeSize );
+        uint8_t const* _code, size_t _codeSize, bool _fast = false );
 
     uint64_t m_io_gas = 0;
 
+    static std::atomic< skale_interpreter_budget_fn > s_budgetHook;
+
+    /// Prepares the instance for reuse by VMPool: drops buffers grown above @a _maxRetained
+    /// bytes and the reference to analyzed code, smaller buffers serve the next execution.
+    void recycle( size_t _maxRetained ) {
+        if ( m_mem.capacity() > _maxRetained )
+            bytes().swap( m_mem );
+        m_returnData = SharedBytes();
+        m_output = owning_bytes_ref();
+        m_analyzed.reset();
+        m_code = nullptr;
+        m_blocks = nullptr;
+        m_blockAt = nullptr;
+        m_block = nullptr;
+        m_pool = nullptr;
+    }
+
 private:
     evmc_context* m_context = nullptr;
     evmc_revision m_rev = EVMC_FRONTIER;
@@ -76,12 +99,21 @@ private:
     boost::optional< evmc_tx_context > m_tx_context;
     static std::array< std::array< evmc_instruction_metrics, 256 >, EVMC_MAX_REVISION + 1 >
         s_metrics;
-    static u256 exp256( u256 _base, u256 _exponent );
-    void copyCode( int );
+    // metrics inside a basic block charged on entry, gas_cost is the part not charged there
+    static std::array< std::array< evmc_instruction_metrics, 256 >, EVMC_MAX_REVISION + 1 >
+        s_blockMetrics;
+    // gas of an instruction charged on entry to its basic block, the same in all revisions
+    static std::array< int16_t, 256 > s_blockGas;
     typedef void ( VM::*MemFnPtr )();
     MemFnPtr m_bounce = nullptr;
     uint64_t m_nSteps = 0;
 
+    // budget hook of this execution and instructions executed and charged to it
+    skale_interpreter_budget_fn m_budgetHook = nullptr;
+    uint64_t m_steps = 0;
+    uint64_t m_chargedSteps = 0;
+    void chargeBudget();
+
     // return bytes
     owning_bytes_ref m_output;
 
@@ -90,11 +122,20 @@ private:
 
     uint8_t const* m_pCode = nullptr;
     size_t m_codeSize = 0;
-    // space for code
-    bytes m_code;
+    // analyzed code shared with other executions, and raw pointers into it
+    AnalyzedCodePtr m_analyzed;
+    _byte_ const* m_code = nullptr;
+    bool m_fast = false;
+
+    // basic blocks of the code by offset, the one being run and whether its gas and stack
+    // bounds were checked on entry
+    BasicBlock const* m_blocks = nullptr;
+    uint32_t const* m_blockAt = nullptr;
+    BasicBlock const* m_block = nullptr;
+    bool m_blockChecked = false;
 
-    /// RETURNDATA buffer for memory returned from direct subcalls.
-    bytes m_returnData;
+    /// RETURNDATA of the last direct subcall, shares the memory of the callee.
+    SharedBytes m_returnData;
 
     // space for data stack, grows towards smaller addresses from the end
     u256 m_stack[VMSchedule::stackLimit];
@@ -102,7 +143,7 @@ private:
     size_t stackSize() { return m_stackEnd - m_SP; }
 
     // constant pool
-    std::vector< u256 > m_pool;
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -118,6 +159,10 @@ private:
     // initialize interpreter
     void initEntry();
     void optimize();
+    static AnalyzedCodePtr analyze( uint8_t const* _code, size_t _codeSize, bool _fast );
+    static void analyzeBlocks( AnalyzedCode& _a );
+    void beginBlock( uint64_t _pc );
+    void leaveBlock();
 
     // interpreter loop & switch
     void interpretCases();
@@ -125,6 +170,7 @@ private:
     // interpreter cases that call out
     void caseCreate();
     bool caseCallSetup( evmc_message& _msg, bytesRef& o_output );
+    owning_bytes_ref copyMemory( uint64_t _offset, uint64_t _size ) const;
     void caseCall();
 
     void copyDataToMemory( bytesConstRef _data, u256* _sp );
@@ -133,6 +179,7 @@ private:
     const evmc_tx_context& getTxContext();
 
     void throwOutOfGas();
+    void outOfGas();
     void throwInvalidInstruction();
     void throwBadInstruction();
     void throwBadJumpDestination();
@@ -141,8 +188,6 @@ private:
     void throwDisallowedStateChange();
     void throwBufferOverrun( bigint const& _enfOfAccess );
 
-    std::vector< uint64_t > m_beginSubs;
-    std::vector< uint64_t > m_jumpDests;
     int64_t verifyJumpDest( u256 const& _dest, bool _throw = true );
 
     void onOperation() {}
@@ -19,6 +19,24 @@
 
 namespace dev {
 namespace eth {
+namespace {
+/// Takes over @a _result, keeping its output alive as long as the return data is used.
+SharedBytes returnData( evmc_result const& _result ) {
+    if ( !_result.output_size ) {
+        if ( _result.release )
+            _result.release( &_result );
+        return SharedBytes();
+    }
+    std::shared_ptr< evmc_result const > owner(
+        new evmc_result( _result ), []( evmc_result const* _owned ) {
+            if ( _owned->release )
+                _owned->release( _owned );
+            delete _owned;
+        } );
+    return SharedBytes( owner, { owner->output_data, owner->output_size } );
+}
+}  // namespace
+
 void VM::copyDataToMemory( bytesConstRef _data, u256* _sp ) {
     auto offset = static_cast< size_t >( _sp[0] );
     s512 bigIndex = _sp[1];
@@ -86,7 +104,7 @@ int64_t VM::verifyJumpDest( u256 const& _dest, bool _throw ) {
         // check for within bounds and to a jump destination
         // use binary search of array because hashtable collisions are exploitable
         uint64_t pc = uint64_t( _dest );
-        if ( std::binary_search( m_jumpDests.begin(), m_jumpDests.end(), pc ) )
+        if ( std::binary_search( m_analyzed->jumpDests.begin(), m_analyzed->jumpDests.end(), pc ) )
             return pc;
     }
     if ( _throw )
@@ -118,8 +136,7 @@ void VM::caseCreate() {
     updateMem( memNeed( initOff, initSize ) );
     updateIOGas();
 
-    // Clear the return data buffer. This will not free the memory.
-    m_returnData.clear();
+    m_returnData = SharedBytes();
 
     u256 const balance =
         fromEvmC( m_context->host->get_balance( m_context, &m_message->destination ) );
@@ -143,21 +160,20 @@ void VM::caseCreate() {
                        EVMC_CREATE2;  // FIXME: In EVMC move the kind to the top.
         msg.value = toEvmC( endowment );
 
-        evmc_result result = m_context->host->call( m_context, &msg );
+        evmc_result const result = m_context->host->call( m_context, &msg );
 
         if ( result.status_code == EVMC_SUCCESS )
             m_SPP[0] = fromAddress( fromEvmC( result.create_address ) );
         else
             m_SPP[0] = 0;
-        m_returnData.assign( result.output_data, result.output_data + result.output_size );
+        m_returnData = returnData( result );
 
         m_io_gas -= ( msg.gas - result.gas_left );
-
-        if ( result.release )
-            result.release( &result );
     } else
         m_SPP[0] = 0;
     ++m_PC;
+    if ( m_fast )
+        beginBlock( m_PC );
 }
 
 void VM::caseCall() {
@@ -165,26 +181,24 @@ void VM::caseCall() {
 
     evmc_message msg = {};
 
-    // Clear the return data buffer. This will not free the memory.
-    m_returnData.clear();
+    m_returnData = SharedBytes();
 
     bytesRef output;
     if ( caseCallSetup( msg, output ) ) {
-        evmc_result result = m_context->host->call( m_context, &msg );
+        evmc_result const result = m_context->host->call( m_context, &msg );
 
-        m_returnData.assign( result.output_data, result.output_data + result.output_size );
-        bytesConstRef{ &m_returnData }.copyTo( output );
+        m_returnData = returnData( result );
+        m_returnData.copyTo( output );
 
         m_SPP[0] = result.status_code == EVMC_SUCCESS ? 1 : 0;
         m_io_gas += result.gas_left;
-
-        if ( result.release )
-            result.release( &result );
     } else {
         m_SPP[0] = 0;
         m_io_gas += msg.gas;
     }
     ++m_PC;
+    if ( m_fast )
+        beginBlock( m_PC );
 }
 
 bool VM::caseCallSetup( evmc_message& o_msg, bytesRef& o_output ) {
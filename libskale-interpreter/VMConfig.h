@@ -22,15 +22,13 @@ namespace eth {
 //
 // interpreter configuration macros for development, optimizations and tracing
 //
-// EVM_OPTIMIZE           - all optimizations off when false (TO DO - MAKE DYNAMIC)
+// EVM_OPTIMIZE           - constant pool and pre-verified jumps for all code when true,
+//                          otherwise only for code run by interpreter-fast, which also
+//                          fuses common instruction sequences into superinstructions
 //
 // EVM_SWITCH_DISPATCH    - dispatch via loop and switch
 // EVM_JUMP_DISPATCH      - dispatch via a jump table - available only on GCC
 //
-// EVM_USE_CONSTANT_POOL  - constants unpacked and ready to assign to stack
-//
-// EVM_REPLACE_CONST_JUMP - pre-verified jumps to save runtime lookup
-//
 // EVM_TRACE              - provides various levels of tracing
 
 #ifndef EVM_JUMP_DISPATCH
@@ -51,11 +49,6 @@ namespace eth {
 #ifndef EVM_OPTIMIZE
 #define EVM_OPTIMIZE false
 #endif
-#if EVM_OPTIMIZE
-#define EVM_REPLACE_CONST_JUMP true
-#define EVM_USE_CONSTANT_POOL true
-#define EVM_DO_FIRST_PASS_OPTIMIZATION ( EVM_REPLACE_CONST_JUMP || EVM_USE_CONSTANT_POOL )
-#endif
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -313,13 +306,13 @@ namespace eth {
         &&LOG2,                                 \
         &&LOG3,                                 \
         &&LOG4,                                 \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
+        &&PUSH2JUMP,                            \
+        &&PUSH2JUMPI,                           \
+        &&ISZEROPUSH2JUMPI,                     \
+        &&PUSH1MSTORE,                          \
+        &&SWAP1POP,                             \
+        &&DUP2DUP2,                             \
+        &&SWAP2SWAP1,                           \
         &&PUSHC,                                \
         &&JUMPC,                                \
         &&JUMPCI,                               \
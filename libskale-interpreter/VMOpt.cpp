@@ -17,9 +17,14 @@
 
 #include "VM.h"
 
+#include <ethash/keccak.hpp>
+
 namespace dev {
 namespace eth {
 std::array< std::array< evmc_instruction_metrics, 256 >, EVMC_MAX_REVISION + 1 > VM::s_metrics;
+std::array< std::array< evmc_instruction_metrics, 256 >, EVMC_MAX_REVISION + 1 >
+    VM::s_blockMetrics;
+std::array< int16_t, 256 > VM::s_blockGas;
 
 bool VM::initMetrics() {
     for ( auto revision = 0; revision <= EVMC_MAX_REVISION; ++revision ) {
@@ -35,115 +40,349 @@ bool VM::initMetrics() {
         metrics[uint8_t( Instruction::JUMPC )] = metrics[uint8_t( Instruction::JUMP )];
         metrics[uint8_t( Instruction::JUMPCI )] =
             s_metrics[revision][uint8_t( Instruction::JUMPI )];
+
+        // Superinstructions are fetched as their first instruction, the rest is fetched by
+        // the superinstruction itself.
+        metrics[uint8_t( Instruction::PUSH2JUMP )] = metrics[uint8_t( Instruction::PUSH2 )];
+        metrics[uint8_t( Instruction::PUSH2JUMPI )] = metrics[uint8_t( Instruction::PUSH2 )];
+        metrics[uint8_t( Instruction::ISZEROPUSH2JUMPI )] =
+            metrics[uint8_t( Instruction::ISZERO )];
+        metrics[uint8_t( Instruction::PUSH1MSTORE )] = metrics[uint8_t( Instruction::PUSH1 )];
+        metrics[uint8_t( Instruction::SWAP1POP )] = metrics[uint8_t( Instruction::SWAP1 )];
+        metrics[uint8_t( Instruction::DUP2DUP2 )] = metrics[uint8_t( Instruction::DUP2 )];
+        metrics[uint8_t( Instruction::SWAP2SWAP1 )] = metrics[uint8_t( Instruction::SWAP2 )];
     };
+
+    // Gas charged on entry to a basic block is what an instruction costs in every revision
+    // defining it. Instructions assigning their gas in the interpreter are charged by it.
+    for ( size_t op = 0; op < s_blockGas.size(); ++op ) {
+        int16_t gas = -1;
+        for ( auto revision = 0; revision <= EVMC_MAX_REVISION; ++revision ) {
+            int16_t const cost = s_metrics[revision][op].gas_cost;
+            if ( cost >= 0 )
+                gas = gas < 0 || gas == cost ? cost : 0;
+        }
+        s_blockGas[op] = std::max< int16_t >( gas, 0 );
+    }
+    for ( Instruction op : { Instruction::SHA3, Instruction::EXP, Instruction::LOG0,
+              Instruction::LOG1, Instruction::LOG2, Instruction::LOG3, Instruction::LOG4,
+              Instruction::SSTORE, Instruction::BLOCKHASH, Instruction::JUMPDEST,
+              Instruction::CREATE, Instruction::CREATE2, Instruction::CALL,
+              Instruction::CALLCODE, Instruction::DELEGATECALL, Instruction::STATICCALL } )
+        s_blockGas[uint8_t( op )] = 0;
+
+    s_blockMetrics = s_metrics;
+    for ( auto& metrics : s_blockMetrics )
+        for ( size_t op = 0; op < metrics.size(); ++op )
+            if ( metrics[op].gas_cost >= 0 )
+                metrics[op].gas_cost -= s_blockGas[op];
     return true;
 }
 
-void VM::copyCode( int _extraBytes ) {
-    // Copy code so that it can be safely modified and extend code by
-    // _extraBytes zero bytes to allow reading virtual data at the end
-    // of the code without bounds checks.
-    auto extendedSize = m_codeSize + _extraBytes;
-    m_code.reserve( extendedSize );
-    m_code.assign( m_pCode, m_pCode + m_codeSize );
-    m_code.resize( extendedSize );
+namespace {
+bool isJumpDest( std::vector< uint64_t > const& _jumpDests, u256 const& _dest ) {
+    return _dest <= 0x7FFFFFFFFFFFFFFF &&
+           std::binary_search( _jumpDests.begin(), _jumpDests.end(), uint64_t( _dest ) );
 }
 
-void VM::optimize() {
-    copyCode( 33 );
+/// Instruction of user code at @a _pc as the interpreter runs it, synthetic ones are undefined.
+Instruction userInstruction( uint8_t const* _code, size_t _pc ) {
+    Instruction const op = Instruction( _code[_pc] );
+    if ( ( _byte_ ) Instruction::PUSH2JUMP <= ( _byte_ ) op &&
+         ( _byte_ ) op < ( _byte_ ) Instruction::UNDEFINED )
+        return Instruction::UNDEFINED;
+    return op;
+}
+
+/// @returns offset of the instruction after @a _op at @a _pc
+size_t nextInstruction( Instruction _op, size_t _pc ) {
+    if ( ( _byte_ ) Instruction::PUSH1 <= ( _byte_ ) _op &&
+         ( _byte_ ) _op <= ( _byte_ ) Instruction::PUSH32 )
+        return _pc + ( _byte_ ) _op - ( _byte_ ) Instruction::PUSH1 + 2;
+    return _pc + 1;
+}
+
+/// Whether @a _op is the last instruction of its basic block: it leaves the straight line of
+/// code, or the code after it depends on the gas left.
+bool endsBlock( Instruction _op, evmc_instruction_metrics const& _metric ) {
+    switch ( _op ) {
+    case Instruction::STOP:
+    case Instruction::JUMP:
+    case Instruction::JUMPI:
+    case Instruction::RETURN:
+    case Instruction::REVERT:
+    case Instruction::INVALID:
+    case Instruction::SUICIDE:
+    case Instruction::GAS:
+    case Instruction::CREATE:
+    case Instruction::CREATE2:
+    case Instruction::CALL:
+    case Instruction::CALLCODE:
+    case Instruction::DELEGATECALL:
+    case Instruction::STATICCALL:
+        return true;
+    default:
+        return _metric.gas_cost < 0;
+    }
+}
+
+/// Replaces the first instruction of a common sequence at @a _pc with a superinstruction
+/// running the whole sequence. The rest of the sequence is left in place, so code layout
+/// and jump destinations do not change. Sequences are never entered in the middle, since
+/// only the JUMPDEST instruction can be jumped to and none of them contains one.
+/// @returns number of bytes of the sequence after @a _pc, 0 if nothing was fused.
+size_t fuseInstructions( AnalyzedCode& _a, size_t _pc ) {
+    // code is padded, reading a few bytes past the end is safe
+    bytes& code = _a.code;
+    auto at = [&]( size_t _offset ) { return Instruction( code[_pc + _offset] ); };
+    auto push2 = [&]( size_t _offset ) {
+        return u256( ( code[_pc + _offset + 1] << 8 ) | code[_pc + _offset + 2] );
+    };
 
-    size_t const nBytes = m_codeSize;
+    Instruction fused = Instruction::UNDEFINED;
+    size_t length = 0;
+    switch ( at( 0 ) ) {
+    case Instruction::PUSH2:
+        if ( at( 3 ) == Instruction::JUMP && isJumpDest( _a.jumpDests, push2( 0 ) ) ) {
+            fused = Instruction::PUSH2JUMP;
+            length = 3;
+        } else if ( at( 3 ) == Instruction::JUMPI && isJumpDest( _a.jumpDests, push2( 0 ) ) ) {
+            fused = Instruction::PUSH2JUMPI;
+            length = 3;
+        }
+        break;
+    case Instruction::ISZERO:
+        if ( at( 1 ) == Instruction::PUSH2 && at( 4 ) == Instruction::JUMPI &&
+             isJumpDest( _a.jumpDests, push2( 1 ) ) ) {
+            fused = Instruction::ISZEROPUSH2JUMPI;
+            length = 4;
+        }
+        break;
+    case Instruction::PUSH1:
+        if ( at( 2 ) == Instruction::MSTORE ) {
+            fused = Instruction::PUSH1MSTORE;
+            length = 2;
+        }
+        break;
+    case Instruction::SWAP1:
+        if ( at( 1 ) == Instruction::POP ) {
+            fused = Instruction::SWAP1POP;
+            length = 1;
+        }
+        break;
+    case Instruction::DUP2:
+        if ( at( 1 ) == Instruction::DUP2 ) {
+            fused = Instruction::DUP2DUP2;
+            length = 1;
+        }
+        break;
+    case Instruction::SWAP2:
+        if ( at( 1 ) == Instruction::SWAP1 ) {
+            fused = Instruction::SWAP2SWAP1;
+            length = 1;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if ( length ) {
+        TRACE_PRE_OPT( 1, _pc, at( 0 ) );
+        code[_pc] = _byte_( fused );
+        TRACE_POST_OPT( 1, _pc, fused );
+    }
+    return length;
+}
+}  // namespace
+
+AnalyzedCodePtr VM::analyze( uint8_t const* _code, size_t _codeSize, bool _fast ) {
+    auto ret = std::make_shared< AnalyzedCode >();
+    AnalyzedCode& a = *ret;
+
+    // Copy code so that it can be safely modified and extend code by
+    // 33 zero bytes to allow reading virtual data at the end
+    // of the code without bounds checks.
+    a.codeSize = _codeSize;
+    a.code.reserve( _codeSize + 33 );
+    a.code.assign( _code, _code + _codeSize );
+    a.code.resize( _codeSize + 33 );
+    bytes& code = a.code;
+
+    size_t const nBytes = _codeSize;
 
     // build a table of jump destinations for use in verifyJumpDest
 
     TRACE_STR( 1, "Build JUMPDEST table" )
     for ( size_t pc = 0; pc < nBytes; ++pc ) {
-        Instruction op = Instruction( m_code[pc] );
+        Instruction op = Instruction( code[pc] );
         TRACE_OP( 2, pc, op );
 
         // make synthetic ops in user code trigger invalid instruction if run
-        if ( op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI ) {
+        if ( ( _byte_ ) Instruction::PUSH2JUMP <= ( _byte_ ) op &&
+             ( _byte_ ) op < ( _byte_ ) Instruction::UNDEFINED ) {
             TRACE_OP( 1, pc, op );
-            m_code[pc] = ( _byte_ ) Instruction::UNDEFINED;
+            code[pc] = ( _byte_ ) Instruction::UNDEFINED;
         }
 
         if ( op == Instruction::JUMPDEST ) {
-            m_jumpDests.push_back( pc );
+            a.jumpDests.push_back( pc );
         } else if ( ( _byte_ ) Instruction::PUSH1 <= ( _byte_ ) op &&
                     ( _byte_ ) op <= ( _byte_ ) Instruction::PUSH32 ) {
             pc += ( _byte_ ) op - ( _byte_ ) Instruction::PUSH1 + 1;
         }
     }
 
-#ifdef EVM_DO_FIRST_PASS_OPTIMIZATION
+#if !EVM_OPTIMIZE
+    if ( !_fast )
+        return ret;
+#endif
+
+    if ( _fast )
+        analyzeBlocks( a );
 
     TRACE_STR( 1, "Do first pass optimizations" )
     for ( size_t pc = 0; pc < nBytes; ++pc ) {
+        if ( _fast ) {
+            if ( size_t const fused = fuseInstructions( a, pc ) ) {
+                pc += fused;
+                continue;
+            }
+        }
+
         u256 val = 0;
-        Instruction op = Instruction( m_code[pc] );
+        Instruction op = Instruction( code[pc] );
 
         if ( ( _byte_ ) Instruction::PUSH1 <= ( _byte_ ) op &&
              ( _byte_ ) op <= ( _byte_ ) Instruction::PUSH32 ) {
             _byte_ nPush = ( _byte_ ) op - ( _byte_ ) Instruction::PUSH1 + 1;
 
             // decode pushed bytes to integral value
-            val = m_code[pc + 1];
+            val = code[pc + 1];
             for ( uint64_t i = pc + 2, n = nPush; --n; ++i ) {
-                val = ( val << 8 ) | m_code[i];
+                val = ( val << 8 ) | code[i];
             }
 
-#if EVM_USE_CONSTANT_POOL
-
             // add value to constant pool and replace PUSHn with PUSHC
             // place offset in code as 2 bytes MSB-first
             // followed by one byte count of remaining pushed bytes
             if ( 5 < nPush ) {
-                uint16_t pool_off = m_pool.size();
+                uint16_t pool_off = a.pool.size();
                 TRACE_VAL( 1, "stash", val );
                 TRACE_VAL( 1, "... in pool at offset", pool_off );
-                m_pool.push_back( val );
+                a.pool.push_back( val );
 
                 TRACE_PRE_OPT( 1, pc, op );
-                m_code[pc] = _byte_( op = Instruction::PUSHC );
-                m_code[pc + 3] = nPush - 2;
-                m_code[pc + 2] = pool_off & 0xff;
-                m_code[pc + 1] = pool_off >> 8;
+                code[pc] = _byte_( op = Instruction::PUSHC );
+                code[pc + 3] = nPush - 2;
+                code[pc + 2] = pool_off & 0xff;
+                code[pc + 1] = pool_off >> 8;
                 TRACE_POST_OPT( 1, pc, op );
             }
 
-#endif
-
-#if EVM_REPLACE_CONST_JUMP
             // replace JUMP or JUMPI to constant location with JUMPC or JUMPCI
             // verifyJumpDest is M = log(number of jump destinations)
             // outer loop is N = number of bytes in code array
             // so complexity is N log M, worst case is N log N
             size_t i = pc + nPush + 1;
-            op = Instruction( m_code[i] );
+            op = Instruction( code[i] );
             if ( op == Instruction::JUMP ) {
                 TRACE_VAL( 1, "Replace const JUMP with JUMPC to", val )
                 TRACE_PRE_OPT( 1, i, op );
 
-                if ( 0 <= verifyJumpDest( val, false ) )
-                    m_code[i] = _byte_( op = Instruction::JUMPC );
+                if ( isJumpDest( a.jumpDests, val ) )
+                    code[i] = _byte_( op = Instruction::JUMPC );
 
                 TRACE_POST_OPT( 1, i, op );
             } else if ( op == Instruction::JUMPI ) {
                 TRACE_VAL( 1, "Replace const JUMPI with JUMPCI to", val )
                 TRACE_PRE_OPT( 1, i, op );
 
-                if ( 0 <= verifyJumpDest( val, false ) )
-                    m_code[i] = _byte_( op = Instruction::JUMPCI );
+                if ( isJumpDest( a.jumpDests, val ) )
+                    code[i] = _byte_( op = Instruction::JUMPCI );
 
                 TRACE_POST_OPT( 1, i, op );
             }
-#endif
 
             pc += nPush;
         }
     }
     TRACE_STR( 1, "Finished optimizations" )
-#endif
+    return ret;
+}
+
+//
+// Split code into basic blocks, each starting at offset 0, after a JUMPDEST or after an
+// instruction ending a block. JUMPDEST itself belongs to no block, it starts the next one.
+//
+void VM::analyzeBlocks( AnalyzedCode& _a ) {
+    auto const& metrics = s_metrics[EVMC_MAX_REVISION];
+    uint8_t const* code = _a.code.data();
+    _a.blockAt.assign( _a.codeSize + 1, 0 );
+
+    BasicBlock block;
+    int64_t height = 0;
+    auto endBlock = [&]( size_t _end ) {
+        block.end = _end;
+        _a.blockAt[block.begin] = _a.blocks.size();
+        _a.blocks.push_back( block );
+        block = BasicBlock();
+        block.begin = _end;
+        height = 0;
+    };
+
+    size_t pc = 0;
+    while ( pc < _a.codeSize ) {
+        Instruction const op = userInstruction( code, pc );
+        auto const& metric = metrics[uint8_t( op )];
+        if ( op == Instruction::JUMPDEST ) {
+            endBlock( pc );
+            block.begin = ++pc;
+            continue;
+        }
+        block.gas += s_blockGas[uint8_t( op )];
+        block.stackNeeded =
+            std::max< int64_t >( block.stackNeeded, metric.num_stack_arguments - height );
+        height += metric.num_stack_returned_items - metric.num_stack_arguments;
+        block.stackGrowth = std::max< int64_t >( block.stackGrowth, height );
+        pc = std::min( nextInstruction( op, pc ), _a.codeSize );
+        if ( endsBlock( op, metric ) )
+            endBlock( pc );
+    }
+    // a block reaching the end of code runs into STOP
+    endBlock( _a.codeSize );
+}
+
+//
+// Leave the basic block charged on entry for checked instructions, giving back the gas charged
+// for its instructions after the current one. They are charged as they run from now on.
+//
+void VM::leaveBlock() {
+    m_blockChecked = false;
+    m_metrics = &s_metrics[m_rev];
+    if ( m_PC < m_block->begin || m_PC >= m_block->end )
+        return;
+    size_t pc = nextInstruction( userInstruction( m_pCode, m_PC ), m_PC );
+    while ( pc < m_block->end ) {
+        Instruction const op = userInstruction( m_pCode, pc );
+        m_io_gas += s_blockGas[uint8_t( op )];
+        pc = nextInstruction( op, pc );
+    }
+}
+
+void VM::optimize() {
+    // the hash is known to the host, only hosts that do not pass it make us compute it
+    h256 codeHash = AnalyzedCodeCache::CodeHashHint::codeHash( m_pCode, m_codeSize );
+    if ( !codeHash ) {
+        ethash::hash256 const hash = ethash::keccak256( m_pCode, m_codeSize );
+        codeHash = h256( hash.bytes, h256::ConstructFromPointer );
+    }
+    m_analyzed = AnalyzedCodeCache::instance().getOrAnalyze(
+        m_fast ? AnalyzedCodeCache::Kind::InterpreterFast : AnalyzedCodeCache::Kind::Interpreter,
+        codeHash, m_codeSize, [this]() { return analyze( m_pCode, m_codeSize, m_fast ); } );
+    m_code = m_analyzed->code.data();
+    m_pool = m_analyzed->pool.data();
+    m_blocks = m_analyzed->blocks.data();
+    m_blockAt = m_analyzed->blockAt.data();
 }
 
 
@@ -153,25 +392,9 @@ void VM::optimize() {
 void VM::initEntry() {
     m_bounce = &VM::interpretCases;
     optimize();
+    if ( m_fast )
+        beginBlock( 0 );
 }
 
-
-// Implementation of EXP.
-//
-// This implements exponentiation by squaring algorithm.
-// Is faster than boost::multiprecision::powm() because it avoids explicit
-// mod operation.
-// Do not inline it.
-u256 VM::exp256( u256 _base, u256 _exponent ) {
-    using boost::multiprecision::limb_type;
-    u256 result = 1;
-    while ( _exponent ) {
-        if ( static_cast< limb_type >( _exponent ) & 1 )  // If exponent is odd.
-            result *= _base;
-        _base *= _base;
-        _exponent >>= 1;
-    }
-    return result;
-}
 }  // namespace eth
 }  // namespace dev
@@ -8,12 +8,28 @@
 #include <evmc/evmc.h>
 #include <evmc/utils.h>
 
+#include <stdint.h>
+
 #if __cplusplus
 extern "C" {
 #endif
 
+/// Charges @a steps instructions executed by the calling thread to its execution budget.
+/// @returns zero if the budget is exceeded, which aborts the execution with EVMC_INTERNAL_ERROR.
+typedef int ( *skale_interpreter_budget_fn )( uint64_t steps );
+
+/// Installs @a hook, called by both interpreters at JUMPDESTs once per
+/// dev::eth::ExecutionBudget::c_chargeInterval instructions and when a frame returns.
+EVMC_EXPORT void skale_interpreter_set_budget_hook(
+    skale_interpreter_budget_fn hook ) EVMC_NOEXCEPT;
+
 EVMC_EXPORT struct evmc_instance* evmc_create_interpreter() EVMC_NOEXCEPT;
 
+/// Same interpreter, running contract code with common instruction sequences fused into
+/// superinstructions and constant gas and stack bounds checked once per basic block. Gas and
+/// results are identical to evmc_create_interpreter().
+EVMC_EXPORT struct evmc_instance* evmc_create_interpreter_fast() EVMC_NOEXCEPT;
+
 #if __cplusplus
 }
 #endif
@@ -0,0 +1,136 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ExecutionBudgetSettings.cpp
+ * @date 2026
+ */
+
+#include "ExecutionBudgetSettings.h"
+
+#include <skutils/utils.h>
+
+namespace skale {
+
+ExecutionBudgetSettings::ExecutionBudgetSettings() {
+    m_methods["eth_call"].timeMs = 5000;
+    // runs the call several times
+    m_methods["eth_estimateGas"].timeMs = 20000;
+}
+
+ExecutionBudgetSettings::Override ExecutionBudgetSettings::overrideFromJSON(
+    nlohmann::json const& _jo ) {
+    Override ret;
+    if ( _jo.count( "maxInstructions" ) )
+        ret.instructions = _jo["maxInstructions"].get< uint64_t >();
+    if ( _jo.count( "maxTimeMs" ) )
+        ret.timeMs = _jo["maxTimeMs"].get< uint64_t >();
+    return ret;
+}
+
+nlohmann::json ExecutionBudgetSettings::overrideToJSON( Override const& _override ) {
+    nlohmann::json jo = nlohmann::json::object();
+    if ( _override.instructions )
+        jo["maxInstructions"] = *_override.instructions;
+    if ( _override.timeMs )
+        jo["maxTimeMs"] = *_override.timeMs;
+    return jo;
+}
+
+void ExecutionBudgetSettings::fromJSON( nlohmann::json const& _jo ) {
+    if ( _jo.count( "methods" ) ) {
+        m_methods.clear();
+        nlohmann::json const& joMethods = _jo["methods"];
+        for ( auto it = joMethods.cbegin(); it != joMethods.cend(); ++it ) {
+            Override const limits = overrideFromJSON( it.value() );
+            Limits& method = m_methods[it.key()];
+            method.instructions = limits.instructions.value_or( 0 );
+            method.timeMs = limits.timeMs.value_or( 0 );
+        }
+    }
+    m_origins.clear();
+    if ( _jo.count( "origins" ) && _jo["origins"].is_array() ) {
+        for ( nlohmann::json const& joOrigin : _jo["origins"] ) {
+            OriginEntry entry;
+            nlohmann::json const& joWildcards = joOrigin.value( "origin", nlohmann::json() );
+            if ( joWildcards.is_string() )
+                entry.wildcards.push_back( joWildcards.get< std::string >() );
+            else if ( joWildcards.is_array() )
+                for ( nlohmann::json const& joWildcard : joWildcards )
+                    if ( joWildcard.is_string() )
+                        entry.wildcards.push_back( joWildcard.get< std::string >() );
+            if ( joOrigin.count( "methods" ) ) {
+                nlohmann::json const& joMethods = joOrigin["methods"];
+                for ( auto it = joMethods.cbegin(); it != joMethods.cend(); ++it )
+                    entry.methods[it.key()] = overrideFromJSON( it.value() );
+            }
+            m_origins.push_back( std::move( entry ) );
+        }
+    }
+}
+
+nlohmann::json ExecutionBudgetSettings::toJSON() const {
+    nlohmann::json joMethods = nlohmann::json::object();
+    for ( auto const& method : m_methods )
+        joMethods[method.first] = { { "maxInstructions", method.second.instructions },
+            { "maxTimeMs", method.second.timeMs } };
+    nlohmann::json joOrigins = nlohmann::json::array();
+    for ( OriginEntry const& entry : m_origins ) {
+        nlohmann::json joEntryMethods = nlohmann::json::object();
+        for ( auto const& method : entry.methods )
+            joEntryMethods[method.first] = overrideToJSON( method.second );
+        joOrigins.push_back( { { "origin", entry.wildcards }, { "methods", joEntryMethods } } );
+    }
+    return { { "methods", joMethods }, { "origins", joOrigins } };
+}
+
+ExecutionBudgetSettings::Limits ExecutionBudgetSettings::limits(
+    std::string const& _method, std::string const& _origin ) const {
+    Limits ret;
+    auto method = m_methods.find( _method );
+    if ( method != m_methods.end() )
+        ret = method->second;
+    for ( OriginEntry const& entry : m_origins ) {
+        auto it = entry.methods.find( _method );
+        if ( it == entry.methods.end() )
+            continue;
+        bool matches = false;
+        for ( std::string const& wildcard : entry.wildcards )
+            if ( skutils::tools::wildcmp( wildcard.c_str(), _origin.c_str() ) ) {
+                matches = true;
+                break;
+            }
+        if ( !matches )
+            continue;
+        ret.instructions = it->second.instructions.value_or( ret.instructions );
+        ret.timeMs = it->second.timeMs.value_or( ret.timeMs );
+        break;
+    }
+    return ret;
+}
+
+std::unique_ptr< dev::eth::ExecutionBudget > ExecutionBudgetSettings::start(
+    std::string const& _method, std::string const& _origin ) const {
+    Limits const limits = this->limits( _method, _origin );
+    if ( limits.unlimited() )
+        return nullptr;
+    return std::unique_ptr< dev::eth::ExecutionBudget >(
+        new dev::eth::ExecutionBudget( _method, limits ) );
+}
+
+}  // namespace skale
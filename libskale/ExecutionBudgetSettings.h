@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file ExecutionBudgetSettings.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libevm/ExecutionBudget.h>
+
+#include <json.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace skale {
+
+/// Execution budgets of RPC methods by origin, from "executionBudget" of config.json:
+///
+///     "executionBudget": {
+///         "methods": { "eth_call": { "maxInstructions": 0, "maxTimeMs": 5000 } },
+///         "origins": [
+///             { "origin": [ "127.0.0.*" ], "methods": { "eth_call": { "maxTimeMs": 0 } } }
+///         ]
+///     }
+///
+/// Methods not listed run without a budget. The first origin entry whose wildcard matches the
+/// host of the request and that lists the method overrides the limits it sets; zero is no limit.
+/// Loaded before the server starts listening and only read afterwards.
+class ExecutionBudgetSettings {
+public:
+    using Limits = dev::eth::ExecutionBudget::Limits;
+
+    /// eth_call and eth_estimateGas limited in time only.
+    ExecutionBudgetSettings();
+
+    void fromJSON( nlohmann::json const& _jo );
+    nlohmann::json toJSON() const;
+
+    Limits limits( std::string const& _method, std::string const& _origin ) const;
+
+    /// Budget for request @a _method from @a _origin, nullptr if it is not limited.
+    std::unique_ptr< dev::eth::ExecutionBudget > start(
+        std::string const& _method, std::string const& _origin ) const;
+
+private:
+    struct Override {
+        std::optional< uint64_t > instructions;
+        std::optional< uint64_t > timeMs;
+    };
+
+    struct OriginEntry {
+        std::vector< std::string > wildcards;
+        std::map< std::string, Override > methods;
+    };
+
+    static Override overrideFromJSON( nlohmann::json const& _jo );
+    static nlohmann::json overrideToJSON( Override const& _override );
+
+    std::map< std::string, Limits > m_methods;
+    std::vector< OriginEntry > m_origins;
+};
+
+}  // namespace skale
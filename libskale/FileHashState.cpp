@@ -0,0 +1,228 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file FileHashState.cpp
+ * @date 2026
+ */
+
+#include "FileHashState.h"
+
+#include <libdevcrypto/Hash.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
+
+namespace skale {
+
+namespace {
+
+const uint64_t c_sidecarMagic = 0x3148534148534653;  // "SFSHASH1"
+const size_t c_readBufferSize = 64 * 1024;
+
+struct SidecarHeader {
+    uint64_t magic;
+    uint64_t contextSize;
+    uint64_t checkpointInterval;
+    uint64_t fileSize;
+    int64_t fileMtime;
+    uint64_t checkpoints;
+};
+
+dev::h256 finalized( secp256k1_sha256_t _ctx ) {
+    dev::h256 hash;
+    secp256k1_sha256_finalize( &_ctx, hash.data() );
+    return hash;
+}
+
+}  // namespace
+
+FileHashState::FileHashState( std::string const& _filePath ) : m_filePath( _filePath ) {
+    if ( !load() )
+        m_checkpoints.clear();
+}
+
+std::string FileHashState::sidecarPath( std::string const& _filePath ) {
+    return _filePath + "._hash._hash";
+}
+
+void FileHashState::remove( std::string const& _filePath ) {
+    boost::system::error_code ec;
+    fs::remove( sidecarPath( _filePath ), ec );
+}
+
+FileHashState::Stat FileHashState::stat( std::string const& _filePath ) {
+    struct stat st;
+    if ( ::stat( _filePath.c_str(), &st ) != 0 )
+        throw std::runtime_error( "Cannot stat " + _filePath );
+    Stat result;
+    result.size = static_cast< uint64_t >( st.st_size );
+    result.mtime = static_cast< int64_t >( st.st_mtim.tv_sec ) * 1000000000 + st.st_mtim.tv_nsec;
+    return result;
+}
+
+bool FileHashState::load() {
+    try {
+        std::ifstream sidecar( sidecarPath( m_filePath ), std::ios::binary );
+        if ( !sidecar )
+            return false;
+        SidecarHeader header;
+        if ( !sidecar.read( reinterpret_cast< char* >( &header ), sizeof( header ) ) )
+            return false;
+        Stat const current = stat( m_filePath );
+        if ( header.magic != c_sidecarMagic ||
+             header.contextSize != sizeof( secp256k1_sha256_t ) ||
+             header.checkpointInterval != c_checkpointInterval ||
+             !( Stat{ header.fileSize, header.fileMtime } == current ) ||
+             header.checkpoints > current.size / c_checkpointInterval )
+            return false;
+        m_checkpoints.resize( header.checkpoints );
+        if ( header.checkpoints > 0 &&
+             !sidecar.read( reinterpret_cast< char* >( m_checkpoints.data() ),
+                 header.checkpoints * sizeof( secp256k1_sha256_t ) ) )
+            return false;
+        return true;
+    } catch ( ... ) {
+        return false;
+    }
+}
+
+bool FileHashState::save() const {
+    try {
+        if ( m_checkpoints.empty() ) {
+            remove( m_filePath );
+            return true;
+        }
+        Stat const current = stat( m_filePath );
+        SidecarHeader header{ c_sidecarMagic, sizeof( secp256k1_sha256_t ),
+            c_checkpointInterval, current.size, current.mtime, m_checkpoints.size() };
+        std::ofstream sidecar( sidecarPath( m_filePath ), std::ios::binary | std::ios::trunc );
+        sidecar.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+        sidecar.write( reinterpret_cast< char const* >( m_checkpoints.data() ),
+            m_checkpoints.size() * sizeof( secp256k1_sha256_t ) );
+        sidecar.close();
+        if ( sidecar )
+            return true;
+    } catch ( ... ) {
+    }
+    remove( m_filePath );
+    return false;
+}
+
+secp256k1_sha256_t FileHashState::hashFrom( size_t _end ) {
+    secp256k1_sha256_t ctx;
+    if ( m_checkpoints.empty() )
+        secp256k1_sha256_initialize( &ctx );
+    else
+        ctx = m_checkpoints.back();
+
+    size_t position = m_checkpoints.size() * c_checkpointInterval;
+    if ( position >= _end )
+        return ctx;
+
+    std::ifstream file( m_filePath, std::ios::binary );
+    file.seekg( static_cast< std::streamoff >( position ) );
+    std::vector< char > buffer( c_readBufferSize );
+    while ( position < _end ) {
+        size_t const nextCheckpoint =
+            ( position / c_checkpointInterval + 1 ) * c_checkpointInterval;
+        size_t const count =
+            std::min( { _end, nextCheckpoint, position + buffer.size() } ) - position;
+        if ( !file.read( buffer.data(), static_cast< std::streamsize >( count ) ) )
+            throw std::runtime_error( "Cannot read " + m_filePath );
+        secp256k1_sha256_write(
+            &ctx, reinterpret_cast< unsigned char const* >( buffer.data() ), count );
+        position += count;
+        if ( position == nextCheckpoint )
+            m_checkpoints.push_back( ctx );
+    }
+    return ctx;
+}
+
+void FileHashState::written( size_t _position, size_t _length ) {
+    size_t const intact = _position / c_checkpointInterval;
+    if ( m_checkpoints.size() > intact )
+        m_checkpoints.resize( intact );
+    // writes far past the hashed prefix are left for contentHash()
+    if ( m_checkpoints.size() < intact )
+        return;
+    hashFrom( ( _position + _length ) / c_checkpointInterval * c_checkpointInterval );
+}
+
+dev::h256 FileHashState::contentHash() {
+    return finalized( hashFrom( stat( m_filePath ).size ) );
+}
+
+dev::h256 FileHashState::combine( std::string const& _filePath, dev::h256 const& _contentHash ) {
+    std::string relativePath = _filePath.substr( _filePath.find( "filestorage" ) );
+    dev::h256 filePathHash = dev::sha256( relativePath );
+
+    secp256k1_sha256_t ctx;
+    secp256k1_sha256_initialize( &ctx );
+    secp256k1_sha256_write( &ctx, filePathHash.data(), filePathHash.size );
+    secp256k1_sha256_write( &ctx, _contentHash.data(), _contentHash.size );
+    return finalized( ctx );
+}
+
+dev::h256 FileHashState::fileHash() {
+    return combine( m_filePath, contentHash() );
+}
+
+FileHashState::Report FileHashState::verify( fs::path const& _directory, bool _repair ) {
+    Report report;
+    for ( auto it = fs::recursive_directory_iterator( _directory );
+          it != fs::recursive_directory_iterator(); ++it ) {
+        fs::path const& path = it->path();
+        if ( !fs::is_regular_file( path ) || fs::extension( path ) == "._hash" )
+            continue;
+        ++report.files;
+
+        std::string const filePath = path.string();
+        FileHashState const existing( filePath );
+        FileHashState rebuilt( filePath );
+        rebuilt.m_checkpoints.clear();
+        dev::h256 const hash = rebuilt.fileHash();
+
+        bool badSidecar = fs::exists( sidecarPath( filePath ) ) && existing.checkpoints() == 0;
+        for ( size_t i = 0; !badSidecar && i < existing.checkpoints(); ++i )
+            badSidecar = i >= rebuilt.checkpoints() ||
+                         finalized( existing.m_checkpoints[i] ) !=
+                             finalized( rebuilt.m_checkpoints[i] );
+        if ( badSidecar )
+            ++report.badSidecars;
+        if ( _repair )
+            rebuilt.save();
+
+        std::string const hashPath = filePath + "._hash";
+        if ( fs::exists( hashPath ) ) {
+            dev::h256 storedHash;
+            std::ifstream hashFile( hashPath );
+            hashFile >> storedHash;
+            if ( storedHash != hash )
+                ++report.badHashes;
+        }
+    }
+    return report;
+}
+
+}  // namespace skale
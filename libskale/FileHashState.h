@@ -0,0 +1,112 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file FileHashState.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <secp256k1_sha256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+namespace skale {
+
+/// Resumable sha256 of the content of a filestorage file.
+/// The file hash is sha256( sha256( relative path ) || sha256( content ) ), and sha256 cannot
+/// combine hashes of separate chunks, so instead of chunk hashes the sidecar keeps the sha256
+/// midstate after every c_checkpointInterval bytes of content. Writes drop the checkpoints past
+/// the written position and, when they continue the hashed prefix, hash the new data right away;
+/// calculating the hash then only reads the content past the last checkpoint.
+/// FilePool keeps the state of written files in memory and saves it once per block.
+/// The sidecar is <file>._hash._hash: the ._hash extension keeps it out of snapshot hashes and
+/// cannot be used by createFile. It remembers the size and modification time of the file, and
+/// is ignored when they do not match, so a stale or broken sidecar only costs a full rehash.
+class FileHashState {
+public:
+    static constexpr size_t c_checkpointInterval = 1 << 20;
+
+    /// Loads the sidecar of @a _filePath, or starts empty if it is missing or out of date.
+    explicit FileHashState( std::string const& _filePath );
+
+    /// Records that [_position, _position + _length) of the file was written.
+    void written( size_t _position, size_t _length );
+
+    /// sha256 of the whole content, adding checkpoints for the part it reads.
+    dev::h256 contentHash();
+
+    /// Hash in the format of the ._hash files.
+    dev::h256 fileHash();
+
+    /// Writes the sidecar, or removes it if there are no checkpoints.
+    /// @returns false if it could not be written; the sidecar is removed then.
+    bool save() const;
+
+    size_t checkpoints() const { return m_checkpoints.size(); }
+
+    /// Drops all checkpoints, so the next hash reads the whole file.
+    void clear() { m_checkpoints.clear(); }
+
+    static std::string sidecarPath( std::string const& _filePath );
+
+    /// Removes the sidecar of @a _filePath if there is one.
+    static void remove( std::string const& _filePath );
+
+    /// sha256( sha256( relative path ) || @a _contentHash )
+    static dev::h256 combine( std::string const& _filePath, dev::h256 const& _contentHash );
+
+    struct Report {
+        size_t files = 0;
+        /// sidecars which were missing, out of date or had wrong checkpoints
+        size_t badSidecars = 0;
+        /// ._hash files which differ from the content
+        size_t badHashes = 0;
+    };
+
+    /// Rehashes every file under @a _directory from scratch and checks its sidecar and ._hash
+    /// file against the result. With @a _repair sidecars are rebuilt; ._hash files are only
+    /// reported.
+    static Report verify( boost::filesystem::path const& _directory, bool _repair );
+
+private:
+    struct Stat {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        bool operator==( Stat const& _other ) const {
+            return size == _other.size && mtime == _other.mtime;
+        }
+    };
+
+    static Stat stat( std::string const& _filePath );
+    bool load();
+
+    /// Hashes the file from the last checkpoint up to @a _end, adding checkpoints on the way.
+    secp256k1_sha256_t hashFrom( size_t _end );
+
+    std::string m_filePath;
+    std::vector< secp256k1_sha256_t > m_checkpoints;
+};
+
+}  // namespace skale
@@ -0,0 +1,340 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file FilePool.cpp
+ * @date 2026
+ */
+
+#include "FilePool.h"
+#include "FileHashState.h"
+
+#include <libdevcore/Log.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace skale {
+
+struct FilePool::File {
+    File( std::string const& _path, int _fd, struct stat const& _st )
+        : path( _path ), fd( _fd ), device( _st.st_dev ), inode( _st.st_ino ) {}
+    ~File() { ::close( fd ); }
+
+    bool isFile( struct stat const& _st ) const {
+        return _st.st_dev == device && _st.st_ino == inode;
+    }
+
+    // Loads the hash state, or drops it if the file was changed by someone else since the last
+    // write or hash through the pool.
+    FileHashState& hashStateFor( struct stat const& _st ) {
+        if ( !hashState )
+            hashState.reset( new FileHashState( path ) );
+        else if ( _st.st_size != knownSize || _st.st_mtim.tv_sec != knownMtime.tv_sec ||
+                  _st.st_mtim.tv_nsec != knownMtime.tv_nsec )
+            hashState->clear();
+        return *hashState;
+    }
+
+    void remember() {
+        struct stat st;
+        if ( ::fstat( fd, &st ) == 0 ) {
+            knownSize = st.st_size;
+            knownMtime = st.st_mtim;
+        }
+    }
+
+    std::string const path;
+    int const fd;
+    dev_t const device;
+    ino_t const inode;
+
+    // guards hashState; chunk I/O itself needs no lock
+    std::mutex mutex;
+    // loaded before the first write through this descriptor
+    std::unique_ptr< FileHashState > hashState;
+    off_t knownSize = -1;
+    timespec knownMtime{};
+};
+
+namespace {
+
+std::runtime_error systemError( std::string const& _what, std::string const& _path ) {
+    return std::runtime_error( _what + " " + _path + ": " + std::strerror( errno ) );
+}
+
+bool isUnder( std::string const& _path, std::string const& _directory ) {
+    return _path.size() > _directory.size() &&
+           _path.compare( 0, _directory.size(), _directory ) == 0 &&
+           _path[_directory.size()] == '/';
+}
+
+}  // namespace
+
+FilePool& FilePool::instance() {
+    static FilePool s_pool;
+    return s_pool;
+}
+
+FilePool::FilePool( size_t _capacity ) : m_capacity( std::max< size_t >( _capacity, 1 ) ) {}
+
+FilePool::~FilePool() = default;
+
+FilePool::FilePtr FilePool::acquire( std::string const& _path, struct stat& o_st ) {
+    struct stat& st = o_st;
+    if ( ::stat( _path.c_str(), &st ) != 0 )
+        throw systemError( "Cannot stat", _path );
+
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        auto it = m_open.find( _path );
+        if ( it != m_open.end() ) {
+            if ( ( *it->second )->isFile( st ) ) {
+                m_lru.splice( m_lru.begin(), m_lru, it->second );
+                return m_lru.front();
+            }
+            m_lru.erase( it->second );
+            m_open.erase( it );
+        }
+        auto dirty = m_dirty.find( _path );
+        if ( dirty != m_dirty.end() && ( *dirty->second )->isFile( st ) ) {
+            // written and evicted; its hash state is newer than the sidecar
+            m_lru.push_front( *dirty->second );
+            m_open.emplace( _path, m_lru.begin() );
+            return m_lru.front();
+        }
+    }
+
+    int const fd = ::open( _path.c_str(), O_RDWR | O_CLOEXEC );
+    if ( fd < 0 )
+        throw systemError( "Cannot open", _path );
+    struct stat opened;
+    if ( ::fstat( fd, &opened ) != 0 ) {
+        ::close( fd );
+        throw systemError( "Cannot stat", _path );
+    }
+    st = opened;
+    auto file = std::make_shared< File >( _path, fd, st );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    auto it = m_open.find( _path );
+    if ( it != m_open.end() ) {
+        // opened concurrently, keep the descriptor already in the pool
+        if ( ( *it->second )->isFile( st ) )
+            return *it->second;
+        m_lru.erase( it->second );
+        m_open.erase( it );
+    }
+    m_lru.push_front( file );
+    m_open.emplace( _path, m_lru.begin() );
+    while ( m_lru.size() > m_capacity ) {
+        m_open.erase( m_lru.back()->path );
+        m_lru.pop_back();
+    }
+    return file;
+}
+
+void FilePool::markDirty( FilePtr const& _file ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    auto it = m_dirty.find( _file->path );
+    if ( it != m_dirty.end() ) {
+        if ( *it->second == _file )
+            return;
+        m_dirtyOrder.erase( it->second );
+        m_dirty.erase( it );
+    }
+    m_dirtyOrder.push_back( _file );
+    m_dirty.emplace( _file->path, std::prev( m_dirtyOrder.end() ) );
+}
+
+void FilePool::syncOverflow() {
+    std::vector< FilePtr > overflow;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        while ( m_dirtyOrder.size() > m_capacity ) {
+            overflow.push_back( m_dirtyOrder.front() );
+            m_dirty.erase( m_dirtyOrder.front()->path );
+            m_dirtyOrder.pop_front();
+        }
+    }
+    // descriptors not in the LRU are closed when the last reference goes
+    for ( FilePtr const& file : overflow )
+        syncFile( *file );
+}
+
+void FilePool::syncFile( File& _file ) {
+    if ( ::fdatasync( _file.fd ) != 0 )
+        clog( dev::VerbosityWarning, "fs" )
+            << "Cannot sync " << _file.path << ": " << std::strerror( errno );
+    struct stat st;
+    if ( ::fstat( _file.fd, &st ) == 0 && st.st_nlink == 0 )
+        return;  // deleted behind the pool
+    std::lock_guard< std::mutex > lock( _file.mutex );
+    if ( _file.hashState && !_file.hashState->save() )
+        clog( dev::VerbosityWarning, "fs" ) << "Cannot save hash state of " << _file.path;
+}
+
+size_t FilePool::fileSize( std::string const& _path ) {
+    struct stat st;
+    if ( ::stat( _path.c_str(), &st ) != 0 )
+        throw systemError( "Cannot stat", _path );
+    if ( !S_ISREG( st.st_mode ) )
+        throw std::runtime_error( _path + " is not a regular file" );
+    return static_cast< size_t >( st.st_size );
+}
+
+void FilePool::read( std::string const& _path, size_t _position, _byte_* o_data, size_t _length ) {
+    struct stat st;
+    FilePtr const file = acquire( _path, st );
+    while ( _length > 0 ) {
+        ssize_t const n = ::pread( file->fd, o_data, _length, static_cast< off_t >( _position ) );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 )
+            throw systemError( "Cannot read", _path );
+        if ( n == 0 )
+            throw std::runtime_error( "Cannot read " + _path + ": unexpected end of file" );
+        o_data += n;
+        _position += static_cast< size_t >( n );
+        _length -= static_cast< size_t >( n );
+    }
+}
+
+void FilePool::write(
+    std::string const& _path, size_t _position, _byte_ const* _data, size_t _length ) {
+    writeChunk( _path, _position, _data, _length );
+    syncOverflow();
+}
+
+void FilePool::writeChunk(
+    std::string const& _path, size_t _position, _byte_ const* _data, size_t _length ) {
+    struct stat st;
+    FilePtr const file = acquire( _path, st );
+    std::lock_guard< std::mutex > lock( file->mutex );
+    FileHashState& hashState = file->hashStateFor( st );
+
+    size_t const position = _position;
+    size_t const length = _length;
+    while ( _length > 0 ) {
+        ssize_t const n = ::pwrite( file->fd, _data, _length, static_cast< off_t >( _position ) );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 ) {
+            hashState.clear();
+            file->remember();
+            markDirty( file );
+            throw systemError( "Cannot write", _path );
+        }
+        _data += n;
+        _position += static_cast< size_t >( n );
+        _length -= static_cast< size_t >( n );
+    }
+
+    try {
+        hashState.written( position, length );
+    } catch ( std::exception const& ex ) {
+        // the hash will be calculated from the file itself
+        hashState.clear();
+        clog( dev::VerbosityWarning, "fs" ) << "Cannot update hash state of " << _path << ": "
+                                            << ex.what();
+    }
+    file->remember();
+    markDirty( file );
+}
+
+dev::h256 FilePool::fileHash( std::string const& _path ) {
+    dev::h256 hash;
+    {
+        struct stat st;
+        FilePtr const file = acquire( _path, st );
+        std::lock_guard< std::mutex > lock( file->mutex );
+        hash = file->hashStateFor( st ).fileHash();
+        file->remember();
+        // new checkpoints are saved with the next sync
+        markDirty( file );
+    }
+    syncOverflow();
+    return hash;
+}
+
+void FilePool::drop( std::string const& _path ) {
+    auto it = m_open.find( _path );
+    if ( it != m_open.end() ) {
+        m_lru.erase( it->second );
+        m_open.erase( it );
+    }
+    auto dirty = m_dirty.find( _path );
+    if ( dirty != m_dirty.end() ) {
+        m_dirtyOrder.erase( dirty->second );
+        m_dirty.erase( dirty );
+    }
+}
+
+void FilePool::forget( std::string const& _path ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    drop( _path );
+}
+
+void FilePool::forgetDirectory( std::string const& _directory ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::vector< std::string > paths;
+    for ( auto const& entry : m_open )
+        if ( isUnder( entry.first, _directory ) )
+            paths.push_back( entry.first );
+    for ( auto const& entry : m_dirty )
+        if ( isUnder( entry.first, _directory ) )
+            paths.push_back( entry.first );
+    for ( auto const& path : paths )
+        drop( path );
+}
+
+size_t FilePool::sync() {
+    std::list< FilePtr > dirty;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        dirty.swap( m_dirtyOrder );
+        m_dirty.clear();
+    }
+    for ( FilePtr const& file : dirty )
+        syncFile( *file );
+    return dirty.size();
+}
+
+size_t FilePool::openFiles() const {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    size_t count = m_lru.size();
+    for ( auto const& entry : m_dirty )
+        if ( !m_open.count( entry.first ) )
+            ++count;
+    return count;
+}
+
+size_t FilePool::dirtyFiles() const {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_dirtyOrder.size();
+}
+
+}  // namespace skale
@@ -0,0 +1,112 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file FilePool.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+namespace skale {
+
+/// Open descriptors of filestorage files, shared by all OverlayFS instances and the
+/// readChunk/uploadChunk precompiles.
+/// Chunks are read and written with pread/pwrite on a descriptor kept in an LRU instead of
+/// opening the file for every operation. Every access stats the path and reopens the file if it
+/// was replaced, so files changed behind the pool are still seen.
+/// Written files are not synced one by one: sync() flushes all of them, and saves their hash
+/// sidecars, once per block. Files written before the others are synced and closed early when
+/// more than capacity files wait for sync, so open descriptors stay bounded. The pool only sees
+/// operations OverlayFS has committed, so reverted operations never reach it.
+class FilePool {
+public:
+    static constexpr size_t c_defaultCapacity = 256;
+
+    static FilePool& instance();
+
+    explicit FilePool( size_t _capacity = c_defaultCapacity );
+    ~FilePool();
+
+    FilePool( FilePool const& ) = delete;
+    FilePool& operator=( FilePool const& ) = delete;
+
+    /// @throws std::runtime_error if there is no regular file at @a _path.
+    size_t fileSize( std::string const& _path );
+
+    /// Reads exactly @a _length bytes at @a _position.
+    /// @throws std::runtime_error if the file is shorter or cannot be read.
+    void read( std::string const& _path, size_t _position, _byte_* o_data, size_t _length );
+
+    /// Writes @a _length bytes at @a _position and updates the hash state of the file.
+    /// @throws std::runtime_error if the file does not exist or cannot be written.
+    void write( std::string const& _path, size_t _position, _byte_ const* _data, size_t _length );
+
+    /// File hash in the format of the ._hash files, see FileHashState.
+    dev::h256 fileHash( std::string const& _path );
+
+    /// Closes the file and drops its unsaved hash state, before it is deleted or recreated.
+    void forget( std::string const& _path );
+
+    /// forget() for every file under @a _directory.
+    void forgetDirectory( std::string const& _directory );
+
+    /// fdatasync()s every file written since the last call and saves its hash sidecar.
+    /// @returns the number of files synced.
+    size_t sync();
+
+    /// Number of files with an open descriptor, including written ones evicted from the LRU.
+    size_t openFiles() const;
+
+    /// Number of files written since the last sync, never much over capacity.
+    size_t dirtyFiles() const;
+
+private:
+    struct File;
+    using FilePtr = std::shared_ptr< File >;
+
+    FilePtr acquire( std::string const& _path, struct stat& o_st );
+    void writeChunk(
+        std::string const& _path, size_t _position, _byte_ const* _data, size_t _length );
+    void markDirty( FilePtr const& _file );
+    /// Syncs files written first while more than capacity files are dirty.
+    void syncOverflow();
+    static void syncFile( File& _file );
+    void drop( std::string const& _path );
+
+    size_t const m_capacity;
+    mutable std::mutex m_mutex;
+    std::list< FilePtr > m_lru;  // most recently used first
+    std::unordered_map< std::string, std::list< FilePtr >::iterator > m_open;
+    // written since the last sync, first written first; kept open after eviction until synced
+    std::list< FilePtr > m_dirtyOrder;
+    std::unordered_map< std::string, std::list< FilePtr >::iterator > m_dirty;
+};
+
+}  // namespace skale
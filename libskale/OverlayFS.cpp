@@ -23,9 +23,10 @@
  */
 
 #include "OverlayFS.h"
+#include "FileHashState.h"
+#include "FilePool.h"
 #include "RevertableFSPatch.h"
 #include <libdevcrypto/Hash.h>
-#include <secp256k1_sha256.h>
 #include <fstream>
 
 
@@ -34,12 +35,14 @@ namespace skale {
 
 bool CreateFileOp::execute() {
     try {
+        FilePool::instance().forget( this->filePath );
         std::fstream file;
         file.open( this->filePath, std::ios::out );
         if ( fileSize > 0 ) {
             file.seekp( static_cast< long >( fileSize ) - 1 );
             file.write( "0", 1 );
         }
+        FileHashState::remove( this->filePath );
         return true;
     } catch ( std::exception& ex ) {
         std::string strError = ex.what();
@@ -73,10 +76,12 @@ bool CreateDirectoryOp::execute() {
 
 bool DeleteFileOp::execute() {
     try {
+        FilePool::instance().forget( this->path );
         bool isDeleted = boost::filesystem::remove( this->path );
         if ( !isDeleted ) {
             throw std::runtime_error( "DeleteFileOp failed because cannot delete file" );
         }
+        FileHashState::remove( this->path );
         return true;
     } catch ( std::exception& ex ) {
         std::string strError = ex.what();
@@ -91,6 +96,7 @@ bool DeleteFileOp::execute() {
 
 bool DeleteDirectoryOp::execute() {
     try {
+        FilePool::instance().forgetDirectory( this->path );
         bool isDeleted = boost::filesystem::remove_all( this->path );
         if ( !isDeleted ) {
             throw std::runtime_error( "DeleteDirectoryOp failed because cannot delete directory" );
@@ -109,10 +115,8 @@ bool DeleteDirectoryOp::execute() {
 
 bool WriteChunkOp::execute() {
     try {
-        std::fstream file;
-        file.open( this->path, std::ios::binary | std::ios::out | std::ios::in );
-        file.seekp( static_cast< long >( this->position ) );
-        file.write( reinterpret_cast< const char* >( &this->data[0] ), this->dataLength );
+        FilePool::instance().write(
+            this->path, this->position, this->data.data(), this->dataLength );
         return true;
     } catch ( std::exception& ex ) {
         std::string strError = ex.what();
@@ -127,28 +131,9 @@ bool WriteChunkOp::execute() {
 
 bool CalculateFileHash::execute() {
     try {
-        std::ifstream file( this->path );
-        file.seekg( 0, std::ios::end );
-        size_t fileSize = file.tellg();
-        std::string fileContent( fileSize, ' ' );
-        file.seekg( 0 );
-        file.read( &fileContent[0], fileSize );
-
         const std::string fileHashName = this->path + "._hash";
 
-        std::string relativePath = this->path.substr( this->path.find( "filestorage" ) );
-
-        dev::h256 filePathHash = dev::sha256( relativePath );
-
-        dev::h256 fileContentHash = dev::sha256( fileContent );
-
-        secp256k1_sha256_t ctx;
-        secp256k1_sha256_initialize( &ctx );
-        secp256k1_sha256_write( &ctx, filePathHash.data(), filePathHash.size );
-        secp256k1_sha256_write( &ctx, fileContentHash.data(), fileContentHash.size );
-
-        dev::h256 commonFileHash;
-        secp256k1_sha256_finalize( &ctx, commonFileHash.data() );
+        dev::h256 commonFileHash = FilePool::instance().fileHash( this->path );
 
         std::fstream fileHash;
         fileHash.open( fileHashName, std::ios::binary | std::ios::out );
@@ -73,6 +73,8 @@ State::State( dev::u256 const& _accountStartNonce, boost::filesystem::path const
     : x_db_ptr( make_shared< boost::shared_mutex >() ),
       m_storedVersion( make_shared< size_t >( 0 ) ),
       m_currentVersion( *m_storedVersion ),
+      m_latestReadCache( make_shared< StateReadCache::Latest >() ),
+      m_writeLog( make_shared< StateWriteLog >() ),
       m_accountStartNonce( _accountStartNonce ),
       m_initial_funds( _initialFunds ),
       contractStorageLimit_( _contractStorageLimit )
@@ -122,6 +124,8 @@ State::State( u256 const& _accountStartNonce, OverlayDB const& _db,
       m_db_ptr( make_shared< OverlayDB >( _db ) ),
       m_storedVersion( make_shared< size_t >( 0 ) ),
       m_currentVersion( *m_storedVersion ),
+      m_latestReadCache( make_shared< StateReadCache::Latest >() ),
+      m_writeLog( make_shared< StateWriteLog >() ),
       m_accountStartNonce( _accountStartNonce ),
       m_initial_funds( _initialFunds ),
       contractStorageLimit_( _contractStorageLimit )
@@ -263,6 +267,10 @@ State::State( const State& _s )
     m_orig_db = _s.m_orig_db;
     m_storedVersion = _s.m_storedVersion;
     m_currentVersion = _s.m_currentVersion;
+    m_latestReadCache = _s.m_latestReadCache;
+    m_readCache = _s.m_readCache;
+    m_writeLog = _s.m_writeLog;
+    m_readSet = _s.m_readSet;
     m_cache = _s.m_cache;
     m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
     m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
@@ -273,6 +281,26 @@ State::State( const State& _s )
     totalStorageUsed_ = _s.storageUsedTotal();
 }
 
+State::State( const State& _s, ReadOnlyOverlay )
+#ifdef HISTORIC_STATE
+    : m_historicState( _s.m_historicState )
+#endif
+{
+    x_db_ptr = _s.x_db_ptr;
+    m_db_read_lock.emplace( *x_db_ptr );
+    m_db_ptr = _s.m_db_ptr;
+    m_orig_db = _s.m_orig_db;
+    m_storedVersion = _s.m_storedVersion;
+    m_currentVersion = *m_storedVersion;
+    m_latestReadCache = _s.m_latestReadCache;
+    m_readCache = m_latestReadCache->get( m_currentVersion );
+    m_writeLog = _s.m_writeLog;
+    m_accountStartNonce = _s.m_accountStartNonce;
+    m_initial_funds = _s.m_initial_funds;
+    contractStorageLimit_ = _s.contractStorageLimit_;
+    totalStorageUsed_ = m_db_ptr->storageUsed();
+}
+
 State& State::operator=( const State& _s ) {
     x_db_ptr = _s.x_db_ptr;
     if ( _s.m_db_read_lock ) {
@@ -285,6 +313,10 @@ State& State::operator=( const State& _s ) {
     m_orig_db = _s.m_orig_db;
     m_storedVersion = _s.m_storedVersion;
     m_currentVersion = _s.m_currentVersion;
+    m_latestReadCache = _s.m_latestReadCache;
+    m_readCache = _s.m_readCache;
+    m_writeLog = _s.m_writeLog;
+    m_readSet = _s.m_readSet;
     m_cache = _s.m_cache;
     m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
     m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
@@ -434,6 +466,9 @@ eth::Account* State::account( Address const& _address ) {
     if ( m_nonExistingAccountsCache.count( _address ) )
         return nullptr;
 
+    if ( m_readSet )
+        m_readSet->noteAccount( _address );
+
     // Populate basic info.
     bytes stateBack;
     {
@@ -445,7 +480,12 @@ eth::Account* State::account( Address const& _address ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
 
-        stateBack = asBytes( m_db_ptr->lookup( _address ) );
+        StateReadCache* readCache = sharedReadCache();
+        if ( !readCache || !readCache->account( _address, stateBack ) ) {
+            stateBack = asBytes( m_db_ptr->lookup( _address ) );
+            if ( readCache )
+                readCache->noteAccount( _address, stateBack );
+        }
     }
     if ( stateBack.empty() ) {
         m_nonExistingAccountsCache.insert( _address );
@@ -501,6 +541,11 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
             BOOST_THROW_EXCEPTION( AttemptToWriteToStateInThePast() );
         }
 
+        // keys changed by this commit, for recorded reads to check
+        std::shared_ptr< StateWriteSet > writes;
+        if ( m_writeLog->enabled() )
+            writes = make_shared< StateWriteSet >();
+
         for ( auto const& addressAccountPair : m_cache ) {
             const Address& address = addressAccountPair.first;
             const eth::Account& account = addressAccountPair.second;
@@ -512,7 +557,11 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
 
                     if ( StorageDestructionPatch::isEnabled() ) {
                         clearStorage( address );
+                        if ( writes )
+                            writes->clearedStorage.insert( address );
                     }
+                    if ( writes )
+                        writes->accounts.insert( address );
 
                 } else {
                     RLPStream rlpStream( 4 );
@@ -521,6 +570,9 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
                               << account.storageUsed();
                     auto rawValue = rlpStream.out();
 
+                    // accounts are dirty for storage changes too, which leave the record as it is
+                    if ( writes && account.recordChanged() )
+                        writes->accounts.insert( address );
                     m_db_ptr->insert( address, ref( rawValue ) );
 
                     for ( auto const& storageAddressValuePair : account.storageOverlay() ) {
@@ -528,6 +580,8 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
                         const u256& value = storageAddressValuePair.second;
 
                         m_db_ptr->insert( address, storageAddress, value );
+                        if ( writes )
+                            writes->storage[address].insert( h256( storageAddress ) );
                     }
 
                     if ( account.hasNewCode() ) {
@@ -540,6 +594,7 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
         m_db_ptr->updateStorageUsage( totalStorageUsed_ );
         m_db_ptr->commit( std::to_string( ++*m_storedVersion ) );
         m_currentVersion = *m_storedVersion;
+        m_writeLog->note( m_currentVersion, std::move( writes ) );
     }
 
 
@@ -712,11 +767,19 @@ u256 State::storage( Address const& _id, u256 const& _key ) const {
             return memoryIterator->second;
 
         // Not in the storage cache - go to the DB.
+        if ( m_readSet )
+            m_readSet->noteStorage( _id, _key );
         boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
-        u256 value = m_db_ptr->lookup( _id, _key );
+        u256 value;
+        StateReadCache* readCache = sharedReadCache();
+        if ( !readCache || !readCache->storage( _id, _key, value ) ) {
+            value = u256( m_db_ptr->lookup( _id, _key ) );
+            if ( readCache )
+                readCache->noteStorage( _id, _key, value );
+        }
         acc->setStorageCache( _key, value );
         return value;
     } else
@@ -740,6 +803,8 @@ void State::setStorage( Address const& _contract, u256 const& _key, u256 const&
     storageUsage[_contract] += count * 32;
     currentStorageUsed_ += count * 32;
 
+    // the limit is checked against storage used by all contracts
+    noteUnkeyedRead();
     if ( totalStorageUsed_ + currentStorageUsed_ > contractStorageLimit_ ) {
         BOOST_THROW_EXCEPTION( dev::StorageOverflow() << errinfo_comment( _contract.hex() ) );
     }
@@ -770,11 +835,19 @@ u256 State::originalStorageValue( Address const& _contract, u256 const& _key ) c
             return memoryPtr->second;
         }
 
+        if ( m_readSet )
+            m_readSet->noteStorage( _contract, _key );
         boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
-        u256 value = m_db_ptr->lookup( _contract, _key );
+        u256 value;
+        StateReadCache* readCache = sharedReadCache();
+        if ( !readCache || !readCache->storage( _contract, _key, value ) ) {
+            value = u256( m_db_ptr->lookup( _contract, _key ) );
+            if ( readCache )
+                readCache->noteStorage( _contract, _key, value );
+        }
         acc->setStorageCache( _key, value );
         return value;
     } else {
@@ -815,19 +888,32 @@ bytes const& State::code( Address const& _addr ) const {
         return NullBytes;
 
     if ( a->code().empty() ) {
-        // Load the code from the backend.
         eth::Account* mutableAccount = const_cast< eth::Account* >( a );
+        auto& codeCache = eth::CodeSizeCache::instance();
+        // code never changes for its hash, cached copy is as good as the backend's
+        if ( auto cached = codeCache.code( a->codeHash() ) ) {
+            mutableAccount->noteCode( std::move( cached ) );
+            return a->code();
+        }
+
+        // Load the code from the backend.
         boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
         mutableAccount->noteCode( m_db_ptr->lookupAuxiliary( _addr, Auxiliary::CODE ) );
-        eth::CodeSizeCache::instance().store( a->codeHash(), a->code().size() );
+        codeCache.storeCode( a->codeHash(), a->sharedCode() );
     }
 
     return a->code();
 }
 
+std::shared_ptr< bytes const > State::sharedCode( Address const& _addr ) const {
+    if ( code( _addr ).empty() )
+        return nullptr;
+    return account( _addr )->sharedCode();
+}
+
 void State::setCode( Address const& _address, bytes&& _code, u256 const& _version ) {
     // rollback assumes that overwriting of the code never happens
     // (not allowed in contract creation logic in Executive)
@@ -852,14 +938,12 @@ size_t State::codeSize( Address const& _a ) const {
         if ( a->hasNewCode() )
             return a->code().size();
         auto& codeSizeCache = eth::CodeSizeCache::instance();
-        h256 codeHash = a->codeHash();
-        if ( codeSizeCache.contains( codeHash ) )
-            return codeSizeCache.get( codeHash );
-        else {
-            size_t size = code( _a ).size();
-            codeSizeCache.store( codeHash, size );
+        size_t size;
+        if ( codeSizeCache.get( a->codeHash(), size ) )
             return size;
-        }
+        size = code( _a ).size();
+        codeSizeCache.store( a->codeHash(), size );
+        return size;
     } else
         return 0;
 }
@@ -938,6 +1022,17 @@ State State::createStateReadOnlyCopy() const {
     return stateCopy;
 }
 
+State State::createReadOnlyOverlay() const {
+    return State( *this, ReadOnlyOverlay() );
+}
+
+void State::recordReads( std::shared_ptr< StateReadSet > _reads ) {
+    assert( m_db_read_lock );
+    m_writeLog->enable();
+    _reads->start( m_currentVersion, m_writeLog );
+    m_readSet = std::move( _reads );
+}
+
 State State::createStateModifyCopy() const {
     State stateCopy = State( *this );
     stateCopy.m_db_write_lock.emplace( *stateCopy.x_db_ptr );
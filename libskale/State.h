@@ -41,6 +41,8 @@
 #include "BaseState.h"
 #include "OverlayDB.h"
 #include "OverlayFS.h"
+#include "StateReadCache.h"
+#include "StateReadSet.h"
 #include <libdevcore/DBImpl.h>
 
 
@@ -307,6 +309,10 @@ public:
     ///          other account. Do not keep it.
     dev::bytes const& code( dev::Address const& _addr ) const;
 
+    /// Get the code of an account for keeping, shared with the state and code cache.
+    /// @returns nullptr if there is no code at that address.
+    std::shared_ptr< dev::bytes const > sharedCode( dev::Address const& _addr ) const;
+
     /// Get the code hash of an account.
     /// @returns EmptySHA3 if no account exists at that address or if there is no code associated
     /// with the address.
@@ -363,6 +369,25 @@ public:
     /// No one can change state while returned object exists.
     State createStateReadOnlyCopy() const;
 
+    /// Create State for read-only execution (calls, gas estimation, traces) at the latest version.
+    /// Holds the read lock like createStateReadOnlyCopy() but copies none of the caches: its own
+    /// cache is the write-set of the execution, committed data comes through a read cache shared
+    /// by all overlays of the version.
+    State createReadOnlyOverlay() const;
+
+    /// @returns the read cache shared with other overlays, null if this is not an overlay.
+    std::shared_ptr< StateReadCache const > readCache() const { return m_readCache; }
+
+    /// Records keys of committed state read from now on in @a _reads, copies of this state record
+    /// there too. Only for overlays, whose read lock keeps the version the reads are valid for.
+    void recordReads( std::shared_ptr< StateReadSet > _reads );
+
+    /// Notes that execution depends on something outside the state, like block context or files.
+    void noteUnkeyedRead() const {
+        if ( m_readSet )
+            m_readSet->noteUnkeyed();
+    }
+
     /// Create State copy to modify data.
     State createStateModifyCopy() const;
 
@@ -402,6 +427,11 @@ public:
 
 
 private:
+    struct ReadOnlyOverlay {};
+
+    /// Overlay of @a _s, @see createReadOnlyOverlay().
+    State( State const& _s, ReadOnlyOverlay );
+
     void updateToLatestVersion();
 
     explicit State( dev::u256 const& _accountStartNonce, skale::OverlayDB const& _db,
@@ -427,6 +457,13 @@ private:
     /// The pointer is valid until the next access to the state or account.
     dev::eth::Account* account( dev::Address const& _addr );
 
+    /// @returns the shared read cache if it can be used, i.e. the read lock keeps its version.
+    StateReadCache* sharedReadCache() const {
+        return m_db_read_lock && m_readCache && m_readCache->version() == m_currentVersion ?
+                   m_readCache.get() :
+                   nullptr;
+    }
+
     /// Purges non-modified entries in m_cache if it grows too large.
     void clearCacheIfTooLarge() const;
 
@@ -474,6 +511,10 @@ private:
     std::shared_ptr< dev::db::DBImpl > m_orig_db;
     std::shared_ptr< size_t > m_storedVersion;
     size_t m_currentVersion;
+    std::shared_ptr< StateReadCache::Latest > m_latestReadCache;
+    std::shared_ptr< StateReadCache > m_readCache;  ///< Set in read-only overlays.
+    std::shared_ptr< StateWriteLog > m_writeLog;
+    std::shared_ptr< StateReadSet > m_readSet;  ///< Set when reads are recorded.
     mutable std::unordered_map< dev::Address, dev::eth::Account > m_cache;  ///< Our address cache.
                                                                             ///< This stores the
                                                                             ///< states of each
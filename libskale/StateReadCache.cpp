@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file StateReadCache.cpp
+ * @date 2026
+ */
+
+#include "StateReadCache.h"
+
+using namespace dev;
+
+namespace skale {
+
+bool StateReadCache::account( Address const& _address, bytes& o_record ) const {
+    Shard const& s = shard( _address );
+    ReadGuard l( s.x_shard );
+    auto it = s.accounts.find( _address );
+    if ( it == s.accounts.end() ) {
+        ++m_misses;
+        return false;
+    }
+    o_record = it->second;
+    ++m_hits;
+    return true;
+}
+
+void StateReadCache::noteAccount( Address const& _address, bytes const& _record ) {
+    if ( !reserveEntry() )
+        return;
+    Shard& s = shard( _address );
+    WriteGuard l( s.x_shard );
+    s.accounts.emplace( _address, _record );
+}
+
+bool StateReadCache::storage( Address const& _address, u256 const& _key, u256& o_value ) const {
+    Shard const& s = shard( _address );
+    ReadGuard l( s.x_shard );
+    auto account = s.storage.find( _address );
+    if ( account != s.storage.end() ) {
+        auto it = account->second.find( h256( _key ) );
+        if ( it != account->second.end() ) {
+            o_value = it->second;
+            ++m_hits;
+            return true;
+        }
+    }
+    ++m_misses;
+    return false;
+}
+
+void StateReadCache::noteStorage( Address const& _address, u256 const& _key, u256 const& _value ) {
+    if ( !reserveEntry() )
+        return;
+    Shard& s = shard( _address );
+    WriteGuard l( s.x_shard );
+    s.storage[_address].emplace( h256( _key ), _value );
+}
+
+bool StateReadCache::reserveEntry() {
+    // may let a few entries over the limit when racing, which is harmless
+    if ( m_entries >= c_maxEntries )
+        return false;
+    ++m_entries;
+    return true;
+}
+
+std::shared_ptr< StateReadCache > StateReadCache::Latest::get( size_t _version ) {
+    Guard l( x_cache );
+    if ( !m_cache || m_cache->version() < _version )
+        m_cache = std::make_shared< StateReadCache >( _version );
+    else if ( m_cache->version() > _version )
+        // a copy left behind by a commit, not worth caching for
+        return std::make_shared< StateReadCache >( _version );
+    return m_cache;
+}
+
+}  // namespace skale
@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file StateReadCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+namespace skale {
+
+/// Committed accounts and storage of one state version as read from the database. It is shared
+/// by the read-only overlays of that version (@see State::createReadOnlyOverlay), so what one
+/// call has read is there for the others. Nothing in it changes while the version is current:
+/// overlays hold the read lock, and a commit makes a new version with an empty cache.
+/// Thread-safe.
+class StateReadCache {
+public:
+    explicit StateReadCache( size_t _version ) : m_version( _version ) {}
+
+    size_t version() const { return m_version; }
+
+    /// @returns true and sets @a o_record to the account record of @a _address as stored in the
+    /// database, empty when there is no such account.
+    bool account( dev::Address const& _address, dev::bytes& o_record ) const;
+    void noteAccount( dev::Address const& _address, dev::bytes const& _record );
+
+    /// @returns true and sets @a o_value to the committed value of @a _key of @a _address.
+    bool storage( dev::Address const& _address, dev::u256 const& _key, dev::u256& o_value ) const;
+    void noteStorage(
+        dev::Address const& _address, dev::u256 const& _key, dev::u256 const& _value );
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+    /// Cache of the latest version, one per database and shared by all State copies using it.
+    class Latest {
+    public:
+        /// @returns cache of @a _version, a new one if the version is newer than the cached one.
+        std::shared_ptr< StateReadCache > get( size_t _version );
+
+    private:
+        dev::Mutex x_cache;
+        std::shared_ptr< StateReadCache > m_cache;
+    };
+
+    /// Entries a version keeps at most, later reads are not cached.
+    static constexpr size_t c_maxEntries = 1 << 18;
+
+private:
+    struct Shard {
+        mutable dev::SharedMutex x_shard;
+        std::unordered_map< dev::Address, dev::bytes > accounts;
+        std::unordered_map< dev::Address, std::unordered_map< dev::h256, dev::u256 > > storage;
+    };
+
+    Shard& shard( dev::Address const& _address ) {
+        return m_shards[_address[dev::Address::size - 1] % m_shards.size()];
+    }
+    Shard const& shard( dev::Address const& _address ) const {
+        return m_shards[_address[dev::Address::size - 1] % m_shards.size()];
+    }
+
+    /// @returns false if the cache is full.
+    bool reserveEntry();
+
+    size_t const m_version;
+    std::array< Shard, 16 > m_shards;
+    std::atomic< size_t > m_entries{ 0 };
+    mutable std::atomic< size_t > m_hits{ 0 };
+    mutable std::atomic< size_t > m_misses{ 0 };
+};
+
+}  // namespace skale
@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file StateReadSet.cpp
+ * @date 2026
+ */
+
+#include "StateReadSet.h"
+
+using namespace dev;
+
+namespace skale {
+
+void StateWriteLog::note( size_t _version, std::shared_ptr< StateWriteSet const > _writes ) {
+    WriteGuard l( x_log );
+    if ( !_writes || ( !m_log.empty() && m_log.back().first + 1 != _version ) )
+        m_log.clear();
+    if ( _writes ) {
+        m_log.emplace_back( _version, std::move( _writes ) );
+        if ( m_log.size() > c_maxVersions )
+            m_log.pop_front();
+    }
+    m_latestVersion = _version;
+}
+
+bool StateWriteLog::untouchedSince( size_t _version, StateReadSet const& _reads ) const {
+    ReadGuard l( x_log );
+    if ( _version == m_latestVersion )
+        return true;
+    // the log must hold every commit after _version
+    if ( m_log.empty() || m_log.front().first > _version + 1 )
+        return false;
+    for ( auto it = m_log.rbegin(); it != m_log.rend() && it->first > _version; ++it )
+        if ( _reads.touchedBy( *it->second ) )
+            return false;
+    return true;
+}
+
+void StateReadSet::noteAccount( Address const& _address ) {
+    if ( m_keys >= c_maxKeys ) {
+        m_exact = false;
+        return;
+    }
+    if ( m_accounts.insert( _address ).second )
+        ++m_keys;
+}
+
+void StateReadSet::noteStorage( Address const& _address, u256 const& _key ) {
+    if ( m_keys >= c_maxKeys ) {
+        m_exact = false;
+        return;
+    }
+    if ( m_storage[_address].insert( h256( _key ) ).second )
+        ++m_keys;
+}
+
+bool StateReadSet::touchedBy( StateWriteSet const& _writes ) const {
+    for ( auto const& address : _writes.accounts )
+        if ( m_accounts.count( address ) )
+            return true;
+    for ( auto const& address : _writes.clearedStorage )
+        if ( m_storage.count( address ) )
+            return true;
+    for ( auto const& written : _writes.storage ) {
+        auto read = m_storage.find( written.first );
+        if ( read == m_storage.end() )
+            continue;
+        auto const& smaller = read->second.size() < written.second.size() ? read->second :
+                                                                             written.second;
+        auto const& larger = &smaller == &read->second ? written.second : read->second;
+        for ( auto const& key : smaller )
+            if ( larger.count( key ) )
+                return true;
+    }
+    return false;
+}
+
+bool StateReadSet::current() const {
+    if ( !m_exact || !m_log )
+        return false;
+    size_t const latest = m_log->latestVersion();
+    size_t const version = m_version;
+    if ( version == latest )
+        return true;
+    if ( !m_log->untouchedSince( version, *this ) )
+        return false;
+    // nothing before latest has to be checked again
+    m_version = latest;
+    return true;
+}
+
+}  // namespace skale
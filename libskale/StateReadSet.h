@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file StateReadSet.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace skale {
+
+class StateReadSet;
+
+/// Keys of committed state a commit has changed.
+struct StateWriteSet {
+    /// Accounts whose record (nonce, balance, code, storage used) changed, created or removed.
+    std::unordered_set< dev::Address > accounts;
+    /// Accounts whose whole storage was cleared.
+    std::unordered_set< dev::Address > clearedStorage;
+    std::unordered_map< dev::Address, std::unordered_set< dev::h256 > > storage;
+};
+
+/// Write-sets of the latest commits to one database, shared by all State copies using it.
+/// Logging starts when the first read set is recorded, until then commits do no extra work.
+/// Thread-safe.
+class StateWriteLog {
+public:
+    /// Starts logging write-sets.
+    void enable() { m_enabled = true; }
+    bool enabled() const { return m_enabled; }
+
+    /// Notes that the commit making @a _version changed @a _writes, null if logging was off.
+    void note( size_t _version, std::shared_ptr< StateWriteSet const > _writes );
+
+    size_t latestVersion() const { return m_latestVersion; }
+
+    /// @returns false if a commit after @a _version changed a key in @a _reads or its write-set
+    /// is not kept any more.
+    bool untouchedSince( size_t _version, StateReadSet const& _reads ) const;
+
+    /// Commits whose write-sets are kept.
+    static constexpr size_t c_maxVersions = 1024;
+
+private:
+    mutable dev::SharedMutex x_log;
+    std::deque< std::pair< size_t, std::shared_ptr< StateWriteSet const > > > m_log;
+    std::atomic< size_t > m_latestVersion{ 0 };
+    std::atomic< bool > m_enabled{ false };
+};
+
+/// Keys of committed state an execution read, @see State::recordReads(). Reads the keys cannot
+/// describe, like block context, files or configuration, make it inexact. Filled by one
+/// execution, afterwards it can be checked from any thread.
+class StateReadSet {
+public:
+    /// Reads beyond this many keys are not tracked, the set becomes inexact.
+    static constexpr size_t c_maxKeys = 4096;
+
+    /// Starts recording at @a _version of the state logged in @a _log.
+    void start( size_t _version, std::shared_ptr< StateWriteLog const > _log ) {
+        m_version = _version;
+        m_log = std::move( _log );
+    }
+
+    void noteAccount( dev::Address const& _address );
+    void noteStorage( dev::Address const& _address, dev::u256 const& _key );
+    /// Notes a read no write-set describes.
+    void noteUnkeyed() { m_exact = false; }
+
+    bool exact() const { return m_exact; }
+    size_t version() const { return m_version; }
+    size_t size() const { return m_keys; }
+
+    /// @returns true if @a _writes changed a key read.
+    bool touchedBy( StateWriteSet const& _writes ) const;
+
+    /// @returns true if everything read is exact and unchanged at the latest version.
+    bool current() const;
+
+private:
+    bool m_exact = true;
+    size_t m_keys = 0;
+    mutable std::atomic< size_t > m_version{ 0 };
+    std::shared_ptr< StateWriteLog const > m_log;
+    std::unordered_set< dev::Address > m_accounts;
+    std::unordered_map< dev::Address, std::unordered_set< dev::h256 > > m_storage;
+};
+
+}  // namespace skale
@@ -29,6 +29,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
 
+#include <jsonrpccpp/common/errors.h>
 #include <jsonrpccpp/common/specificationparser.h>
 
 #include <cassert>
@@ -67,6 +68,7 @@
 #include <skutils/multithreading.h>
 #include <skutils/network.h>
 #include <skutils/task_performance.h>
+#include <skutils/task_trace.h>
 #include <skutils/url.h>
 
 #include <iostream>
@@ -676,6 +678,364 @@ void SkaleStatsSubscriptionManager::unsubscribeAll() {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+static const char g_strWsSubscriptionHubQueueID[] = "ws-subscription-hub";
+
+const size_t SkaleWsSubscriptionHub::g_nDefaultMaxPendingNotificationsPerPeer = 4096;
+
+SkaleWsSubscriptionHub::SkaleWsSubscriptionHub()
+    : nMaxPendingNotificationsPerPeer_( g_nDefaultMaxPendingNotificationsPerPeer ),
+      cntEvictedPeers_( 0 ),
+      cntSerializedEvents_( 0 ),
+      cntDeliveredNotifications_( 0 ) {}
+
+SkaleWsSubscriptionHub::~SkaleWsSubscriptionHub() {
+    // client watches must be removed by owner via hubUnsubscribeAll() while ethereum() is alive
+}
+
+SkaleWsSubscriptionHub::subscription_id_t SkaleWsSubscriptionHub::nextHubSubscriptionID() {
+    hub_lock_type lock( mtxHub_ );
+    subscription_id_t idSubscription = nextHubSubscription_;
+    ++nextHubSubscription_;
+    if ( ( nextHubSubscription_ & SKALED_WS_SUBSCRIPTION_TYPE_MASK ) != 0 )
+        nextHubSubscription_ = 1;  // wrap around, type bits are reserved
+    return idSubscription;
+}
+
+std::vector< std::pair< SkaleWsSubscriptionHub::subscription_id_t,
+    SkaleWsSubscriptionHub::peer_ptr_t > >
+SkaleWsSubscriptionHub::hubSnapshot( const map_subscribers_t& mapSubscribers ) {
+    return std::vector< std::pair< subscription_id_t, peer_ptr_t > >(
+        mapSubscribers.begin(), mapSubscribers.end() );
+}
+
+SkaleWsSubscriptionHub::subscription_id_t SkaleWsSubscriptionHub::hubSubscribeNewHeads(
+    SkaleWsSubscriber* pPeer, bool bIncludeTransactions ) {
+    if ( !pPeer )
+        throw std::runtime_error( "no peer to subscribe" );
+    hub_lock_type lock( mtxHub_ );
+    if ( iwHubNewBlocks_ == unsigned( -1 ) ) {
+        std::function< void( const unsigned& iw, const dev::eth::Block& block ) > fnOnNewBlock =
+            [this]( const unsigned& /*iw*/, const dev::eth::Block& block ) -> void {
+            dev::h256 hBlock = block.info().hash();
+            skutils::dispatch::async(
+                g_strWsSubscriptionHubQueueID, [this, hBlock]() -> void { hubOnNewBlock( hBlock ); } );
+        };
+        iwHubNewBlocks_ = getSSO().ethereum()->installNewBlockWatch( fnOnNewBlock );
+    }
+    subscription_id_t idSubscription = nextHubSubscriptionID();
+    if ( bIncludeTransactions )
+        mapNewHeadsWithTransactions_[idSubscription] = pPeer;
+    else
+        mapNewHeads_[idSubscription] = pPeer;
+    return idSubscription;
+}
+
+SkaleWsSubscriptionHub::subscription_id_t SkaleWsSubscriptionHub::hubSubscribeNewPendingTransactions(
+    SkaleWsSubscriber* pPeer ) {
+    if ( !pPeer )
+        throw std::runtime_error( "no peer to subscribe" );
+    hub_lock_type lock( mtxHub_ );
+    if ( iwHubNewPendingTransactions_ == unsigned( -1 ) ) {
+        std::function< void( const unsigned& iw, const dev::eth::Transaction& t ) > fnOnNewTx =
+            [this]( const unsigned& /*iw*/, const dev::eth::Transaction& t ) -> void {
+            dev::h256 hTransaction = t.sha3();
+            skutils::dispatch::async( g_strWsSubscriptionHubQueueID,
+                [this, hTransaction]() -> void { hubOnNewPendingTransaction( hTransaction ); } );
+        };
+        iwHubNewPendingTransactions_ =
+            getSSO().ethereum()->installNewPendingTransactionWatch( fnOnNewTx );
+    }
+    subscription_id_t idSubscription = nextHubSubscriptionID();
+    mapNewPendingTransactions_[idSubscription] = pPeer;
+    return idSubscription;
+}
+
+SkaleWsSubscriptionHub::subscription_id_t SkaleWsSubscriptionHub::hubSubscribeLogs(
+    SkaleWsSubscriber* pPeer, const dev::eth::LogFilter& logFilter ) {
+    if ( !pPeer )
+        throw std::runtime_error( "no peer to subscribe" );
+    dev::h256 hFilter = logFilter.sha3();
+    hub_lock_type lock( mtxHub_ );
+    log_filter_group_t& group = mapLogFilterGroups_[hFilter];
+    if ( group.iwClient_ == unsigned( -1 ) ) {
+        dev::eth::fnClientWatchHandlerMulti_t fnOnLogs;
+        fnOnLogs += [this, hFilter]( unsigned /*iw*/ ) -> void {
+            skutils::dispatch::async( g_strWsSubscriptionHubQueueID,
+                [this, hFilter]() -> void { hubOnLogFilterChanges( hFilter ); } );
+        };
+        try {
+            group.iwClient_ = getSSO().ethereum()->installWatch(
+                logFilter, dev::eth::Reaping::Automatic, fnOnLogs, true );  // isWS = true
+        } catch ( ... ) {
+            mapLogFilterGroups_.erase( hFilter );
+            throw;
+        }
+    }
+    subscription_id_t idSubscription = nextHubSubscriptionID();
+    group.subscribers_[idSubscription] = pPeer;
+    mapLogSubscriptionFilters_[idSubscription] = hFilter;
+    return idSubscription;
+}
+
+bool SkaleWsSubscriptionHub::hubUnsubscribeNewHeads( subscription_id_t idSubscription ) {
+    hub_lock_type lock( mtxHub_ );
+    if ( mapNewHeads_.erase( idSubscription ) == 0 &&
+         mapNewHeadsWithTransactions_.erase( idSubscription ) == 0 )
+        return false;
+    if ( mapNewHeads_.empty() && mapNewHeadsWithTransactions_.empty() &&
+         iwHubNewBlocks_ != unsigned( -1 ) ) {
+        getSSO().ethereum()->uninstallNewBlockWatch( iwHubNewBlocks_ );
+        iwHubNewBlocks_ = unsigned( -1 );
+    }
+    return true;
+}
+
+bool SkaleWsSubscriptionHub::hubUnsubscribeNewPendingTransactions(
+    subscription_id_t idSubscription ) {
+    hub_lock_type lock( mtxHub_ );
+    if ( mapNewPendingTransactions_.erase( idSubscription ) == 0 )
+        return false;
+    if ( mapNewPendingTransactions_.empty() && iwHubNewPendingTransactions_ != unsigned( -1 ) ) {
+        getSSO().ethereum()->uninstallNewPendingTransactionWatch( iwHubNewPendingTransactions_ );
+        iwHubNewPendingTransactions_ = unsigned( -1 );
+    }
+    return true;
+}
+
+bool SkaleWsSubscriptionHub::hubUnsubscribeLogs( subscription_id_t idSubscription ) {
+    hub_lock_type lock( mtxHub_ );
+    auto itFilter = mapLogSubscriptionFilters_.find( idSubscription );
+    if ( itFilter == mapLogSubscriptionFilters_.end() )
+        return false;
+    dev::h256 hFilter = itFilter->second;
+    mapLogSubscriptionFilters_.erase( itFilter );
+    auto itGroup = mapLogFilterGroups_.find( hFilter );
+    if ( itGroup == mapLogFilterGroups_.end() )
+        return true;
+    itGroup->second.subscribers_.erase( idSubscription );
+    if ( itGroup->second.subscribers_.empty() ) {
+        if ( itGroup->second.iwClient_ != unsigned( -1 ) )
+            getSSO().ethereum()->uninstallWatch( itGroup->second.iwClient_ );
+        mapLogFilterGroups_.erase( itGroup );
+    }
+    return true;
+}
+
+bool SkaleWsSubscriptionHub::hubUnsubscribeImpl( subscription_id_t idSubscription ) {
+    // any kind, ids are unique across all kinds
+    if ( hubUnsubscribeLogs( idSubscription ) )
+        return true;
+    if ( hubUnsubscribeNewHeads( idSubscription ) )
+        return true;
+    return hubUnsubscribeNewPendingTransactions( idSubscription );
+}
+
+void SkaleWsSubscriptionHub::hubUnsubscribeAll() {
+    hub_lock_type lock( mtxHub_ );
+    std::list< subscription_id_t > lst;
+    for ( const auto& entry : mapNewHeads_ )
+        lst.push_back( entry.first );
+    for ( const auto& entry : mapNewHeadsWithTransactions_ )
+        lst.push_back( entry.first );
+    for ( const auto& entry : mapNewPendingTransactions_ )
+        lst.push_back( entry.first );
+    for ( const auto& entry : mapLogSubscriptionFilters_ )
+        lst.push_back( entry.first );
+    for ( const subscription_id_t& idSubscription : lst ) {
+        try {
+            hubUnsubscribeImpl( idSubscription );
+        } catch ( ... ) {
+        }
+    }
+}
+
+nlohmann::json SkaleWsSubscriptionHub::hubStats() const {
+    nlohmann::json jo = nlohmann::json::object();
+    hub_lock_type lock( mtxHub_ );
+    jo["newHeads"] = mapNewHeads_.size() + mapNewHeadsWithTransactions_.size();
+    jo["newPendingTransactions"] = mapNewPendingTransactions_.size();
+    jo["logs"] = mapLogSubscriptionFilters_.size();
+    jo["distinctLogFilters"] = mapLogFilterGroups_.size();
+    jo["serializedEvents"] = size_t( cntSerializedEvents_ );
+    jo["deliveredNotifications"] = size_t( cntDeliveredNotifications_ );
+    jo["evictedPeers"] = size_t( cntEvictedPeers_ );
+    return jo;
+}
+
+void SkaleWsSubscriptionHub::hubOnNewBlock( const dev::h256& hBlock ) {
+    std::vector< std::pair< subscription_id_t, peer_ptr_t > > vecHeads, vecHeadsWithTransactions;
+    {  // block
+        hub_lock_type lock( mtxHub_ );
+        vecHeads = hubSnapshot( mapNewHeads_ );
+        vecHeadsWithTransactions = hubSnapshot( mapNewHeadsWithTransactions_ );
+    }  // block
+    dev::eth::Interface* pEthereum = getSSO().ethereum();
+    auto fnSerialize = [&]( bool bIncludeTransactions ) -> buffer_ptr_t {
+        Json::Value jv;
+        if ( bIncludeTransactions )
+            jv = dev::eth::toJson( pEthereum->blockInfo( hBlock ),
+                pEthereum->blockDetails( hBlock ), pEthereum->uncleHashes( hBlock ),
+                pEthereum->transactions( hBlock ), pEthereum->sealEngine() );
+        else
+            jv = dev::eth::toJson( pEthereum->blockInfo( hBlock ),
+                pEthereum->blockDetails( hBlock ), pEthereum->uncleHashes( hBlock ),
+                pEthereum->transactionHashes( hBlock ), pEthereum->sealEngine() );
+        Json::FastWriter fastWriter;
+        std::string s = fastWriter.write( jv );
+        ++cntSerializedEvents_;
+        // re-dump keeps notification text byte-identical to what peers received before
+        return std::make_shared< const std::string >( nlohmann::json::parse( s ).dump() );
+    };
+    if ( !vecHeads.empty() )
+        hubFanOut( "eth_subscription/newHeads", SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK, vecHeads,
+            fnSerialize( false ) );
+    if ( !vecHeadsWithTransactions.empty() )
+        hubFanOut( "eth_subscription/newHeads", SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK,
+            vecHeadsWithTransactions, fnSerialize( true ) );
+}
+
+void SkaleWsSubscriptionHub::hubOnNewPendingTransaction( const dev::h256& hTransaction ) {
+    std::vector< std::pair< subscription_id_t, peer_ptr_t > > vecSubscribers;
+    {  // block
+        hub_lock_type lock( mtxHub_ );
+        vecSubscribers = hubSnapshot( mapNewPendingTransactions_ );
+    }  // block
+    if ( vecSubscribers.empty() )
+        return;
+    ++cntSerializedEvents_;
+    buffer_ptr_t pResult =
+        std::make_shared< const std::string >( "\"" + dev::toJS( hTransaction ) + "\"" );
+    hubFanOut( "eth_subscription/newPendingTransactions",
+        SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION, vecSubscribers, pResult );
+}
+
+void SkaleWsSubscriptionHub::hubOnLogFilterChanges( const dev::h256& hFilter ) {
+    unsigned iwClient = unsigned( -1 );
+    std::vector< std::pair< subscription_id_t, peer_ptr_t > > vecSubscribers;
+    {  // block
+        hub_lock_type lock( mtxHub_ );
+        auto itGroup = mapLogFilterGroups_.find( hFilter );
+        if ( itGroup == mapLogFilterGroups_.end() )
+            return;
+        iwClient = itGroup->second.iwClient_;
+        vecSubscribers = hubSnapshot( itGroup->second.subscribers_ );
+    }  // block
+    if ( iwClient == unsigned( -1 ) )
+        return;
+    // one checkWatch() and one serialization per filter, shared by all its subscribers
+    dev::eth::LocalisedLogEntries le = getSSO().ethereum()->checkWatchSafe( iwClient );
+    if ( le.empty() || vecSubscribers.empty() )
+        return;
+    nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
+    if ( !joResult.is_array() )
+        throw std::runtime_error( "Log entries should be array" );
+    for ( const auto& joRW : joResult ) {
+        if ( joRW.count( "logs" ) == 0 || joRW.count( "blockHash" ) == 0 ||
+             joRW.count( "blockNumber" ) == 0 )
+            continue;
+        const std::string strBlockHash = joRW["blockHash"].get< std::string >();
+        const std::string strBlockNumber = joRW["blockNumber"].get< std::string >();
+        const nlohmann::json& joResultLogs = joRW["logs"];
+        if ( !joResultLogs.is_array() )
+            throw std::runtime_error( "Result logs should be array" );
+        for ( const auto& joWalk : joResultLogs ) {
+            if ( !joWalk.is_object() )
+                continue;
+            nlohmann::json joLog = joWalk;  // copy
+            joLog["blockHash"] = strBlockHash;
+            joLog["blockNumber"] = strBlockNumber;
+            ++cntSerializedEvents_;
+            hubFanOut( "eth_subscription/logs", 0, vecSubscribers,
+                std::make_shared< const std::string >( joLog.dump() ) );
+        }
+    }
+}
+
+bool SkaleWsSubscriptionHub::hubReservePending(
+    std::atomic_size_t& nPending, size_t nMaxPending ) {
+    size_t n = ++nPending;
+    if ( nMaxPending > 0 && n > nMaxPending ) {
+        --nPending;
+        return false;
+    }
+    return true;
+}
+
+void SkaleWsSubscriptionHub::hubFanOut( const char* strSubscriptionKind,
+    subscription_id_t nTypeBits,
+    const std::vector< std::pair< subscription_id_t, peer_ptr_t > >& vecSubscribers,
+    const buffer_ptr_t& pResult ) {
+    const size_t nMaxPending = nMaxPendingNotificationsPerPeer_;
+    std::string strKind( strSubscriptionKind );
+    // the envelope is serialized once, peers differ in the subscription id only; keys are in
+    // the same order nlohmann::json::dump() used to produce
+    std::string strEnvelope;
+    strEnvelope.reserve( pResult->size() + 96 );
+    strEnvelope += "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{\"result\":";
+    strEnvelope += ( *pResult );
+    strEnvelope += ",\"subscription\":\"";
+    buffer_ptr_t pEnvelope = std::make_shared< const std::string >( std::move( strEnvelope ) );
+    for ( const auto& subscriber : vecSubscribers ) {
+        const subscription_id_t idSubscription = subscriber.first;
+        peer_ptr_t pPeer = subscriber.second;
+        if ( !pPeer || !pPeer->hubIsConnected() )
+            continue;
+        if ( !hubReservePending( pPeer.get_unconst()->nPendingNotifications_, nMaxPending ) ) {
+            hubEvictPeer( pPeer, strSubscriptionKind );
+            continue;
+        }
+        pPeer.get_unconst()->hubPost(
+            [this, pPeer, idSubscription, nTypeBits, pEnvelope, strKind]() -> void {
+                --pPeer.get_unconst()->nPendingNotifications_;
+                // a per-peer copy costs no more than the one the WebSocket transport makes of
+                // every outgoing message into its own framed buffer
+                std::string strNotification;
+                strNotification.reserve( pEnvelope->size() + 32 );
+                strNotification += ( *pEnvelope );
+                strNotification += dev::toJS( idSubscription | nTypeBits );
+                strNotification += "\"}}";
+                if ( pPeer.get_unconst()->hubSend( strKind, strNotification ) ) {
+                    ++cntDeliveredNotifications_;
+                    return;
+                }
+                try {
+                    hubUnsubscribeImpl( idSubscription );
+                } catch ( ... ) {
+                }
+            } );
+    }
+}
+
+void SkaleWsSubscriptionHub::hubEvictPeer( peer_ptr_t pPeer, const char* strSubscriptionKind ) {
+    std::list< subscription_id_t > lst;
+    {  // block
+        hub_lock_type lock( mtxHub_ );
+        auto fnCollect = [&]( const map_subscribers_t& mapSubscribers ) {
+            for ( const auto& entry : mapSubscribers )
+                if ( entry.second.get() == pPeer.get() )
+                    lst.push_back( entry.first );
+        };
+        fnCollect( mapNewHeads_ );
+        fnCollect( mapNewHeadsWithTransactions_ );
+        fnCollect( mapNewPendingTransactions_ );
+        for ( const auto& entry : mapLogFilterGroups_ )
+            fnCollect( entry.second.subscribers_ );
+    }  // block
+    if ( lst.empty() )
+        return;  // already evicted
+    for ( const subscription_id_t& idSubscription : lst ) {
+        try {
+            hubUnsubscribeImpl( idSubscription );
+        } catch ( ... ) {
+        }
+    }
+    ++cntEvictedPeers_;
+    pPeer.get_unconst()->hubEvicted( strSubscriptionKind );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkaleServerConnectionsTrackHelper::SkaleServerConnectionsTrackHelper( SkaleServerOverride& sso )
     : m_sso( sso ) {
     m_sso.connection_counter_inc();
@@ -707,6 +1067,65 @@ SkaleWsPeer::~SkaleWsPeer() {
     skutils::dispatch::remove( m_strPeerQueueID );
 }
 
+void SkaleWsPeer::hubPost( std::function< void() > fn ) {
+    skutils::dispatch::async( m_strPeerQueueID, fn );
+}
+
+bool SkaleWsPeer::hubSend(
+    const std::string& strSubscriptionKind, const std::string& strNotification ) {
+    if ( pso()->opts_.isTraceCalls_ )
+        clog( dev::VerbosityDebug, cc::info( getRelay().nfoGetSchemeUC() ) )
+            << ( cc::ws_tx_inv( " <<< " + getRelay().nfoGetSchemeUC() + "/TX <<< " ) + desc() +
+                   cc::ws_tx( " <<< " ) +
+                   implPreformatTrafficJsonMessage( strNotification, false ) );
+    bool bMessageSentOK = false;
+    try {
+        bMessageSentOK = sendMessage( strNotification );
+        if ( !bMessageSentOK )
+            throw std::runtime_error( strSubscriptionKind + " failed to sent message" );
+        stats::register_stats_answer(
+            ( std::string( "RPC/" ) + getRelay().nfoGetSchemeUC() ).c_str(),
+            strSubscriptionKind.c_str(), strNotification.size() );
+        stats::register_stats_answer(
+            "RPC", strSubscriptionKind.c_str(), strNotification.size() );
+    } catch ( std::exception& ex ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( getRelay().nfoGetSchemeUC() ) +
+                                                  cc::debug( "/" ) +
+                                                  cc::num10( getRelay().serverIndex() ) )
+            << ( desc() + " " + cc::error( "error in " ) + cc::warn( strSubscriptionKind ) +
+                   cc::error( " will uninstall subscription because of exception: " ) +
+                   cc::warn( ex.what() ) );
+    } catch ( ... ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( getRelay().nfoGetSchemeUC() ) +
+                                                  cc::debug( "/" ) +
+                                                  cc::num10( getRelay().serverIndex() ) )
+            << ( desc() + " " + cc::error( "error in " ) + cc::warn( strSubscriptionKind ) +
+                   cc::error( " will uninstall subscription because of unknown exception" ) );
+    }
+    if ( !bMessageSentOK ) {
+        stats::register_stats_error(
+            ( std::string( "RPC/" ) + getRelay().nfoGetSchemeUC() ).c_str(),
+            strSubscriptionKind.c_str() );
+        stats::register_stats_error( "RPC", strSubscriptionKind.c_str() );
+    }
+    return bMessageSentOK;
+}
+
+void SkaleWsPeer::hubEvicted( const std::string& strSubscriptionKind ) {
+    clog( dev::Verbosity::VerbosityWarning, cc::info( getRelay().nfoGetSchemeUC() ) +
+                                                cc::debug( "/" ) +
+                                                cc::num10( getRelay().serverIndex() ) )
+        << ( desc() + " " + cc::warn( "slow consumer evicted from " ) +
+               cc::info( strSubscriptionKind ) + cc::warn( ", it has " ) +
+               cc::size10( size_t( nPendingNotifications_ ) ) +
+               cc::warn( " undelivered notifications" ) );
+    stats::register_stats_error(
+        ( std::string( "RPC/" ) + getRelay().nfoGetSchemeUC() ).c_str(),
+        "eth_subscription/evicted" );
+    async_close( "too many undelivered subscription notifications",
+        int( skutils::ws::close_status::policy_violation ) );
+}
+
 void SkaleWsPeer::register_ws_conn_for_origin() {
     if ( m_strUnDdosOrigin.empty() ) {
         SkaleServerOverride* pSO = pso();
@@ -910,20 +1329,14 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
             nlohmann::json joID = joRequest["id"];
             //
-            std::string strPerformanceQueueName =
-                skutils::tools::format( "rpc/%s/%zu/%s", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis->getRelay().serverIndex(), pThis->desc( false ).c_str() );
-            std::string strPerformanceActionName =
-                skutils::tools::format( "%s task %zu", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis.get_unconst()->nTaskNumberInPeer_++ );
-            //
             skutils::stats::time_tracker::element_ptr_t rttElement;
             rttElement.emplace( "RPC", pThis->getRelay().nfoGetSchemeUC().c_str(),
                 strMethod.c_str(), pThis->getRelay().serverIndex(), -1 );
             size_t nRequestSize = strRequest.size();
             //
-            skutils::task::performance::action a(
-                strPerformanceQueueName, strPerformanceActionName, joRequest );
+            skutils::task::trace::scope a( pThis->getRelay().traceChannelId(),
+                pSO->traceMethodId( strMethod ), nRequestSize,
+                pThis.get_unconst()->nTaskNumberInPeer_++ );
             if ( pSO->methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
                 clog( pSO->methodTraceVerbosity( strMethod ),
                     cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
@@ -943,6 +1356,9 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                     joRequest );
                 stats::register_stats_message( "RPC", joRequest );
 
+                std::unique_ptr< dev::eth::ExecutionBudget > budget =
+                    pSO->executionBudget_.start( strMethod, pThis->m_strUnDdosOrigin );
+                dev::eth::ExecutionBudget::Scope budgetScope( budget.get() );
                 if ( !pThis.get_unconst()->handleWebSocketSpecificRequest(
                          pThis->getRelay().esm_, joRequest, strResponse ) ) {
                     jsonrpc::IClientConnectionHandler* handler = pSO->GetHandler( "/" );
@@ -958,7 +1374,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                     ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
                     joRequest, joResponse );
                 stats::register_stats_answer( "RPC", joRequest, joResponse );
-                a.set_json_out( joResponse );
+                a.set_response_size( strResponse.size() );
                 bPassed = true;
             } catch ( const std::exception& ex ) {
                 rttElement->setError();
@@ -983,7 +1399,8 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
                     stats::register_stats_exception( "RPC", strMethod.c_str() );
                 }
-                a.set_json_err( joErrorResponce );
+                a.set_error();
+                a.set_response_size( strResponse.size() );
             } catch ( ... ) {
                 rttElement->setError();
                 const char* e = "unknown exception in SkaleServerOverride";
@@ -1009,7 +1426,8 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
                     stats::register_stats_exception( "RPC", strMethod.c_str() );
                 }
-                a.set_json_err( joErrorResponce );
+                a.set_error();
+                a.set_response_size( strResponse.size() );
             }
             if ( pSO->methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
                 clog( pSO->methodTraceVerbosity( strMethod ),
@@ -1094,13 +1512,13 @@ dev::eth::Interface* SkaleWsPeer::ethereum() const {
 
 void SkaleWsPeer::uninstallAllWatches() {
     set_watche_ids_t sw;
+    SkaleServerOverride* pSO = pso();
     //
     sw = setInstalledWatchesLogs_;
     setInstalledWatchesLogs_.clear();
-    auto pEthereum = ethereum();
     for ( auto iw : sw ) {
         try {
-            pEthereum->uninstallWatch( iw );
+            pSO->hubUnsubscribeLogs( iw );
         } catch ( ... ) {
         }
     }
@@ -1109,7 +1527,7 @@ void SkaleWsPeer::uninstallAllWatches() {
     setInstalledWatchesNewPendingTransactions_.clear();
     for ( auto iw : sw ) {
         try {
-            pEthereum->uninstallNewPendingTransactionWatch( iw );
+            pSO->hubUnsubscribeNewPendingTransactions( iw );
         } catch ( ... ) {
         }
     }
@@ -1118,7 +1536,7 @@ void SkaleWsPeer::uninstallAllWatches() {
     setInstalledWatchesNewBlocks_.clear();
     for ( auto iw : sw ) {
         try {
-            pEthereum->uninstallNewBlockWatch( iw );
+            pSO->hubUnsubscribeNewHeads( iw );
         } catch ( ... ) {
         }
     }
@@ -1272,103 +1690,8 @@ void SkaleWsPeer::eth_subscribe_logs(
                 }
             }
         }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        dev::eth::fnClientWatchHandlerMulti_t fnOnSunscriptionEvent;
-        fnOnSunscriptionEvent += [pThis]( unsigned iw ) -> void {
-            skutils::dispatch::async( "logs-rethread", [=]() -> void {
-                skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw]() -> void {
-                    dev::eth::LocalisedLogEntries le = pThis->ethereum()->checkWatch( iw );
-                    nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
-
-                    if ( !joResult.is_array() )
-                        throw std::runtime_error( "Log entries should be array" );
-                    for ( const auto& joRW : joResult ) {
-                        if ( joRW.count( "logs" ) > 0 && joRW.count( "blockHash" ) > 0 &&
-                             joRW.count( "blockNumber" ) > 0 ) {
-                            const std::string strBlockHash = joRW["blockHash"].get< std::string >();
-                            std::string strBlockNumber = joRW["blockNumber"].get< std::string >();
-                            const nlohmann::json& joResultLogs = joRW["logs"];
-                            if ( !joResultLogs.is_array() )
-                                throw std::runtime_error( "Result logs should be array" );
-                            for ( const auto& joWalk : joResultLogs ) {
-                                if ( !joWalk.is_object() )
-                                    continue;
-                                nlohmann::json joLog = joWalk;  // copy
-                                joLog["blockHash"] = strBlockHash;
-                                joLog["blockNumber"] = strBlockNumber;
-                                nlohmann::json joParams = nlohmann::json::object();
-                                joParams["subscription"] = dev::toJS( iw );
-                                joParams["result"] = joLog;
-                                nlohmann::json joNotification = nlohmann::json::object();
-                                joNotification["jsonrpc"] = "2.0";
-                                joNotification["method"] = "eth_subscription";
-                                joNotification["params"] = joParams;
-                                std::string strNotification = joNotification.dump();
-                                const SkaleServerOverride* pSO = pThis->pso();
-                                if ( pSO->opts_.isTraceCalls_ )
-                                    clog( dev::VerbosityDebug,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::ws_tx_inv( " <<< " +
-                                                           pThis->getRelay().nfoGetSchemeUC() +
-                                                           "/TX <<< " ) )
-                                        << ( pThis->desc() + cc::ws_tx( " <<< " ) +
-                                               pThis->implPreformatTrafficJsonMessage(
-                                                   strNotification, false ) );
-                                // skutils::dispatch::async( pThis->m_strPeerQueueID,
-                                // [pThis, strNotification]() -> void {
-                                bool bMessageSentOK = false;
-                                try {
-                                    bMessageSentOK = const_cast< SkaleWsPeer* >( pThis.get() )
-                                                         ->sendMessage( skutils::tools::trim_copy(
-                                                             strNotification ) );
-                                    if ( !bMessageSentOK )
-                                        throw std::runtime_error(
-                                            "eth_subscription/logs failed to sent "
-                                            "message" );
-                                    stats::register_stats_answer(
-                                        ( std::string( "RPC/" ) +
-                                            pThis->getRelay().nfoGetSchemeUC() )
-                                            .c_str(),
-                                        "eth_subscription/logs", strNotification.size() );
-                                    stats::register_stats_answer(
-                                        "RPC", "eth_subscription/logs", strNotification.size() );
-                                } catch ( std::exception& ex ) {
-                                    clog( dev::Verbosity::VerbosityError,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::debug( "/" ) +
-                                            cc::num10( pThis->getRelay().serverIndex() ) )
-                                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                                               cc::warn( "eth_subscription/logs" ) +
-                                               cc::error( " will uninstall watcher callback "
-                                                          "because of exception: " ) +
-                                               cc::warn( ex.what() ) );
-                                } catch ( ... ) {
-                                    clog( dev::Verbosity::VerbosityError,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::debug( "/" ) +
-                                            cc::num10( pThis->getRelay().serverIndex() ) )
-                                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                                               cc::warn( "eth_subscription/logs" ) +
-                                               cc::error( " will uninstall watcher callback "
-                                                          "because of unknown exception" ) );
-                                }
-                                if ( !bMessageSentOK ) {
-                                    stats::register_stats_error(
-                                        ( std::string( "RPC/" ) +
-                                            pThis->getRelay().nfoGetSchemeUC() )
-                                            .c_str(),
-                                        "eth_subscription/logs" );
-                                    stats::register_stats_error( "RPC", "eth_subscription/logs" );
-                                    pThis->ethereum()->uninstallWatch( iw );
-                                }
-                            }
-                        }
-                    }
-                } );
-            } );
-        };
-        unsigned iw = ethereum()->installWatch(
-            logFilter, dev::eth::Reaping::Automatic, fnOnSunscriptionEvent, true );  // isWS = true
+        // log filters with equal hashes share one client watch and one serialization per log
+        unsigned iw = pSO->hubSubscribeLogs( this, logFilter );
         setInstalledWatchesLogs_.insert( iw );
         std::string strIW = dev::toJS( iw );
         if ( pSO->opts_.isTraceCalls_ )
@@ -1410,73 +1733,7 @@ void SkaleWsPeer::eth_subscribe_newPendingTransactions(
     e_server_mode_t /*esm*/, const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) {
     SkaleServerOverride* pSO = pso();
     try {
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        std::function< void( const unsigned& iw, const dev::eth::Transaction& t ) >
-            fnOnSunscriptionEvent =
-                [pThis]( const unsigned& iw, const dev::eth::Transaction& t ) -> void {
-            skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw, t]() -> void {
-                const SkaleServerOverride* pSO = pThis->pso();
-                dev::h256 h = t.sha3();
-                //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] =
-                    dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION );
-                joParams["result"] = dev::toJS( h );  // h.hex()
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
-                if ( pSO->opts_.isTraceCalls_ )
-                    clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
-                        << ( cc::ws_tx_inv(
-                                 " <<< " + pThis->getRelay().nfoGetSchemeUC() + "/TX <<< " ) +
-                               pThis->desc() + cc::ws_tx( " <<< " ) +
-                               pThis->implPreformatTrafficJsonMessage( strNotification, false ) );
-                // skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, strNotification]() ->
-                // void {
-                bool bMessageSentOK = false;
-                try {
-                    bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
-                    if ( !bMessageSentOK )
-                        throw std::runtime_error(
-                            "eth_subscription/newPendingTransactions failed to sent message" );
-                    stats::register_stats_answer(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newPendingTransactions", strNotification.size() );
-                    stats::register_stats_answer(
-                        "RPC", "eth_subscription/newPendingTransactions", strNotification.size() );
-                } catch ( std::exception& ex ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newPendingTransactions" ) +
-                               cc::error(
-                                   " will uninstall watcher callback because of exception: " ) +
-                               cc::warn( ex.what() ) );
-                } catch ( ... ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newPendingTransactions" ) +
-                               cc::error( " will uninstall watcher callback because of unknown "
-                                          "exception" ) );
-                }
-                if ( !bMessageSentOK ) {
-                    stats::register_stats_error(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newPendingTransactions" );
-                    stats::register_stats_error( "RPC", "eth_subscription/newPendingTransactions" );
-                    pThis->ethereum()->uninstallNewPendingTransactionWatch( iw );
-                }
-                //} );
-            } );
-        };
-        unsigned iw = ethereum()->installNewPendingTransactionWatch( fnOnSunscriptionEvent );
+        unsigned iw = pSO->hubSubscribeNewPendingTransactions( this );
         setInstalledWatchesNewPendingTransactions_.insert( iw );
         iw |= SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION;
         std::string strIW = dev::toJS( iw );
@@ -1524,85 +1781,7 @@ void SkaleWsPeer::eth_subscribe_newHeads( e_server_mode_t /*esm*/,
     const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse, bool bIncludeTransactions ) {
     SkaleServerOverride* pSO = pso();
     try {
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        std::function< void( const unsigned& iw, const dev::eth::Block& block ) >
-            fnOnSunscriptionEvent = [pThis, bIncludeTransactions](
-                                        const unsigned& iw, const dev::eth::Block& block ) -> void {
-            skutils::dispatch::async( [pThis, iw, block, bIncludeTransactions]() -> void {
-                const SkaleServerOverride* pSO = pThis->pso();
-                dev::h256 h = block.info().hash();
-                Json::Value jv;
-                if ( bIncludeTransactions )
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactions( h ), pThis->ethereum()->sealEngine() );
-                else
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactionHashes( h ),
-                        pThis->ethereum()->sealEngine() );
-                Json::FastWriter fastWriter;
-                std::string s = fastWriter.write( jv );
-                nlohmann::json joBlockDescription = nlohmann::json::parse( s );
-                //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] = dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK );
-                joParams["result"] = joBlockDescription;
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
-                if ( pSO->opts_.isTraceCalls_ )
-                    clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
-                        << ( cc::ws_tx_inv(
-                                 " <<< " + pThis->getRelay().nfoGetSchemeUC() + "/TX <<< " ) +
-                               pThis->desc() + cc::ws_tx( " <<< " ) +
-                               pThis->implPreformatTrafficJsonMessage( strNotification, false ) );
-                // skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, strNotification]() ->
-                // void {
-                bool bMessageSentOK = false;
-                try {
-                    bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
-                    if ( !bMessageSentOK )
-                        throw std::runtime_error(
-                            "eth_subscription/newHeads failed to sent message" );
-                    stats::register_stats_answer(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newHeads", strNotification.size() );
-                    stats::register_stats_answer(
-                        "RPC", "eth_subscription/newHeads", strNotification.size() );
-                } catch ( std::exception& ex ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newHeads" ) +
-                               cc::error(
-                                   " will uninstall watcher callback because of exception: " ) +
-                               cc::warn( ex.what() ) );
-                } catch ( ... ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newHeads" ) +
-                               cc::error( " will uninstall watcher callback because of unknown "
-                                          "exception" ) );
-                }
-                if ( !bMessageSentOK ) {
-                    stats::register_stats_error(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newHeads" );
-                    stats::register_stats_error( "RPC", "eth_subscription/newHeads" );
-                    pThis->ethereum()->uninstallNewBlockWatch( iw );
-                }
-                //} );
-            } );
-        };
-        unsigned iw = ethereum()->installNewBlockWatch( fnOnSunscriptionEvent );
+        unsigned iw = pSO->hubSubscribeNewHeads( this, bIncludeTransactions );
         setInstalledWatchesNewBlocks_.insert( iw );
         iw |= SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK;
         std::string strIW = dev::toJS( iw );
@@ -1751,7 +1930,8 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallNewPendingTransactionWatch( iw );
+            pSO->hubUnsubscribeNewPendingTransactions(
+                iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
             setInstalledWatchesNewPendingTransactions_.erase(
                 iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
         } else if ( x == SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK ) {
@@ -1774,7 +1954,7 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallNewBlockWatch( iw );
+            pSO->hubUnsubscribeNewHeads( iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
             setInstalledWatchesNewBlocks_.erase( iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
         } else if ( x == SKALED_WS_SUBSCRIPTION_TYPE_SKALE_STATS ) {
             SkaleStatsSubscriptionManager::subscription_id_t idSubscription =
@@ -1817,7 +1997,7 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallWatch( iw );
+            pSO->hubUnsubscribeLogs( iw );
             setInstalledWatchesLogs_.erase( iw );
         }
     }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
@@ -1859,7 +2039,9 @@ SkaleRelayWS::SkaleRelayWS( int ipVer, const char* strBindAddr,
       m_strScheme_( skutils::tools::to_lower( strScheme ) ),
       m_strSchemeUC( skutils::tools::to_upper( strScheme ) ),
       m_nPort( nPort ),
-      esm_( esm ) {
+      esm_( esm ),
+      m_idTraceChannel( skutils::task::trace::intern(
+          "rpc/" + m_strSchemeUC + "/" + std::to_string( nServerIndex ) ) ) {
     //
     if ( !strBindAddr_.empty() ) {
         if ( ipVer_ == 6 ) {
@@ -2074,7 +2256,19 @@ const double SkaleServerOverride::g_lfDefaultExecutionDurationMaxForPerformanceW
 
 SkaleServerOverride::SkaleServerOverride(
     dev::eth::ChainParams& chainParams, dev::eth::Interface* pEth, const opts_t& opts )
-    : AbstractServerConnector(), chainParams_( chainParams ), pEth_( pEth ), opts_( opts ) {
+    : AbstractServerConnector(),
+      chainParams_( chainParams ),
+      pEth_( pEth ),
+      opts_( opts ),
+      idTraceUnknown_( skutils::task::trace::intern( "rpc/unknown" ) ) {
+    //
+    // methods handled here rather than by JSON RPC handler
+    for ( const auto& entry : SkaleWsPeer::g_ws_rpc_map )
+        implInternTraceMethod( entry.first );
+    for ( const auto& entry : g_informational_rpc_map )
+        implInternTraceMethod( entry.first );
+    for ( const auto& entry : g_protocol_rpc_map )
+        implInternTraceMethod( entry.first );
     //
     //
     // proxygen-related init
@@ -2129,6 +2323,7 @@ SkaleServerOverride::~SkaleServerOverride() {
         ethereum()->uninstallNewPendingTransactionWatch( iwPendingTransactionStats_ );
         iwPendingTransactionStats_ = unsigned( -1 );
     }
+    hubUnsubscribeAll();
     StopListening();
 }
 
@@ -2182,6 +2377,37 @@ const dev::eth::ChainParams& SkaleServerOverride::chainParams() const {
     return chainParams_;
 }
 
+void SkaleServerOverride::setTraceMethods( const std::vector< std::string >& vecMethods ) {
+    for ( const std::string& strMethod : vecMethods )
+        implInternTraceMethod( strMethod );
+}
+
+skutils::task::trace::id_type SkaleServerOverride::traceMethodId(
+    const std::string& strMethod ) const {
+    auto itFind = mapTraceMethodIds_.find( strMethod );
+    if ( itFind == mapTraceMethodIds_.end() )
+        return idTraceUnknown_;
+    return itFind->second;
+}
+
+skutils::task::trace::id_type SkaleServerOverride::traceChannelId(
+    const std::string& strProtocol, int nServerIndex ) const {
+    auto itFind = mapTraceChannelIds_.find( std::make_pair( strProtocol, nServerIndex ) );
+    if ( itFind == mapTraceChannelIds_.end() )
+        return idTraceUnknown_;
+    return itFind->second;
+}
+
+void SkaleServerOverride::implInternTraceMethod( const std::string& strMethod ) {
+    mapTraceMethodIds_[strMethod] = skutils::task::trace::intern( strMethod );
+}
+
+void SkaleServerOverride::implInternTraceChannel(
+    const std::string& strProtocol, int nServerIndex ) {
+    mapTraceChannelIds_[std::make_pair( strProtocol, nServerIndex )] =
+        skutils::task::trace::intern( "rpc/" + strProtocol + "/" + std::to_string( nServerIndex ) );
+}
+
 dev::Verbosity SkaleServerOverride::methodTraceVerbosity( const std::string& strMethod ) const {
     // skip if disabled completely
     if ( !this->opts_.isTraceCalls_ && !this->opts_.isTraceSpecialCalls_ )
@@ -2448,12 +2674,8 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
         jarrBatchAnswer = nlohmann::json::array();
     for ( const nlohmann::json& joRequest : jarrRequest ) {
         std::string strBody = joRequest.dump();  // = req.body_;
-        std::string strPerformanceQueueName =
-            skutils::tools::format( "rpc/%s/%zu", strProtocol.c_str(), nServerIndex );
-        std::string strPerformanceActionName = skutils::tools::format(
-            "%s task %zu, %s", strProtocol.c_str(), nTaskNumberCall_++, strMethod.c_str() );
-        skutils::task::performance::action a(
-            strPerformanceQueueName, strPerformanceActionName, joRequest );
+        skutils::task::trace::scope a( traceChannelId( strProtocol, nServerIndex ),
+            skutils::task::trace::c_invalid_id, strBody.size(), nTaskNumberCall_++ );
         //
         skutils::stats::time_tracker::element_ptr_t rttElement;
         rttElement.emplace( "RPC", strProtocol.c_str(), strMethod.c_str(), nServerIndex, ipVer );
@@ -2472,6 +2694,7 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
                 throw std::runtime_error( "server too busy" );
             }
             strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+            a.set_method( traceMethodId( strMethod ) );
             if ( !handleAdminOriginFilter( strMethod, strOrigin ) ) {
                 throw std::runtime_error( "origin not allowed for call attempt" );
             }
@@ -2486,25 +2709,31 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
             std::vector< uint8_t > buffer;
             if ( handleRequestWithBinaryAnswer( esm, joRequest, buffer ) ) {
                 stats::register_stats_answer( strProtocol.c_str(), "POST", buffer.size() );
+                a.set_response_size( buffer.size() );
                 rttElement->stop();
                 rslt.isBinary_ = true;
                 rslt.vecBytes_ = buffer;
                 return rslt;
             }
+            if ( !isBatch && handleRequestWithStreamedAnswer( strProtocol, joRequest, rslt ) ) {
+                rttElement->stop();
+                return rslt;
+            }
+            // eth_call and alike abort when the budget of the method and origin runs out
+            std::unique_ptr< dev::eth::ExecutionBudget > budget =
+                executionBudget_.start( strMethod, str_unddos_origin );
+            dev::eth::ExecutionBudget::Scope budgetScope( budget.get() );
             if ( !handleHttpSpecificRequest( strOrigin, esm, strBody, strResponse ) ) {
                 handler->HandleRequest( strBody.c_str(), strResponse );
             }
+            skutils::tools::rtrim( strResponse );
             //
             stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
-            nlohmann::json joResponse = nlohmann::json::parse( strResponse );
-            stats::register_stats_answer( ( "RPC/" + strProtocol ).c_str(), joRequest, joResponse );
-            stats::register_stats_answer( "RPC", joRequest, joResponse );
+            stats::register_stats_answer(
+                ( "RPC/" + strProtocol ).c_str(), strMethod.c_str(), strResponse.size() );
+            stats::register_stats_answer( "RPC", strMethod.c_str(), strResponse.size() );
             //
-            if ( !isBatch ) {
-                rslt.isBinary_ = false;
-                rslt.joOut_ = nlohmann::json::parse( strResponse );
-            }
-            a.set_json_out( joResponse );
+            a.set_response_size( strResponse.size() );
             bPassed = true;
         } catch ( const std::exception& ex ) {
             rttElement->setError();
@@ -2526,7 +2755,8 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
                 rslt.isBinary_ = false;
                 rslt.joOut_ = joErrorResponce;
             }
-            a.set_json_err( joErrorResponce );
+            a.set_error();
+            a.set_response_size( strResponse.size() );
         } catch ( ... ) {
             rttElement->setError();
             const char* e = "unknown exception in SkaleServerOverride";
@@ -2548,21 +2778,24 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
                 rslt.isBinary_ = false;
                 rslt.joOut_ = joErrorResponce;
             }
-            a.set_json_err( joErrorResponce );
+            a.set_error();
+            a.set_response_size( strResponse.size() );
         }
         if ( methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
             logTraceServerTraffic( false, methodTraceVerbosity( strMethod ), ipVer,
                 strProtocol.c_str(), nServerIndex, esm, strOrigin.c_str(),
                 implPreformatTrafficJsonMessage( strResponse, false ) );
+        if ( !bPassed )
+            stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
         if ( isBatch ) {
             nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
             jarrBatchAnswer.push_back( joAnswerPart );
         } else {
+            // answer text is passed as is, without re-parsing it into JSON object
             rslt.isBinary_ = false;
-            rslt.joOut_ = nlohmann::json::parse( strResponse );
+            rslt.joOut_ = nlohmann::json();
+            rslt.strOut_ = std::move( strResponse );
         }
-        if ( !bPassed )
-            stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
         rttElement->stop();
         double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
         if ( lfExecutionDuration >= opts_.lfExecutionDurationMaxForPerformanceWarning_ )
@@ -2637,8 +2870,11 @@ bool SkaleServerOverride::implStartListening(  // mini HTTP
                 if ( rslt.isBinary_ ) {
                     res.set_content( ( char* ) rslt.vecBytes_.data(), rslt.vecBytes_.size(),
                         "application/octet-stream" );
+                } else if ( rslt.fnStreamOut_ ) {
+                    res.set_content_producer( rslt.fnStreamOut_, "application/octet-stream" );
                 } else {
-                    std::string strOut = rslt.joOut_.dump();
+                    std::string strOut =
+                        rslt.strOut_.empty() ? rslt.joOut_.dump() : std::move( rslt.strOut_ );
                     res.set_content(
                         ( char* ) strOut.c_str(), strOut.size(), "application/octet-stream" );
                 }
@@ -2788,6 +3024,7 @@ bool SkaleServerOverride::implStartListening(  // proxygen HTTP
         // check if somebody is already listening
         stat_check_port_availability_for_server_to_start_listen(
             ipVer, strAddr.c_str(), nPort, esm, bIsSSL ? "HTTPS" : "HTTP", nServerIndex, this );
+        implInternTraceChannel( bIsSSL ? "HTTPS" : "HTTP", nServerIndex );
         //
         pSrv.reset( new SkaleRelayProxygenHTTP( pSO, ipVer, strAddr.c_str(), nPort,
             strPathSslCert.c_str(), strPathSslKey.c_str(), strPathSslCA.c_str(), nServerIndex, esm,
@@ -3484,6 +3721,7 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
     joExecutionPerformance["RPC"] =
         skutils::stats::time_tracker::queue::getQueueForSubsystem( "RPC" ).getAllStats();
     joStats["executionPerformance"] = joExecutionPerformance;
+    joStats["subscriptions"] = hubStats();
     joStats["protocols"]["http"]["listenerCount"] =
         // serversMiniHTTP4std_.size() + serversMiniHTTP4nfo_.size() +
         // serversMiniHTTP6std_.size() + serversMiniHTTP6nfo_.size() +
@@ -3673,6 +3911,101 @@ bool SkaleServerOverride::handleRequestWithBinaryAnswer(
     return false;
 }
 
+// answers with potentially huge arrays are written element by element while they are produced,
+// instead of building whole answer text and its JSON copies first
+bool SkaleServerOverride::handleRequestWithStreamedAnswer( const std::string& strProtocol,
+    const nlohmann::json& joRequest, skutils::result_of_http_request& rslt ) {
+    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+    if ( strMethodName != "eth_getLogs" )
+        return false;
+    dev::eth::Interface* pEthereum = ethereum();
+    if ( !pEthereum )
+        return false;
+    const nlohmann::json& joParams = joRequest["params"];
+    if ( !joParams.is_array() || joParams.size() != 1 || !joParams[0].is_object() )
+        return false;
+    if ( joParams[0].count( "limit" ) > 0 )
+        return false;  // paginated answer is small, let regular handler compose it
+    // logs are fetched page by page while the answer is sent, first page is fetched here so
+    // bad filter gets usual error answer
+    struct logs_stream {
+        dev::eth::LogFilter filter;
+        std::string cursor;
+        dev::eth::LocalisedLogEntries page;
+        size_t next = 0;
+        bool headWritten = false;
+    };
+    static const size_t g_nLogsPageSize = 1024;
+    auto pStream = std::make_shared< logs_stream >();
+    try {
+        Json::Value jvFilter;
+        if ( !Json::Reader().parse( joParams[0].dump(), jvFilter ) )
+            BOOST_THROW_EXCEPTION( std::invalid_argument( "bad filter" ) );
+        pStream->filter = dev::eth::toLogFilter( jvFilter );
+        pStream->page = pEthereum->pendingLogs( pStream->filter );
+        // blocks imported while the answer is sent are not in it
+        unsigned const nLatest = pEthereum->number();
+        if ( unsigned( pStream->filter.latest() ) > nLatest )
+            pStream->filter.withLatest( nLatest );
+        dev::eth::LocalisedLogEntries firstPage =
+            pEthereum->logs( pStream->filter, pStream->cursor, g_nLogsPageSize );
+        pStream->page.insert( pStream->page.end(), std::make_move_iterator( firstPage.begin() ),
+            std::make_move_iterator( firstPage.end() ) );
+    } catch ( ... ) {
+        // same answer as regular handler gives, without running the query again
+        nlohmann::json joError = nlohmann::json::object();
+        joError["code"] = int( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS );
+        joError["message"] =
+            jsonrpc::Errors::GetErrorMessage( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS );
+        rslt.isBinary_ = false;
+        rslt.joOut_ = nlohmann::json::object();
+        rslt.joOut_["id"] = joRequest.count( "id" ) > 0 ? joRequest["id"] : nlohmann::json();
+        rslt.joOut_["jsonrpc"] = "2.0";
+        rslt.joOut_["error"] = joError;
+        std::string strOut = rslt.joOut_.dump();
+        stats::register_stats_answer( strProtocol.c_str(), "POST", strOut.size() );
+        stats::register_stats_answer(
+            ( "RPC/" + strProtocol ).c_str(), strMethodName.c_str(), strOut.size() );
+        stats::register_stats_answer( "RPC", strMethodName.c_str(), strOut.size() );
+        return true;
+    }
+    std::string strHead =
+        "{\"id\":" + joRequest["id"].dump() + ",\"jsonrpc\":\"2.0\",\"result\":[";
+    rslt.isBinary_ = false;
+    rslt.fnStreamOut_ = [pEthereum, pStream, strHead, strProtocol, strMethodName](
+                            skutils::http::stream_writer& w ) -> bool {
+        logs_stream& ls = *pStream;
+        if ( !ls.headWritten ) {
+            w.write( strHead );
+            ls.headWritten = true;
+        }
+        Json::FastWriter fastWriter;
+        while ( !w.full() ) {
+            if ( ls.next == ls.page.size() ) {
+                if ( ls.cursor.empty() )
+                    break;
+                ls.page = pEthereum->logs( ls.filter, ls.cursor, g_nLogsPageSize );
+                ls.next = 0;
+                continue;
+            }
+            if ( w.written() > strHead.size() )
+                w.write( ",", 1 );
+            std::string strEntry = fastWriter.write( dev::eth::toJson( ls.page[ls.next++] ) );
+            skutils::tools::rtrim( strEntry );
+            w.write( strEntry );
+        }
+        if ( ls.next < ls.page.size() || !ls.cursor.empty() )
+            return true;
+        w.write( "]}", 2 );
+        stats::register_stats_answer( strProtocol.c_str(), "POST", size_t( w.written() ) );
+        stats::register_stats_answer(
+            ( "RPC/" + strProtocol ).c_str(), strMethodName.c_str(), size_t( w.written() ) );
+        stats::register_stats_answer( "RPC", strMethodName.c_str(), size_t( w.written() ) );
+        return false;
+    };
+    return true;
+}
+
 bool SkaleServerOverride::handleAdminOriginFilter(
     const std::string& strMethod, const std::string& strOriginURL ) {
     // std::cout << cc::attention( "------------ " ) << cc::info( strOriginURL ) <<
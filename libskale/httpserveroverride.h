@@ -64,12 +64,14 @@ typedef intptr_t ssize_t;
 #include <skutils/dispatch.h>
 #include <skutils/http.h>
 #include <skutils/stats.h>
+#include <skutils/task_trace.h>
 #include <skutils/unddos.h>
 #include <skutils/utils.h>
 #include <skutils/ws.h>
 #include <json.hpp>
 
 #include <libdevcore/Log.h>
+#include <libskale/ExecutionBudgetSettings.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/Interface.h>
 #include <libethereum/LogFilter.h>
@@ -77,6 +79,8 @@ typedef intptr_t ssize_t;
 #include <libweb3jsonrpc/SkaleStatsSite.h>
 
 class SkaleStatsSubscriptionManager;
+class SkaleWsSubscriber;
+class SkaleWsSubscriptionHub;
 struct SkaleServerConnectionsTrackHelper;
 class SkaleWsPeer;
 class SkaleRelayWS;
@@ -126,6 +130,98 @@ public:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Receiver of SkaleWsSubscriptionHub notifications, SkaleWsPeer outside of tests
+class SkaleWsSubscriber {
+public:
+    // queued by SkaleWsSubscriptionHub, not sent yet
+    std::atomic_size_t nPendingNotifications_ = 0;
+    virtual ~SkaleWsSubscriber() {}
+    // reference counting for skutils::retain_release_ptr
+    virtual size_t ref_retain() = 0;
+    virtual size_t ref_release() = 0;
+    virtual bool hubIsConnected() const = 0;
+    // runs fn after everything posted to this subscriber before
+    virtual void hubPost( std::function< void() > fn ) = 0;
+    // returns false if notification of strSubscriptionKind was not sent
+    virtual bool hubSend(
+        const std::string& strSubscriptionKind, const std::string& strNotification ) = 0;
+    // closes connection of subscriber evicted for not draining its notifications
+    virtual void hubEvicted( const std::string& strSubscriptionKind ) = 0;
+};  // class SkaleWsSubscriber
+
+// Shared fan-out of eth_subscribe notifications. Client watches are installed once per
+// subscription kind (and once per distinct log filter), each event is serialized into JSON
+// exactly once and the same immutable buffer is delivered to all matching peers. Peers which
+// do not drain their notification queues fast enough are evicted.
+class SkaleWsSubscriptionHub {
+public:
+    typedef unsigned subscription_id_t;
+    typedef std::shared_ptr< const std::string > buffer_ptr_t;
+    typedef skutils::retain_release_ptr< SkaleWsSubscriber > peer_ptr_t;
+
+    static const size_t g_nDefaultMaxPendingNotificationsPerPeer;
+
+    // takes a queue slot from a peer having nPending undelivered notifications, returns false
+    // without taking it if the peer already has nMaxPending of them, 0 means unlimited
+    static bool hubReservePending( std::atomic_size_t& nPending, size_t nMaxPending );
+
+protected:
+    // own names, SkaleServerOverride derives from both subscription managers
+    typedef skutils::multithreading::recursive_mutex_type hub_mutex_type;
+    typedef std::lock_guard< hub_mutex_type > hub_lock_type;
+    mutable hub_mutex_type mtxHub_;
+
+    subscription_id_t nextHubSubscription_ = 1;
+    subscription_id_t nextHubSubscriptionID();
+
+    typedef std::map< subscription_id_t, peer_ptr_t > map_subscribers_t;
+    map_subscribers_t mapNewHeads_, mapNewHeadsWithTransactions_, mapNewPendingTransactions_;
+    unsigned iwHubNewBlocks_ = unsigned( -1 );
+    unsigned iwHubNewPendingTransactions_ = unsigned( -1 );
+
+    struct log_filter_group_t {
+        unsigned iwClient_ = unsigned( -1 );
+        map_subscribers_t subscribers_;
+    };  /// struct log_filter_group_t
+    std::map< dev::h256, log_filter_group_t > mapLogFilterGroups_;
+    std::map< subscription_id_t, dev::h256 > mapLogSubscriptionFilters_;
+
+    std::atomic_size_t nMaxPendingNotificationsPerPeer_;
+    std::atomic_size_t cntEvictedPeers_;
+    std::atomic_size_t cntSerializedEvents_;
+    std::atomic_size_t cntDeliveredNotifications_;
+
+    void hubOnNewBlock( const dev::h256& hBlock );
+    void hubOnNewPendingTransaction( const dev::h256& hTransaction );
+    void hubOnLogFilterChanges( const dev::h256& hFilter );
+    void hubFanOut( const char* strSubscriptionKind, subscription_id_t nTypeBits,
+        const std::vector< std::pair< subscription_id_t, peer_ptr_t > >& vecSubscribers,
+        const buffer_ptr_t& pResult );
+    void hubEvictPeer( peer_ptr_t pPeer, const char* strSubscriptionKind );
+    bool hubUnsubscribeImpl( subscription_id_t idSubscription );
+    static std::vector< std::pair< subscription_id_t, peer_ptr_t > > hubSnapshot(
+        const map_subscribers_t& mapSubscribers );
+
+public:
+    SkaleWsSubscriptionHub();
+    virtual ~SkaleWsSubscriptionHub();
+    subscription_id_t hubSubscribeNewHeads( SkaleWsSubscriber* pPeer, bool bIncludeTransactions );
+    subscription_id_t hubSubscribeNewPendingTransactions( SkaleWsSubscriber* pPeer );
+    subscription_id_t hubSubscribeLogs(
+        SkaleWsSubscriber* pPeer, const dev::eth::LogFilter& logFilter );
+    bool hubUnsubscribeNewHeads( subscription_id_t idSubscription );
+    bool hubUnsubscribeNewPendingTransactions( subscription_id_t idSubscription );
+    bool hubUnsubscribeLogs( subscription_id_t idSubscription );
+    void hubUnsubscribeAll();
+    size_t getMaxPendingNotificationsPerPeer() const { return nMaxPendingNotificationsPerPeer_; }
+    void setMaxPendingNotificationsPerPeer( size_t n ) { nMaxPendingNotificationsPerPeer_ = n; }
+    nlohmann::json hubStats() const;
+    virtual SkaleServerOverride& getSSO() = 0;
+};  // class SkaleWsSubscriptionHub
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 struct SkaleServerConnectionsTrackHelper {
     SkaleServerOverride& m_sso;
     SkaleServerConnectionsTrackHelper( SkaleServerOverride& sso );
@@ -135,7 +231,7 @@ struct SkaleServerConnectionsTrackHelper {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class SkaleWsPeer : public skutils::ws::peer {
+class SkaleWsPeer : public skutils::ws::peer, public SkaleWsSubscriber {
 public:
     std::atomic_size_t nTaskNumberInPeer_ = 0;
     const std::string m_strPeerQueueID;
@@ -161,6 +257,14 @@ public:
     const SkaleServerOverride* pso() const { return const_cast< SkaleWsPeer* >( this )->pso(); }
     dev::eth::Interface* ethereum() const;
 
+    size_t ref_retain() override { return skutils::ws::peer::ref_retain(); }
+    size_t ref_release() override { return skutils::ws::peer::ref_release(); }
+    bool hubIsConnected() const override { return isConnected(); }
+    void hubPost( std::function< void() > fn ) override;
+    bool hubSend(
+        const std::string& strSubscriptionKind, const std::string& strNotification ) override;
+    void hubEvicted( const std::string& strSubscriptionKind ) override;
+
 protected:
     typedef std::set< unsigned > set_watche_ids_t;
     set_watche_ids_t setInstalledWatchesLogs_, setInstalledWatchesNewPendingTransactions_,
@@ -196,6 +300,7 @@ protected:
 
 public:
     friend class SkaleRelayWS;
+    friend class SkaleServerOverride;
 
 private:
     void register_ws_conn_for_origin();
@@ -233,6 +338,7 @@ protected:
     int m_nPort = -1;
     SkaleServerOverride* m_pSO = nullptr;
     e_server_mode_t esm_;
+    skutils::task::trace::id_type m_idTraceChannel;
 
 public:
     typedef skutils::multithreading::recursive_mutex_type mutex_type;
@@ -263,6 +369,7 @@ public:
 
     std::string nfoGetScheme() const { return m_strScheme_; }
     std::string nfoGetSchemeUC() const { return m_strSchemeUC; }
+    skutils::task::trace::id_type traceChannelId() const { return m_idTraceChannel; }
 
     friend class SkaleWsPeer;
 };  /// class SkaleRelayWS
@@ -322,6 +429,7 @@ public:
 
 class SkaleServerOverride : public jsonrpc::AbstractServerConnector,
                             public SkaleStatsSubscriptionManager,
+                            public SkaleWsSubscriptionHub,
                             public dev::rpc::SkaleStatsProviderImpl {
     std::atomic_size_t nTaskNumberCall_ = 0;
     dev::eth::ChainParams& chainParams_;
@@ -342,6 +450,7 @@ public:
     size_t maxCountInBatchJsonRpcRequest_ = 128;
 
     skutils::unddos::algorithm unddos_;
+    skale::ExecutionBudgetSettings executionBudget_;
 
     struct net_bind_opts_t {
         size_t cntServers_ = 1;
@@ -459,6 +568,20 @@ public:
     dev::Verbosity methodTraceVerbosity( const std::string& strMethod ) const;
     bool checkAdminOriginAllowed( const std::string& origin ) const;
 
+    // interns trace names of methods served by JSON RPC handler, call before starting listening
+    void setTraceMethods( const std::vector< std::string >& vecMethods );
+    // trace name ids interned at setup, "rpc/unknown" for everything else
+    skutils::task::trace::id_type traceMethodId( const std::string& strMethod ) const;
+    skutils::task::trace::id_type traceChannelId(
+        const std::string& strProtocol, int nServerIndex ) const;
+
+private:
+    void implInternTraceMethod( const std::string& strMethod );
+    void implInternTraceChannel( const std::string& strProtocol, int nServerIndex );
+    skutils::task::trace::id_type idTraceUnknown_;
+    std::map< std::string, skutils::task::trace::id_type > mapTraceMethodIds_;
+    std::map< std::pair< std::string, int >, skutils::task::trace::id_type > mapTraceChannelIds_;
+
 protected:
     skutils::result_of_http_request implHandleHttpRequest( const nlohmann::json& joIn,
         const std::string& strProtocol, int nServerIndex, std::string strOrigin, int ipVer,
@@ -551,7 +674,8 @@ public:
     virtual void on_connection_overflow_peer_closed(
         int ipVer, const char* strProtocol, int nServerIndex, int nPort, e_server_mode_t esm );
 
-    SkaleServerOverride& getSSO() override;       // abstract in SkaleStatsSubscriptionManager
+    SkaleServerOverride& getSSO() override;       // abstract in SkaleStatsSubscriptionManager and
+                                                  // SkaleWsSubscriptionHub
     nlohmann::json provideSkaleStats() override;  // abstract from dev::rpc::SkaleStatsProviderImpl
 
 protected:
@@ -570,6 +694,8 @@ protected:
 public:
     bool handleRequestWithBinaryAnswer(
         e_server_mode_t esm, const nlohmann::json& joRequest, std::vector< uint8_t >& buffer );
+    bool handleRequestWithStreamedAnswer( const std::string& strProtocol,
+        const nlohmann::json& joRequest, skutils::result_of_http_request& rslt );
     bool handleAdminOriginFilter( const std::string& strMethod, const std::string& strOriginURL );
 
     bool isShutdownMode() const { return m_bShutdownMode; }
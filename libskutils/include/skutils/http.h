@@ -102,6 +102,8 @@ typedef int socket_t;
 
 #define __SKUTILS_HTTP_CLIENT_CONNECT_TIMEOUT_MILLISECONDS__ ( 60 * 1000 )
 
+#define __SKUTILS_HTTP_DEFAULT_STREAM_BUFFER_SIZE__ ( 64 * 1024 )
+
 //#define #define __SKUTILS_HTTP_ENABLE_FILE_REQUEST_HANDLING 1
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -180,6 +182,31 @@ struct request {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// bounded buffer for response bodies produced part by part,
+// producer writes while not full(), transport takes buffered data and sends it as one chunk
+class stream_writer {
+    std::string buffer_;
+    size_t nBufferSize_;
+    uint64_t nWritten_ = 0;
+
+public:
+    explicit stream_writer( size_t nBufferSize = __SKUTILS_HTTP_DEFAULT_STREAM_BUFFER_SIZE__ );
+    ~stream_writer();
+    void write( const char* p, size_t n );
+    void write( const std::string& s ) { write( s.data(), s.size() ); }
+    bool full() const { return buffer_.size() >= nBufferSize_; }
+    bool empty() const { return buffer_.empty(); }
+    size_t buffer_size() const { return nBufferSize_; }
+    uint64_t written() const { return nWritten_; }
+    std::string take();  // returns buffered data and empties buffer
+};  /// class stream_writer
+
+// writes next part of response body, returns false when whole body is written
+typedef std::function< bool( stream_writer& ) > stream_producer_t;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 struct response {
     std::string version_;
     int status_ = -1;
@@ -199,6 +226,9 @@ struct response {
     void set_redirect( const char* uri );
     void set_content( const char* s, size_t n, const char* content_type );
     void set_content( const std::string& s, const char* content_type );
+    // body is sent with chunked transfer encoding, at most one buffer of it is kept in memory
+    void set_content_producer( stream_producer_t fn, const char* content_type,
+        size_t nBufferSize = __SKUTILS_HTTP_DEFAULT_STREAM_BUFFER_SIZE__ );
 
 };  /// struct response
 
@@ -731,6 +761,8 @@ struct result_of_http_request {
     bool isBinary_ = false;
     nlohmann::json joOut_;
     std::vector< uint8_t > vecBytes_;
+    std::string strOut_;                     // serialized text answer, used instead of joOut_
+    http::stream_producer_t fnStreamOut_;  // text answer produced part by part, used if set
 };  /// struct result_of_http_request
 
 namespace http_pg {
@@ -753,6 +785,8 @@ typedef std::vector< pg_accumulate_entry > pg_accumulate_entries;
 
 bool pg_logging_get();
 void pg_logging_set( bool bIsLoggingMode );
+size_t pg_stream_buffer_size_get();
+void pg_stream_buffer_size_set( size_t nBufferSize );
 wrapped_proxygen_server_handle pg_start( pg_on_request_handler_t h, const pg_accumulate_entry& pge,
     int32_t threads = 0, int32_t threads_limit = 0 );
 wrapped_proxygen_server_handle pg_start( pg_on_request_handler_t h,
@@ -2,6 +2,8 @@
 #define SKUTILS_HTTP_PG_H 1
 
 #include <atomic>
+#include <functional>
+#include <memory>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-copy"
@@ -25,6 +27,7 @@
 #include <json.hpp>
 
 #include <skutils/http.h>
+#include <skutils/thread_pool.h>
 
 namespace proxygen {
 class ResponseHandler;
@@ -60,6 +63,11 @@ class request_site : public proxygen::RequestHandler {
     std::string strLogPrefix_;
     size_t nBodyPartNumber_ = 0;
     std::string strBody_;
+    // streamed answer state, chunks are produced on worker thread and sent from event base
+    struct stream_out;
+    std::shared_ptr< stream_out > pStreamOut_;
+    bool bEgressPaused_ = false;
+    void pump_stream_out();
 
 public:
     std::string strHttpMethod_, strOrigin_, strPath_, strDstAddress_;
@@ -74,6 +82,8 @@ public:
     void onUpgrade( proxygen::UpgradeProtocol proto ) noexcept override;
     void requestComplete() noexcept override;
     void onError( proxygen::ProxygenError err ) noexcept override;
+    void onEgressPaused() noexcept override;
+    void onEgressResumed() noexcept override;
 };  /// class request_site
 
 
@@ -107,6 +117,8 @@ public:
     virtual skutils::result_of_http_request onRequest( const nlohmann::json& joIn,
         const std::string& strOrigin, int ipVer, const std::string& strDstAddress,
         int nDstPort ) = 0;
+    // runs producer of streamed answer outside of event base thread
+    virtual void post_stream_job( std::function< void() > fn );
 };  /// class server_side_request_handler
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -119,6 +131,7 @@ class server : public server_side_request_handler {
     pg_accumulate_entries entries_;
     int32_t threads_ = 0;
     int32_t threads_limit_ = 0;
+    std::unique_ptr< skutils::thread_pool > stream_pool_;
 
     std::string strLogPrefix_;
 
@@ -131,6 +144,7 @@ public:
     skutils::result_of_http_request onRequest( const nlohmann::json& joIn,
         const std::string& strOrigin, int ipVer, const std::string& strDstAddress,
         int nDstPort ) override;
+    void post_stream_job( std::function< void() > fn ) override;
 };  /// class server
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
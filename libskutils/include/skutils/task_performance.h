@@ -118,6 +118,7 @@ public:
     bool is_finished() const;
     virtual bool is_running() const;
     virtual void set_running( bool b = true );
+    void set_finished( time_point tpStart, time_point tpEnd );
     time_point tp_start() const;
     time_point tp_end() const;
     std::chrono::nanoseconds tp_duration() const;
@@ -183,6 +184,8 @@ private:
 public:
     tracker_ptr get_tracker() const;
     item_ptr new_item( const string& strName, const json& jsn );
+    item_ptr new_finished_item(
+        const string& strName, const json& jsn, time_point tpStart, time_point tpEnd );
     json compose_json( index_type minIndexT = 0 ) const;
 };
 
@@ -221,6 +224,7 @@ public:
     void set_session_max_item_count( size_t n );
     bool is_running() const override;
     void set_running( bool b = true ) override;
+    bool can_accept_new_item();
     queue_ptr get_queue( const string& strName );
     json compose_json( index_type minIndexT = 0 ) const;
     void cancel();
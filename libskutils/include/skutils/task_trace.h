@@ -0,0 +1,232 @@
+#if ( !defined __SKUTILS_TASK_TRACE_H )
+#define __SKUTILS_TASK_TRACE_H 1
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <skutils/task_performance.h>
+
+#include <json.hpp>
+
+//
+// Low-overhead tracing of RPC calls and block pipeline steps.
+//
+// Every thread owns a single-producer/single-consumer ring buffer of fixed-size binary records.
+// Recording a record is two clock reads and one ring slot write, no locks and no allocations.
+// A background collector drains all rings, aggregates records into per-method latency
+// histograms and, while the performance timeline tracker is running, converts records into
+// regular timeline items so skale_performanceTracking* RPC output keeps its format.
+//
+
+namespace skutils {
+namespace task {
+namespace trace {
+
+typedef uint16_t id_type;
+typedef std::chrono::system_clock clock;
+typedef skutils::multithreading::mutex_type mutex_type;
+typedef nlohmann::json json;
+
+static const id_type c_invalid_id = 0;
+static const size_t c_max_name_count = 4096;
+static const size_t c_default_ring_capacity = 8192;  // records, power of two
+static const size_t c_histogram_bucket_count = 32;   // log2 buckets of microseconds
+
+enum class status_t : uint8_t { ok = 0, error = 1 };
+
+struct record_t {
+    int64_t tsStart_ = 0;  // nanoseconds since epoch
+    int64_t tsEnd_ = 0;
+    uint64_t nRequestSize_ = 0;
+    uint64_t nResponseSize_ = 0;
+    uint32_t nTaskNumber_ = 0;
+    id_type idChannel_ = c_invalid_id;
+    id_type idMethod_ = c_invalid_id;
+    status_t status_ = status_t::ok;
+};  /// struct record_t
+static_assert( std::is_trivially_copyable< record_t >::value,
+    "trace records must be trivially copyable" );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// interns channel and method names into small integer ids,
+// lookups of already known names are served from a thread-local cache without locking
+class name_registry {
+    mutable mutex_type mtx_;
+    std::map< std::string, id_type > mapIds_;
+    std::vector< std::string > vecNames_;
+
+public:
+    name_registry();
+    name_registry( const name_registry& ) = delete;
+    name_registry( name_registry&& ) = delete;
+    ~name_registry();
+    name_registry& operator=( const name_registry& ) = delete;
+    name_registry& operator=( name_registry&& ) = delete;
+    id_type intern( const std::string& strName );
+    std::string name_of( id_type id ) const;
+    size_t size() const;
+};  /// class name_registry
+
+extern name_registry& get_default_name_registry();
+extern id_type intern( const std::string& strName );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// wait-free single producer (owner thread) / single consumer (collector thread) ring
+class ring {
+    std::vector< record_t > vecRecords_;
+    const uint64_t nMask_;
+    alignas( 64 ) std::atomic< uint64_t > nHead_;  // written by producer only
+    alignas( 64 ) std::atomic< uint64_t > nTail_;  // written by consumer only
+    std::atomic< uint64_t > nDropped_;
+
+public:
+    explicit ring( size_t nCapacity = c_default_ring_capacity );
+    ring( const ring& ) = delete;
+    ring( ring&& ) = delete;
+    ~ring();
+    ring& operator=( const ring& ) = delete;
+    ring& operator=( ring&& ) = delete;
+    size_t capacity() const { return vecRecords_.size(); }
+    uint64_t dropped() const { return nDropped_.load( std::memory_order_relaxed ); }
+    bool push( const record_t& rec ) {
+        const uint64_t nHead = nHead_.load( std::memory_order_relaxed );
+        if ( nHead - nTail_.load( std::memory_order_acquire ) >= vecRecords_.size() ) {
+            nDropped_.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        vecRecords_[nHead & nMask_] = rec;
+        nHead_.store( nHead + 1, std::memory_order_release );
+        return true;
+    }
+    template < typename F >
+    size_t drain( F&& fn ) {
+        const uint64_t nTail = nTail_.load( std::memory_order_relaxed );
+        const uint64_t nHead = nHead_.load( std::memory_order_acquire );
+        for ( uint64_t i = nTail; i != nHead; ++i )
+            fn( vecRecords_[i & nMask_] );
+        nTail_.store( nHead, std::memory_order_release );
+        return size_t( nHead - nTail );
+    }
+};  /// class ring
+
+typedef std::shared_ptr< ring > ring_ptr;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct histogram_t {
+    uint64_t nCount_ = 0;
+    uint64_t nErrors_ = 0;
+    uint64_t nRequestBytes_ = 0;
+    uint64_t nResponseBytes_ = 0;
+    uint64_t nSumNs_ = 0;
+    uint64_t nMinNs_ = 0;
+    uint64_t nMaxNs_ = 0;
+    std::array< uint64_t, c_histogram_bucket_count > arrBuckets_{};
+    void add( const record_t& rec );
+    uint64_t percentile_upper_bound_ns( double lfPercentile ) const;
+    json compose_json() const;
+};  /// struct histogram_t
+
+class collector {
+    mutable mutex_type mtxRings_;
+    std::vector< ring_ptr > vecRings_;
+    mutable mutex_type mtxHistograms_;
+    std::map< std::pair< id_type, id_type >, histogram_t > mapHistograms_;
+    std::atomic_bool isEnabled_;
+    std::atomic_bool isRunning_;
+    std::atomic< uint64_t > nDrained_;
+    std::atomic< uint64_t > nDroppedFromReleasedRings_;
+    std::thread thread_;
+    std::mutex mtxWait_;
+    std::condition_variable cvWait_;
+    std::chrono::milliseconds drainInterval_;
+    performance::tracker_ptr pTracker_;
+
+public:
+    collector();
+    collector( const collector& ) = delete;
+    collector( collector&& ) = delete;
+    ~collector();
+    collector& operator=( const collector& ) = delete;
+    collector& operator=( collector&& ) = delete;
+    bool is_enabled() const { return isEnabled_.load( std::memory_order_relaxed ); }
+    void set_enabled( bool b );
+    void set_tracker( performance::tracker_ptr pTracker );
+    void set_drain_interval( std::chrono::milliseconds interval );
+    ring& thread_ring();  // ring of calling thread, registered on first use
+    void start();
+    void stop();
+    size_t drain();  // can be called from any thread, drainer thread does it periodically
+    void reset();
+    json compose_json();  // drains, then returns aggregated histograms
+
+private:
+    void drain_record( const record_t& rec, std::vector< record_t >& vecForTimeline );
+    void publish_to_timeline( const std::vector< record_t >& vecForTimeline );
+};  /// class collector
+
+extern collector& get_default_collector();
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        clock::now().time_since_epoch() )
+        .count();
+}
+
+// RAII trace point, pushes one record into calling thread's ring on destruction
+class scope {
+    record_t rec_;
+    bool isActive_;
+
+public:
+    scope( id_type idChannel, id_type idMethod, size_t nRequestSize = 0, size_t nTaskNumber = 0 )
+        : isActive_( get_default_collector().is_enabled() ) {
+        if ( !isActive_ )
+            return;
+        rec_.idChannel_ = idChannel;
+        rec_.idMethod_ = idMethod;
+        rec_.nRequestSize_ = nRequestSize;
+        rec_.nTaskNumber_ = uint32_t( nTaskNumber );
+        rec_.tsStart_ = now_ns();
+    }
+    scope( const scope& ) = delete;
+    scope( scope&& ) = delete;
+    ~scope() { finish(); }
+    scope& operator=( const scope& ) = delete;
+    scope& operator=( scope&& ) = delete;
+    void set_method( id_type idMethod ) { rec_.idMethod_ = idMethod; }
+    void set_request_size( size_t n ) { rec_.nRequestSize_ = n; }
+    void set_response_size( size_t n ) { rec_.nResponseSize_ = n; }
+    void set_error() { rec_.status_ = status_t::error; }
+    void finish() {
+        if ( !isActive_ )
+            return;
+        isActive_ = false;
+        rec_.tsEnd_ = now_ns();
+        get_default_collector().thread_ring().push( rec_ );
+    }
+};  /// class scope
+
+};  // namespace trace
+};  // namespace task
+};  // namespace skutils
+
+#endif  /// (!defined __SKUTILS_TASK_TRACE_H)
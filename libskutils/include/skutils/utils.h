@@ -598,6 +598,7 @@ extern std::string read_maps();
 class json_config_file_accessor {
     const std::string configPath_;
     time_t configModificationTime_;
+    size_t configGeneration_;
     nlohmann::json joConfig_;
 
     typedef std::recursive_mutex mutex_type;
@@ -613,6 +614,8 @@ public:
     nlohmann::json getConfigJSON() const {
         return ( const_cast< json_config_file_accessor* >( this ) )->getConfigJSON();
     };
+    // changes each time any accessor loads its file, so it also tells accessors apart
+    size_t getConfigGeneration();
     static nlohmann::json stat_extract_at_path(
         const nlohmann::json& joConfig, const string_list_t& listPath );
     static nlohmann::json stat_extract_at_path(
@@ -1135,6 +1135,43 @@ void response::set_content( const std::string& s, const char* content_type ) {
     set_header( "Content-Type", content_type );
 }
 
+void response::set_content_producer(
+    stream_producer_t fn, const char* content_type, size_t nBufferSize ) {
+    body_.clear();
+    set_header( "Content-Type", content_type );
+    auto pWriter = std::make_shared< stream_writer >( nBufferSize );
+    auto pHaveMore = std::make_shared< bool >( true );
+    // empty chunk means end of body, so producer is called until it gives something or finishes
+    streamcb_ = [fn, pWriter, pHaveMore]( uint64_t /*offset*/ ) -> std::string {
+        while ( ( *pHaveMore ) && pWriter->empty() )
+            ( *pHaveMore ) = fn( *pWriter );
+        return pWriter->take();
+    };
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+stream_writer::stream_writer( size_t nBufferSize ) : nBufferSize_( nBufferSize ) {
+    if ( nBufferSize_ == 0 )
+        nBufferSize_ = 1;
+    buffer_.reserve( nBufferSize_ );
+}
+
+stream_writer::~stream_writer() {}
+
+void stream_writer::write( const char* p, size_t n ) {
+    buffer_.append( p, n );
+    nWritten_ += n;
+}
+
+std::string stream_writer::take() {
+    std::string s;
+    s.reserve( nBufferSize_ );
+    s.swap( buffer_ );
+    return s;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1895,7 +1932,18 @@ void server::write_response(
             uint64_t offset = 0;
             bool data_available = true;
             while ( data_available ) {
-                std::string chunk = res.streamcb_( offset );
+                std::string chunk;
+                try {
+                    chunk = res.streamcb_( offset );
+                } catch ( ... ) {
+                    // status is already sent, body is left without last chunk and connection
+                    // is closed after this request, so client sees broken answer
+                    std::cerr.flush();
+                    std::cerr << "HTTP server failed to stream answer to " << req.method_ << " "
+                              << req.path_ << " after " << offset << " bytes\n";
+                    std::cerr.flush();
+                    break;
+                }
                 offset += chunk.size();
                 data_available = !chunk.empty();
                 // Emit chunked response header and footer for each chunk
@@ -13,6 +13,10 @@
 
 #pragma GCC diagnostic pop
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include <skutils/console_colors.h>
 #include <skutils/multithreading.h>
 #include <skutils/rest_call.h>
@@ -71,6 +75,76 @@ void request_sink::OnRecordRequestCountIncrement() {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// at most this count of produced chunks waits for egress, producer blocks when all are taken
+static const size_t g_nStreamChunksInFlight = 4;
+
+struct request_site::stream_out : public std::enable_shared_from_this< stream_out > {
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque< std::string > chunks_;  // produced but not yet passed to proxygen
+    bool bDone_ = false, bFailed_ = false, bCancelled_ = false;
+    uint64_t nWritten_ = 0;
+    std::string strError_;
+    skutils::http::stream_producer_t fnStreamOut_;
+    folly::EventBase* pEventBase_ = nullptr;
+    // next members are used only on event base thread
+    request_site* pSite_ = nullptr;
+    bool bFinished_ = false;
+    void produce();
+    void cancel();
+};
+
+void request_site::stream_out::produce() {
+    skutils::http::stream_writer w( pg_stream_buffer_size_get() );
+    bool bHaveMore = true;
+    while ( bHaveMore ) {
+        {  // block
+            std::unique_lock< std::mutex > lock( mtx_ );
+            cv_.wait( lock,
+                [&]() { return bCancelled_ || chunks_.size() < g_nStreamChunksInFlight; } );
+            if ( bCancelled_ )
+                return;
+        }  // block
+        bool bFailed = false;
+        std::string strError;
+        try {
+            bHaveMore = fnStreamOut_( w );
+        } catch ( const std::exception& ex ) {
+            bFailed = true;
+            strError = ex.what();
+        } catch ( ... ) {
+            bFailed = true;
+            strError = "unknown exception in stream producer";
+        }
+        std::lock_guard< std::mutex > lock( mtx_ );
+        if ( bCancelled_ )
+            return;  // site is gone, event base may be gone too
+        nWritten_ = w.written();
+        if ( bFailed ) {
+            bFailed_ = true;
+            strError_ = strError;
+            bHaveMore = false;
+        } else {
+            if ( !w.empty() )
+                chunks_.push_back( w.take() );
+            bDone_ = !bHaveMore;
+        }
+        std::shared_ptr< stream_out > pThis = shared_from_this();
+        pEventBase_->runInEventBaseThread( [pThis]() {
+            if ( pThis->pSite_ )
+                pThis->pSite_->pump_stream_out();
+        } );
+    }
+}
+
+void request_site::stream_out::cancel() {
+    std::lock_guard< std::mutex > lock( mtx_ );
+    bCancelled_ = true;
+    pSite_ = nullptr;
+    chunks_.clear();
+    cv_.notify_all();
+}
+
 std::atomic_uint64_t request_site::g_instance_counter = 0;
 
 request_site::request_site( request_sink& a_sink, server_side_request_handler* pSSRQ )
@@ -83,6 +157,8 @@ request_site::request_site( request_sink& a_sink, server_side_request_handler* p
 
 request_site::~request_site() {
     pg_log( strLogPrefix_ + cc::debug( "destructor" ) + "\n" );
+    if ( pStreamOut_ )
+        pStreamOut_->cancel();
 }
 
 void request_site::onRequest( std::unique_ptr< proxygen::HTTPMessage > req ) noexcept {
@@ -173,6 +249,11 @@ void request_site::onEOM() noexcept {
                     cc::binary_table( ( const void* ) ( void* ) rslt.vecBytes_.data(),
                         size_t( rslt.vecBytes_.size() ) ) +
                     "\n" );
+        else if ( rslt.fnStreamOut_ )
+            pg_log( strLogPrefix_ + cc::debug( "got streamed answer" ) + "\n" );
+        else if ( !rslt.strOut_.empty() )
+            pg_log( strLogPrefix_ + cc::debug( "got answer JSON " ) + cc::normal( rslt.strOut_ ) +
+                    "\n" );
         else
             pg_log( strLogPrefix_ + cc::debug( "got answer JSON " ) + cc::j( rslt.joOut_ ) + "\n" );
     } catch ( const std::exception& ex ) {
@@ -200,14 +281,80 @@ void request_site::onEOM() noexcept {
         bldr.header( "Content-Type", "application/octet-stream" );
         std::string buffer( rslt.vecBytes_.begin(), rslt.vecBytes_.end() );
         bldr.body( buffer );
+    } else if ( rslt.fnStreamOut_ ) {
+        // no content-length, so HTTP/1.1 answer goes out with chunked transfer encoding,
+        // producer reads on worker thread, event base sends only while egress is not paused
+        bldr.send();
+        pStreamOut_ = std::make_shared< stream_out >();
+        pStreamOut_->fnStreamOut_ = std::move( rslt.fnStreamOut_ );
+        pStreamOut_->pEventBase_ = folly::EventBaseManager::get()->getEventBase();
+        pStreamOut_->pSite_ = this;
+        std::shared_ptr< stream_out > pStreamOut = pStreamOut_;
+        pSSRQ_->post_stream_job( [pStreamOut]() { pStreamOut->produce(); } );
+        return;
     } else {
-        std::string strOut = rslt.joOut_.dump();
+        std::string strOut = rslt.strOut_.empty() ? rslt.joOut_.dump() : std::move( rslt.strOut_ );
         bldr.header( "content-length", skutils::tools::format( "%zu", strOut.size() ) );
         bldr.body( strOut );
     }
     bldr.sendWithEOM();
 }
 
+void request_site::pump_stream_out() {
+    std::shared_ptr< stream_out > pStreamOut = pStreamOut_;
+    // sending may pause egress or finish this site, so re-check both after each chunk
+    while ( pStreamOut->pSite_ == this && !bEgressPaused_ && !pStreamOut->bFinished_ ) {
+        std::string strChunk;
+        bool bHaveChunk = false, bDone = false, bFailed = false;
+        uint64_t nWritten = 0;
+        std::string strError;
+        {  // block
+            std::lock_guard< std::mutex > lock( pStreamOut->mtx_ );
+            if ( !pStreamOut->chunks_.empty() ) {
+                strChunk = std::move( pStreamOut->chunks_.front() );
+                pStreamOut->chunks_.pop_front();
+                bHaveChunk = true;
+                pStreamOut->cv_.notify_one();
+            } else {
+                bDone = pStreamOut->bDone_;
+                bFailed = pStreamOut->bFailed_;
+                nWritten = pStreamOut->nWritten_;
+                strError = pStreamOut->strError_;
+            }
+        }  // block
+        if ( bHaveChunk ) {
+            proxygen::ResponseBuilder( downstream_ ).body( std::move( strChunk ) ).send();
+            continue;
+        }
+        if ( bFailed ) {
+            // status is already sent, only thing left is to break the answer
+            pg_log( strLogPrefix_ + cc::error( "streamed answer failed after " ) +
+                    cc::size10( size_t( nWritten ) ) + cc::error( " bytes, error info: " ) +
+                    cc::warn( strError ) + "\n" );
+            pStreamOut->bFinished_ = true;
+            downstream_->sendAbort();
+            return;
+        }
+        if ( bDone ) {
+            pStreamOut->bFinished_ = true;
+            proxygen::ResponseBuilder( downstream_ ).sendWithEOM();
+        }
+        return;  // wait for producer
+    }
+}
+
+void request_site::onEgressPaused() noexcept {
+    pg_log( strLogPrefix_ + cc::debug( "egress paused" ) + "\n" );
+    bEgressPaused_ = true;
+}
+
+void request_site::onEgressResumed() noexcept {
+    pg_log( strLogPrefix_ + cc::debug( "egress resumed" ) + "\n" );
+    bEgressPaused_ = false;
+    if ( pStreamOut_ )
+        pump_stream_out();
+}
+
 void request_site::onUpgrade( proxygen::UpgradeProtocol /*protocol*/ ) noexcept {
     // handler doesn't support upgrades
     pg_log( strLogPrefix_ + cc::debug( "upgrade query" ) + "\n" );
@@ -262,6 +409,10 @@ nlohmann::json server_side_request_handler::json_from_error_text(
     return jo;
 }
 
+void server_side_request_handler::post_stream_job( std::function< void() > fn ) {
+    std::thread( fn ).detach();
+}
+
 std::string server_side_request_handler::answer_from_error_text(
     const char* strErrorDescription, const nlohmann::json& joID ) {
     nlohmann::json jo = json_from_error_text( strErrorDescription, joID );
@@ -379,6 +530,7 @@ bool server::start() {
     options.h2cEnabled = true;
     //
     server_.reset( new proxygen::HTTPServer( std::move( options ) ) );
+    stream_pool_.reset( new skutils::thread_pool( size_t( threads_ ) ) );
     server_->bind( IPs );
     // start HTTPServer main loop in a separate thread
     thread_ = std::move( std::thread( [&]() {
@@ -407,6 +559,8 @@ void server::stop() {
         server_.reset();
         pg_log( strLogPrefix_ + cc::debug( "did released server instance" ) + "\n" );
     }
+    // sites are gone at this point, so producers are cancelled and pool joins quickly
+    stream_pool_.reset();
 }
 
 skutils::result_of_http_request server::onRequest( const nlohmann::json& joIn,
@@ -415,6 +569,12 @@ skutils::result_of_http_request server::onRequest( const nlohmann::json& joIn,
     return rslt;
 }
 
+void server::post_stream_job( std::function< void() > fn ) {
+    if ( stream_pool_ && stream_pool_->safe_submit_without_future( fn ) )
+        return;
+    server_side_request_handler::post_stream_job( fn );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -428,6 +588,16 @@ void pg_logging_set( bool bIsLoggingMode ) {
     g_b_pb_logging = bIsLoggingMode;
 }
 
+static std::atomic_size_t g_n_pg_stream_buffer_size{ __SKUTILS_HTTP_DEFAULT_STREAM_BUFFER_SIZE__ };
+
+size_t pg_stream_buffer_size_get() {
+    return g_n_pg_stream_buffer_size;
+}
+
+void pg_stream_buffer_size_set( size_t nBufferSize ) {
+    g_n_pg_stream_buffer_size = ( nBufferSize > 0 ) ? nBufferSize : 1;
+}
+
 wrapped_proxygen_server_handle pg_start( pg_on_request_handler_t h, const pg_accumulate_entry& pge,
     int32_t threads, int32_t threads_limit ) {
     pg_accumulate_entries entries;
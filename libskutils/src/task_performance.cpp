@@ -114,6 +114,12 @@ void time_holder::set_running( bool b ) {
     }
 }
 
+void time_holder::set_finished( time_point tpStart, time_point tpEnd ) {
+    isRunning_ = false;
+    tpStart_ = tpStart;
+    tpEnd_ = tpEnd;
+}
+
 time_point time_holder::tp_start() const {
     return tpStart_;
 }
@@ -272,6 +278,21 @@ item_ptr queue::new_item( const string& strName, const json& jsn ) {
     return pItem;
 }
 
+item_ptr queue::new_finished_item(
+    const string& strName, const json& jsn, time_point tpStart, time_point tpEnd ) {
+    item_ptr pItem;
+    {  // block
+        lockable::lock_type lock( mtx() );
+        queue_ptr pThisQueue = this;
+        index_type indexQ = alloc_index();
+        index_type indexT = get_tracker()->alloc_index();
+        pItem = item_ptr::make( strName, jsn, pThisQueue, indexQ, indexT );
+        pItem->set_finished( tpStart, tpEnd );
+        map_[indexQ] = pItem;
+    }  // block
+    return pItem;
+}
+
 json queue::compose_json( index_type minIndexT ) const {
     json jsn = json::array();
     {  // block
@@ -358,6 +379,22 @@ void tracker::set_running( bool b ) {
         reset();
 }
 
+bool tracker::can_accept_new_item() {
+    if ( !is_enabled() )
+        return false;
+    if ( !is_running() )
+        return false;
+    if ( get_index() >= get_safe_max_item_count() ) {
+        came_accross_with_possible_session_stop_reason( "max limit of events reached" );
+        return false;
+    }
+    if ( get_index() >= get_session_max_item_count() ) {
+        came_accross_with_possible_session_stop_reason( "number of requested of events saved" );
+        return false;
+    }
+    return true;
+}
+
 queue_ptr tracker::get_queue( const string& strName ) {
     queue_ptr pQueue;
     {  // block
@@ -465,23 +502,8 @@ void action::init( const string& strQueueName, const string& strActionName, cons
             throw std::runtime_error(
                 "Attempt to instantiate performance action without tracker provided" );
     }
-    if ( !pTracker->is_enabled() ) {
-        isSkipped_ = true;
-        return;
-    }
-    if ( !pTracker->is_running() ) {
-        isSkipped_ = true;
-        return;
-    }
-    if ( pTracker->get_index() >= pTracker->get_safe_max_item_count() ) {
-        isSkipped_ = true;
-        pTracker->came_accross_with_possible_session_stop_reason( "max limit of events reached" );
-        return;
-    }
-    if ( pTracker->get_index() >= pTracker->get_session_max_item_count() ) {
+    if ( !pTracker->can_accept_new_item() ) {
         isSkipped_ = true;
-        pTracker->came_accross_with_possible_session_stop_reason(
-            "number of requested of events saved" );
         return;
     }
     queue_ptr pQueue = pTracker->get_queue( strQueueName );
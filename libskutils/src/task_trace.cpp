@@ -0,0 +1,334 @@
+#include <skutils/task_trace.h>
+#include <skutils/utils.h>
+
+#include <algorithm>
+#include <exception>
+#include <unordered_map>
+
+namespace skutils {
+namespace task {
+namespace trace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+name_registry::name_registry() {
+    vecNames_.push_back( "unknown" );  // c_invalid_id
+}
+
+name_registry::~name_registry() {}
+
+id_type name_registry::intern( const std::string& strName ) {
+    std::lock_guard< mutex_type > lock( mtx_ );
+    auto itFind = mapIds_.find( strName );
+    if ( itFind != mapIds_.end() )
+        return itFind->second;
+    if ( vecNames_.size() >= c_max_name_count )
+        return c_invalid_id;  // too many distinct names, account them as "unknown"
+    id_type id = id_type( vecNames_.size() );
+    vecNames_.push_back( strName );
+    mapIds_[strName] = id;
+    return id;
+}
+
+std::string name_registry::name_of( id_type id ) const {
+    std::lock_guard< mutex_type > lock( mtx_ );
+    if ( size_t( id ) >= vecNames_.size() )
+        return vecNames_[c_invalid_id];
+    return vecNames_[id];
+}
+
+size_t name_registry::size() const {
+    std::lock_guard< mutex_type > lock( mtx_ );
+    return vecNames_.size();
+}
+
+name_registry& get_default_name_registry() {
+    static name_registry g_registry;
+    return g_registry;
+}
+
+id_type intern( const std::string& strName ) {
+    static thread_local std::unordered_map< std::string, id_type > t_mapCache;
+    auto itFind = t_mapCache.find( strName );
+    if ( itFind != t_mapCache.end() )
+        return itFind->second;
+    id_type id = get_default_name_registry().intern( strName );
+    if ( t_mapCache.size() < c_max_name_count )
+        t_mapCache.emplace( strName, id );
+    return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static size_t stat_round_up_to_power_of_two( size_t n ) {
+    size_t nResult = 1;
+    while ( nResult < n )
+        nResult <<= 1;
+    return nResult;
+}
+
+ring::ring( size_t nCapacity )
+    : vecRecords_( stat_round_up_to_power_of_two( std::max( nCapacity, size_t( 2 ) ) ) ),
+      nMask_( vecRecords_.size() - 1 ),
+      nHead_( 0 ),
+      nTail_( 0 ),
+      nDropped_( 0 ) {}
+
+ring::~ring() {}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void histogram_t::add( const record_t& rec ) {
+    uint64_t nDurationNs =
+        ( rec.tsEnd_ > rec.tsStart_ ) ? uint64_t( rec.tsEnd_ - rec.tsStart_ ) : uint64_t( 0 );
+    if ( nCount_ == 0 || nDurationNs < nMinNs_ )
+        nMinNs_ = nDurationNs;
+    if ( nDurationNs > nMaxNs_ )
+        nMaxNs_ = nDurationNs;
+    ++nCount_;
+    if ( rec.status_ != status_t::ok )
+        ++nErrors_;
+    nRequestBytes_ += rec.nRequestSize_;
+    nResponseBytes_ += rec.nResponseSize_;
+    nSumNs_ += nDurationNs;
+    uint64_t nMicroseconds = nDurationNs / 1000;
+    size_t idxBucket = 0;
+    while ( nMicroseconds > 0 && idxBucket + 1 < c_histogram_bucket_count ) {
+        nMicroseconds >>= 1;
+        ++idxBucket;
+    }
+    ++arrBuckets_[idxBucket];
+}
+
+uint64_t histogram_t::percentile_upper_bound_ns( double lfPercentile ) const {
+    if ( nCount_ == 0 )
+        return 0;
+    uint64_t nThreshold = uint64_t( double( nCount_ ) * lfPercentile / 100.0 );
+    uint64_t nAccumulated = 0;
+    for ( size_t i = 0; i < c_histogram_bucket_count; ++i ) {
+        nAccumulated += arrBuckets_[i];
+        if ( nAccumulated > nThreshold )
+            return std::min( ( uint64_t( 1 ) << i ) * 1000, nMaxNs_ );
+    }
+    return nMaxNs_;
+}
+
+json histogram_t::compose_json() const {
+    json jsn = json::object();
+    jsn["count"] = nCount_;
+    jsn["errors"] = nErrors_;
+    jsn["requestBytes"] = nRequestBytes_;
+    jsn["responseBytes"] = nResponseBytes_;
+    jsn["minNs"] = nMinNs_;
+    jsn["maxNs"] = nMaxNs_;
+    jsn["avgNs"] = ( nCount_ > 0 ) ? ( nSumNs_ / nCount_ ) : uint64_t( 0 );
+    jsn["p50Ns"] = percentile_upper_bound_ns( 50.0 );
+    jsn["p99Ns"] = percentile_upper_bound_ns( 99.0 );
+    json jarrBuckets = json::array();
+    for ( size_t i = 0; i < c_histogram_bucket_count; ++i )
+        jarrBuckets.push_back( arrBuckets_[i] );
+    jsn["bucketsLog2Us"] = jarrBuckets;
+    return jsn;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+collector& get_default_collector() {
+    static collector g_collector;
+    return g_collector;
+}
+
+collector::collector()
+    : isEnabled_( true ),
+      isRunning_( false ),
+      nDrained_( 0 ),
+      nDroppedFromReleasedRings_( 0 ),
+      drainInterval_( 100 ) {}
+
+collector::~collector() {
+    stop();
+}
+
+void collector::set_enabled( bool b ) {
+    isEnabled_ = b;
+}
+
+void collector::set_tracker( performance::tracker_ptr pTracker ) {
+    std::lock_guard< mutex_type > lock( mtxHistograms_ );
+    pTracker_ = pTracker;
+}
+
+void collector::set_drain_interval( std::chrono::milliseconds interval ) {
+    std::lock_guard< std::mutex > lock( mtxWait_ );
+    drainInterval_ = interval;
+}
+
+ring& collector::thread_ring() {
+    struct thread_ring_holder {
+        collector* pOwner_ = nullptr;
+        ring_ptr pRing_;
+    };
+    static thread_local thread_ring_holder t_holder;
+    if ( t_holder.pOwner_ != this || !t_holder.pRing_ ) {
+        ring_ptr pRing = std::make_shared< ring >( c_default_ring_capacity );
+        {  // block
+            std::lock_guard< mutex_type > lock( mtxRings_ );
+            vecRings_.push_back( pRing );
+        }  // block
+        t_holder.pOwner_ = this;
+        t_holder.pRing_ = pRing;
+    }
+    return *t_holder.pRing_;
+}
+
+void collector::start() {
+    bool bExpected = false;
+    if ( !isRunning_.compare_exchange_strong( bExpected, true ) )
+        return;
+    thread_ = std::thread( [this]() {
+        while ( isRunning_ ) {
+            {  // block
+                std::unique_lock< std::mutex > lock( mtxWait_ );
+                cvWait_.wait_for( lock, drainInterval_, [this]() { return !isRunning_; } );
+            }  // block
+            try {
+                drain();
+            } catch ( ... ) {
+            }
+        }
+    } );
+}
+
+void collector::stop() {
+    {  // block
+        std::lock_guard< std::mutex > lock( mtxWait_ );
+        if ( !isRunning_ )
+            return;
+        isRunning_ = false;
+    }  // block
+    cvWait_.notify_all();
+    if ( thread_.joinable() )
+        thread_.join();
+    drain();
+}
+
+size_t collector::drain() {
+    std::vector< ring_ptr > vecRings;
+    {  // block
+        std::lock_guard< mutex_type > lock( mtxRings_ );
+        vecRings = vecRings_;
+    }  // block
+    std::vector< record_t > vecForTimeline;
+    size_t nDrained = 0;
+    {  // block
+        // histograms lock also serializes consumers, rings are single-consumer
+        std::lock_guard< mutex_type > lock( mtxHistograms_ );
+        auto fnDrainRecord = [&]( const record_t& rec ) { drain_record( rec, vecForTimeline ); };
+        for ( const ring_ptr& pRing : vecRings )
+            nDrained += pRing->drain( fnDrainRecord );
+        // forget rings of finished threads, one reference is in vecRings_ and one in local copy
+        std::lock_guard< mutex_type > lockRings( mtxRings_ );
+        auto itRemove = std::remove_if(
+            vecRings_.begin(), vecRings_.end(), [&]( const ring_ptr& pRing ) -> bool {
+                if ( pRing.use_count() > 2 )
+                    return false;
+                nDrained += pRing->drain( fnDrainRecord );
+                nDroppedFromReleasedRings_ += pRing->dropped();
+                return true;
+            } );
+        vecRings_.erase( itRemove, vecRings_.end() );
+    }  // block
+    nDrained_ += nDrained;
+    if ( !vecForTimeline.empty() )
+        publish_to_timeline( vecForTimeline );
+    return nDrained;
+}
+
+void collector::drain_record( const record_t& rec, std::vector< record_t >& vecForTimeline ) {
+    mapHistograms_[std::make_pair( rec.idChannel_, rec.idMethod_ )].add( rec );
+    performance::tracker_ptr pTracker = pTracker_ ? pTracker_ : performance::get_default_tracker();
+    if ( pTracker && pTracker->is_running() )
+        vecForTimeline.push_back( rec );
+}
+
+void collector::publish_to_timeline( const std::vector< record_t >& vecForTimeline ) {
+    performance::tracker_ptr pTracker;
+    {  // block
+        std::lock_guard< mutex_type > lock( mtxHistograms_ );
+        pTracker = pTracker_ ? pTracker_ : performance::get_default_tracker();
+    }  // block
+    if ( !pTracker )
+        return;
+    name_registry& names = get_default_name_registry();
+    for ( const record_t& rec : vecForTimeline ) {
+        performance::time_point tpStart{ std::chrono::duration_cast< clock::duration >(
+            std::chrono::nanoseconds( rec.tsStart_ ) ) };
+        performance::time_point tpEnd{ std::chrono::duration_cast< clock::duration >(
+            std::chrono::nanoseconds( rec.tsEnd_ ) ) };
+        if ( tpStart < pTracker->tp_start() )
+            continue;  // recorded before current tracking session
+        if ( !pTracker->can_accept_new_item() )
+            break;
+        std::string strChannel = names.name_of( rec.idChannel_ );
+        std::string strMethod = names.name_of( rec.idMethod_ );
+        json jsnIn = json::object();
+        jsnIn["method"] = strMethod;
+        jsnIn["requestSize"] = rec.nRequestSize_;
+        json jsnOut = json::object();
+        jsnOut["responseSize"] = rec.nResponseSize_;
+        performance::queue_ptr pQueue = pTracker->get_queue( strChannel );
+        performance::item_ptr pItem = pQueue->new_finished_item(
+            skutils::tools::format( "task %u, %s", unsigned( rec.nTaskNumber_ ),
+                strMethod.c_str() ),
+            jsnIn, tpStart, tpEnd );
+        if ( rec.status_ == status_t::ok )
+            pItem->set_json_out( jsnOut );
+        else
+            pItem->set_json_err( jsnOut );
+    }
+}
+
+void collector::reset() {
+    drain();
+    std::lock_guard< mutex_type > lock( mtxHistograms_ );
+    mapHistograms_.clear();
+}
+
+json collector::compose_json() {
+    drain();
+    name_registry& names = get_default_name_registry();
+    json jsnChannels = json::object();
+    uint64_t nDropped = nDroppedFromReleasedRings_;
+    size_t nRingCount = 0;
+    {  // block
+        std::lock_guard< mutex_type > lock( mtxRings_ );
+        nRingCount = vecRings_.size();
+        for ( const ring_ptr& pRing : vecRings_ )
+            nDropped += pRing->dropped();
+    }  // block
+    {  // block
+        std::lock_guard< mutex_type > lock( mtxHistograms_ );
+        for ( const auto& entry : mapHistograms_ ) {
+            std::string strChannel = names.name_of( entry.first.first );
+            std::string strMethod = names.name_of( entry.first.second );
+            if ( jsnChannels.count( strChannel ) == 0 )
+                jsnChannels[strChannel] = json::object();
+            jsnChannels[strChannel][strMethod] = entry.second.compose_json();
+        }
+    }  // block
+    json jsn = json::object();
+    jsn["enabled"] = is_enabled();
+    jsn["threadRings"] = nRingCount;
+    jsn["drained"] = uint64_t( nDrained_ );
+    jsn["dropped"] = nDropped;
+    jsn["channels"] = jsnChannels;
+    return jsn;
+}
+
+};  // namespace trace
+};  // namespace task
+};  // namespace skutils
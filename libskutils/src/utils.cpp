@@ -1663,6 +1663,7 @@ std::string read_maps() {
 json_config_file_accessor::json_config_file_accessor( const std::string& configPath )
     : configPath_( configPath ),
       configModificationTime_( 0 ),
+      configGeneration_( 0 ),
       joConfig_( nlohmann::json::object() ) {}
 json_config_file_accessor::~json_config_file_accessor() {}
 
@@ -1684,6 +1685,8 @@ void json_config_file_accessor::reloadConfigIfNeeded() {
         nlohmann::json joNewConfig = nlohmann::json::parse( ifs );
         joConfig_ = joNewConfig;
         configModificationTime_ = tt;
+        static std::atomic< size_t > g_nGenerationCounter( 0 );
+        configGeneration_ = ++g_nGenerationCounter;
         std::cout << strLogPrefix << cc::success( " Done, loaded configuration file " )
                   << cc::p( configPath_ ) << "\n";
     } catch ( std::exception& ex ) {
@@ -1705,6 +1708,12 @@ nlohmann::json json_config_file_accessor::getConfigJSON() {
     return joConfig_;
 }
 
+size_t json_config_file_accessor::getConfigGeneration() {
+    reloadConfigIfNeeded();
+    lock_type lock( mtx() );
+    return configGeneration_;
+}
+
 nlohmann::json json_config_file_accessor::stat_extract_at_path(
     const nlohmann::json& joConfig, const string_list_t& listPath ) {
     string_list_t::const_iterator itWalk = listPath.cbegin(), itEnd = listPath.cend();
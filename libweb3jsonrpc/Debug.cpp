@@ -222,6 +222,7 @@ Json::Value Debug::debug_traceCall( Json::Value const& _call, Json::Value const&
     Json::Value ret;
     try {
         Block temp = m_eth.latestBlock();
+        temp.startReadState();
         TransactionSkeleton ts = toTransactionSkeleton( _call );
         if ( !ts.from ) {
             ts.from = Address();
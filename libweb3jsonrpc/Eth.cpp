@@ -31,6 +31,8 @@
 #include <libethashseal/EthashClient.h>
 #include <libethcore/CommonJS.h>
 #include <libethereum/Client.h>
+#include <libevm/ExecutionBudget.h>
+#include <libskale/StateReadSet.h>
 #include <libweb3jsonrpc/JsonHelper.h>
 
 #include <csignal>
@@ -48,6 +50,16 @@ using namespace dev::rpc;
 const uint64_t MAX_CALL_CACHE_ENTRIES = 1024;
 const uint64_t MAX_RECEIPT_CACHE_ENTRIES = 1024;
 
+// "limit exceeded" of EIP-1474
+const int ERROR_RPC_EXECUTION_BUDGET_EXCEEDED = -32005;
+
+static JsonRpcException executionBudgetError( ExecutionBudgetExceeded const& _ex ) {
+    std::string message = "execution budget exceeded";
+    if ( auto const* comment = boost::get_error_info< errinfo_comment >( _ex ) )
+        message += ": " + *comment;
+    return JsonRpcException( ERROR_RPC_EXECUTION_BUDGET_EXCEEDED, message );
+}
+
 
 Eth::Eth( const std::string& configPath, eth::Interface& _eth, eth::AccountHolder& _ethAccounts )
     : skutils::json_config_file_accessor( configPath ),
@@ -401,22 +413,46 @@ string Eth::eth_call( TransactionSkeleton& t, string const&
     }
 
 
-    key = t.toString().append( to_string( bN ) );
-
-    auto result = m_callCache.getIfExists( key );
+    // defaults of gas and gas price change from block to block, so they are resolved here to be
+    // a part of the key
+    setTransactionDefaults( t );
+    if ( t.gas == Invalid256 )
+        t.gas = client()->gasLimitRemaining();
+    if ( t.gasPrice == Invalid256 )
+        t.gasPrice = client()->gasBidPrice();
+
+    // a call at the latest block keeps its result over later blocks until they change state it
+    // read, so it is keyed without the block number; calls with reads that cannot be tracked are
+    // keyed with it
+    bool const latest = bN == client()->number();
+    key = t.toString();
+    string const blockKey = key + to_string( bN );
+
+    auto result = m_callCache.getIfExists( latest ? key : blockKey );
     if ( result.has_value() ) {
-        // found an identical request in cache, return
-        return any_cast< string >( result );
+        auto cached = any_cast< CachedCall >( result );
+        if ( !cached.reads || cached.reads->current() )
+            // found an identical request in cache, return
+            return cached.result;
+    }
+    if ( latest ) {
+        result = m_callCache.getIfExists( blockKey );
+        if ( result.has_value() )
+            return any_cast< CachedCall >( result ).result;
     }
 
     // Step 2. We got a cache miss. Execute the call now.
-    setTransactionDefaults( t );
 
-    ExecutionResult er = client()->call( t.from, t.value, t.to, t.data, t.gas, t.gasPrice,
+    ExecutionResult er;
+    try {
+        er = client()->call( t.from, t.value, t.to, t.data, t.gas, t.gasPrice,
 #ifdef HISTORIC_STATE
-        bN,
+            bN,
 #endif
-        FudgeFactor::Lenient );
+            FudgeFactor::Lenient );
+    } catch ( ExecutionBudgetExceeded const& ex ) {
+        BOOST_THROW_EXCEPTION( executionBudgetError( ex ) );
+    }
 
     std::string strRevertReason;
     if ( er.excepted == dev::eth::TransactionException::RevertInstruction ) {
@@ -437,7 +473,10 @@ string Eth::eth_call( TransactionSkeleton& t, string const&
     string callResult = toJS( er.output );
 
     // put the result into cache so it can be used by future calls
-    m_callCache.put( key, callResult );
+    if ( latest && er.stateReads && er.stateReads->exact() )
+        m_callCache.put( key, CachedCall{ callResult, er.stateReads } );
+    else
+        m_callCache.put( blockKey, CachedCall{ callResult, nullptr } );
 
     return callResult;
 }
@@ -459,6 +498,8 @@ string Eth::eth_estimateGas( Json::Value const& _json ) {
         return toJS( result.first );
     } catch ( std::logic_error& error ) {
         throw error;
+    } catch ( ExecutionBudgetExceeded const& ex ) {
+        BOOST_THROW_EXCEPTION( executionBudgetError( ex ) );
     } catch ( ... ) {
         BOOST_THROW_EXCEPTION( JsonRpcException( Errors::ERROR_RPC_INVALID_PARAMS ) );
     }
@@ -689,6 +730,19 @@ Json::Value Eth::eth_getFilterLogs( string const& _filterId ) {
 
 Json::Value Eth::eth_getLogs( Json::Value const& _json ) {
     try {
+        // with "limit" result is paginated: {"logs": [...], "cursor": next page or null}
+        if ( _json.isObject() && _json.isMember( "limit" ) ) {
+            std::string cursor;
+            if ( _json.isMember( "cursor" ) && !_json["cursor"].isNull() )
+                cursor = _json["cursor"].asString();
+            size_t const limit = _json["limit"].isString() ?
+                                     static_cast< size_t >( jsToInt( _json["limit"].asString() ) ) :
+                                     static_cast< size_t >( _json["limit"].asUInt64() );
+            Json::Value ret( Json::objectValue );
+            ret["logs"] = toJson( client()->logs( toLogFilter( _json ), cursor, limit ) );
+            ret["cursor"] = cursor.empty() ? Json::Value() : Json::Value( cursor );
+            return ret;
+        }
         return toJson( client()->logs( toLogFilter( _json ) ) );
     } catch ( ... ) {
         BOOST_THROW_EXCEPTION( JsonRpcException( Errors::ERROR_RPC_INVALID_PARAMS ) );
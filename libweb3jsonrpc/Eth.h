@@ -37,6 +37,10 @@
 
 #include <skutils/utils.h>
 
+namespace skale {
+class StateReadSet;
+}
+
 namespace dev {
 class NetworkFace;
 class KeyPair;
@@ -151,9 +155,15 @@ protected:
     eth::Interface& m_eth;
     eth::AccountHolder& m_ethAccounts;
 
-    // a cache that maps the call request to the pair of response string and block number
-    // for which the request has been executed
-    cache::lru_cache< string, string > m_callCache;
+    struct CachedCall {
+        string result;
+        // state the call read at the latest block, null for calls at earlier blocks
+        std::shared_ptr< skale::StateReadSet const > reads;
+    };
+
+    // a cache that maps the call request to its response; calls at an earlier block are keyed
+    // with the block number, calls at the latest block stay until a commit changes what they read
+    cache::lru_cache< string, CachedCall > m_callCache;
 
     // a cache that maps a transaction receipt to the block number where
     // the transaction was not yet ready
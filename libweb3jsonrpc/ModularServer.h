@@ -125,6 +125,9 @@ public:
         return m_connectors.at( _i ).get();
     }
 
+    /// @returns names of all methods and notifications the server handles.
+    virtual std::vector< std::string > procedureNames() const { return { "rpc_modules" }; }
+
 protected:
     std::vector< std::unique_ptr< jsonrpc::AbstractServerConnector > > m_connectors;
     std::unique_ptr< jsonrpc::IProtocolHandler > m_handler;
@@ -185,6 +188,15 @@ public:
             ModularServer< Is... >::HandleNotificationCall( _proc, _input );
     }
 
+    std::vector< std::string > procedureNames() const override {
+        std::vector< std::string > names = ModularServer< Is... >::procedureNames();
+        for ( auto const& method : m_methods )
+            names.push_back( method.first );
+        for ( auto const& notification : m_notifications )
+            names.push_back( notification.first );
+        return names;
+    }
+
 private:
     std::unique_ptr< I > m_interface;
     std::map< std::string, MethodPointer > m_methods;
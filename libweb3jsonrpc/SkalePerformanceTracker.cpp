@@ -35,6 +35,7 @@
 #include <skutils/eth_utils.h>
 #include <skutils/rest_call.h>
 #include <skutils/task_performance.h>
+#include <skutils/task_trace.h>
 
 #include <array>
 #include <csignal>
@@ -65,6 +66,7 @@ Json::Value SkalePerformanceTracker::skale_performanceTrackingStatus(
         jo["maxItemCount"] = pTracker->get_safe_max_item_count();
         jo["sessionMaxItemCount"] = pTracker->get_session_max_item_count();
         jo["sessionStopReason"] = pTracker->get_first_encountered_stop_reason();
+        jo["trace"] = skutils::task::trace::get_default_collector().compose_json();
         //
         std::string s = jo.dump();
         Json::Value ret;
@@ -139,6 +141,7 @@ Json::Value SkalePerformanceTracker::skale_performanceTrackingStop(
     const Json::Value& /*request*/ ) {
     std::string strLogPrefix = cc::deep_info( "Performance tracking stop" );
     try {
+        skutils::task::trace::get_default_collector().drain();
         skutils::task::performance::tracker_ptr pTracker =
             skutils::task::performance::get_default_tracker();
         bool bTrackerIsRunning = pTracker->is_running();
@@ -186,6 +189,7 @@ Json::Value SkalePerformanceTracker::skale_performanceTrackingFetch( const Json:
         if ( joRequest.count( "minIndex" ) > 0 )
             minIndexT = joRequest["minIndex"].get< size_t >();
         //
+        skutils::task::trace::get_default_collector().drain();
         skutils::task::performance::tracker_ptr pTracker =
             skutils::task::performance::get_default_tracker();
         bool bTrackerIsRunning = pTracker->is_running();
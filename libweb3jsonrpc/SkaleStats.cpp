@@ -32,6 +32,10 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonJS.h>
 #include <libdevcore/FileSystem.h>
+#include <libethcore/PrecompiledCache.h>
+#include <libethereum/CodeSizeCache.h>
+#include <libevm/AnalyzedCodeCache.h>
+#include <libevm/ExecutionBudget.h>
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
@@ -205,6 +209,45 @@ Json::Value SkaleStats::skale_stats() {
 
         }  // if client
 
+        const dev::eth::AnalyzedCodeCache& codeCache = dev::eth::AnalyzedCodeCache::instance();
+        nlohmann::json joCodeCache = nlohmann::json::object();
+        joCodeCache["hits"] = codeCache.hits();
+        joCodeCache["misses"] = codeCache.misses();
+        joCodeCache["evictions"] = codeCache.evictions();
+        joCodeCache["entries"] = codeCache.size();
+        joCodeCache["memoryUsage"] = codeCache.memoryUsage();
+        joStats["analyzedCodeCache"] = joCodeCache;
+
+        const dev::eth::CodeSizeCache& codeSizeCache = dev::eth::CodeSizeCache::instance();
+        nlohmann::json joCodeSizeCache = nlohmann::json::object();
+        joCodeSizeCache["hits"] = codeSizeCache.hits();
+        joCodeSizeCache["misses"] = codeSizeCache.misses();
+        joCodeSizeCache["entries"] = codeSizeCache.size();
+        joCodeSizeCache["codeMemory"] = codeSizeCache.codeMemory();
+        joStats["codeCache"] = joCodeSizeCache;
+
+        nlohmann::json joPrecompiled = nlohmann::json::object();
+        for ( auto const& entry : dev::eth::PrecompiledCache::stats() ) {
+            nlohmann::json joEntry = nlohmann::json::object();
+            joEntry["calls"] = entry.second.calls;
+            joEntry["hits"] = entry.second.hits;
+            joEntry["hitRate"] =
+                entry.second.calls ? double( entry.second.hits ) / entry.second.calls : 0.0;
+            joEntry["executionTimeUs"] = entry.second.executionTime;
+            joPrecompiled[entry.first] = joEntry;
+        }
+        joStats["precompiled"] = joPrecompiled;
+
+        nlohmann::json joExecutionBudget = nlohmann::json::object();
+        for ( auto const& entry : dev::eth::ExecutionBudget::stats() ) {
+            nlohmann::json joEntry = nlohmann::json::object();
+            joEntry["requests"] = entry.second.requests;
+            joEntry["exceeded"] = entry.second.exceeded;
+            joEntry["instructions"] = entry.second.instructions;
+            joExecutionBudget[entry.first] = joEntry;
+        }
+        joStats["executionBudget"] = joExecutionBudget;
+
         std::string strStatsJson = joStats.dump();
         Json::Value ret;
         Json::Reader().parse( strStatsJson, ret );
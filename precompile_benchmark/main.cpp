@@ -0,0 +1,95 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+#include <libdevcore/CommonData.h>
+#include <libethereum/Precompiled.h>
+
+using namespace dev;
+using namespace dev::eth;
+
+// Calls per second of _code, run for about _seconds.
+double measure_performance( function< void() > code, double _seconds = 1 ) {
+    using clock = chrono::steady_clock;
+    size_t total_count = 0;
+    auto const start = clock::now();
+    chrono::duration< double > elapsed{ 0 };
+    for ( size_t count = 1; elapsed.count() < _seconds; count *= 2 ) {
+        for ( size_t i = 0; i < count; ++i )
+            code();
+        total_count += count;
+        elapsed = clock::now() - start;
+    }
+    return total_count / elapsed.count();
+}
+
+void report( string const& _name, double _callsPerSecond ) {
+    cout << _name << ": " << _callsPerSecond << " calls/s, " << 1e6 / _callsPerSecond
+         << " us/call" << endl;
+}
+
+bytes modexpInput( size_t _bytes, bool _oddModulus, mt19937_64& _rng ) {
+    bytes base( _bytes ), exp( _bytes ), mod( _bytes );
+    for ( auto* v : { &base, &exp, &mod } )
+        for ( auto& b : *v )
+            b = static_cast< _byte_ >( _rng() );
+    base[0] &= 0x7f;
+    mod[0] |= 0x80;
+    if ( _oddModulus )
+        mod.back() |= 1;
+    else
+        mod.back() &= 0xfe;
+    return toBigEndian( u256( _bytes ) ) + toBigEndian( u256( _bytes ) ) +
+           toBigEndian( u256( _bytes ) ) + base + exp + mod;
+}
+
+void testModexp() {
+    PrecompiledExecutor const& exec = PrecompiledRegistrar::executor( "modexp" );
+    mt19937_64 rng( 1 );
+    for ( size_t bits : { 256, 512, 1024, 2048, 4096 } ) {
+        // odd moduli take the Montgomery path, even ones the bigint one
+        bytes const odd = modexpInput( bits / 8, true, rng );
+        bytes const even = modexpInput( bits / 8, false, rng );
+        report( "modexp " + to_string( bits ) + " bit, odd modulus",
+            measure_performance( [&]() { exec( ref( odd ) ); } ) );
+        report( "modexp " + to_string( bits ) + " bit, even modulus",
+            measure_performance( [&]() { exec( ref( even ) ); } ) );
+    }
+}
+
+void testBn128() {
+    bytes const g1 = toBigEndian( u256( 1 ) ) + toBigEndian( u256( 2 ) );
+    bytes const g1Neg = toBigEndian( u256( 1 ) ) +
+                        toBigEndian( u256( "218882428718392752222464057452572750886963111572978236"
+                                           "62689037894645226208581" ) );
+    bytes const g2 = fromHex(
+        "198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c2"
+        "1800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed"
+        "090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b"
+        "12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa" );
+
+    bytes const add = g1 + g1;
+    PrecompiledExecutor const& addExec = PrecompiledRegistrar::executor( "alt_bn128_G1_add" );
+    report( "alt_bn128_G1_add", measure_performance( [&]() { addExec( ref( add ) ); } ) );
+
+    bytes const mul = g1 + toBigEndian( ~u256( 0 ) );
+    PrecompiledExecutor const& mulExec = PrecompiledRegistrar::executor( "alt_bn128_G1_mul" );
+    report( "alt_bn128_G1_mul", measure_performance( [&]() { mulExec( ref( mul ) ); } ) );
+
+    // the same G2 point every call, as with a fixed verifying key
+    bytes const pairing = g1 + g2 + g1Neg + g2;
+    PrecompiledExecutor const& pairingExec =
+        PrecompiledRegistrar::executor( "alt_bn128_pairing_product" );
+    report( "alt_bn128_pairing_product, 2 pairs",
+        measure_performance( [&]() { pairingExec( ref( pairing ) ); } ) );
+}
+
+int main() {
+    testModexp();
+    testBn128();
+    return 0;
+}
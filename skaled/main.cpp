@@ -26,6 +26,7 @@
  */
 
 #include <signal.h>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -57,6 +58,7 @@
 #include <libevm/VMFactory.h>
 
 #include <libskale/ConsensusGasPricer.h>
+#include <libskale/FileHashState.h>
 #include <libskale/SnapshotManager.h>
 #include <libskale/UnsafeRegion.h>
 
@@ -99,6 +101,7 @@
 #include <skutils/console_colors.h>
 #include <skutils/rest_call.h>
 #include <skutils/task_performance.h>
+#include <skutils/task_trace.h>
 #include <skutils/url.h>
 #include <skutils/utils.h>
 
@@ -729,6 +732,8 @@ int main( int argc, char** argv ) try {
     addClientOption( "performance-timeline-max-items",
         po::value< size_t >()->value_name( "<number>" ),
         "Specifies max number of items performance timeline tracker can save" );
+    addClientOption( "rpc-trace-disable",
+        "Disable low-overhead RPC and block pipeline tracing histograms" );
 
     std::string str_ws_mode_description =
         "Run web3 WS and/or WSS server(s) using specified mode(" +
@@ -741,6 +746,10 @@ int main( int argc, char** argv ) try {
     addClientOption( "max-connections", po::value< size_t >()->value_name( "<count>" ),
         "Max number of RPC connections(such as web3) summary for all protocols(0 is default and "
         "means unlimited)" );
+    addClientOption( "ws-max-pending-notifications",
+        po::value< size_t >()->value_name( "<count>" ),
+        "Max number of subscription notifications queued for one web socket peer, slower peers "
+        "are disconnected(4096 is default, 0 means unlimited)" );
     addClientOption( "max-http-queues", po::value< size_t >()->value_name( "<count>" ),
         "Max number of handler queues for HTTP/S connections per endpoint server" );
     addClientOption(
@@ -752,6 +761,8 @@ int main( int argc, char** argv ) try {
     addClientOption( "pg-threads-limit", po::value< int32_t >()->value_name( "<count>" ),
         "Limit number of proxygen threads, zero means no limit" );
     addClientOption( "pg-trace", "Log low level proxygen information" );
+    addClientOption( "pg-stream-buffer-size", po::value< size_t >()->value_name( "<bytes>" ),
+        "Size of buffer used for HTTP answers sent in chunks, like big eth_getLogs results" );
 
     addClientOption( "expose-all-debug-info", "Expose extra detailed debug info into log output" );
 
@@ -818,6 +829,14 @@ int main( int argc, char** argv ) try {
     //    "Path of file to save downloaded snapshot to" );
     addClientOption( "start-timestamp", po::value< time_t >()->value_name( "<seconds>" ),
         "Start at specified timestamp (since epoch) - usually after downloading a snapshot" );
+    addClientOption( "log-index-backfill", po::value< uint64_t >()->value_name( "<block>" ),
+        "Index logs of already imported blocks down to specified block in background, "
+        "after removing stale ones (requires nodeInfo.logIndex)" );
+    addClientOption( "estimate-gas-probes", po::value< unsigned >()->value_name( "<count>" ),
+        "Gas limits one eth_estimateGas call tries at once when searching, 1 for bisection "
+        "(default: 4)" );
+    addClientOption( "estimate-gas-threads", po::value< unsigned >()->value_name( "<count>" ),
+        "Threads shared by all eth_estimateGas calls for trying gas limits at once (default: 2)" );
 
     LoggingOptions loggingOptions;
     po::options_description loggingProgramOptions(
@@ -857,6 +876,10 @@ int main( int argc, char** argv ) try {
         "for unlimited" );
     addGeneralOption( "dispatch-threads", po::value< size_t >()->value_name( "<count>" ),
         "Number of threads to run task dispatcher, default is CPU count * 2" );
+    addGeneralOption( "verify-filestorage-hashes",
+        "Check filestorage hash sidecars and ._hash files against the file contents and exit" );
+    addGeneralOption(
+        "repair-filestorage-hashes", "Rebuild filestorage hash sidecars from the files and exit" );
     addGeneralOption( "version,V", "Show the version and exit" );
     addGeneralOption( "help,h", "Show this help message and exit\n" );
 
@@ -912,6 +935,16 @@ int main( int argc, char** argv ) try {
     if ( vm.count( "network-idle-timeout" ) )
         skutils::rest::g_nClientConnectionTimeoutMS = vm["network-idle-timeout"].as< long >();
 
+    if ( vm.count( "estimate-gas-probes" ) || vm.count( "estimate-gas-threads" ) ) {
+        unsigned probes = dev::eth::ClientBase::c_defaultEstimateGasProbes;
+        unsigned threads = dev::eth::ClientBase::c_defaultEstimateGasThreads;
+        if ( vm.count( "estimate-gas-probes" ) )
+            probes = vm["estimate-gas-probes"].as< unsigned >();
+        if ( vm.count( "estimate-gas-threads" ) )
+            threads = vm["estimate-gas-threads"].as< unsigned >();
+        dev::eth::ClientBase::setEstimateGasConcurrency( probes, threads );
+    }
+
     if ( vm.count( "test-enable-crash-at" ) ) {
         std::string crash_at = vm["test-enable-crash-at"].as< string >();
         batched_io::test_enable_crash_at( crash_at );
@@ -1382,6 +1415,19 @@ int main( int argc, char** argv ) try {
         return int( ExitHandler::ec_state_root_mismatch );
     }  // if bad exit
 
+    if ( vm.count( "verify-filestorage-hashes" ) || vm.count( "repair-filestorage-hashes" ) ) {
+        bool const repair = vm.count( "repair-filestorage-hashes" ) > 0;
+        fs::path const fileStorageDir = getDataDir() / "filestorage";
+        skale::FileHashState::Report report;
+        if ( fs::exists( fileStorageDir ) )
+            report = skale::FileHashState::verify( fileStorageDir, repair );
+        clog( VerbosityInfo, "main" )
+            << "Checked " << report.files << " filestorage files: " << report.badSidecars
+            << " bad hash sidecars" << ( repair ? " rebuilt, " : ", " ) << report.badHashes
+            << " ._hash files not matching the content";
+        return report.badHashes > 0 || ( !repair && report.badSidecars > 0 ) ? EX_DATAERR : 0;
+    }
+
     size_t clockDbRotationPeriodInSeconds = 0;
     if ( chainConfigParsed ) {
         try {
@@ -2138,6 +2184,16 @@ int main( int argc, char** argv ) try {
                 << ( pTracker->is_enabled() ? cc::size10( pTracker->get_safe_max_item_count() ) :
                                               cc::error( "off" ) );
 
+            skutils::task::trace::collector& traceCollector =
+                skutils::task::trace::get_default_collector();
+            traceCollector.set_enabled( vm.count( "rpc-trace-disable" ) == 0 );
+            if ( traceCollector.is_enabled() )
+                traceCollector.start();
+            clog( VerbosityDebug, "main" )
+                << cc::debug( "...." ) << cc::info( "RPC trace collector" )
+                << cc::debug( "...................... " )
+                << ( traceCollector.is_enabled() ? cc::success( "on" ) : cc::error( "off" ) );
+
             if ( !bHaveSSL )
                 nExplicitPortHTTPS4std = nExplicitPortHTTPS6std = nExplicitPortHTTPS4nfo =
                     nExplicitPortHTTPS6nfo = nExplicitPortWSS4std = nExplicitPortWSS6std =
@@ -2175,6 +2231,21 @@ int main( int argc, char** argv ) try {
             if ( vm.count( "max-connections" ) )
                 maxConnections = vm["max-connections"].as< size_t >();
             //
+            // First, get "ws-max-pending-notifications" from config.json
+            // Second, get it from command line parameter (higher priority source)
+            size_t maxPendingWsNotifications =
+                SkaleWsSubscriptionHub::g_nDefaultMaxPendingNotificationsPerPeer;
+            if ( chainConfigParsed ) {
+                try {
+                    maxPendingWsNotifications =
+                        joConfig["skaleConfig"]["nodeInfo"]["ws-max-pending-notifications"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                }
+            }
+            if ( vm.count( "ws-max-pending-notifications" ) )
+                maxPendingWsNotifications = vm["ws-max-pending-notifications"].as< size_t >();
+            //
             // First, get "max-http-queues" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
             if ( chainConfigParsed ) {
@@ -2226,6 +2297,13 @@ int main( int argc, char** argv ) try {
                     skutils::http_pg::pg_logging_set( is_pg_trace );
                 } catch ( ... ) {
                 }
+                try {
+                    size_t pg_stream_buffer_size =
+                        joConfig["skaleConfig"]["nodeInfo"]["pg-stream-buffer-size"]
+                            .get< size_t >();
+                    skutils::http_pg::pg_stream_buffer_size_set( pg_stream_buffer_size );
+                } catch ( ... ) {
+                }
             }
             if ( vm.count( "pg-threads" ) )
                 pg_threads = vm["pg-threads"].as< int32_t >();
@@ -2233,6 +2311,9 @@ int main( int argc, char** argv ) try {
                 pg_threads_limit = vm["pg-threads-limit"].as< int32_t >();
             if ( vm.count( "pg-trace" ) )
                 skutils::http_pg::pg_logging_set( true );
+            if ( vm.count( "pg-stream-buffer-size" ) )
+                skutils::http_pg::pg_stream_buffer_size_set(
+                    vm["pg-stream-buffer-size"].as< size_t >() );
 
             // First, get "acceptors"/"info-acceptors" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
@@ -2314,6 +2395,11 @@ int main( int argc, char** argv ) try {
                 << cc::debug( "...................... " )
                 << ( ( maxConnections > 0 ) ? cc::size10( maxConnections ) :
                                               cc::error( "disabled" ) );
+            clog( VerbosityDebug, "main" )
+                << cc::debug( "...." ) + cc::info( "Max WS pending notifications" )
+                << cc::debug( "............. " )
+                << ( ( maxPendingWsNotifications > 0 ) ? cc::size10( maxPendingWsNotifications ) :
+                                                         cc::error( "disabled" ) );
             clog( VerbosityDebug, "main" )
                 << cc::debug( "...." ) + cc::info( "Max HTTP queues" )
                 << cc::debug( ".......................... " )
@@ -2432,6 +2518,13 @@ int main( int argc, char** argv ) try {
             clog( VerbosityDebug, "main" )
                 << cc::attention( "UN-DDOS" ) + cc::debug( " is using configuration" )
                 << cc::j( skale_server_connector->unddos_.get_settings_json() );
+            //
+            // execution budget of eth_call and alike
+            if ( joConfig.count( "executionBudget" ) > 0 )
+                skale_server_connector->executionBudget_.fromJSON( joConfig["executionBudget"] );
+            clog( VerbosityDebug, "main" )
+                << cc::attention( "EXECUTION BUDGET" ) + cc::debug( " is using configuration" )
+                << cc::j( skale_server_connector->executionBudget_.toJSON() );
             skale_server_connector->max_http_handler_queues_ = max_http_handler_queues;
             skale_server_connector->is_async_http_transfer_mode_ = is_async_http_transfer_mode;
             skale_server_connector->maxCountInBatchJsonRpcRequest_ = cntInBatch;
@@ -2445,7 +2538,9 @@ int main( int argc, char** argv ) try {
             skale_server_connector->opts_.isTraceSpecialCalls_ = bTraceJsonRpcSpecialCalls;
 
             skale_server_connector->max_connection_set( maxConnections );
+            skale_server_connector->setMaxPendingNotificationsPerPeer( maxPendingWsNotifications );
             g_jsonrpcIpcServer->addConnector( skale_server_connector );
+            skale_server_connector->setTraceMethods( g_jsonrpcIpcServer->procedureNames() );
             if ( !skale_server_connector->StartListening() ) {  // TODO Will it delete itself?
                 clog( VerbosityError, "main" )
                     << ( cc::fatal( "FATAL:" ) + " " +
@@ -2768,6 +2863,28 @@ int main( int argc, char** argv ) try {
             << cc::debug( "Done, programmatic shutdown via Web3 is disabled" );
     }
 
+    // indexes logs of old blocks while new ones are imported
+    std::atomic_bool logIndexBackfillStop( false );
+    std::thread logIndexBackfillThread;
+    if ( g_client && vm.count( "log-index-backfill" ) ) {
+        uint64_t downTo = vm["log-index-backfill"].as< uint64_t >();
+        if ( !g_client->blockChain().logIndex() )
+            clog( VerbosityWarning, "main" )
+                << "--log-index-backfill ignored, log index is disabled in nodeInfo";
+        else
+            logIndexBackfillThread = std::thread( [downTo, &logIndexBackfillStop]() {
+                dev::setThreadName( "logIndexBackfill" );
+                try {
+                    uint64_t n =
+                        g_client->blockChain().backfillLogIndex( downTo, logIndexBackfillStop );
+                    clog( VerbosityInfo, "main" )
+                        << "Log index backfill indexed " << n << " blocks";
+                } catch ( const std::exception& ex ) {
+                    clog( VerbosityError, "main" ) << "Log index backfill failed: " << ex.what();
+                }
+            } );
+    }
+
     dev::setThreadName( "main" );
     if ( g_client ) {
         unsigned int n = g_client->blockChain().details().number;
@@ -2793,6 +2910,9 @@ int main( int argc, char** argv ) try {
         g_jsonrpcIpcServer.reset( nullptr );
         statusAndControl->setSubsystemRunning( StatusAndControl::Rpc, false );
     }
+    logIndexBackfillStop = true;
+    if ( logIndexBackfillThread.joinable() )
+        logIndexBackfillThread.join();
     if ( g_client ) {
         g_client->stopWorking();
         statusAndControl->setSubsystemRunning( StatusAndControl::Blockchain, false );
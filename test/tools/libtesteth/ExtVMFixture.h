@@ -0,0 +1,80 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ExtVMFixture.h
+ * Fixture running EVM code in ExtVM on an empty State, outside of a chain.
+ */
+
+#pragma once
+
+#include <libethashseal/GenesisInfo.h>
+#include <libethereum/ChainParams.h>
+#include <libethereum/ExtVM.h>
+#include <libethereum/LastBlockHashesFace.h>
+#include <libskale/State.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <memory>
+
+namespace dev {
+namespace test {
+
+/// Hashes of the 256 blocks preceding any block, all zero.
+class LastBlockHashes : public eth::LastBlockHashesFace {
+public:
+    h256s precedingHashes( h256 const& /* _mostRecentHash */ ) const override {
+        return h256s( 256, h256() );
+    }
+    void clear() override {}
+};
+
+/// Header of a block with the largest gas limit and timestamp 0.
+inline eth::BlockHeader initBlockHeader() {
+    eth::BlockHeader blockHeader;
+    blockHeader.setGasLimit( 0x7fffffffffffffff );
+    blockHeader.setTimestamp( 0 );
+    return blockHeader;
+}
+
+/// Block, seal engine of @a _network and State for running code in ExtVM. With @a _writable the
+/// State holds the write lock until the fixture is destroyed, so code runs on it directly;
+/// otherwise tests take writable copies and read-only overlays of it themselves.
+class ExtVMFixture : public TestOutputHelperFixture {
+public:
+    explicit ExtVMFixture(
+        bool _writable = true, eth::Network _network = eth::Network::ConstantinopleTest )
+        : se( eth::ChainParams( eth::genesisInfo( _network ) ).createSealEngine() ),
+          envInfo( blockHeader, lastBlockHashes, 0, se->chainParams().chainID ),
+          state( _writable ? skale::State( 0 ).createStateModifyCopy() : skale::State( 0 ) ) {}
+    ~ExtVMFixture() { state.releaseWriteLock(); }
+
+    /// Frame of @a _code run by account @a _address calling itself with gas price 1.
+    eth::ExtVM extVM( Address const& _address, bytes const& _code ) {
+        return eth::ExtVM( state, envInfo, *se, _address, _address, _address, 0, 1,
+            bytesConstRef(), ref( _code ), sha3( _code ), 0, 0, false, false );
+    }
+
+    eth::BlockHeader blockHeader{ initBlockHeader() };
+    LastBlockHashes lastBlockHashes;
+    std::unique_ptr< eth::SealEngineFace > se;
+    eth::EnvInfo envInfo;
+    skale::State state;
+};
+
+}  // namespace test
+}  // namespace dev
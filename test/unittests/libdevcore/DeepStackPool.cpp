@@ -0,0 +1,120 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file DeepStackPool.cpp
+ * Tests for the pool of large stack threads.
+ */
+
+#include <libdevcore/DeepStackPool.h>
+#include <libdevcore/Exceptions.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace dev;
+using namespace dev::test;
+
+namespace {
+
+/// Uses about 64 KiB of stack per level.
+size_t recurse( size_t _depth ) {
+    volatile unsigned char frame[64 * 1024];
+    frame[0] = static_cast< unsigned char >( _depth );
+    if ( _depth == 0 )
+        return frame[0];
+    return recurse( _depth - 1 ) + frame[0];
+}
+
+struct NotAStdException {
+    int value;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( DeepStackPoolSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( threadsAreReused ) {
+    DeepStackPool pool( 1024 * 1024 );
+    std::thread::id first;
+    pool.run( [&] { first = std::this_thread::get_id(); } );
+    BOOST_CHECK( first != std::this_thread::get_id() );
+
+    for ( int i = 0; i < 10; ++i ) {
+        std::thread::id id;
+        pool.run( [&] { id = std::this_thread::get_id(); } );
+        BOOST_CHECK( id == first );
+    }
+    BOOST_CHECK_EQUAL( pool.threadsStarted(), 1 );
+    BOOST_CHECK_EQUAL( pool.idle(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( stackIsLargerThanDefault ) {
+    // 32 MiB of recursion does not fit into default 8 MiB thread stack
+    DeepStackPool pool( 64 * 1024 * 1024 );
+    size_t result = 0;
+    pool.run( [&] { result = recurse( 512 ); } );
+    BOOST_CHECK( result > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( exceptionsArePropagated ) {
+    DeepStackPool pool( 1024 * 1024 );
+    BOOST_CHECK_THROW( pool.run( [] { BOOST_THROW_EXCEPTION( BadHexCharacter() ); } ),
+        BadHexCharacter );
+
+    try {
+        pool.run( [] { throw NotAStdException{ 42 }; } );
+        BOOST_FAIL( "exception expected" );
+    } catch ( NotAStdException const& _e ) {
+        BOOST_CHECK_EQUAL( _e.value, 42 );
+    }
+
+    // thread survives exceptions
+    bool ran = false;
+    pool.run( [&] { ran = true; } );
+    BOOST_CHECK( ran );
+    BOOST_CHECK_EQUAL( pool.threadsStarted(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentCallersGetOwnThreads ) {
+    DeepStackPool pool( 1024 * 1024, 2 );
+    std::atomic< int > inside{ 0 };
+    std::atomic< int > maxInside{ 0 };
+    std::vector< std::thread > callers;
+    for ( int i = 0; i < 4; ++i )
+        callers.emplace_back( [&] {
+            for ( int j = 0; j < 100; ++j )
+                pool.run( [&] {
+                    int now = ++inside;
+                    int seen = maxInside;
+                    while ( now > seen && !maxInside.compare_exchange_weak( seen, now ) ) {
+                    }
+                    std::this_thread::yield();
+                    --inside;
+                } );
+        } );
+    for ( auto& caller : callers )
+        caller.join();
+
+    BOOST_CHECK( maxInside <= 4 );
+    BOOST_CHECK( pool.threadsStarted() >= 1 );
+    BOOST_CHECK( pool.idle() <= 2 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
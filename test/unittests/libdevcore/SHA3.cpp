@@ -0,0 +1,153 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SHA3.cpp
+ * Tests and benchmark for batched and memoized Keccak hashing.
+ */
+
+#include <libdevcore/SHA3.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace dev;
+using namespace dev::test;
+
+namespace {
+
+/// Key and slot as Solidity hashes them for mapping(uint => ...) at @a _slot.
+bytes mappingInput( unsigned _key, unsigned _slot ) {
+    return toBigEndian( u256( _key ) ) + toBigEndian( u256( _slot ) );
+}
+
+bool batchMatches( std::vector< bytes > const& _inputs ) {
+    std::vector< bytesConstRef > refs;
+    for ( auto const& input : _inputs )
+        refs.push_back( &input );
+    std::vector< h256 > hashes( _inputs.size() );
+    sha3Batch( refs.data(), hashes.data(), refs.size() );
+    for ( size_t i = 0; i < _inputs.size(); ++i )
+        if ( hashes[i] != sha3( _inputs[i] ) )
+            return false;
+    return true;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SHA3Suite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( batchMatchesSingleHashes ) {
+    BOOST_CHECK( batchMatches( {} ) );
+    BOOST_CHECK( batchMatches( { bytes() } ) );
+
+    // sizes around Keccak block size of 136 bytes, both equal and mixed within groups of four
+    for ( size_t size : { 0, 1, 32, 64, 135, 136, 137, 271, 272, 273, 1000 } ) {
+        std::vector< bytes > inputs;
+        for ( unsigned i = 0; i < 9; ++i )
+            inputs.push_back( bytes( size, uint8_t( i * 31 + size ) ) );
+        BOOST_CHECK( batchMatches( inputs ) );
+        inputs[5].push_back( 1 );
+        inputs[6].resize( size / 2 );
+        BOOST_CHECK( batchMatches( inputs ) );
+    }
+
+    std::vector< bytes > inputs;
+    for ( unsigned i = 0; i < 100; ++i )
+        inputs.push_back( mappingInput( i, 3 ) );
+    BOOST_CHECK( batchMatches( inputs ) );
+
+    h256 known;
+    bytesConstRef empty;
+    sha3Batch( &empty, &known, 1 );
+    BOOST_CHECK_EQUAL(
+        known, h256( "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470" ) );
+}
+
+BOOST_AUTO_TEST_CASE( cachedMatchesForRecurringAndCollidingInputs ) {
+    // many more distinct inputs than memo entries, each seen several times
+    for ( unsigned round = 0; round < 3; ++round )
+        for ( unsigned key = 0; key < 5000; ++key ) {
+            bytes const input = mappingInput( key, round % 2 );
+            BOOST_REQUIRE_EQUAL( sha3Cached64( input.data() ), sha3( input ) );
+        }
+
+    // inputs differing only in the last byte
+    bytes input( 64, 0xab );
+    for ( unsigned i = 0; i < 256; ++i ) {
+        input[63] = uint8_t( i );
+        BOOST_REQUIRE_EQUAL( sha3Cached64( input.data() ), sha3( input ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( cachedFromManyThreads ) {
+    std::atomic< unsigned > mismatches{ 0 };
+    std::vector< std::thread > threads;
+    for ( unsigned t = 0; t < 4; ++t )
+        threads.emplace_back( [&, t] {
+            for ( unsigned i = 0; i < 20000; ++i ) {
+                bytes const input = mappingInput( i % 700, t );
+                mismatches += sha3Cached64( input.data() ) != sha3( input );
+            }
+        } );
+    for ( auto& thread : threads )
+        thread.join();
+    BOOST_CHECK_EQUAL( mismatches, 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( SHA3PerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_AUTO_TEST_CASE( mappingSlots ) {
+    // token transfers touch few distinct balances many times
+    std::vector< bytes > inputs;
+    for ( unsigned i = 0; i < 100000; ++i )
+        inputs.push_back( mappingInput( i % 500, 0 ) );
+    std::vector< bytesConstRef > refs;
+    for ( auto const& input : inputs )
+        refs.push_back( &input );
+    std::vector< h256 > hashes( inputs.size() );
+
+    auto const perHash = []( std::chrono::high_resolution_clock::time_point _start,
+                             size_t _count ) {
+        auto const elapsed = std::chrono::high_resolution_clock::now() - _start;
+        return std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count() / _count;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( size_t i = 0; i < inputs.size(); ++i )
+        hashes[i] = sha3( refs[i] );
+    std::cout << "sha3: " << perHash( start, inputs.size() ) << " ns per hash" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    sha3Batch( refs.data(), hashes.data(), refs.size() );
+    std::cout << "sha3Batch: " << perHash( start, inputs.size() ) << " ns per hash" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for ( size_t i = 0; i < inputs.size(); ++i )
+        hashes[i] = sha3Cached64( inputs[i].data() );
+    std::cout << "sha3Cached64: " << perHash( start, inputs.size() ) << " ns per hash"
+              << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SharedBytes.cpp
+ * Lifetime tests for shared byte views, meant to be run under address and thread sanitizers.
+ */
+
+#include <libdevcore/SharedBytes.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace dev;
+using namespace dev::test;
+
+BOOST_FIXTURE_TEST_SUITE( SharedBytesSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( viewOutlivesOriginal ) {
+    SharedBytes view;
+    {
+        bytes data{ 1, 2, 3, 4, 5 };
+        _byte_ const* const buffer = data.data();
+        SharedBytes const original( std::move( data ), 1, 3 );
+        BOOST_CHECK_EQUAL( original.data(), buffer + 1 );
+        view = original;
+    }
+    BOOST_CHECK( view.toBytes() == bytes( { 2, 3, 4 } ) );
+    BOOST_CHECK_EQUAL( view.owner().use_count(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( slicesShareBuffer ) {
+    auto buffer = std::make_shared< bytes const >( bytes{ 1, 2, 3, 4, 5, 6 } );
+    std::weak_ptr< bytes const > const weak = buffer;
+    SharedBytes whole( std::move( buffer ) );
+
+    SharedBytes middle = whole.slice( 2, 2 );
+    SharedBytes tail = whole.slice( 4, 100 );
+    SharedBytes past = whole.slice( 10, 1 );
+    whole = SharedBytes();
+
+    BOOST_CHECK( middle.toBytes() == bytes( { 3, 4 } ) );
+    BOOST_CHECK( tail.toBytes() == bytes( { 5, 6 } ) );
+    BOOST_CHECK( past.empty() );
+    BOOST_CHECK( !weak.expired() );
+
+    middle = SharedBytes();
+    tail = SharedBytes();
+    past = SharedBytes();
+    BOOST_CHECK( weak.expired() );
+}
+
+BOOST_AUTO_TEST_CASE( foreignOwnerKeepsData ) {
+    struct Result {
+        bytes memory{ 7, 8, 9 };
+    };
+    auto result = std::make_shared< Result >();
+    SharedBytes const view( result, bytesConstRef( &result->memory ).cropped( 1 ) );
+    result.reset();
+    BOOST_CHECK( view.toBytes() == bytes( { 8, 9 } ) );
+}
+
+BOOST_AUTO_TEST_CASE( emptyViews ) {
+    BOOST_CHECK( SharedBytes().empty() );
+    BOOST_CHECK( SharedBytes( std::shared_ptr< bytes const >() ).empty() );
+    BOOST_CHECK( SharedBytes( bytes() ).empty() );
+    BOOST_CHECK( SharedBytes().slice( 0, 10 ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( copiesAcrossThreads ) {
+    SharedBytes shared( bytes( 4096, 0x5a ) );
+    std::weak_ptr< void const > const weak = shared.owner();
+
+    std::vector< std::thread > threads;
+    std::atomic< unsigned > good{ 0 };
+    for ( size_t i = 0; i < 8; ++i )
+        threads.emplace_back( [copy = shared, i, &good] {
+            for ( size_t j = 0; j < 1000; ++j ) {
+                SharedBytes const slice = copy.slice( i * 512, 512 );
+                if ( slice.size() == 512 && slice[j % 512] == 0x5a )
+                    ++good;
+            }
+        } );
+    shared = SharedBytes();
+    for ( auto& thread : threads )
+        thread.join();
+
+    BOOST_CHECK_EQUAL( good, 8000 );
+    BOOST_CHECK( weak.expired() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file WorkerPool.cpp
+ * Tests for parallel loops on the worker pool.
+ */
+
+#include <libdevcore/WorkerPool.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace dev;
+using namespace dev::test;
+
+BOOST_FIXTURE_TEST_SUITE( WorkerPoolSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( runsEveryIndexOnce ) {
+    WorkerPool pool( 4 );
+    BOOST_CHECK_EQUAL( pool.threads(), 4 );
+    for ( size_t count : { 0, 1, 2, 5, 1000 } ) {
+        std::vector< std::atomic< unsigned > > calls( count );
+        pool.parallelFor( count, [&]( size_t _i ) { ++calls[_i]; } );
+        for ( auto const& c : calls )
+            BOOST_REQUIRE_EQUAL( c, 1 );
+    }
+
+    // without workers everything runs on the caller
+    WorkerPool empty( 0 );
+    std::thread::id const caller = std::this_thread::get_id();
+    std::atomic< unsigned > elsewhere{ 0 };
+    empty.parallelFor( 100, [&]( size_t ) { elsewhere += std::this_thread::get_id() != caller; } );
+    BOOST_CHECK_EQUAL( elsewhere, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( rethrowsAfterAllCallsFinish ) {
+    WorkerPool pool( 3 );
+    std::atomic< unsigned > calls{ 0 };
+    BOOST_CHECK_THROW( pool.parallelFor( 100,
+                           [&]( size_t _i ) {
+                               ++calls;
+                               if ( _i % 10 == 3 )
+                                   throw std::runtime_error( "failed" );
+                           } ),
+        std::runtime_error );
+    BOOST_CHECK_EQUAL( calls, 100 );
+
+    // the pool stays usable
+    calls = 0;
+    pool.parallelFor( 10, [&]( size_t ) { ++calls; } );
+    BOOST_CHECK_EQUAL( calls, 10 );
+}
+
+BOOST_AUTO_TEST_CASE( sharedByManyCallers ) {
+    WorkerPool pool( 2 );
+    std::atomic< size_t > sum{ 0 };
+    std::vector< std::thread > callers;
+    for ( unsigned t = 0; t < 8; ++t )
+        callers.emplace_back( [&] {
+            for ( unsigned round = 0; round < 50; ++round )
+                pool.parallelFor( 100, [&]( size_t _i ) { sum += _i; } );
+        } );
+    for ( auto& caller : callers )
+        caller.join();
+    BOOST_CHECK_EQUAL( sum, 8 * 50 * 4950 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
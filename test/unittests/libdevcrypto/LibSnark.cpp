@@ -371,6 +371,37 @@ BOOST_AUTO_TEST_CASE( pairingNullInput, *boost::unit_test::precondition( run_not
     BOOST_CHECK( !r.first );
 }
 
+// G2 points are decoded, checked and precomputed once per thread and reused. Results must not
+// depend on whether a point comes from that cache.
+BOOST_AUTO_TEST_CASE( pairingCachedG2, *boost::unit_test::precondition( run_not_express ) ) {
+    bytes const g1 = toBigEndian( u256( 1 ) ) + toBigEndian( u256( 2 ) );
+    bytes const g2 = fromHex(
+        "198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c2"
+        "1800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed"
+        "090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b"
+        "12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa" );
+    bytes notOnCurve = g2;
+    notOnCurve.back() ^= 1;
+    bytes const zero( 128, 0 );
+
+    for ( int round = 0; round < 3; ++round ) {
+        auto r = pairingprod_helper( g1 + g2 + negateG1( g1 ) + g2 );
+        BOOST_REQUIRE( r.first );
+        BOOST_CHECK( r.second == toBigEndian( u256( 1 ) ) );
+
+        r = pairingprod_helper( g1 + g2 + g1 + g2 );
+        BOOST_REQUIRE( r.first );
+        BOOST_CHECK( r.second == toBigEndian( u256( 0 ) ) );
+
+        r = pairingprod_helper( g1 + g2 + g1 + notOnCurve );
+        BOOST_CHECK( !r.first );
+
+        r = pairingprod_helper( g1 + zero + g1 + g2 + negateG1( g1 ) + g2 );
+        BOOST_REQUIRE( r.first );
+        BOOST_CHECK( r.second == toBigEndian( u256( 1 ) ) );
+    }
+}
+
 BOOST_AUTO_TEST_CASE( generateRandomPoints, *boost::unit_test::precondition( run_not_express ) ) {
     bytes trivialPt = toBigEndian( u256( 1 ) ) + toBigEndian( u256( 2 ) );
 
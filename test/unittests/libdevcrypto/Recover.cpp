@@ -0,0 +1,155 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Recover.cpp
+ * Tests and throughput benchmark for batched signature recovery.
+ */
+
+#include <libdevcore/SHA3.h>
+#include <libdevcore/WorkerPool.h>
+#include <libdevcrypto/Common.h>
+#include <libethcore/TransactionBase.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+struct Signed {
+    std::vector< Signature > sigs;
+    h256s hashes;
+    std::vector< Public > publics;
+};
+
+/// @a _count messages signed by different keys; @a _salt makes the set differ from others.
+Signed signMessages( size_t _count, unsigned _salt ) {
+    Signed ret;
+    for ( size_t i = 0; i < _count; ++i ) {
+        KeyPair const key = KeyPair::create();
+        ret.hashes.push_back( sha3( toBigEndian( u256( i * 1000003 + _salt ) ) ) );
+        ret.sigs.push_back( sign( key.secret(), ret.hashes.back() ) );
+        ret.publics.push_back( key.pub() );
+    }
+    return ret;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( RecoverSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( batchMatchesSingleRecovery ) {
+    Signed s = signMessages( 50, 1 );
+    // invalid recovery id and a signature of another hash
+    s.sigs[7][64] = 4;
+    s.publics[7] = Public();
+    s.hashes[9] = sha3( s.hashes[9] );
+
+    std::vector< Public > publics( s.sigs.size() );
+    WorkerPool pool( 3 );
+    recover( s.sigs.data(), s.hashes.data(), publics.data(), s.sigs.size(), &pool );
+    for ( size_t i = 0; i < s.sigs.size(); ++i ) {
+        BOOST_CHECK_EQUAL( publics[i], recover( s.sigs[i], s.hashes[i] ) );
+        if ( i != 9 )
+            BOOST_CHECK_EQUAL( publics[i], s.publics[i] );
+    }
+    BOOST_CHECK( publics[9] != s.publics[9] );
+
+    // default pool and empty batch
+    std::fill( publics.begin(), publics.end(), Public() );
+    recover( s.sigs.data(), s.hashes.data(), publics.data(), s.sigs.size() );
+    BOOST_CHECK_EQUAL( publics[0], s.publics[0] );
+    recover( s.sigs.data(), s.hashes.data(), publics.data(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( cacheTellsSignaturesOfSameHashApart ) {
+    h256 const hash = sha3( bytes{ 1, 2, 3 } );
+    KeyPair const a = KeyPair::create();
+    KeyPair const b = KeyPair::create();
+    Signature const sigA = sign( a.secret(), hash );
+    Signature const sigB = sign( b.secret(), hash );
+    for ( unsigned round = 0; round < 3; ++round ) {
+        BOOST_CHECK_EQUAL( recover( sigA, hash ), a.pub() );
+        BOOST_CHECK_EQUAL( recover( sigB, hash ), b.pub() );
+    }
+
+    // many more signatures than cache entries
+    Signed const s = signMessages( 10000, 2 );
+    for ( size_t i = 0; i < s.sigs.size(); i += 97 )
+        BOOST_REQUIRE_EQUAL( recover( s.sigs[i], s.hashes[i] ), s.publics[i] );
+    for ( size_t i = 0; i < s.sigs.size(); ++i )
+        BOOST_REQUIRE_EQUAL( recover( s.sigs[i], s.hashes[i] ), s.publics[i] );
+    BOOST_CHECK_EQUAL( recover( sigA, hash ), a.pub() );
+}
+
+BOOST_AUTO_TEST_CASE( prefetchSendersKeepsTransactionChecks ) {
+    KeyPair const key = KeyPair::create();
+    TransactionBase t( 0, 1, 21000, Address( 1 ), bytes(), 0, key.secret() );
+    bytes const good = t.rlp();
+    bytes bad = good;
+    bad[bad.size() - 1] ^= 1;
+    bytes const garbage{ 0x01, 0x02 };
+
+    TransactionBase const goodTx( good, CheckTransaction::Cheap, true );
+    TransactionBase const badTx( bad, CheckTransaction::None, true );
+    TransactionBase const garbageTx( garbage, CheckTransaction::Cheap, true );
+    TransactionBase::prefetchSenders( { &goodTx, &badTx, &garbageTx } );
+    BOOST_CHECK_EQUAL( goodTx.sender(), key.address() );
+    BOOST_CHECK( badTx.safeSender() != key.address() );
+    BOOST_CHECK( garbageTx.isInvalid() );
+    BOOST_CHECK_EQUAL( garbageTx.sender(), MaxAddress );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( RecoverPerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_AUTO_TEST_CASE( throughput ) {
+    size_t const count = 4000;
+    unsigned salt = 100;
+    for ( unsigned threads : { 1, 8, 32 } ) {
+        // fresh signatures every round, so that none come from the cache
+        Signed const s = signMessages( count, salt++ );
+        std::vector< Public > publics( count );
+        WorkerPool pool( threads - 1 );
+        auto t1 = std::chrono::high_resolution_clock::now();
+        recover( s.sigs.data(), s.hashes.data(), publics.data(), count, &pool );
+        auto t2 = std::chrono::high_resolution_clock::now();
+        BOOST_CHECK( publics == s.publics );
+        std::cout << threads << " threads: "
+                  << count / std::chrono::duration< double >( t2 - t1 ).count()
+                  << " recoveries/s" << std::endl;
+    }
+
+    Signed const s = signMessages( count, salt );
+    std::vector< Public > publics( count );
+    recover( s.sigs.data(), s.hashes.data(), publics.data(), count );
+    auto t1 = std::chrono::high_resolution_clock::now();
+    recover( s.sigs.data(), s.hashes.data(), publics.data(), count );
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "cached: " << count / std::chrono::duration< double >( t2 - t1 ).count()
+              << " recoveries/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
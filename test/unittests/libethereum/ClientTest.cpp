@@ -437,6 +437,53 @@ static std::string const c_genesisInfoSkaleTest = std::string() +
 )E";
 
 
+namespace {
+
+/// Estimation by bisection over all of (intrinsic gas, limit], as done before speculative
+/// estimation, for differential testing.
+u256 bisectionEstimate( ClientTest& _client, Address const& _from, Address const& _dest,
+    bytes const& _data, int64_t _maxGas ) {
+    Block bk = _client.latestBlock();
+    auto passes = [&]( int64_t _gas ) {
+        Transaction t( 0, 1000000, _gas, _dest, _data, bk.transactionsFrom( _from ) );
+        t.forceSender( _from );
+        t.forceChainId( _client.chainId() );
+        t.checkOutExternalGas( ~u256( 0 ) );
+        EnvInfo const env( bk.info(), _client.blockChain().lastBlockHashes(), 0, _gas );
+        skale::State tempState = bk.mutableState();
+        tempState.addBalance( _from, t.gas() * t.gasPrice() );
+        ExecutionResult const er =
+            tempState.execute( env, *_client.blockChain().sealEngine(), t, Permanence::Reverted )
+                .first;
+        return er.excepted != TransactionException::OutOfGas &&
+               er.excepted != TransactionException::OutOfGasBase &&
+               er.excepted != TransactionException::OutOfGasIntrinsic &&
+               er.codeDeposit != CodeDeposit::Failed &&
+               er.excepted != TransactionException::BadJumpDestination &&
+               er.excepted != TransactionException::RevertInstruction ?
+                   er.gasUsed.convert_to< int64_t >() :
+                   int64_t( -1 );
+    };
+
+    int64_t upperBound = std::min( _maxGas, bk.info().gasLimit().convert_to< int64_t >() );
+    int64_t lowerBound = Transaction::baseGasRequired( false, &_data, EVMSchedule() );
+    int64_t const gasUsed = passes( upperBound );
+    if ( gasUsed < 0 )
+        return upperBound;
+    if ( passes( gasUsed ) >= 0 )
+        return gasUsed;
+    while ( lowerBound + 1 < upperBound ) {
+        int64_t middle = ( lowerBound + upperBound ) / 2;
+        if ( passes( middle ) >= 0 )
+            upperBound = middle;
+        else
+            lowerBound = middle;
+    }
+    return upperBound;
+}
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE( EstimateGas )
 
 BOOST_AUTO_TEST_CASE( constantConsumption ) {
@@ -813,6 +860,66 @@ BOOST_AUTO_TEST_CASE( consumptionWithReverts ) {
     BOOST_CHECK_EQUAL( estimate, u256( 121944 ) );
 }
 
+BOOST_AUTO_TEST_CASE( matchesBisection ) {
+    TestClientFixture fixture( c_genesisInfoSkaleTest );
+    ClientTest* testClient = asClientTest( fixture.ethereum() );
+
+    dev::eth::simulateMining( *( fixture.ethereum() ), 10 );
+
+    // calls of the contracts above: constant, linear, non-linear consumption, refunds, reverts
+    struct Case {
+        Address from;
+        char const* to;
+        char const* data;
+        int64_t maxGas;
+    };
+    Address const rich( "0xca4409573a5129a72edf85d6c51e26760fc9c903" );
+    Address const coinbase = fixture.coinbase.address();
+    std::vector< Case > const cases{
+        { rich, "0xD2001300000000000000000000000000000000D2",
+            "0x815b8ab4000000000000000000000000000000000000000000000000000000000000c350",
+            10000000 },
+        { rich, "0xD2001300000000000000000000000000000000D2", "0x8273f754", 10000000 },
+        { rich, "0xD2001300000000000000000000000000000000D2",
+            "0x815b8ab4000000000000000000000000000000000000000000000000000000000000c350", 50000 },
+        { rich, "0xd40B3c51D0ECED279b1697DbdF45d4D19b872164",
+            "0x6057361d0000000000000000000000000000000000000000000000000000000000000016", 50000 },
+        { coinbase, "0xD2001300000000000000000000000000000000D3",
+            "0xee919d500000000000000000000000000000000000000000000000000000000000000000", 100000 },
+        { coinbase, "0xD40b89C063a23eb85d739f6fA9B14341838eeB2b",
+            "0xd82cf7900000000000000000000000000000000000000000000000000000000000000003", 100000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0xd37165fa00000000000000000000000000000000000000000000000000000000000186a0", 100000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0xd37165fa00000000000000000000000000000000000000000000000000000000000186a0", 50000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0xd37165fa00000000000000000000000000000000000000000000000000000000000186a0", 200000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0xb8bd717f000000000000000000000000000000000000000000000000000000000000c350", 1000000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0x20987767000000000000000000000000000000000000000000000000000000000000c350", 1000000 },
+        { rich, "0xD2001300000000000000000000000000000000D4",
+            "0xfdde8d66000000000000000000000000000000000000000000000000000000000000c350", 1000000 },
+    };
+
+    // bisection and k-ary search with parallel probes
+    for ( unsigned probes : { 1, 3, 8 } ) {
+        ClientBase::setEstimateGasConcurrency( probes, 2 );
+        for ( Case const& c : cases ) {
+            Address const to( c.to );
+            bytes const data = jsToBytes( c.data );
+            unsigned steps = 0;
+            auto const estimate = testClient->estimateGas( c.from, 0, to, data, c.maxGas,
+                1000000, [&steps]( GasEstimationProgress const& ) { ++steps; } );
+            BOOST_CHECK_EQUAL(
+                estimate.first, bisectionEstimate( *testClient, c.from, to, data, c.maxGas ) );
+            BOOST_CHECK_LT( steps, 20 );
+        }
+    }
+    ClientBase::setEstimateGasConcurrency(
+        ClientBase::c_defaultEstimateGasProbes, ClientBase::c_defaultEstimateGasThreads );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( IMABLSPublicKey )
@@ -0,0 +1,193 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file CodeSizeCacheTest.cpp
+ * Tests and contention benchmark for the code cache.
+ */
+
+#include <libethereum/CodeSizeCache.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+h256 hashOf( unsigned _i ) {
+    return sha3( toBigEndian( u256( _i ) ) );
+}
+
+/// Single lock map, as the cache was before sharding; baseline for the benchmark.
+class SingleLockCache {
+public:
+    void store( h256 const& _hash, size_t _size ) {
+        Guard l( x_cache );
+        m_cache[_hash] = _size;
+    }
+    bool get( h256 const& _hash, size_t& o_size ) const {
+        Guard l( x_cache );
+        auto it = m_cache.find( _hash );
+        if ( it == m_cache.end() )
+            return false;
+        o_size = it->second;
+        return true;
+    }
+
+private:
+    mutable Mutex x_cache;
+    std::map< h256, size_t > m_cache;
+};
+
+template < class Cache >
+double lookupsPerSecond( Cache& _cache, unsigned _threads, h256s const& _keys ) {
+    size_t const lookups = 1000000;
+    std::atomic< size_t > found{ 0 };
+    std::vector< std::thread > readers;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for ( unsigned t = 0; t < _threads; ++t )
+        readers.emplace_back( [&, t] {
+            size_t size, n = 0;
+            for ( size_t i = 0; i < lookups; ++i )
+                n += _cache.get( _keys[( i * 7 + t ) % _keys.size()], size );
+            found += n;
+        } );
+    for ( auto& reader : readers )
+        reader.join();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    BOOST_CHECK_EQUAL( found, _threads * lookups );
+    return _threads * lookups / std::chrono::duration< double >( t2 - t1 ).count();
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( CodeSizeCacheSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( storesSizesAndCode ) {
+    CodeSizeCache cache;
+    size_t size = 0;
+    BOOST_CHECK( !cache.get( hashOf( 1 ), size ) );
+    BOOST_CHECK( !cache.code( hashOf( 1 ) ) );
+
+    cache.store( hashOf( 1 ), 10 );
+    BOOST_CHECK( cache.contains( hashOf( 1 ) ) );
+    BOOST_CHECK( cache.get( hashOf( 1 ), size ) );
+    BOOST_CHECK_EQUAL( size, 10 );
+    BOOST_CHECK( !cache.code( hashOf( 1 ) ) );
+
+    // code added to an entry with size only
+    bytes code( 10, 0x60 );
+    cache.storeCode( hashOf( 1 ), code );
+    BOOST_REQUIRE( cache.code( hashOf( 1 ) ) );
+    BOOST_CHECK( *cache.code( hashOf( 1 ) ) == code );
+    BOOST_CHECK_EQUAL( cache.codeMemory(), 10 );
+    BOOST_CHECK_EQUAL( cache.size(), 1 );
+
+    BOOST_CHECK_EQUAL( cache.hits(), 3 );
+    BOOST_CHECK_EQUAL( cache.misses(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( boundedByEntriesAndCodeMemory ) {
+    size_t const maxSize = 20 * CodeSizeCache::c_shards;
+    size_t const maxCodeMemory = 4 * 1000 * CodeSizeCache::c_shards;
+    CodeSizeCache cache( maxSize, maxCodeMemory );
+
+    for ( unsigned i = 0; i < 10 * maxSize; ++i )
+        cache.store( hashOf( i ), i );
+    BOOST_CHECK( cache.size() <= maxSize );
+    BOOST_CHECK( cache.size() > maxSize / 2 );
+
+    for ( unsigned i = 0; i < 1000; ++i )
+        cache.storeCode( hashOf( 100000 + i ), bytes( 1000, 1 ) );
+    BOOST_CHECK( cache.codeMemory() <= maxCodeMemory );
+    BOOST_CHECK( cache.codeMemory() > maxCodeMemory / 2 );
+
+    // code larger than a shard's budget is not kept, its size is
+    cache.storeCode( hashOf( 1 ), bytes( maxCodeMemory, 1 ) );
+    size_t size;
+    BOOST_CHECK( cache.get( hashOf( 1 ), size ) );
+    BOOST_CHECK_EQUAL( size, maxCodeMemory );
+    BOOST_CHECK( !cache.code( hashOf( 1 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( recentlyUsedEntriesSurvive ) {
+    CodeSizeCache cache( 4 * CodeSizeCache::c_shards );
+    cache.store( hashOf( 0 ), 42 );
+    size_t size;
+    for ( unsigned i = 1; i < 10000; ++i ) {
+        cache.store( hashOf( i ), i );
+        BOOST_REQUIRE( cache.get( hashOf( 0 ), size ) );
+    }
+    BOOST_CHECK_EQUAL( size, 42 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentReadersAndWriters ) {
+    CodeSizeCache cache( 100 * CodeSizeCache::c_shards, 100 * 100 * CodeSizeCache::c_shards );
+    h256s keys;
+    for ( unsigned i = 0; i < 3000; ++i )
+        keys.push_back( hashOf( i ) );
+    std::atomic< size_t > mismatches{ 0 };
+    std::vector< std::thread > threads;
+    for ( unsigned t = 0; t < 8; ++t )
+        threads.emplace_back( [&, t] {
+            for ( unsigned i = 0; i < 20000; ++i ) {
+                unsigned const key = ( i * 31 + t ) % keys.size();
+                bytes const expected( key % 200, uint8_t( key ) );
+                if ( i % 8 == 0 )
+                    cache.storeCode( keys[key], expected );
+                else if ( auto code = cache.code( keys[key] ) )
+                    mismatches += *code != expected;
+            }
+        } );
+    for ( auto& thread : threads )
+        thread.join();
+    BOOST_CHECK_EQUAL( mismatches, 0 );
+    BOOST_CHECK( cache.size() <= 100 * CodeSizeCache::c_shards );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( CodeSizeCachePerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_AUTO_TEST_CASE( readerContention ) {
+    h256s keys;
+    CodeSizeCache sharded;
+    SingleLockCache singleLock;
+    for ( unsigned i = 0; i < 10000; ++i ) {
+        keys.push_back( hashOf( i ) );
+        sharded.store( keys.back(), i );
+        singleLock.store( keys.back(), i );
+    }
+
+    for ( unsigned threads : { 1, 2, 4, 8, 16 } ) {
+        double const before = lookupsPerSecond( singleLock, threads, keys );
+        double const after = lookupsPerSecond( sharded, threads, keys );
+        std::cout << threads << " readers: single lock " << before / 1e6 << " M/s, sharded "
+                  << after / 1e6 << " M/s" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,11 +18,14 @@
 */
 
 #include <test/tools/libtesteth/BlockChainHelper.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
 #include <test/tools/libtesteth/TestHelper.h>
 #include <test/tools/libtestutils/TestLastBlockHashes.h>
 
 #include <libethereum/Block.h>
+#include <libethereum/ChainParams.h>
 #include <libethereum/ExtVM.h>
+#include <libevm/LegacyVM.h>
 
 using namespace dev;
 using namespace dev::eth;
@@ -73,7 +76,7 @@ BOOST_AUTO_TEST_CASE( BlockhashOutOfBoundsRetunsZero,
     EnvInfo envInfo( createEnvInfo( block.info() ) );
     Address addr( "0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b" );
     ExtVM extVM( block.mutableState(), envInfo, *blockchain.sealEngine(), addr, addr, addr, 0, 0,
-        {}, {}, {}, 0, 0, false, false );
+        {}, bytesConstRef(), {}, 0, 0, false, false );
 
     BOOST_CHECK_EQUAL( extVM.blockHash( 100 ), h256() );
 }
@@ -88,9 +91,68 @@ BOOST_AUTO_TEST_CASE( BlockhashBeforeConstantinopleReliesOnLastHashes,
     EnvInfo envInfo( block.info(), lastBlockHashes, 0, blockchain.chainID() );
     Address addr( "0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b" );
     ExtVM extVM( block.mutableState(), envInfo, *blockchain.sealEngine(), addr, addr, addr, 0, 0,
-        {}, {}, {}, 0, 0, false, false );
+        {}, bytesConstRef(), {}, 0, 0, false, false );
     h256 hash = extVM.blockHash( 1 );
     BOOST_REQUIRE_EQUAL( hash, lastHashes[0] );
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+namespace {
+
+struct DeepCallAborted {
+    unsigned depth;
+};
+
+class DeepCallFixture : public ExtVMFixture {
+public:
+    DeepCallFixture() { state.setCode( address, bytes{ code }, 0 ); }
+
+    void run( OnOpFunc const& _onOp ) {
+        ExtVM extVm = extVM( address, code );
+        u256 gas = 100000000000;
+        LegacyVM vm;
+        vm.exec( gas, extVm, _onOp );
+    }
+
+    Address address{ KeyPair::create().address() };
+
+    // sstore(0, sload(0) + 1) call(gas, address, 0, 0, 0, 0, 0) stop
+    bytes code = fromHex( "60005460010160005560006000600060006000305af100" );
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ExtVmDeepCallSuite, DeepCallFixture )
+
+BOOST_AUTO_TEST_CASE( recursionStopsAtDepthLimit ) {
+    // depths 0..1024 execute, call from depth 1024 fails without an exception; the part above
+    // the offload point runs on the large stack threads
+    for ( unsigned i = 1; i <= 2; ++i ) {
+        run( OnOpFunc{} );
+        BOOST_CHECK_EQUAL( state.storage( address, 0 ), 1025 * i );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( exceptionsCrossOffloadedStack ) {
+    for ( unsigned const depth : { 1u, 1000u, 1024u } ) {
+        auto onOp = [depth]( uint64_t, uint64_t, Instruction, bigint, bigint, bigint,
+                        VMFace const*, ExtVMFace const* _ext ) {
+            if ( _ext->depth == depth )
+                throw DeepCallAborted{ _ext->depth };
+        };
+        try {
+            run( onOp );
+            BOOST_FAIL( "exception expected" );
+        } catch ( DeepCallAborted const& _e ) {
+            BOOST_CHECK_EQUAL( _e.depth, depth );
+        }
+    }
+
+    // execution still works after aborted deep calls
+    u256 const before = state.storage( address, 0 );
+    run( OnOpFunc{} );
+    BOOST_CHECK_EQUAL( state.storage( address, 0 ), before + 1025 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
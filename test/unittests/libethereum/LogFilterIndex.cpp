@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LogFilterIndex.cpp
+ * Tests for the inverted index of live log filters.
+ */
+
+#include <libethereum/LogFilterIndex.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+LogBloom bloomOf( TransactionReceipts const& _receipts ) {
+    LogBloom ret;
+    for ( auto const& r : _receipts )
+        ret |= r.bloom();
+    return ret;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( LogFilterIndexSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( candidatesAreSupersetOfMatches ) {
+    Address a1( 1 ), a2( 2 ), a3( 3 );
+    h256 t1( 11 ), t2( 12 ), t3( 13 );
+
+    std::vector< LogFilter > filters = { LogFilter().address( a1 ), LogFilter().address( a2 ),
+        LogFilter().address( a1 ).topic( 0, t1 ), LogFilter().topic( 0, t2 ),
+        LogFilter().topic( 1, t3 ), LogFilter() };
+    LogFilterIndex index;
+    for ( auto const& f : filters )
+        index.insert( f.sha3(), f );
+    BOOST_REQUIRE_EQUAL( index.size(), filters.size() );
+
+    std::vector< TransactionReceipt > receipts = {
+        TransactionReceipt( 1, 0, { LogEntry( a1, { t1 }, bytes() ) } ),
+        TransactionReceipt( 1, 0, { LogEntry( a3, { t2, t3 }, bytes() ) } ),
+        TransactionReceipt( 1, 0, { LogEntry( a3, {}, bytes() ) } ),
+        TransactionReceipt( 1, 0, {} ) };
+
+    for ( auto const& r : receipts ) {
+        h256Hash candidates;
+        index.candidates( r, candidates );
+        for ( auto const& f : filters )
+            if ( !f.matches( r ).empty() )
+                BOOST_CHECK( candidates.count( f.sha3() ) );
+    }
+
+    h256Hash candidates;
+    index.candidates( receipts[2], candidates );
+    BOOST_CHECK( !candidates.count( filters[0].sha3() ) );
+    BOOST_CHECK( !candidates.count( filters[3].sha3() ) );
+    BOOST_CHECK( candidates.count( filters[5].sha3() ) );  // range filter sees everything
+
+    candidates.clear();
+    index.candidates( receipts[3], candidates );
+    BOOST_CHECK( candidates.empty() );  // no logs, no candidates
+}
+
+BOOST_AUTO_TEST_CASE( blockBloomPrecheck ) {
+    Address a1( 1 ), a2( 2 );
+    h256 t1( 11 );
+    LogFilterIndex index;
+    BOOST_CHECK( !index.mayMatch( LogBloom().shiftBloom< 3 >( sha3( a1 ) ) ) );
+
+    LogFilter f = LogFilter().address( a1 );
+    index.insert( f.sha3(), f );
+    TransactionReceipts withA1 = { TransactionReceipt(
+        1, 0, { LogEntry( a1, { t1 }, bytes() ) } ) };
+    TransactionReceipts withA2 = { TransactionReceipt(
+        1, 0, { LogEntry( a2, { t1 }, bytes() ) } ) };
+    BOOST_CHECK( index.mayMatch( bloomOf( withA1 ) ) );
+    BOOST_CHECK( !index.mayMatch( bloomOf( withA2 ) ) );
+    BOOST_CHECK( !index.mayMatch( LogBloom() ) );
+
+    index.erase( f.sha3(), f );
+    BOOST_CHECK( index.empty() );
+    BOOST_CHECK( !index.mayMatch( bloomOf( withA1 ) ) );
+
+    LogFilter range;
+    index.insert( range.sha3(), range );
+    BOOST_CHECK( index.mayMatch( bloomOf( withA2 ) ) );
+    BOOST_CHECK( !index.mayMatch( LogBloom() ) );  // still nothing to match in a block without logs
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LogIndex.cpp
+ * Tests for the on-disk log index.
+ */
+
+#include <libdevcore/TransientDirectory.h>
+#include <libethereum/LogIndex.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+BOOST_FIXTURE_TEST_SUITE( LogIndexSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( candidatesAndCoverage ) {
+    TransientDirectory dir;
+    Address a1( 1 ), a2( 2 );
+    h256 t1( 11 ), t2( 12 );
+
+    TransactionReceipts block1 = {
+        TransactionReceipt( 1, 0, { LogEntry( a1, { t1 }, bytes() ) } ),
+        TransactionReceipt( 1, 0, { LogEntry( a2, { t2 }, bytes() ), LogEntry( a1, {}, bytes() ) } ) };
+    TransactionReceipts block2 = { TransactionReceipt( 1, 0, {} ),
+        TransactionReceipt( 1, 0, { LogEntry( a2, { t1, t2 }, bytes() ) } ) };
+
+    {
+        LogIndex index( dir.path() );
+        uint64_t first, last;
+        BOOST_CHECK( !index.range( first, last ) );
+        index.indexBlock( 2, block2 );
+        index.indexBlock( 1, block1 );  // backfill
+        BOOST_REQUIRE( index.range( first, last ) );
+        BOOST_CHECK_EQUAL( first, 1 );
+        BOOST_CHECK_EQUAL( last, 2 );
+        BOOST_CHECK( index.covers( 1, 2 ) );
+        BOOST_CHECK( !index.covers( 0, 2 ) );
+    }
+
+    // reopened index keeps its range and keys
+    LogIndex index( dir.path() );
+    BOOST_CHECK( index.covers( 1, 2 ) );
+
+    auto byA1 = index.candidates( LogFilter().address( a1 ), LogPosition( 0 ), 2, 100 );
+    BOOST_REQUIRE_EQUAL( byA1.size(), 2 );
+    BOOST_CHECK( byA1[0] == LogPosition( 1, 0, 0 ) );
+    BOOST_CHECK( byA1[1] == LogPosition( 1, 1, 2 ) );
+
+    auto byT1 = index.candidates( LogFilter().topic( 0, t1 ), LogPosition( 0 ), 2, 100 );
+    BOOST_REQUIRE_EQUAL( byT1.size(), 2 );
+    BOOST_CHECK( byT1[1] == LogPosition( 2, 1, 0 ) );
+
+    // addresses drive the scan, topics are left for confirmation
+    auto byA2OrA1 = index.candidates(
+        LogFilter().address( a1 ).address( a2 ).topic( 1, t2 ), LogPosition( 0 ), 2, 100 );
+    BOOST_CHECK_EQUAL( byA2OrA1.size(), 4 );
+
+    auto all = index.candidates( LogFilter(), LogPosition( 1, 1, 1 ), 2, 2 );
+    BOOST_REQUIRE_EQUAL( all.size(), 2 );
+    BOOST_CHECK( all[0] == LogPosition( 1, 1, 1 ) );
+    BOOST_CHECK( all[1] == LogPosition( 1, 1, 2 ) );
+
+    BOOST_CHECK( index.candidates( LogFilter(), LogPosition( 0 ), 1, 100 ).size() == 3 );
+
+    // gap restarts coverage, keys of the old range are dropped later
+    BOOST_CHECK( index.indexBlock( 5, block1 ) );
+    BOOST_CHECK( index.covers( 5, 5 ) );
+    BOOST_CHECK( !index.covers( 2, 5 ) );
+    BOOST_CHECK( !index.candidates( LogFilter(), LogPosition( 0 ), 4, 100 ).empty() );
+    BOOST_CHECK( !index.indexBlock( 1, block1 ) );
+    while ( index.removeStale() ) {
+    }
+    BOOST_CHECK( index.candidates( LogFilter(), LogPosition( 0 ), 4, 100 ).empty() );
+    BOOST_CHECK( index.candidates( LogFilter().address( a2 ), LogPosition( 0 ), 4, 100 ).empty() );
+    BOOST_CHECK_EQUAL( index.candidates( LogFilter(), LogPosition( 0 ), 5, 100 ).size(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( reindexAfterReorg ) {
+    TransientDirectory dir;
+    Address a1( 1 ), a2( 2 );
+    h256 t1( 11 ), t2( 12 );
+    TransactionReceipts const old = {
+        TransactionReceipt( 1, 0, { LogEntry( a1, { t1 }, bytes() ) } ) };
+    TransactionReceipts const fresh = {
+        TransactionReceipt( 1, 0, { LogEntry( a2, { t2 }, bytes() ) } ) };
+
+    LogIndex index( dir.path() );
+    for ( uint64_t n = 1; n <= 4; ++n )
+        index.indexBlock( n, old );
+
+    // block 3 is replaced, block 4 is not in the chain any more: both are stale until removed
+    BOOST_CHECK( !index.indexBlock( 3, fresh ) );
+    uint64_t first, last;
+    BOOST_REQUIRE( index.range( first, last ) );
+    BOOST_CHECK_EQUAL( first, 1 );
+    BOOST_CHECK_EQUAL( last, 2 );
+    BOOST_CHECK( !index.indexBlock( 3, fresh ) );
+    BOOST_CHECK( !index.removeStale() );
+    BOOST_CHECK( index.indexBlock( 3, fresh ) );
+    BOOST_REQUIRE( index.range( first, last ) );
+    BOOST_CHECK_EQUAL( last, 3 );
+
+    auto byA1 = index.candidates( LogFilter().address( a1 ), LogPosition( 0 ), 10, 100 );
+    BOOST_REQUIRE_EQUAL( byA1.size(), 2 );
+    BOOST_CHECK( byA1[1] == LogPosition( 2, 0, 0 ) );
+    BOOST_CHECK(
+        index.candidates( LogFilter().topic( 0, t1 ), LogPosition( 3 ), 10, 100 ).empty() );
+    auto byT2 = index.candidates( LogFilter().topic( 0, t2 ), LogPosition( 0 ), 10, 100 );
+    BOOST_REQUIRE_EQUAL( byT2.size(), 1 );
+    BOOST_CHECK( byT2[0] == LogPosition( 3, 0, 0 ) );
+    BOOST_CHECK_EQUAL( index.candidates( LogFilter(), LogPosition( 0 ), 10, 100 ).size(), 3 );
+
+    // the first block again leaves nothing else
+    BOOST_CHECK( !index.indexBlock( 1, fresh ) );
+    BOOST_CHECK( !index.range( first, last ) );
+    BOOST_CHECK( !index.removeStale() );
+    BOOST_CHECK( index.indexBlock( 1, fresh ) );
+    BOOST_CHECK( index.covers( 1, 1 ) );
+    BOOST_CHECK( !index.covers( 1, 2 ) );
+    BOOST_CHECK_EQUAL( index.candidates( LogFilter(), LogPosition( 0 ), 10, 100 ).size(), 1 );
+
+    index.retireBlocks( 1 );
+    BOOST_CHECK( !index.range( first, last ) );
+    BOOST_CHECK( !index.candidates( LogFilter(), LogPosition( 0 ), 10, 100 ).empty() );
+    BOOST_CHECK( !index.removeStale() );
+    BOOST_CHECK( index.candidates( LogFilter(), LogPosition( 0 ), 10, 100 ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( cursorRoundTrip ) {
+    LogPosition pos( 123456789, 7, 42 );
+    BOOST_CHECK( LogPosition::fromCursor( pos.toCursor() ) == pos );
+    BOOST_CHECK( pos < pos.next() );
+    BOOST_CHECK_THROW( LogPosition::fromCursor( "0x1234" ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,210 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PrecompiledCacheTest.cpp
+ * Tests for the per-block memo of pure precompiled results.
+ */
+
+#include <libdevcrypto/Common.h>
+#include <libethcore/PrecompiledCache.h>
+#include <libskale/State.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+using skale::State;
+
+namespace {
+
+class PrecompiledCacheFixture : public ExtVMFixture {
+public:
+    PrecompiledCacheFixture() : ExtVMFixture( false ) {
+        // ecrecover input: hash, v, r, s
+        h256 const hash = sha3( "message" );
+        Signature const signature = sign( signer.secret(), hash );
+        SignatureStruct const sig( signature );
+        input = hash.asBytes() + h256( u256( sig.v + 27 ) ).asBytes() + sig.r.asBytes() +
+                sig.s.asBytes();
+
+        // store the input at 0, staticcall ecrecover twice, return its output
+        for ( unsigned i = 0; i < 4; ++i ) {
+            code.push_back( 0x7f );
+            code += bytesConstRef( &input ).cropped( i * 32, 32 ).toBytes();
+            code += bytes{ 0x60, _byte_( i * 32 ), 0x52 };
+        }
+        bytes const staticCall{
+            0x60, 0x20, 0x60, 0x80, 0x60, 0x80, 0x60, 0x00, 0x60, 0x01, 0x5a, 0xfa, 0x50 };
+        code += staticCall + staticCall;
+        code += bytes{ 0x60, 0x20, 0x60, 0x80, 0xf3 };
+
+        State writer = state.createStateModifyCopy();
+        writer.setStorageLimit( 1 << 30 );
+        writer.createContract( contract );
+        writer.setCode( contract, code, 0 );
+        writer.commit( CommitBehaviour::KeepEmptyAccounts );
+    }
+
+    ~PrecompiledCacheFixture() { PrecompiledCache::setEnabled( true ); }
+
+    ExecutionResult call() {
+        State overlay = state.createReadOnlyOverlay();
+        Transaction t( 0, 0, 1000000, contract, bytes(), overlay.getNonce( sender ) );
+        t.forceSender( sender );
+        t.forceChainId( se->chainParams().chainID );
+        t.checkOutExternalGas( ~u256( 0 ) );
+        return overlay.execute( envInfo, *se, t, skale::Permanence::Reverted ).first;
+    }
+
+    PrecompiledContract const& ecrecover() const {
+        return se->chainParams().precompiled.at( Address( 1 ) );
+    }
+
+    static PrecompiledCache::Stats stats( std::string const& _name ) {
+        return PrecompiledCache::stats()[_name];
+    }
+
+    KeyPair signer = KeyPair::create();
+    Address contract{ KeyPair::create().address() };
+    Address sender{ KeyPair::create().address() };
+    bytes input;
+    bytes code;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( PrecompiledCacheSuite, PrecompiledCacheFixture )
+
+BOOST_AUTO_TEST_CASE( repeatedCallSharesOutput ) {
+    PrecompiledCache& cache = PrecompiledCache::local();
+    BOOST_REQUIRE( ecrecover().memoize() );
+    auto const expected = ecrecover().execute( ref( input ) );
+    BOOST_REQUIRE( expected.first );
+    BOOST_REQUIRE( right160( h256( expected.second ) ) == signer.address() );
+
+    auto const hits = stats( "ecrecover" ).hits;
+    auto const first = cache.execute( ecrecover(), ref( input ), 100 );
+    bytes const copy = input;
+    auto const second = cache.execute( ecrecover(), ref( copy ), 100 );
+    BOOST_REQUIRE( first.first && second.first );
+    BOOST_REQUIRE( first.second.toBytes() == expected.second );
+    BOOST_REQUIRE( second.second.data() == first.second.data() );
+    BOOST_REQUIRE_EQUAL( stats( "ecrecover" ).hits, hits + 1 );
+
+    // a different input is not confused with the cached one
+    bytes other = input;
+    other[0] ^= 1;
+    auto const third = cache.execute( ecrecover(), ref( other ), 100 );
+    BOOST_REQUIRE( third.second.toBytes() == ecrecover().execute( ref( other ) ).second );
+    BOOST_REQUIRE_EQUAL( stats( "ecrecover" ).hits, hits + 1 );
+    BOOST_REQUIRE_EQUAL( cache.size(), 2 );
+
+    // the next block starts empty
+    cache.execute( ecrecover(), ref( input ), 101 );
+    BOOST_REQUIRE_EQUAL( cache.size(), 1 );
+    BOOST_REQUIRE_EQUAL( stats( "ecrecover" ).hits, hits + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( cheapPrecompilesAreNotKept ) {
+    PrecompiledCache& cache = PrecompiledCache::local();
+    PrecompiledContract const& identity = se->chainParams().precompiled.at( Address( 4 ) );
+    BOOST_REQUIRE( identity.pure() && !identity.memoize() );
+
+    auto const calls = stats( "identity" ).calls;
+    cache.execute( ecrecover(), ref( input ), 200 );
+    auto const result = cache.execute( identity, ref( input ), 200 );
+    cache.execute( identity, ref( input ), 200 );
+    BOOST_REQUIRE( result.second.toBytes() == input );
+    BOOST_REQUIRE_EQUAL( cache.size(), 1 );
+    BOOST_REQUIRE_EQUAL( stats( "identity" ).calls, calls + 2 );
+    BOOST_REQUIRE_EQUAL( stats( "identity" ).hits, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( memoryBoundedAcrossThreads ) {
+    // ecrecover reads the first 128 bytes, longer inputs are kept in full
+    auto const bigInput = [&]( size_t _i ) {
+        bytes ret = input + bytes( 1024 * 1024 );
+        ret.back() = _byte_( _i );
+        return ret;
+    };
+    PrecompiledCache& cache = PrecompiledCache::local();
+    size_t const othersMemory = PrecompiledCache::totalMemory() - cache.memory();
+
+    // threads keep their caches until the total is read; Boost checks are made on this thread
+    size_t const nThreads = 8;
+    std::atomic< size_t > filled( 0 ), maxThread( 0 );
+    std::atomic< bool > done( false );
+    std::vector< std::thread > threads;
+    for ( size_t t = 0; t < nThreads; ++t )
+        threads.emplace_back( [&]() {
+            PrecompiledCache& threadCache = PrecompiledCache::local();
+            for ( size_t i = 0; i < 8; ++i ) {
+                bytes const in = bigInput( i );
+                threadCache.execute( ecrecover(), ref( in ), 300 );
+            }
+            size_t seen = maxThread;
+            while ( seen < threadCache.memory() &&
+                    !maxThread.compare_exchange_weak( seen, threadCache.memory() ) ) {
+            }
+            ++filled;
+            while ( !done )
+                std::this_thread::yield();
+        } );
+    while ( filled < nThreads )
+        std::this_thread::yield();
+    size_t const used = PrecompiledCache::totalMemory();
+    done = true;
+    for ( std::thread& thread : threads )
+        thread.join();
+
+    BOOST_REQUIRE_LE( maxThread.load(), PrecompiledCache::c_maxThreadMemory );
+    BOOST_REQUIRE_LE( used, PrecompiledCache::c_maxMemory );
+    BOOST_REQUIRE_GT( used, PrecompiledCache::c_maxMemory - 2 * 1024 * 1024 );
+    // exited threads give their memory back
+    BOOST_REQUIRE_EQUAL( PrecompiledCache::totalMemory(), othersMemory + cache.memory() );
+
+    bytes const in = bigInput( 0 );
+    cache.execute( ecrecover(), ref( in ), 301 );
+    BOOST_REQUIRE_EQUAL( cache.size(), 1 );
+    BOOST_REQUIRE_EQUAL( PrecompiledCache::totalMemory(), othersMemory + cache.memory() );
+}
+
+BOOST_AUTO_TEST_CASE( resultsAndGasUnchanged ) {
+    PrecompiledCache::setEnabled( false );
+    auto const hits = stats( "ecrecover" ).hits;
+    ExecutionResult const uncached = call();
+    BOOST_REQUIRE_EQUAL( stats( "ecrecover" ).hits, hits );
+
+    PrecompiledCache::setEnabled( true );
+    ExecutionResult const cached = call();
+    BOOST_REQUIRE_GE( stats( "ecrecover" ).hits, hits + 1 );
+
+    BOOST_REQUIRE( uncached.excepted == TransactionException::None );
+    BOOST_REQUIRE( right160( h256( uncached.output ) ) == signer.address() );
+    BOOST_REQUIRE( cached.output == uncached.output );
+    BOOST_REQUIRE_EQUAL( cached.gasUsed, uncached.gasUsed );
+    BOOST_REQUIRE( cached.excepted == uncached.excepted );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,277 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PrecompiledConfig.cpp
+ * Tests for the configuration snapshot read by the getConfigVariable* precompiles.
+ */
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libethereum/Precompiled.h>
+#include <libethereum/PrecompiledConfig.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <skutils/utils.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+char const* const c_config = R"({
+    "sealEngine": "Ethash",
+    "params": { "chainID": "0x1" },
+    "skaleConfig": {
+        "nodeInfo": {
+            "nodeName": "Node1",
+            "nodeID": 1112,
+            "basePort": 1231,
+            "basePortHttp": " 7000 ",
+            "httpRpcPort": 1234,
+            "wsRpcPort": "0x4d2",
+            "acceptors": 1,
+            "max-connections": 0,
+            "ws-mode": "simple",
+            "ecdsaKeyName": "secret",
+            "wallets": { "ima": {
+                "commonBLSPublicKey0": "1122334455",
+                "BLSPublicKey0": "0xabcdef",
+                "t": 1 } }
+        },
+        "contractSettings": {
+            "common": { "enableContractLogMessages": true },
+            "IMA": {
+                "ownerAddress": "0x23f0a9ea6d8b5a5c0d4e7b8a6e5c3f2b1a098765",
+                "tokenCount": "18446744073709551617",
+                "ratio": 1.5,
+                "variables": [ "0x10", 20, true, null, { "k": "v" } ],
+                "permissions": {
+                    "0x00000000000000000000000000000000000000aa": 1,
+                    "0x00000000000000000000000000000000000000AA": 0,
+                    "0xbb": false,
+                    "0xcc": 0.5,
+                    "dd": true,
+                    "zz": 1,
+                    "zzz": 1
+                },
+                "dotted.key": 1
+            }
+        },
+        "sChain": {
+            "schainName": "TestChain",
+            "schainID": 5,
+            "emptyBlockIntervalMs": "0x10",
+            "nodes": [
+                { "nodeID": 1112, "ip": "127.0.0.1", "basePort": 1231 },
+                { "nodeID": 1113, "ip": "127.0.0.2", "basePort": 1331 }
+            ]
+        }
+    }
+})";
+
+// What the precompiles computed from the JSON tree before the snapshot.
+nlohmann::json walk( nlohmann::json const& _config, string const& _path ) {
+    return skutils::json_config_file_accessor::stat_extract_at_path( _config, _path );
+}
+
+string walkText( nlohmann::json const& _config, string const& _path ) {
+    nlohmann::json const value = walk( _config, _path );
+    return value.is_string() ? value.get< string >() : value.dump();
+}
+
+// Every path of the tree as the flattening names it.
+void collectPaths( nlohmann::json const& _value, string const& _path, vector< string >& o_paths ) {
+    if ( !_path.empty() )
+        o_paths.push_back( _path );
+    string const prefix = _path.empty() ? _path : _path + ".";
+    if ( _value.is_object() )
+        for ( auto it = _value.cbegin(); it != _value.cend(); ++it )
+            collectPaths( it.value(), prefix + it.key(), o_paths );
+    else if ( _value.is_array() ) {
+        for ( size_t i = 0; i < _value.size(); ++i )
+            collectPaths( _value[i], prefix + to_string( i ), o_paths );
+        for ( char const* size : { "count", "size", "length" } )
+            o_paths.push_back( prefix + size );
+    }
+}
+
+template < class F >
+string resultOf( F _f ) {
+    try {
+        return toString( _f() );
+    } catch ( std::exception const& ex ) {
+        return string( "error: " ) + ex.what();
+    }
+}
+
+bytes stringArgument( string const& _s ) {
+    bytes ret = toBigEndian( u256( _s.size() ) ) + asBytes( _s );
+    ret.resize( 32 + ( _s.size() + 31 ) / 32 * 32 );
+    return ret;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( PrecompiledConfigSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( everyReadablePathMatchesJsonWalk ) {
+    nlohmann::json const config = nlohmann::json::parse( c_config );
+    PrecompiledConfig const snapshot( config );
+
+    vector< string > paths;
+    collectPaths( config, "", paths );
+    size_t readable = 0;
+    for ( string const& path : paths ) {
+        // keys with dots cannot be flattened and are left to the JSON walk
+        if ( !PrecompiledConfig::isReadablePath( path ) || path.find( "dotted" ) != string::npos )
+            continue;
+        ++readable;
+
+        BOOST_CHECK_MESSAGE( snapshot.text( path ) == walkText( config, path ), path );
+
+        string const uint256 = resultOf( [&]() { return snapshot.uint256( path ); } );
+        string const expectedUint256 = resultOf( [&]() {
+            string const s = skutils::tools::trim_copy( walkText( config, path ) );
+            if ( s.size() >= 2 && s[0] == '0' && ( s[1] == 'x' || s[1] == 'X' ) )
+                return u256( s );
+            if ( s.find_first_not_of( "0123456789" ) != string::npos )
+                throw runtime_error( "Bad u256 value \"" + s + "\" cannot be parsed" );
+            return s.empty() ? u256( 0 ) : u256( s );
+        } );
+        BOOST_CHECK_MESSAGE( uint256 == expectedUint256, path + ": " + uint256 );
+
+        string const address = resultOf( [&]() { return snapshot.address( path ); } );
+        string const expectedAddress = resultOf( [&]() {
+            return u256( skutils::tools::trim_copy( walkText( config, path ) ) );
+        } );
+        BOOST_CHECK_MESSAGE( address == expectedAddress, path + ": " + address );
+    }
+    BOOST_CHECK_EQUAL( snapshot.size(), readable );
+}
+
+BOOST_AUTO_TEST_CASE( values ) {
+    PrecompiledConfig const snapshot( nlohmann::json::parse( c_config ) );
+
+    BOOST_CHECK_EQUAL( snapshot.text( "sealEngine" ), "Ethash" );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.nodeInfo.nodeID" ), 1112 );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.nodeInfo.basePortHttp" ), 7000 );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.nodeInfo.wsRpcPort" ), 1234 );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.sChain.emptyBlockIntervalMs" ), 16 );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.contractSettings.IMA.tokenCount" ),
+        u256( "18446744073709551617" ) );
+    BOOST_CHECK_EQUAL( snapshot.address( "skaleConfig.contractSettings.IMA.ownerAddress" ),
+        u256( "0x23f0a9ea6d8b5a5c0d4e7b8a6e5c3f2b1a098765" ) );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.sChain.nodes.count" ), 2 );
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.sChain.nodes.1.basePort" ), 1331 );
+    BOOST_CHECK_EQUAL(
+        snapshot.text( "skaleConfig.contractSettings.IMA.variables.4" ), R"({"k":"v"})" );
+    BOOST_CHECK_EQUAL( snapshot.text( "skaleConfig.contractSettings.IMA.variables.3" ), "null" );
+    BOOST_CHECK_THROW(
+        snapshot.uint256( "skaleConfig.contractSettings.IMA.ratio" ), std::runtime_error );
+    BOOST_CHECK( snapshot.contractLogMessagesEnabled() );
+
+    // non-canonical and missing paths go through the JSON walk
+    BOOST_CHECK_EQUAL( snapshot.uint256( "skaleConfig.sChain.nodes.[1].nodeID" ), 1113 );
+    BOOST_CHECK_EQUAL( snapshot.text( "skaleConfig.sChain.nodes.2" ), "null" );
+    BOOST_CHECK_THROW( snapshot.text( "skaleConfig.sChain.nodes.3" ), std::runtime_error );
+    BOOST_CHECK_THROW( snapshot.text( "skaleConfig.contractSettings.none" ), std::runtime_error );
+    BOOST_CHECK_THROW( snapshot.text( "skaleConfig.contractSettings.IMA.dotted.key" ),
+        std::runtime_error );
+
+    // the allowlist
+    BOOST_CHECK( PrecompiledConfig::isReadablePath( "skaleConfig.nodeInfo.httpRpcPort" ) );
+    BOOST_CHECK( !PrecompiledConfig::isReadablePath( "skaleConfig.nodeInfo.ecdsaKeyName" ) );
+    BOOST_CHECK( !PrecompiledConfig::isReadablePath( "params.chainID" ) );
+    BOOST_CHECK( !PrecompiledConfig::isReadablePath( "skaleConfig.sChain.nodes" ) );
+    BOOST_CHECK( !PrecompiledConfig::isReadablePath( "" ) );
+}
+
+BOOST_AUTO_TEST_CASE( permissionFlags ) {
+    PrecompiledConfig const snapshot( nlohmann::json::parse( c_config ) );
+    string const path = "skaleConfig.contractSettings.IMA.permissions";
+
+    // keys are visited in sorted order and the first one with the address decides
+    BOOST_CHECK( !snapshot.permissionFlag( path, 0xaa ) );
+    BOOST_CHECK( !snapshot.permissionFlag( path, 0xbb ) );
+    BOOST_CHECK( snapshot.permissionFlag( path, 0xcc ) );
+    BOOST_CHECK( snapshot.permissionFlag( path, 0xdd ) );
+    // "zz" is not an address, so addresses not found before it fail
+    BOOST_CHECK_THROW( snapshot.permissionFlag( path, 0xee ), std::runtime_error );
+    // not an object
+    BOOST_CHECK( !snapshot.permissionFlag( "skaleConfig.sChain.schainID", 5 ) );
+
+    BOOST_CHECK_EQUAL( PrecompiledConfig::parseAddress( "AB" ), 0xab );
+    BOOST_CHECK_EQUAL( PrecompiledConfig::parseAddress( "0xab" ), 0xab );
+}
+
+BOOST_AUTO_TEST_CASE( precompilesFollowConfigFile ) {
+    TransientDirectory dir;
+    boost::filesystem::path const configPath = boost::filesystem::path( dir.path() ) / "config.json";
+    writeFile( configPath, asBytes( c_config ) );
+
+    auto const savedAccessor = g_configAccesssor;
+    g_configAccesssor.reset( new skutils::json_config_file_accessor( configPath.string() ) );
+
+    PrecompiledExecutor const& execUint =
+        PrecompiledRegistrar::executor( "getConfigVariableUint256" );
+    PrecompiledExecutor const& execString =
+        PrecompiledRegistrar::executor( "getConfigVariableString" );
+    PrecompiledExecutor const& execFlag =
+        PrecompiledRegistrar::executor( "getConfigPermissionFlag" );
+
+    bytes in = stringArgument( "skaleConfig.nodeInfo.nodeID" );
+    auto res = execUint( ref( in ) );
+    BOOST_REQUIRE( res.first );
+    BOOST_CHECK( res.second == toBigEndian( u256( 1112 ) ) );
+
+    in = stringArgument( "sealEngine" );
+    res = execString( ref( in ) );
+    BOOST_REQUIRE( res.first );
+    BOOST_CHECK( res.second == stringArgument( "Ethash" ) );
+
+    in = toBigEndian( u256( 0xdd ) ) +
+         stringArgument( "skaleConfig.contractSettings.IMA.permissions" );
+    res = execFlag( ref( in ) );
+    BOOST_REQUIRE( res.first );
+    BOOST_CHECK( res.second == toBigEndian( u256( 1 ) ) );
+
+    // the allowlist is checked before anything is read
+    in = stringArgument( "skaleConfig.nodeInfo.ecdsaKeyName" );
+    res = execString( ref( in ) );
+    BOOST_CHECK( !res.first );
+
+    // a changed file is picked up as before
+    string changed = c_config;
+    changed.replace( changed.find( "1112" ), 4, "4321" );
+    writeFile( configPath, asBytes( changed ) );
+    boost::filesystem::last_write_time(
+        configPath, boost::filesystem::last_write_time( configPath ) + 10 );
+    in = stringArgument( "skaleConfig.nodeInfo.nodeID" );
+    res = execUint( ref( in ) );
+    BOOST_REQUIRE( res.first );
+    BOOST_CHECK( res.second == toBigEndian( u256( 4321 ) ) );
+
+    g_configAccesssor = savedAccessor;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -31,6 +31,8 @@
 
 #include <secp256k1_sha256.h>
 
+#include <random>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -361,6 +363,59 @@ BOOST_AUTO_TEST_CASE( modexpCostHighRange,
         res == ( ( 1025 * 1025 / 16 + 480 * 1025 - 199680 ) * 8 ) / 20, "Got: " + toString( res ) );
 }
 
+// Compares the modexp precompile with plain bigint powm on random inputs. Sizes go around the
+// 256..4096 bit Montgomery widths, moduli are odd and even, and inputs are cut short to exercise
+// right-padding.
+BOOST_AUTO_TEST_CASE( modexpDifferentialFuzz,
+    *boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    PrecompiledExecutor exec = PrecompiledRegistrar::executor( "modexp" );
+
+    size_t const widths[] = { 1, 8, 31, 32, 33, 64, 65, 128, 200, 256, 257, 512, 513 };
+    std::mt19937_64 rng( 45 );
+    auto randomBytes = [&rng]( size_t _size ) {
+        bytes ret( _size );
+        for ( auto& b : ret )
+            b = static_cast< _byte_ >( rng() );
+        return ret;
+    };
+
+    for ( size_t i = 0; i < 2000; ++i ) {
+        size_t const modLength = widths[rng() % ( sizeof( widths ) / sizeof( widths[0] ) )];
+        size_t const baseLength = rng() % 2 ? modLength : rng() % ( modLength + 40 );
+        size_t const expLength = rng() % ( i % 10 == 0 ? 64 : 8 );
+
+        bytes base = randomBytes( baseLength );
+        bytes exp = randomBytes( expLength );
+        bytes mod = randomBytes( modLength );
+        if ( rng() % 2 )
+            mod.back() |= 1;
+        if ( rng() % 4 == 0 )
+            // leading zeroes let a wide modulus take a narrower width
+            std::fill( mod.begin(), mod.begin() + mod.size() / 2, 0 );
+        if ( rng() % 4 == 0 && baseLength > 0 )
+            // base above the modulus
+            base[0] = 0xff;
+
+        bytes in = toBigEndian( u256( baseLength ) ) + toBigEndian( u256( expLength ) ) +
+                   toBigEndian( u256( modLength ) ) + base + exp + mod;
+        if ( rng() % 8 == 0 )
+            in.resize( in.size() - rng() % ( modLength + 1 ) );
+
+        bigint const b = fromBigEndian< bigint >( ref( base ) );
+        bigint const e = fromBigEndian< bigint >( ref( exp ) );
+        bigint m = fromBigEndian< bigint >( ref( mod ) );
+        size_t const modAvailable = in.size() - 96 - baseLength - expLength;
+        m >>= 8 * ( modLength - modAvailable );
+        m <<= 8 * ( modLength - modAvailable );
+        bytes expected( modLength );
+        toBigEndian( m != 0 ? boost::multiprecision::powm( b, e, m ) : bigint{ 0 }, expected );
+
+        auto res = exec( ref( in ) );
+        BOOST_REQUIRE( res.first );
+        BOOST_REQUIRE_MESSAGE( res.second == expected, "Mismatch for input " + toHex( in ) );
+    }
+}
+
 /// @defgroup PrecompiledTests Test cases for precompiled contracts.
 ///
 /// These test cases are used for testing and benchmarking precompiled contracts.
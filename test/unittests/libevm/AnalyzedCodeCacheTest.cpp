@@ -0,0 +1,192 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file AnalyzedCodeCacheTest.cpp
+ * Tests and microbenchmark for the shared analyzed code cache.
+ */
+
+#include <libevm/AnalyzedCodeCache.h>
+#include <libevm/EVMC.h>
+#include <libevm/LegacyVM.h>
+#include <libskale-interpreter/interpreter.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+AnalyzedCodePtr analyzedOfSize( size_t _size ) {
+    auto ret = std::make_shared< AnalyzedCode >();
+    ret->code.resize( _size );
+    ret->codeSize = _size;
+    return ret;
+}
+
+class AnalyzedCodeFixture : public ExtVMFixture {
+public:
+    AnalyzedCodeFixture() { AnalyzedCodeCache::instance().clear(); }
+
+    owning_bytes_ref run( VMFace& _vm, bytes const& _code, u256& io_gas ) {
+        ExtVM extVm = extVM( address, _code );
+        return _vm.exec( io_gas, extVm, OnOpFunc{} );
+    }
+
+    Address address{ KeyPair::create().address() };
+
+    // push32 0x11..11 (goes to constant pool)
+    // push1 0x25 jump (becomes JUMPC)
+    // invalid
+    // jumpdest mstore(0, top) return(0, 0x20)
+    bytes code = fromHex( "7f" + std::string( 64, '1' ) + "602556fe5b60005260206000f3" );
+    bytes expected = bytes( 32, 0x11 );
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE( AnalyzedCodeCacheSuite )
+
+BOOST_AUTO_TEST_CASE( hitsMissesAndEviction ) {
+    AnalyzedCodeCache cache( 3 * analyzedOfSize( 1000 )->memoryUsage() );
+    size_t analyzed = 0;
+    auto get = [&]( unsigned _hash, size_t _size ) {
+        return cache.getOrAnalyze( AnalyzedCodeCache::Kind::Legacy, h256( _hash ), _size, [&]() {
+            ++analyzed;
+            return analyzedOfSize( _size );
+        } );
+    };
+
+    AnalyzedCodePtr first = get( 1, 1000 );
+    BOOST_CHECK( get( 1, 1000 ) == first );
+    BOOST_CHECK_EQUAL( analyzed, 1 );
+    BOOST_CHECK_EQUAL( cache.hits(), 1 );
+    BOOST_CHECK_EQUAL( cache.misses(), 1 );
+
+    // interpreters do not share entries
+    cache.getOrAnalyze( AnalyzedCodeCache::Kind::Interpreter, h256( 1 ), 1000,
+        [&]() { return analyzedOfSize( 1000 ); } );
+    BOOST_CHECK_EQUAL( cache.size(), 2 );
+
+    // unknown hash is never cached, hash with wrong size is analyzed again
+    get( 0, 1000 );
+    get( 0, 1000 );
+    BOOST_CHECK( get( 1, 999 ) != first );
+    BOOST_CHECK_EQUAL( analyzed, 4 );
+
+    // least recently used entry goes first
+    get( 2, 1000 );
+    get( 3, 1000 );
+    BOOST_CHECK_EQUAL( cache.evictions(), 1 );
+    BOOST_CHECK_EQUAL( cache.size(), 3 );
+    get( 1, 999 );
+    BOOST_CHECK_EQUAL( analyzed, 6 );
+    BOOST_CHECK( cache.memoryUsage() <= cache.maxMemory() );
+
+    // entries outlive eviction while in use
+    cache.setMaxMemory( 0 );
+    BOOST_CHECK_EQUAL( cache.size(), 0 );
+    BOOST_CHECK_EQUAL( first->code.size(), 1000 );
+}
+
+BOOST_FIXTURE_TEST_CASE( legacyVMExecutesFromCache, AnalyzedCodeFixture ) {
+    AnalyzedCodeCache& cache = AnalyzedCodeCache::instance();
+    for ( int i = 0; i < 3; ++i ) {
+        LegacyVM vm;
+        u256 gas = 100000;
+        BOOST_CHECK( run( vm, code, gas ).toBytes() == expected );
+        BOOST_CHECK_EQUAL( gas, 100000 - 3 - 3 - 8 - 1 - 3 - 6 - 3 - 3 );
+    }
+    BOOST_CHECK_EQUAL( cache.misses(), 1 );
+    BOOST_CHECK_EQUAL( cache.hits(), 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( skaleInterpreterExecutesFromCache, AnalyzedCodeFixture ) {
+    AnalyzedCodeCache& cache = AnalyzedCodeCache::instance();
+    for ( int i = 0; i < 3; ++i ) {
+        EVMC vm{ evmc_create_interpreter() };
+        u256 gas = 100000;
+        BOOST_CHECK( run( vm, code, gas ).toBytes() == expected );
+        BOOST_CHECK_EQUAL( gas, 100000 - 3 - 3 - 8 - 1 - 3 - 6 - 3 - 3 );
+    }
+    BOOST_CHECK_EQUAL( cache.misses(), 1 );
+    BOOST_CHECK_EQUAL( cache.hits(), 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( skaleInterpreterTakesCodeHashFromHost, AnalyzedCodeFixture ) {
+    // a hash that is not the hash of the code shows that the interpreter did not compute it
+    h256 const hash( 42 );
+    ExtVM extVm( state, envInfo, *se, address, address, address, 0, 1, bytesConstRef(),
+        ref( code ), hash, 0, 0, false, false );
+    EVMC vm{ evmc_create_interpreter() };
+    u256 gas = 100000;
+    BOOST_CHECK( vm.exec( gas, extVm, OnOpFunc{} ).toBytes() == expected );
+
+    bool analyzed = false;
+    AnalyzedCodeCache::instance().getOrAnalyze(
+        AnalyzedCodeCache::Kind::Interpreter, hash, code.size(), [&]() {
+            analyzed = true;
+            return analyzedOfSize( code.size() );
+        } );
+    BOOST_CHECK( !analyzed );
+
+    // the hint applies to its code only
+    AnalyzedCodeCache::CodeHashHint hint( ref( code ), hash );
+    BOOST_CHECK_EQUAL( AnalyzedCodeCache::CodeHashHint::codeHash( code.data(), code.size() ), hash );
+    BOOST_CHECK( !AnalyzedCodeCache::CodeHashHint::codeHash( expected.data(), expected.size() ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( AnalyzedCodeCachePerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_FIXTURE_TEST_CASE( repeatedCallsOfLargeContract, AnalyzedCodeFixture ) {
+    // 24k of push32/pop pairs followed by stop: analysis dominates execution of a short call
+    bytes big;
+    while ( big.size() + 34 < 24 * 1024 ) {
+        big.push_back( 0x7f );
+        big.resize( big.size() + 32, 0x22 );
+        big.push_back( 0x50 );
+    }
+    big.push_back( 0x00 );
+
+    size_t const calls = 10000;
+    for ( size_t maxMemory : { size_t( 0 ), AnalyzedCodeCache::c_defaultMaxMemory } ) {
+        AnalyzedCodeCache::instance().clear();
+        AnalyzedCodeCache::instance().setMaxMemory( maxMemory );
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for ( size_t i = 0; i < calls; ++i ) {
+            LegacyVM vm;
+            u256 gas = 10000000;
+            run( vm, big, gas );
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << "Cache " << ( maxMemory ? "on" : "off" ) << ": "
+                  << std::chrono::duration< double >( t2 - t1 ).count() / calls * 1e6
+                  << " us per call, hits " << AnalyzedCodeCache::instance().hits() << ", misses "
+                  << AnalyzedCodeCache::instance().misses() << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
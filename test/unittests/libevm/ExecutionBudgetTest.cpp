@@ -0,0 +1,166 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ExecutionBudgetTest.cpp
+ * Tests for the instruction and time budget of RPC calls.
+ */
+
+#include <libevm/ExecutionBudget.h>
+#include <libevm/VMFactory.h>
+#include <libskale/State.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+using skale::State;
+
+namespace {
+
+class ExecutionBudgetFixture : public ExtVMFixture {
+public:
+    ExecutionBudgetFixture() : ExtVMFixture( false ) {
+        State writer = state.createStateModifyCopy();
+        writer.setStorageLimit( 1 << 30 );
+        writer.createContract( contract );
+        // JUMPDEST PUSH1 0 JUMP
+        writer.setCode( contract, bytes{ 0x5b, 0x60, 0x00, 0x56 }, 0 );
+        writer.createContract( recursive );
+        writer.setCode( recursive, recursiveCode, 0 );
+        writer.commit( CommitBehaviour::KeepEmptyAccounts );
+    }
+
+    ExecutionResult call( u256 const& _gas, Address const& _to, bytes const& _data = bytes() ) {
+        State overlay = state.createReadOnlyOverlay();
+        Transaction t( 0, 0, _gas, _to, _data, overlay.getNonce( sender ) );
+        t.forceSender( sender );
+        t.forceChainId( se->chainParams().chainID );
+        t.checkOutExternalGas( ~u256( 0 ) );
+        return overlay.execute( envInfo, *se, t, skale::Permanence::Reverted ).first;
+    }
+
+    Address contract{ KeyPair::create().address() };
+    Address recursive{ KeyPair::create().address() };
+    Address sender{ KeyPair::create().address() };
+
+    // n = calldataload(0); if n == 0 loop forever, else call(gas, address, 0, 0, 32, 0, 0) with
+    // n - 1 in memory, so the loop runs n frames deep
+    bytes recursiveCode = fromHex(
+        "600035801560"
+        "1d57"
+        "600190036000526000600060206000600030"
+        "5af100"
+        "5b601d56" );
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ExecutionBudgetSuite, ExecutionBudgetFixture )
+
+BOOST_AUTO_TEST_CASE( instructionLimit ) {
+    auto const exceeded = ExecutionBudget::stats()["test_instructions"].exceeded;
+    ExecutionBudget budget( "test_instructions", { 100000, 0 } );
+    {
+        ExecutionBudget::Scope scope( &budget );
+        BOOST_REQUIRE_THROW( call( 100000000, contract ), ExecutionBudgetExceeded );
+    }
+    BOOST_REQUIRE_GT( budget.instructions(), 100000 );
+    BOOST_REQUIRE_LE( budget.instructions(), 100000 + ExecutionBudget::c_chargeInterval + 4 );
+    BOOST_REQUIRE_EQUAL( ExecutionBudget::stats()["test_instructions"].exceeded, exceeded + 1 );
+
+    // a call within the budget is not affected
+    ExecutionBudget enough( "test_instructions", { 100000, 0 } );
+    ExecutionBudget::Scope scope( &enough );
+    ExecutionResult const result = call( 30000, contract );
+    BOOST_REQUIRE( result.excepted == TransactionException::OutOfGas );
+    BOOST_REQUIRE_GT( enough.instructions(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( timeLimit ) {
+    ExecutionBudget budget( "test_time", { 0, 20 } );
+    ExecutionBudget::Scope scope( &budget );
+    auto const start = std::chrono::steady_clock::now();
+    BOOST_REQUIRE_THROW( call( 1000000000, contract ), ExecutionBudgetExceeded );
+    BOOST_REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::seconds( 5 ) );
+}
+
+BOOST_AUTO_TEST_CASE( noBudgetOutsideScope ) {
+    BOOST_REQUIRE( ExecutionBudget::current() == nullptr );
+    {
+        ExecutionBudget budget( "test_scope", { 1, 0 } );
+        ExecutionBudget::Scope scope( &budget );
+        BOOST_REQUIRE( ExecutionBudget::current() == &budget );
+    }
+    BOOST_REQUIRE( ExecutionBudget::current() == nullptr );
+
+    // block execution runs to the gas limit as before
+    ExecutionResult const result = call( 1000000, contract );
+    BOOST_REQUIRE( result.excepted == TransactionException::OutOfGas );
+    BOOST_REQUIRE_EQUAL( result.gasUsed, 1000000 );
+}
+
+BOOST_AUTO_TEST_CASE( offloadedFrames ) {
+    // deeper than frames run on the current thread's stack
+    bytes const depth = h256( 100 ).asBytes();
+    ExecutionBudget budget( "test_offloaded", { 100000, 0 } );
+    ExecutionBudget::Scope scope( &budget );
+    BOOST_REQUIRE_THROW( call( 100000000, recursive, depth ), ExecutionBudgetExceeded );
+}
+
+BOOST_AUTO_TEST_CASE( nestedFrameUnderEVMC ) {
+    // staticcall(gas, contract, 0, 0, 0, 0) stop
+    bytes const callCode =
+        fromHex( "600060006000600073" + toHex( contract.asBytes() ) + "5afa00" );
+    ExecutionBudget budget( "test_evmc", { 1, 0 } );
+    BOOST_REQUIRE_THROW( budget.charge( 2 ), ExecutionBudgetExceeded );
+    ExecutionBudget::Scope scope( &budget );
+
+    State writer = state.createStateModifyCopy();
+    for ( VMKind kind : { VMKind::Interpreter, VMKind::InterpreterFast } ) {
+        // the nested frame throws inside a host callback, the VM reports it when it returns
+        ExtVM extVm( writer, envInfo, *se, sender, sender, sender, 0, 0, bytesConstRef(),
+            ref( callCode ), sha3( callCode ), 0, 0, false, false );
+        u256 gas = 1000000;
+        BOOST_CHECK_THROW(
+            VMFactory::create( kind )->exec( gas, extVm, OnOpFunc{} ), ExecutionBudgetExceeded );
+    }
+    writer.releaseWriteLock();
+}
+
+BOOST_AUTO_TEST_CASE( loopUnderEVMC ) {
+    // JUMPDEST PUSH1 0 JUMP in a single frame, checked by the VM itself
+    bytes const loopCode{ 0x5b, 0x60, 0x00, 0x56 };
+    State writer = state.createStateModifyCopy();
+    for ( VMKind kind : { VMKind::Interpreter, VMKind::InterpreterFast } ) {
+        ExecutionBudget budget( "test_evmc_loop", { 100000, 0 } );
+        ExecutionBudget::Scope scope( &budget );
+        ExtVM extVm( writer, envInfo, *se, contract, sender, sender, 0, 0, bytesConstRef(),
+            ref( loopCode ), sha3( loopCode ), 0, 0, false, false );
+        u256 gas = 100000000;
+        BOOST_CHECK_THROW(
+            VMFactory::create( kind )->exec( gas, extVm, OnOpFunc{} ), ExecutionBudgetExceeded );
+        BOOST_CHECK_GT( budget.instructions(), 100000 );
+        BOOST_CHECK_LE( budget.instructions(), 100000 + ExecutionBudget::c_chargeInterval + 4 );
+    }
+    writer.releaseWriteLock();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
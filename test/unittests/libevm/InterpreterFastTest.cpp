@@ -0,0 +1,209 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file InterpreterFastTest.cpp
+ * Differential tests and opcode benchmark for superinstructions and basic blocks of
+ * interpreter-fast.
+ */
+
+#include <libevm/AnalyzedCodeCache.h>
+#include <libevm/EVMC.h>
+#include <libevm/Instruction.h>
+#include <libskale-interpreter/interpreter.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <typeinfo>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+struct Outcome {
+    bytes output;
+    u256 gas;
+    std::string exception;
+};
+
+class InterpreterFastFixture : public ExtVMFixture {
+public:
+    InterpreterFastFixture() { state.addBalance( address, 1 * ether ); }
+
+    Outcome run( VMFace& _vm, bytes const& _code, u256 const& _gas ) {
+        ExtVM extVm = extVM( address, _code );
+        Outcome ret;
+        ret.gas = _gas;
+        try {
+            ret.output = _vm.exec( ret.gas, extVm, OnOpFunc{} ).toBytes();
+        } catch ( VMException const& _e ) {
+            ret.exception = typeid( _e ).name();
+        }
+        return ret;
+    }
+
+    /// Runs @a _code on both interpreters and checks that they behave the same.
+    Outcome checkSame( bytes const& _code, u256 const& _gas = 1000000 ) {
+        Outcome const expected = run( interpreter, _code, _gas );
+        Outcome const actual = run( interpreterFast, _code, _gas );
+        BOOST_CHECK_EQUAL( actual.exception, expected.exception );
+        BOOST_CHECK_EQUAL( actual.gas, expected.gas );
+        BOOST_CHECK( actual.output == expected.output );
+        return actual;
+    }
+
+    /// @returns code as analyzed for interpreter-fast, after it was run.
+    bytes fastCode( bytes const& _code ) {
+        return AnalyzedCodeCache::instance()
+            .getOrAnalyze( AnalyzedCodeCache::Kind::InterpreterFast, sha3( _code ), _code.size(),
+                [] { return std::make_shared< AnalyzedCode >(); } )
+            ->code;
+    }
+
+    Address address{ KeyPair::create().address() };
+
+    EVMC interpreter{ evmc_create_interpreter() };
+    EVMC interpreterFast{ evmc_create_interpreter_fast() };
+};
+
+/// Counts down from @a _count, on every iteration storing the counter to memory and shuffling
+/// the stack. Contains every superinstruction except PUSH2JUMPI.
+bytes loopCode( uint8_t _count ) {
+    return fromHex( "60" + toHex( bytes{ _count } ) +
+                    "5b"        // 02 loop: JUMPDEST
+                    "8015"      // 03 DUP1 ISZERO
+                    "61002257"  // 05 PUSH2 exit JUMPI
+                    "60019003"  // 09 PUSH1 1 SWAP1 SUB
+                    "80600052"  // 0d DUP1 PUSH1 0 MSTORE
+                    "60056006"  // 11 PUSH1 5 PUSH1 6
+                    "8181"      // 15 DUP2 DUP2
+                    "919050"    // 17 SWAP2 SWAP1 POP
+                    "9050"      // 1a SWAP1 POP
+                    "5050"      // 1c POP POP
+                    "61000256"  // 1e PUSH2 loop JUMP
+                    "5b"        // 22 exit: JUMPDEST
+                    "60206000f3" );
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( InterpreterFastSuite, InterpreterFastFixture )
+
+BOOST_AUTO_TEST_CASE( loopMatchesInterpreter ) {
+    bytes const code = loopCode( 10 );
+    Outcome const outcome = checkSame( code );
+    BOOST_CHECK( outcome.exception.empty() );
+    BOOST_CHECK( outcome.output == bytes( 32, 0 ) );
+
+    bytes const fused = fastCode( code );
+    BOOST_CHECK( Instruction( fused[0x04] ) == Instruction::ISZEROPUSH2JUMPI );
+    BOOST_CHECK( Instruction( fused[0x0e] ) == Instruction::PUSH1MSTORE );
+    BOOST_CHECK( Instruction( fused[0x15] ) == Instruction::DUP2DUP2 );
+    BOOST_CHECK( Instruction( fused[0x17] ) == Instruction::SWAP2SWAP1 );
+    BOOST_CHECK( Instruction( fused[0x1a] ) == Instruction::SWAP1POP );
+    BOOST_CHECK( Instruction( fused[0x1e] ) == Instruction::PUSH2JUMP );
+    // rest of the sequences stays in place
+    BOOST_CHECK( Instruction( fused[0x05] ) == Instruction::PUSH2 );
+    BOOST_CHECK( Instruction( fused[0x08] ) == Instruction::JUMPI );
+}
+
+BOOST_AUTO_TEST_CASE( conditionalJumps ) {
+    // jump taken, then not taken, then mstore(0, 42) return(0, 0x20)
+    bytes const code = fromHex( "600161000757005b600061000757602a60005260206000f3" );
+    Outcome const outcome = checkSame( code );
+    BOOST_CHECK( outcome.exception.empty() );
+    BOOST_CHECK_EQUAL( u256( h256( outcome.output ) ), 42 );
+    BOOST_CHECK( Instruction( fastCode( code )[0x02] ) == Instruction::PUSH2JUMPI );
+}
+
+BOOST_AUTO_TEST_CASE( failuresInsideSequences ) {
+    // JUMPI of PUSH2JUMPI underflows the stack
+    checkSame( fromHex( "610004575b" ) );
+    // POP of SWAP1POP underflows the stack
+    checkSame( fromHex( "6001600190505050" ) );
+    // enough gas for PUSH1 of PUSH1MSTORE, not for MSTORE
+    for ( unsigned gas = 0; gas < 14; ++gas )
+        checkSame( fromHex( "600160005200" ), gas );
+    // enough gas for part of ISZEROPUSH2JUMPI
+    for ( unsigned gas = 0; gas < 20; ++gas )
+        checkSame( fromHex( "60001561000857005b00" ), gas );
+    // jump to a non JUMPDEST is not fused
+    checkSame( fromHex( "61000456005b" ) );
+}
+
+BOOST_AUTO_TEST_CASE( basicBlocks ) {
+    // mstore(0x400, 0) expands memory in the middle of a block charged on entry
+    for ( unsigned gas = 0; gas < 130; ++gas )
+        checkSame( fromHex( "600061040052600150600150600100" ), gas );
+    // undefined in the revision after memory expansion, thrown once enough gas is left for it
+    for ( unsigned gas = 100; gas < 130; ++gas )
+        checkSame( fromHex( "6000610400524700" ), gas );
+    // GAS ends a block, it sees the gas of the instructions before it only
+    Outcome const outcome = checkSame( fromHex( "600160010180505a60005260206000f3" ) );
+    BOOST_CHECK( outcome.exception.empty() );
+    BOOST_CHECK_EQUAL( u256( h256( outcome.output ) ), 1000000 - 3 - 3 - 3 - 3 - 2 - 2 );
+    // stack underflow at the end of a block, with and without gas for the block
+    for ( unsigned gas = 0; gas < 16; ++gas )
+        checkSame( fromHex( "60016001010100" ), gas );
+    // stack overflow in the middle of a block
+    bytes overflow;
+    for ( unsigned i = 0; i < 1025; ++i )
+        overflow += bytes{ 0x60, 0x01 };
+    checkSame( overflow + bytes{ 0x00 } );
+    checkSame( overflow + bytes{ 0x00 }, 3 * 1024 + 2 );
+    // blocks after JUMPDEST, not taken JUMPI and a call
+    for ( unsigned gas = 0; gas < 800; gas += 7 )
+        checkSame( fromHex( "5b600060006000600060006000305af150600061000e575b600150600100" ),
+            gas );
+}
+
+BOOST_AUTO_TEST_CASE( syntheticInstructionsInUserCodeAreInvalid ) {
+    unsigned const first = unsigned( Instruction::PUSH2JUMP );
+    for ( unsigned op = first; op <= unsigned( Instruction::UNDEFINED ); ++op ) {
+        Outcome const outcome = checkSame( bytes{ 0x60, 0x01, 0x60, 0x02, uint8_t( op ) } );
+        BOOST_CHECK( !outcome.exception.empty() );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE(
+    InterpreterFastPerformanceSuite, InterpreterFastFixture, *boost::unit_test::disabled() )
+
+BOOST_AUTO_TEST_CASE( loop ) {
+    bytes const code = loopCode( 255 );
+    int const runs = 5000;
+    for ( auto vm : { &interpreter, &interpreterFast } ) {
+        run( *vm, code, 1000000 );
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for ( int i = 0; i < runs; ++i )
+            run( *vm, code, 1000000 );
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << vm->name() << ": "
+                  << std::chrono::duration_cast< std::chrono::nanoseconds >( t2 - t1 ).count() /
+                         runs
+                  << " ns per run of " << 255 * 24 << " instructions" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
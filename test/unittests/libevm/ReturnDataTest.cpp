@@ -0,0 +1,99 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ReturnDataTest.cpp
+ * Tests for return data and code shared between call frames without copies.
+ */
+
+#include <libevm/EVMC.h>
+#include <libevm/LegacyVM.h>
+#include <libskale-interpreter/interpreter.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+class ReturnDataFixture : public ExtVMFixture {
+public:
+    ReturnDataFixture() {
+        state.addBalance( caller, 1 * ether );
+        state.setCode( callee, bytes( calleeCode ), 0 );
+    }
+
+    /// Runs the caller on @a _vm, the result outlives all frames and VMs.
+    owning_bytes_ref run( VMFace& _vm ) {
+        ExtVM extVm( state, envInfo, *se, caller, caller, caller, 0, 1, bytesConstRef(),
+            SharedBytes( bytes( callerCode ) ), sha3( callerCode ), 0, 0, false, false );
+        u256 gas = 1000000;
+        return _vm.exec( gas, extVm, OnOpFunc{} );
+    }
+
+    Address caller{ KeyPair::create().address() };
+    Address callee{ KeyPair::create().address() };
+
+    // mstore(0, 0xaa) mstore(0x20, 0xbb) return(0, 0x40)
+    bytes calleeCode = fromHex( "60aa60005260bb60205260406000f3" );
+    // call(gas, callee, 0, 0, 0, 0, 0) returndatacopy(0, 0, returndatasize)
+    // return(0, returndatasize)
+    bytes callerCode = fromHex( "60006000600060006000" "73" + callee.hex() +
+                                "5af1503d600060003e3d6000f3" );
+    bytes expected = fromHex(
+        "00000000000000000000000000000000000000000000000000000000000000aa"
+        "00000000000000000000000000000000000000000000000000000000000000bb" );
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ReturnDataSuite, ReturnDataFixture )
+
+BOOST_AUTO_TEST_CASE( legacyVMKeepsReturnData ) {
+    owning_bytes_ref output;
+    {
+        LegacyVM vm;
+        output = run( vm );
+    }
+    BOOST_CHECK( output.toBytes() == expected );
+}
+
+BOOST_AUTO_TEST_CASE( interpreterKeepsReturnData ) {
+    owning_bytes_ref output;
+    {
+        EVMC vm{ evmc_create_interpreter() };
+        output = run( vm );
+    }
+    BOOST_CHECK( output.toBytes() == expected );
+}
+
+BOOST_AUTO_TEST_CASE( codeIsSharedWithState ) {
+    std::shared_ptr< bytes const > const code = state.sharedCode( callee );
+    BOOST_REQUIRE( code );
+    BOOST_CHECK( *code == calleeCode );
+    BOOST_CHECK_EQUAL( state.sharedCode( callee ), code );
+    BOOST_CHECK( !state.sharedCode( caller ) );
+
+    SharedBytes const view( code );
+    BOOST_CHECK_EQUAL( view.data(), code->data() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
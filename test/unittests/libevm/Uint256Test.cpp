@@ -0,0 +1,260 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Uint256Test.cpp
+ * Differential tests of fixed width 256-bit arithmetic against boost::multiprecision.
+ */
+
+#include <libevm/LegacyVM.h>
+#include <libevm/Uint256.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+// reference implementations, as interpreters computed these opcodes before
+namespace reference {
+u256 div( u256 const& _a, u256 const& _b ) {
+    return _b ? u256( _a / _b ) : 0;
+}
+u256 mod( u256 const& _a, u256 const& _b ) {
+    return _b ? u256( _a % _b ) : 0;
+}
+u256 sdiv( u256 const& _a, u256 const& _b ) {
+    return _b ? s2u( s256( s512( u2s( _a ) ) / s512( u2s( _b ) ) ) ) : 0;
+}
+u256 smod( u256 const& _a, u256 const& _b ) {
+    return _b ? s2u( s256( s512( u2s( _a ) ) % s512( u2s( _b ) ) ) ) : 0;
+}
+u256 addmod( u256 const& _a, u256 const& _b, u256 const& _m ) {
+    return _m ? u256( ( u512( _a ) + u512( _b ) ) % _m ) : 0;
+}
+u256 mulmod( u256 const& _a, u256 const& _b, u256 const& _m ) {
+    return _m ? u256( ( u512( _a ) * u512( _b ) ) % _m ) : 0;
+}
+u256 exp( u256 _base, u256 _exponent ) {
+    u256 result = 1;
+    while ( _exponent ) {
+        if ( static_cast< boost::multiprecision::limb_type >( _exponent ) & 1 )
+            result *= _base;
+        _base *= _base;
+        _exponent >>= 1;
+    }
+    return result;
+}
+u256 sar( u256 const& _x, unsigned _shift ) {
+    static u256 const hibit = u256( 1 ) << 255;
+    if ( _shift >= 256 )
+        return ( _x & hibit ) ? ~u256( 0 ) : 0;
+    u256 ret = _x >> _shift;
+    if ( _x & hibit )
+        ret |= ~u256( 0 ) << ( 256 - _shift );
+    return ret;
+}
+u256 signextend( unsigned _byteIndex, u256 _x ) {
+    if ( _byteIndex < 31 ) {
+        unsigned testBit = _byteIndex * 8 + 7;
+        u256 mask = ( ( u256( 1 ) << testBit ) - 1 );
+        if ( boost::multiprecision::bit_test( _x, testBit ) )
+            _x |= ~mask;
+        else
+            _x &= mask;
+    }
+    return _x;
+}
+}  // namespace reference
+
+// mostly values around limb and sign boundaries, where division has its corner cases
+u256 randomValue( std::mt19937_64& _rng ) {
+    switch ( _rng() % 6 ) {
+    case 0:
+        return _rng() % 4;
+    case 1:
+        return u256( _rng() );
+    case 2:
+        return ( u256( 1 ) << ( _rng() % 256 ) ) - ( _rng() % 3 );
+    case 3:
+        return ~( u256( _rng() ) << ( 64 * ( _rng() % 4 ) ) );
+    default: {
+        u256 ret = 0;
+        for ( unsigned limbs = 1 + _rng() % 4; limbs; --limbs )
+            ret = ( ret << 64 ) | u256( _rng() );
+        return ret;
+    }
+    }
+}
+
+Uint256 fast( u256 const& _v ) {
+    return Uint256::fromU256( _v );
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE( Uint256Suite )
+
+BOOST_AUTO_TEST_CASE( conversions ) {
+    std::mt19937_64 rng( 1 );
+    for ( int i = 0; i < 10000; ++i ) {
+        u256 const v = randomValue( rng );
+        BOOST_REQUIRE_EQUAL( Uint256::fromU256( v ).toU256(), v );
+    }
+    Uint256 const one = Uint256::fromU256( 1 );
+    BOOST_CHECK( one.w[0] == 1 && one.isSmall() && !one.isZero() );
+    BOOST_CHECK( Uint256::fromU256( u256( 1 ) << 255 ).isNegative() );
+}
+
+BOOST_AUTO_TEST_CASE( differentialAgainstBoost ) {
+    std::mt19937_64 rng( 2 );
+    for ( int i = 0; i < 200000; ++i ) {
+        u256 const a = randomValue( rng ), b = randomValue( rng ), m = randomValue( rng );
+        unsigned const shift = rng() % 300;
+        unsigned const index = rng() % 40;
+        Uint256 const fa = fast( a ), fb = fast( b );
+
+        BOOST_REQUIRE_EQUAL( uint256::add( fa, fb ).toU256(), u256( a + b ) );
+        BOOST_REQUIRE_EQUAL( uint256::sub( fa, fb ).toU256(), u256( a - b ) );
+        BOOST_REQUIRE_EQUAL( uint256::mul( fa, fb ).toU256(), u256( a * b ) );
+        BOOST_REQUIRE_EQUAL( uint256::div( a, b ), reference::div( a, b ) );
+        BOOST_REQUIRE_EQUAL( uint256::mod( a, b ), reference::mod( a, b ) );
+        BOOST_REQUIRE_EQUAL( uint256::sdiv( a, b ), reference::sdiv( a, b ) );
+        BOOST_REQUIRE_EQUAL( uint256::smod( a, b ), reference::smod( a, b ) );
+        BOOST_REQUIRE_EQUAL( uint256::addmod( a, b, m ), reference::addmod( a, b, m ) );
+        BOOST_REQUIRE_EQUAL( uint256::mulmod( a, b, m ), reference::mulmod( a, b, m ) );
+        BOOST_REQUIRE_EQUAL(
+            uint256::shl( fa, shift ).toU256(), shift < 256 ? u256( a << shift ) : u256( 0 ) );
+        BOOST_REQUIRE_EQUAL(
+            uint256::shr( fa, shift ).toU256(), shift < 256 ? u256( a >> shift ) : u256( 0 ) );
+        BOOST_REQUIRE_EQUAL( uint256::sar( fa, shift ).toU256(), reference::sar( a, shift ) );
+        BOOST_REQUIRE_EQUAL(
+            uint256::signextend( index, fa ).toU256(), reference::signextend( index, a ) );
+        BOOST_REQUIRE_EQUAL( uint256::byteAt( index, fa ).toU256(),
+            index < 32 ? u256( ( a >> ( 8 * ( 31 - index ) ) ) & 0xff ) : u256( 0 ) );
+        if ( i % 16 == 0 )
+            BOOST_REQUIRE_EQUAL( uint256::exp( a, b ), reference::exp( a, b ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( edgeCases ) {
+    u256 const max = ~u256( 0 );
+    u256 const minSigned = u256( 1 ) << 255;
+    BOOST_CHECK_EQUAL( uint256::div( max, 0 ), 0 );
+    BOOST_CHECK_EQUAL( uint256::mod( max, 0 ), 0 );
+    BOOST_CHECK_EQUAL( uint256::addmod( max, max, 0 ), 0 );
+    BOOST_CHECK_EQUAL( uint256::mulmod( max, max, 0 ), 0 );
+    // overflow case of signed division wraps around
+    BOOST_CHECK_EQUAL( uint256::sdiv( minSigned, max ), minSigned );
+    BOOST_CHECK_EQUAL( uint256::smod( minSigned, max ), 0 );
+    BOOST_CHECK_EQUAL( uint256::addmod( max, max, max - 1 ), 2 );
+    BOOST_CHECK_EQUAL( uint256::mulmod( max, max, max - 1 ), 1 );
+    BOOST_CHECK_EQUAL( uint256::exp( 2, 255 ), minSigned );
+    BOOST_CHECK_EQUAL( uint256::exp( 2, 256 ), 0 );
+    BOOST_CHECK_EQUAL( uint256::exp( 0, 0 ), 1 );
+    BOOST_CHECK_EQUAL( uint256::sar( fast( minSigned ), 255 ).toU256(), max );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( Uint256PerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_AUTO_TEST_CASE( opcodes ) {
+    std::mt19937_64 rng( 3 );
+    std::vector< u256 > values( 1024 );
+    for ( u256& v : values ) {
+        for ( int i = 0; i < 4; ++i )
+            v = ( v << 64 ) | u256( rng() );
+    }
+
+    auto measure = [&]( char const* _name, std::function< u256( u256 const&, u256 const&,
+                                               u256 const& ) > const& _op ) {
+        size_t const rounds = 1000;
+        u256 acc = 0;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for ( size_t r = 0; r < rounds; ++r )
+            for ( size_t i = 0; i + 2 < values.size(); ++i )
+                acc ^= _op( values[i], values[i + 1], values[i + 2] );
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << _name << ": "
+                  << std::chrono::duration< double >( t2 - t1 ).count() * 1e9 /
+                         ( rounds * ( values.size() - 2 ) )
+                  << " ns" << std::endl;
+        ( void ) acc;
+    };
+
+    measure( "DIV boost", []( u256 const& a, u256 const& b, u256 const& ) {
+        return reference::div( a, b >> 100 );
+    } );
+    measure( "DIV fast", []( u256 const& a, u256 const& b, u256 const& ) {
+        return uint256::div( a, b >> 100 );
+    } );
+    measure( "SDIV boost",
+        []( u256 const& a, u256 const& b, u256 const& ) { return reference::sdiv( a, b ); } );
+    measure( "SDIV fast",
+        []( u256 const& a, u256 const& b, u256 const& ) { return uint256::sdiv( a, b ); } );
+    measure( "ADDMOD boost", []( u256 const& a, u256 const& b, u256 const& m ) {
+        return reference::addmod( a, b, m );
+    } );
+    measure( "ADDMOD fast", []( u256 const& a, u256 const& b, u256 const& m ) {
+        return uint256::addmod( a, b, m );
+    } );
+    measure( "MULMOD boost", []( u256 const& a, u256 const& b, u256 const& m ) {
+        return reference::mulmod( a, b, m );
+    } );
+    measure( "MULMOD fast", []( u256 const& a, u256 const& b, u256 const& m ) {
+        return uint256::mulmod( a, b, m );
+    } );
+    measure( "EXP boost",
+        []( u256 const& a, u256 const& b, u256 const& ) { return reference::exp( a, b ); } );
+    measure( "EXP fast",
+        []( u256 const& a, u256 const& b, u256 const& ) { return uint256::exp( a, b ); } );
+}
+
+BOOST_FIXTURE_TEST_CASE( mulmodLoop, ExtVMFixture ) {
+    // counter = 10000
+    // do { pop(mulmod(b, a, p)) } while (--counter)
+    std::string const word( 64, 'e' );
+    bytes const code = fromHex( "6127105b7f" + word + "7f" + word + "7f" + word +
+                                "095060019003806003" + "5700" );
+
+    Address const address( 0x1234 );
+
+    size_t const calls = 100;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for ( size_t i = 0; i < calls; ++i ) {
+        ExtVM extVm = extVM( address, code );
+        LegacyVM vm;
+        u256 gas = 10000000;
+        vm.exec( gas, extVm, OnOpFunc{} );
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "10000 MULMOD iterations: "
+              << std::chrono::duration< double >( t2 - t1 ).count() * 1e6 / calls << " us"
+              << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMPoolTest.cpp
+ * Tests and microbenchmark for reuse of pooled VM instances.
+ */
+
+#include <libevm/EVMC.h>
+#include <libevm/LegacyVM.h>
+#include <libevm/VMFactory.h>
+#include <libevm/VMPool.h>
+#include <libskale-interpreter/interpreter.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+class VMPoolFixture : public ExtVMFixture {
+public:
+    VMPoolFixture() {
+        state.addBalance( address, 1 * ether );
+        state.setCode( extAddress, bytes{ returnCode }, 0 );
+    }
+
+    owning_bytes_ref run( VMFace& _vm, bytes const& _code, u256& io_gas ) {
+        ExtVM extVm = extVM( address, _code );
+        return _vm.exec( io_gas, extVm, OnOpFunc{} );
+    }
+
+    Address address{ KeyPair::create().address() };
+    Address extAddress{ KeyPair::create().address() };
+
+    // mstore(0, 0x11..11) return(0, 0x20)
+    bytes returnCode = fromHex( "7f" + std::string( 64, '1' ) + "60005260206000f3" );
+    // mstore(0x20, 1), then push until the stack overflows: leaves stack and memory dirty
+    bytes dirtyCode = fromHex( "60016020525b6001600556" );
+    // staticcall(gas, extAddress, 0, 0, 0, 0x20) pop return(0, 0x20)
+    bytes callCode = fromHex( "602060006000600073" + toHex( extAddress.asBytes() ) +
+                              "5afa5060206000f3" );
+    // mstore(0x200000, 1) stop
+    bytes bigMemoryCode = fromHex( "6001622000005200" );
+    bytes expected = bytes( 32, 0x11 );
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( VMPoolSuite, VMPoolFixture )
+
+BOOST_AUTO_TEST_CASE( instancesAreReusedPerThread ) {
+    VMFace* first;
+    {
+        VMPtr vm = VMFactory::create( VMKind::Legacy );
+        first = vm.get();
+    }
+    size_t const idle = VMPool< LegacyVM >::idle();
+    BOOST_CHECK( idle > 0 );
+    {
+        VMPtr vm = VMFactory::create( VMKind::Legacy );
+        BOOST_CHECK( vm.get() == first );
+        BOOST_CHECK_EQUAL( VMPool< LegacyVM >::idle(), idle - 1 );
+
+        // nested instances come from the same pool
+        VMPtr nested = VMFactory::create( VMKind::Legacy );
+        BOOST_CHECK( nested.get() != first );
+    }
+    BOOST_CHECK_EQUAL( VMPool< LegacyVM >::idle(), std::max< size_t >( idle, 2 ) );
+}
+
+BOOST_AUTO_TEST_CASE( legacyVMResetsStateBetweenExecutions ) {
+    VMPtr vm = VMFactory::create( VMKind::Legacy );
+    for ( int i = 0; i < 3; ++i ) {
+        u256 gas = 100000;
+        BOOST_CHECK( run( *vm, returnCode, gas ).toBytes() == expected );
+        BOOST_CHECK_EQUAL( gas, 100000 - 3 - 3 - 6 - 3 - 3 );
+
+        u256 dirtyGas = 100000;
+        BOOST_CHECK_THROW( run( *vm, dirtyCode, dirtyGas ), VMException );
+
+        // output does not share the buffer with memory of the next execution
+        gas = 100000;
+        owning_bytes_ref out = run( *vm, returnCode, gas );
+        u256 callGas = 1000000;
+        BOOST_CHECK( run( *vm, callCode, callGas ).toBytes() == expected );
+        BOOST_CHECK( out.toBytes() == expected );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( skaleInterpreterResetsStateBetweenExecutions ) {
+    EVMC vm{ evmc_create_interpreter() };
+    for ( int i = 0; i < 3; ++i ) {
+        u256 gas = 100000;
+        BOOST_CHECK( run( vm, returnCode, gas ).toBytes() == expected );
+        BOOST_CHECK_EQUAL( gas, 100000 - 3 - 3 - 6 - 3 - 3 );
+
+        u256 dirtyGas = 100000;
+        BOOST_CHECK_THROW( run( vm, dirtyCode, dirtyGas ), VMException );
+
+        u256 callGas = 1000000;
+        BOOST_CHECK( run( vm, callCode, callGas ).toBytes() == expected );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( largeBuffersAreNotRetained ) {
+    LegacyVM vm;
+    u256 gas = 10000000;
+    run( vm, bigMemoryCode, gas );
+    BOOST_CHECK_EQUAL( vm.memory().size(), 0x200000 + 32 );
+    // gas depends on the logical memory size only
+    uint64_t const words = ( 0x200000 + 32 ) / 32;
+    BOOST_CHECK_EQUAL( gas, 10000000 - 3 - 3 - 3 - ( words * 3 + words * words / 512 ) );
+
+    vm.recycle( VMPool< LegacyVM >::c_maxRetainedMemory );
+    BOOST_CHECK_EQUAL( vm.memory().capacity(), 0 );
+
+    gas = 100000;
+    run( vm, returnCode, gas );
+    size_t const capacity = vm.memory().capacity();
+    vm.recycle( VMPool< LegacyVM >::c_maxRetainedMemory );
+    BOOST_CHECK_EQUAL( vm.memory().capacity(), capacity );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( VMPoolPerformanceSuite, *boost::unit_test::disabled() )
+
+BOOST_FIXTURE_TEST_CASE( shortCallsWithMemory, VMPoolFixture ) {
+    size_t const calls = 100000;
+    for ( bool pooled : { false, true } ) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for ( size_t i = 0; i < calls; ++i ) {
+            VMPtr vm = pooled ? VMFactory::create( VMKind::Legacy ) :
+                                VMPtr( new LegacyVM, []( VMFace* _vm ) { delete _vm; } );
+            u256 gas = 1000000;
+            run( *vm, callCode, gas );
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << "Pool " << ( pooled ? "on" : "off" ) << ": "
+                  << std::chrono::duration< double >( t2 - t1 ).count() / calls * 1e6
+                  << " us per call" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,12 +17,12 @@
     along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <libethereum/LastBlockHashesFace.h>
 #include <libevm/EVMC.h>
 #include <libevm/LegacyVM.h>
 #include <libskale-interpreter/interpreter.h>
 #include <test/tools/jsontests/vm.h>
 #include <test/tools/libtesteth/BlockChainHelper.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
@@ -33,21 +33,6 @@ using skale::State;
 
 
 namespace {
-class LastBlockHashes : public eth::LastBlockHashesFace {
-public:
-    h256s precedingHashes( h256 const& /* _mostRecentHash */ ) const override {
-        return h256s( 256, h256() );
-    }
-    void clear() override {}
-};
-
-BlockHeader initBlockHeader() {
-    BlockHeader blockHeader;
-    blockHeader.setGasLimit( 0x7fffffffffffffff );
-    blockHeader.setTimestamp( 0 );
-    return blockHeader;
-}
-
 class Create2TestFixture : public TestOutputHelperFixture {
 public:
     explicit Create2TestFixture( VMFace* _vm ) : vm{_vm} { state.addBalance( address, 1 * ether ); }
@@ -0,0 +1,211 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file FileHashState.cpp
+ * Tests for the resumable filestorage file hashes.
+ */
+
+#include <libdevcore/TransientDirectory.h>
+#include <libdevcrypto/Hash.h>
+#include <libskale/FileHashState.h>
+#include <libskale/FilePool.h>
+#include <libskale/OverlayFS.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <random>
+
+using namespace dev;
+using namespace dev::test;
+using skale::FileHashState;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+class FileHashStateFixture : public TestOutputHelperFixture {
+public:
+    static constexpr size_t c_fileSize = 3 * FileHashState::c_checkpointInterval + 12345;
+
+    FileHashStateFixture() : overlayFS( false ), rng( 7 ) {
+        fs::path const directory = fs::path( tempDir.path() ) / "filestorage" / "0123abcd";
+        fs::create_directories( directory );
+        filePath = ( directory / "file.bin" ).string();
+        content.resize( c_fileSize );
+        for ( auto& b : content )
+            b = static_cast< _byte_ >( rng() );
+    }
+
+    // the ._hash format computed from the whole file
+    h256 expectedHash() const {
+        std::ifstream file( filePath, std::ios::binary );
+        bytes const data{ std::istreambuf_iterator< char >( file ),
+            std::istreambuf_iterator< char >() };
+        h256 const pathHash = sha256( filePath.substr( filePath.find( "filestorage" ) ) );
+        bytes const hashes = pathHash.asBytes() + sha256( ref( data ) ).asBytes();
+        return sha256( ref( hashes ) );
+    }
+
+    h256 storedHash() const {
+        h256 hash;
+        std::ifstream hashFile( filePath + "._hash" );
+        hashFile >> hash;
+        return hash;
+    }
+
+    void upload( size_t _position, size_t _length ) {
+        overlayFS.writeChunk( filePath, _position, _length, content.data() + _position );
+    }
+
+    void uploadAll( size_t _chunk ) {
+        for ( size_t position = 0; position < c_fileSize; position += _chunk )
+            upload( position, std::min( _chunk, c_fileSize - position ) );
+    }
+
+    TransientDirectory tempDir;
+    skale::OverlayFS overlayFS;
+    std::mt19937_64 rng;
+    std::string filePath;
+    bytes content;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( FileHashStateSuite, FileHashStateFixture )
+
+BOOST_AUTO_TEST_CASE( sequentialUpload ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    uploadAll( 100 * 1024 );
+    // every full interval was hashed while uploading
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE_EQUAL( FileHashState( filePath ).checkpoints(), 3 );
+
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+}
+
+BOOST_AUTO_TEST_CASE( outOfOrderAndRewrittenChunks ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    size_t const chunk = 300 * 1024;
+    std::vector< size_t > positions;
+    for ( size_t position = 0; position < c_fileSize; position += chunk )
+        positions.push_back( position );
+    std::shuffle( positions.begin(), positions.end(), rng );
+    for ( size_t position : positions )
+        upload( position, std::min( chunk, c_fileSize - position ) );
+
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE_EQUAL( FileHashState( filePath ).checkpoints(), 3 );
+
+    // rewriting the middle drops the checkpoints after it
+    content[FileHashState::c_checkpointInterval + 5] ^= 0xff;
+    upload( FileHashState::c_checkpointInterval, 1024 );
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE_EQUAL( FileHashState( filePath ).checkpoints(), 1 );
+
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+}
+
+BOOST_AUTO_TEST_CASE( smallFile ) {
+    overlayFS.createFile( filePath, 100 );
+    upload( 0, 100 );
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+    BOOST_REQUIRE( !fs::exists( FileHashState::sidecarPath( filePath ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( partiallyUploadedFile ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    upload( 0, 2 * FileHashState::c_checkpointInterval );
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+}
+
+BOOST_AUTO_TEST_CASE( fileChangedBehindSidecar ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    uploadAll( 1024 * 1024 );
+    {
+        std::ofstream file( filePath, std::ios::binary | std::ios::app );
+        file.write( "changed", 7 );
+    }
+    overlayFS.calculateFileHash( filePath );
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+}
+
+BOOST_AUTO_TEST_CASE( recreateAndDelete ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    uploadAll( 1024 * 1024 );
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE( fs::exists( FileHashState::sidecarPath( filePath ) ) );
+
+    overlayFS.createFile( filePath, c_fileSize );
+    BOOST_REQUIRE( !fs::exists( FileHashState::sidecarPath( filePath ) ) );
+
+    uploadAll( 1024 * 1024 );
+    overlayFS.deleteFile( filePath );
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE( !fs::exists( FileHashState::sidecarPath( filePath ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( cachedOperationsWaitForCommit ) {
+    skale::OverlayFS cachedFS;
+    cachedFS.createFile( filePath, c_fileSize );
+    cachedFS.writeChunk( filePath, 0, c_fileSize, content.data() );
+    cachedFS.calculateFileHash( filePath );
+    BOOST_REQUIRE( !fs::exists( FileHashState::sidecarPath( filePath ) ) );
+
+    cachedFS.commit();
+    BOOST_REQUIRE_EQUAL( storedHash(), expectedHash() );
+    BOOST_REQUIRE( !fs::exists( FileHashState::sidecarPath( filePath ) ) );
+    skale::FilePool::instance().sync();
+    BOOST_REQUIRE( fs::exists( FileHashState::sidecarPath( filePath ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( verifyAndRepair ) {
+    overlayFS.createFile( filePath, c_fileSize );
+    uploadAll( 1024 * 1024 );
+    overlayFS.calculateFileHash( filePath );
+    skale::FilePool::instance().sync();
+
+    fs::path const directory = fs::path( tempDir.path() ) / "filestorage";
+    FileHashState::Report report = FileHashState::verify( directory, false );
+    BOOST_REQUIRE_EQUAL( report.files, 1 );
+    BOOST_REQUIRE_EQUAL( report.badSidecars, 0 );
+    BOOST_REQUIRE_EQUAL( report.badHashes, 0 );
+
+    // damage the last checkpoint, keeping the header valid
+    {
+        std::fstream sidecar( FileHashState::sidecarPath( filePath ),
+            std::ios::binary | std::ios::in | std::ios::out );
+        sidecar.seekp( -static_cast< long >( sizeof( secp256k1_sha256_t ) ), std::ios::end );
+        sidecar.write( "garbage!", 8 );
+    }
+    report = FileHashState::verify( directory, true );
+    BOOST_REQUIRE_EQUAL( report.badSidecars, 1 );
+
+    report = FileHashState::verify( directory, false );
+    BOOST_REQUIRE_EQUAL( report.badSidecars, 0 );
+    BOOST_REQUIRE_EQUAL( FileHashState( filePath ).checkpoints(), 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
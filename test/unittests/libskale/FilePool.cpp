@@ -0,0 +1,219 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file FilePool.cpp
+ * Tests for the pool of open filestorage files.
+ */
+
+#include <libdevcore/TransientDirectory.h>
+#include <libskale/FileHashState.h>
+#include <libskale/FilePool.h>
+#include <libskale/OverlayFS.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+using namespace dev;
+using namespace dev::test;
+using skale::FilePool;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+class FilePoolFixture : public TestOutputHelperFixture {
+public:
+    FilePoolFixture() {
+        directory = fs::path( tempDir.path() ) / "filestorage" / "0123abcd";
+        fs::create_directories( directory );
+    }
+
+    std::string create( std::string const& _name, size_t _size ) {
+        std::string const path = ( directory / _name ).string();
+        std::ofstream file( path, std::ios::binary );
+        file << std::string( _size, 'a' );
+        return path;
+    }
+
+    std::string contents( std::string const& _path ) const {
+        std::ifstream file( _path, std::ios::binary );
+        return { std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() };
+    }
+
+    TransientDirectory tempDir;
+    fs::path directory;
+};
+
+bytes asChunk( std::string const& _s ) {
+    return bytes( _s.begin(), _s.end() );
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( FilePoolSuite, FilePoolFixture )
+
+BOOST_AUTO_TEST_CASE( readWrite ) {
+    FilePool pool;
+    std::string const path = create( "file", 16 );
+    bytes const chunk = asChunk( "hello" );
+    pool.write( path, 3, chunk.data(), chunk.size() );
+    BOOST_REQUIRE_EQUAL( contents( path ), "aaahelloaaaaaaaa" );
+
+    bytes read( 7 );
+    pool.read( path, 2, read.data(), read.size() );
+    BOOST_REQUIRE( read == asChunk( "ahelloa" ) );
+    BOOST_REQUIRE_EQUAL( pool.fileSize( path ), 16 );
+
+    BOOST_REQUIRE_THROW( pool.read( path, 10, read.data(), read.size() ), std::runtime_error );
+    BOOST_REQUIRE_THROW( pool.fileSize( directory.string() ), std::runtime_error );
+    BOOST_REQUIRE_THROW(
+        pool.write( ( directory / "missing" ).string(), 0, chunk.data(), chunk.size() ),
+        std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( replacedFileIsReopened ) {
+    FilePool pool;
+    std::string const path = create( "file", 8 );
+    bytes read( 4 );
+    pool.read( path, 0, read.data(), read.size() );
+
+    fs::remove( path );
+    {
+        std::ofstream file( path, std::ios::binary );
+        file << "bbbbbbbb";
+    }
+    pool.read( path, 0, read.data(), read.size() );
+    BOOST_REQUIRE( read == asChunk( "bbbb" ) );
+}
+
+BOOST_AUTO_TEST_CASE( evictionKeepsUnsyncedFiles ) {
+    FilePool pool( 3 );
+    bytes const chunk = asChunk( "x" );
+    std::vector< std::string > paths;
+    for ( int i = 0; i < 3; ++i )
+        paths.push_back( create( "file" + std::to_string( i ), 4 ) );
+    for ( std::string const& path : paths )
+        pool.write( path, 0, chunk.data(), chunk.size() );
+    bytes read( 4 );
+    pool.read( create( "other", 4 ), 0, read.data(), read.size() );
+    // written files stay open until they are synced
+    BOOST_REQUIRE_EQUAL( pool.openFiles(), 4 );
+    BOOST_REQUIRE_EQUAL( pool.sync(), 3 );
+    BOOST_REQUIRE_EQUAL( pool.openFiles(), 3 );
+    BOOST_REQUIRE_EQUAL( pool.sync(), 0 );
+
+    pool.forgetDirectory( directory.string() );
+    BOOST_REQUIRE_EQUAL( pool.openFiles(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( dirtyFilesAreBounded ) {
+    FilePool pool( 2 );
+    bytes const chunk = asChunk( "x" );
+    std::vector< std::string > paths;
+    for ( int i = 0; i < 5; ++i ) {
+        paths.push_back( create( "file" + std::to_string( i ), 4 ) );
+        pool.write( paths.back(), 0, chunk.data(), chunk.size() );
+        BOOST_REQUIRE_LE( pool.dirtyFiles(), 2 );
+    }
+    // files written first were synced and closed early
+    BOOST_REQUIRE_EQUAL( pool.openFiles(), 2 );
+    BOOST_REQUIRE_EQUAL( pool.sync(), 2 );
+    for ( std::string const& path : paths )
+        BOOST_REQUIRE_EQUAL( contents( path ), "xaaa" );
+
+    // hash state saved by the early sync matches the content
+    skale::FileHashState hashState( paths[0] );
+    hashState.clear();
+    BOOST_REQUIRE_EQUAL( pool.fileHash( paths[0] ), hashState.fileHash() );
+}
+
+BOOST_AUTO_TEST_CASE( revertedWritesNeverReachThePool ) {
+    std::string const path = create( "file", 8 );
+    bytes const chunk = asChunk( "zz" );
+
+    skale::OverlayFS reverted;
+    reverted.writeChunk( path, 0, chunk.size(), chunk.data() );
+    reverted.reset();
+    reverted.commit();
+    BOOST_REQUIRE_EQUAL( contents( path ), "aaaaaaaa" );
+
+    skale::OverlayFS committed;
+    committed.writeChunk( path, 6, chunk.size(), chunk.data() );
+    BOOST_REQUIRE_EQUAL( contents( path ), "aaaaaaaa" );
+    committed.commit();
+    BOOST_REQUIRE_EQUAL( contents( path ), "aaaaaazz" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE( FilePoolPerformanceSuite, FilePoolFixture,
+    *boost::unit_test::disabled() )
+
+// many small chunks per block, as a file upload does, against opening the file for every chunk;
+// the pool also keeps the hash sidecar up to date
+BOOST_AUTO_TEST_CASE( smallChunkUploads ) {
+    size_t const fileSize = 64 * 1024 * 1024;
+    size_t const chunkSize = 4096;
+    size_t const chunksPerBlock = 256;
+    std::string const path = create( "file", fileSize );
+    bytes const chunk( chunkSize, 'c' );
+
+    auto measure = [&]( std::string const& _name, std::function< void( size_t ) > _write,
+                       std::function< void() > _endBlock ) {
+        auto const start = std::chrono::steady_clock::now();
+        for ( size_t position = 0; position < fileSize; position += chunkSize ) {
+            _write( position );
+            if ( ( position / chunkSize + 1 ) % chunksPerBlock == 0 )
+                _endBlock();
+        }
+        _endBlock();
+        std::chrono::duration< double > const seconds = std::chrono::steady_clock::now() - start;
+        std::cout << _name << ": " << fileSize / chunkSize / seconds.count() << " chunks/s, "
+                  << fileSize / seconds.count() / 1024 / 1024 << " MiB/s" << std::endl;
+    };
+
+    auto writeChunk = [&]( size_t _position ) {
+        std::fstream file( path, std::ios::binary | std::ios::out | std::ios::in );
+        file.seekp( static_cast< long >( _position ) );
+        file.write( reinterpret_cast< char const* >( chunk.data() ), chunk.size() );
+    };
+    measure( "fstream per chunk, no hashing", writeChunk, [] {} );
+
+    measure(
+        "fstream and hash sidecar per chunk",
+        [&]( size_t _position ) {
+            skale::FileHashState hashState( path );
+            writeChunk( _position );
+            hashState.written( _position, chunk.size() );
+            hashState.save();
+        },
+        [] {} );
+
+    FilePool pool;
+    measure(
+        "pooled pwrite, sync per block",
+        [&]( size_t _position ) { pool.write( path, _position, chunk.data(), chunk.size() ); },
+        [&] { pool.sync(); } );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,192 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ReadOnlyOverlay.cpp
+ * Tests for read-only State overlays and the read cache they share.
+ */
+
+#include <libskale/State.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+using skale::State;
+
+namespace {
+
+class ReadOnlyOverlayFixture : public ExtVMFixture {
+public:
+    static constexpr unsigned c_slots = 64;
+
+    ReadOnlyOverlayFixture() : ExtVMFixture( false ) {
+        // sum of sload(0) ... sload(c_slots - 1) returned as a word
+        code = { 0x60, 0x00 };
+        for ( unsigned i = 0; i < c_slots; ++i )
+            code += bytes{ 0x60, _byte_( i ), 0x54, 0x01 };
+        code += fromHex( "60005260206000f3" );
+
+        State writer = state.createStateModifyCopy();
+        writer.setStorageLimit( 1 << 30 );
+        writer.createContract( contract );
+        writer.setCode( contract, code, 0 );
+        for ( unsigned i = 0; i < c_slots; ++i )
+            writer.setStorage( contract, i, i + 1 );
+        writer.addBalance( holder, 100 );
+        writer.commit( CommitBehaviour::KeepEmptyAccounts );
+    }
+
+    /// Calls the contract from @a _state, @returns the returned sum.
+    u256 call( State& _state ) {
+        Transaction t( 0, 0, 1000000, contract, bytes(), _state.getNonce( sender ) );
+        t.forceSender( sender );
+        t.forceChainId( se->chainParams().chainID );
+        t.checkOutExternalGas( ~u256( 0 ) );
+        ExecutionResult const result =
+            _state.execute( envInfo, *se, t, skale::Permanence::Reverted ).first;
+        return result.output.size() == 32 ? u256( h256( result.output ) ) : 0;
+    }
+
+    Address contract{ KeyPair::create().address() };
+    Address holder{ KeyPair::create().address() };
+    Address sender{ KeyPair::create().address() };
+    bytes code;
+    u256 const sum = c_slots * ( c_slots + 1 ) / 2;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ReadOnlyOverlaySuite, ReadOnlyOverlayFixture )
+
+BOOST_AUTO_TEST_CASE( writesStayInOverlay ) {
+    State overlay = state.createReadOnlyOverlay();
+    BOOST_CHECK_EQUAL( overlay.balance( holder ), 100 );
+    BOOST_CHECK_EQUAL( overlay.storage( contract, 1 ), 2 );
+    BOOST_CHECK( overlay.code( contract ) == code );
+    overlay.addBalance( holder, 5 );
+    overlay.addBalance( sender, 7 );
+    BOOST_CHECK_EQUAL( overlay.balance( holder ), 105 );
+
+    State other = state.createReadOnlyOverlay();
+    BOOST_CHECK_EQUAL( other.balance( holder ), 100 );
+    BOOST_CHECK( !other.addressInUse( sender ) );
+    BOOST_CHECK_EQUAL( call( other ), sum );
+    BOOST_CHECK_EQUAL( overlay.balance( holder ), 105 );
+}
+
+BOOST_AUTO_TEST_CASE( overlaysShareReadCache ) {
+    State first = state.createReadOnlyOverlay();
+    State second = state.createReadOnlyOverlay();
+    BOOST_REQUIRE( first.readCache() );
+    BOOST_CHECK_EQUAL( first.readCache(), second.readCache() );
+    BOOST_CHECK( !state.createStateReadOnlyCopy().readCache() );
+
+    BOOST_CHECK_EQUAL( call( first ), sum );
+    size_t const hits = first.readCache()->hits();
+    BOOST_CHECK_EQUAL( call( second ), sum );
+    // the contract account and all its slots came from the cache
+    BOOST_CHECK_GE( second.readCache()->hits(), hits + c_slots + 1 );
+
+    // copies of an overlay keep sharing
+    State copy = second;
+    BOOST_CHECK_EQUAL( copy.readCache(), first.readCache() );
+    BOOST_CHECK_EQUAL( call( copy ), sum );
+}
+
+BOOST_AUTO_TEST_CASE( commitStartsNewCache ) {
+    std::shared_ptr< skale::StateReadCache const > before;
+    {
+        State overlay = state.createReadOnlyOverlay();
+        BOOST_CHECK_EQUAL( overlay.storage( contract, 0 ), 1 );
+        before = overlay.readCache();
+    }
+
+    State writer = state.createStateModifyCopy();
+    writer.setStorageLimit( 1 << 30 );
+    writer.setStorage( contract, 0, 1001 );
+    writer.commit( CommitBehaviour::KeepEmptyAccounts );
+    writer.releaseWriteLock();
+
+    State overlay = state.createReadOnlyOverlay();
+    BOOST_CHECK_NE( overlay.readCache(), before );
+    BOOST_CHECK_GT( overlay.readCache()->version(), before->version() );
+    BOOST_CHECK_EQUAL( overlay.storage( contract, 0 ), 1001 );
+    BOOST_CHECK_EQUAL( call( overlay ), sum + 1000 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentOverlays ) {
+    std::atomic< unsigned > failures{ 0 };
+    std::vector< std::thread > threads;
+    for ( unsigned i = 0; i < 8; ++i )
+        threads.emplace_back( [&] {
+            for ( unsigned j = 0; j < 20; ++j ) {
+                State overlay = state.createReadOnlyOverlay();
+                if ( call( overlay ) != sum )
+                    ++failures;
+            }
+        } );
+    for ( auto& thread : threads )
+        thread.join();
+    BOOST_CHECK_EQUAL( failures.load(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE( ReadOnlyOverlayPerformanceSuite, ReadOnlyOverlayFixture )
+
+BOOST_AUTO_TEST_CASE( callsPerSecond, *boost::unit_test::disabled() ) {
+    auto const measure = [&]( unsigned _threads, bool _overlay ) {
+        std::atomic< size_t > calls{ 0 };
+        std::atomic< bool > stop{ false };
+        std::vector< std::thread > threads;
+        auto const start = std::chrono::high_resolution_clock::now();
+        for ( unsigned i = 0; i < _threads; ++i )
+            threads.emplace_back( [&] {
+                while ( !stop ) {
+                    State s = _overlay ? state.createReadOnlyOverlay() :
+                                         state.createStateReadOnlyCopy();
+                    call( s );
+                    ++calls;
+                }
+            } );
+        std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+        stop = true;
+        for ( auto& thread : threads )
+            thread.join();
+        std::chrono::duration< double > const elapsed =
+            std::chrono::high_resolution_clock::now() - start;
+        return calls / elapsed.count();
+    };
+
+    for ( unsigned threads : { 1, 2, 4, 8, 16, 32 } ) {
+        double const copies = measure( threads, false );
+        double const overlays = measure( threads, true );
+        std::cout << threads << " threads: " << copies << " calls/s with copies, " << overlays
+                  << " calls/s with overlays" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,234 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SkaleWsSubscriptionHub.cpp
+ * Tests for fan-out of subscription notifications and the per-peer limit of undelivered ones.
+ */
+
+#include <libdevcore/CommonJS.h>
+#include <libskale/httpserveroverride.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace dev::test;
+
+namespace {
+
+// keeps what the hub does with it, runs posted notifications only when asked to
+class FakeSubscriber : public SkaleWsSubscriber {
+public:
+    size_t nRefs_ = 0;
+    bool bConnected_ = true;
+    bool bSendOK_ = true;
+    std::vector< std::function< void() > > vecPosted_;
+    std::vector< std::string > vecSent_;
+    std::vector< std::string > vecEvictedFrom_;
+
+    size_t ref_retain() override { return ++nRefs_; }
+    size_t ref_release() override { return --nRefs_; }
+    bool hubIsConnected() const override { return bConnected_; }
+    void hubPost( std::function< void() > fn ) override { vecPosted_.push_back( fn ); }
+    bool hubSend( const std::string&, const std::string& strNotification ) override {
+        vecSent_.push_back( strNotification );
+        return bSendOK_;
+    }
+    void hubEvicted( const std::string& strSubscriptionKind ) override {
+        vecEvictedFrom_.push_back( strSubscriptionKind );
+    }
+    void drain() {
+        std::vector< std::function< void() > > vec;
+        vec.swap( vecPosted_ );
+        for ( auto& fn : vec )
+            fn();
+    }
+};
+
+// hub without client watches, subscribers are added to its maps directly
+class TestHub : public SkaleWsSubscriptionHub {
+public:
+    SkaleServerOverride& getSSO() override {
+        throw std::logic_error( "no server in subscription hub tests" );
+    }
+    subscription_id_t subscribeNewHeads( FakeSubscriber& peer ) {
+        hub_lock_type lock( mtxHub_ );
+        subscription_id_t idSubscription = nextHubSubscriptionID();
+        mapNewHeads_[idSubscription] = &peer;
+        return idSubscription;
+    }
+    subscription_id_t subscribeLogs( FakeSubscriber& peer, const dev::h256& hFilter ) {
+        hub_lock_type lock( mtxHub_ );
+        subscription_id_t idSubscription = nextHubSubscriptionID();
+        mapLogFilterGroups_[hFilter].subscribers_[idSubscription] = &peer;
+        mapLogSubscriptionFilters_[idSubscription] = hFilter;
+        return idSubscription;
+    }
+    void notifyNewHeads( const std::string& strResult ) {
+        std::vector< std::pair< subscription_id_t, peer_ptr_t > > vec;
+        {  // block
+            hub_lock_type lock( mtxHub_ );
+            vec = hubSnapshot( mapNewHeads_ );
+        }  // block
+        hubFanOut( "eth_subscription/newHeads", 0, vec,
+            std::make_shared< const std::string >( strResult ) );
+    }
+    void notifyLogs( const dev::h256& hFilter, const std::string& strResult ) {
+        std::vector< std::pair< subscription_id_t, peer_ptr_t > > vec;
+        {  // block
+            hub_lock_type lock( mtxHub_ );
+            vec = hubSnapshot( mapLogFilterGroups_[hFilter].subscribers_ );
+        }  // block
+        hubFanOut( "eth_subscription/logs", 0, vec,
+            std::make_shared< const std::string >( strResult ) );
+    }
+    size_t stat( const char* strName ) const { return hubStats()[strName].get< size_t >(); }
+};
+
+std::string notification( unsigned idSubscription, const std::string& strResult ) {
+    return "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{\"result\":" +
+           strResult + ",\"subscription\":\"" + dev::toJS( idSubscription ) + "\"}}";
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SkaleWsSubscriptionHubSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( perPeerLimit ) {
+    std::atomic_size_t nPendingA( 0 ), nPendingB( 0 );
+    for ( size_t i = 0; i < 3; ++i )
+        BOOST_REQUIRE( SkaleWsSubscriptionHub::hubReservePending( nPendingA, 3 ) );
+    BOOST_REQUIRE_EQUAL( size_t( nPendingA ), 3 );
+
+    // the peer is full, the notification is dropped and the peer is evicted
+    BOOST_REQUIRE( !SkaleWsSubscriptionHub::hubReservePending( nPendingA, 3 ) );
+    BOOST_REQUIRE( !SkaleWsSubscriptionHub::hubReservePending( nPendingA, 3 ) );
+    BOOST_REQUIRE_EQUAL( size_t( nPendingA ), 3 );
+
+    // another peer has its own queue
+    BOOST_REQUIRE( SkaleWsSubscriptionHub::hubReservePending( nPendingB, 3 ) );
+    BOOST_REQUIRE_EQUAL( size_t( nPendingB ), 1 );
+
+    // a sent notification frees its slot
+    --nPendingA;
+    BOOST_REQUIRE( SkaleWsSubscriptionHub::hubReservePending( nPendingA, 3 ) );
+    BOOST_REQUIRE( !SkaleWsSubscriptionHub::hubReservePending( nPendingA, 3 ) );
+}
+
+BOOST_AUTO_TEST_CASE( zeroIsUnlimited ) {
+    std::atomic_size_t nPending( 0 );
+    for ( size_t i = 0; i < 100000; ++i )
+        BOOST_REQUIRE( SkaleWsSubscriptionHub::hubReservePending( nPending, 0 ) );
+    BOOST_REQUIRE_EQUAL( size_t( nPending ), 100000 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentFanOuts ) {
+    // block, transaction and log notifications are fanned out from different threads
+    std::atomic_size_t nPending( 0 ), nReserved( 0 ), nDropped( 0 );
+    std::vector< std::thread > threads;
+    for ( size_t i = 0; i < 4; ++i )
+        threads.emplace_back( [&]() {
+            for ( size_t j = 0; j < 1000; ++j )
+                if ( SkaleWsSubscriptionHub::hubReservePending( nPending, 100 ) )
+                    ++nReserved;
+                else
+                    ++nDropped;
+        } );
+    for ( std::thread& thread : threads )
+        thread.join();
+    BOOST_REQUIRE_EQUAL( size_t( nPending ), 100 );
+    BOOST_REQUIRE_EQUAL( size_t( nReserved ), 100 );
+    BOOST_REQUIRE_EQUAL( size_t( nDropped ), 3900 );
+}
+
+BOOST_AUTO_TEST_CASE( fanOutToAllPeers ) {
+    FakeSubscriber a, b, closed;  // outlive references of the hub
+    TestHub hub;
+    closed.bConnected_ = false;
+    unsigned idA = hub.subscribeNewHeads( a ), idB = hub.subscribeNewHeads( b );
+    hub.subscribeNewHeads( closed );
+
+    hub.notifyNewHeads( "{\"number\":\"0x1\"}" );
+    a.drain();
+    b.drain();
+    closed.drain();
+    BOOST_REQUIRE_EQUAL( a.vecSent_.size(), 1 );
+    BOOST_REQUIRE_EQUAL( b.vecSent_.size(), 1 );
+    BOOST_REQUIRE( closed.vecSent_.empty() );
+    // one envelope, only the subscription ids differ
+    BOOST_REQUIRE_EQUAL( a.vecSent_[0], notification( idA, "{\"number\":\"0x1\"}" ) );
+    BOOST_REQUIRE_EQUAL( b.vecSent_[0], notification( idB, "{\"number\":\"0x1\"}" ) );
+    BOOST_REQUIRE_EQUAL( size_t( a.nPendingNotifications_ ), 0 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "deliveredNotifications" ), 2 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "newHeads" ), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( slowPeerIsEvicted ) {
+    FakeSubscriber fast, slow;
+    TestHub hub;
+    hub.setMaxPendingNotificationsPerPeer( 2 );
+    dev::h256 const hFilter( 1 );
+    hub.subscribeNewHeads( fast );
+    hub.subscribeNewHeads( slow );
+    hub.subscribeLogs( slow, hFilter );
+    hub.subscribeLogs( fast, hFilter );
+
+    for ( size_t i = 0; i < 3; ++i ) {
+        hub.notifyNewHeads( "{}" );
+        fast.drain();
+    }
+    BOOST_REQUIRE_EQUAL( fast.vecSent_.size(), 3 );
+    BOOST_REQUIRE( fast.vecEvictedFrom_.empty() );
+
+    // the third notification did not fit, all subscriptions of the peer are gone
+    BOOST_REQUIRE_EQUAL( slow.vecEvictedFrom_.size(), 1 );
+    BOOST_REQUIRE_EQUAL( slow.vecEvictedFrom_[0], "eth_subscription/newHeads" );
+    BOOST_REQUIRE_EQUAL( slow.vecPosted_.size(), 2 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "evictedPeers" ), 1 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "newHeads" ), 1 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "logs" ), 1 );
+
+    // only queued notifications keep the evicted peer, and no new ones come
+    hub.notifyLogs( hFilter, "[]" );
+    fast.drain();
+    BOOST_REQUIRE_EQUAL( fast.vecSent_.size(), 4 );
+    BOOST_REQUIRE_EQUAL( slow.vecPosted_.size(), 2 );
+    BOOST_REQUIRE_EQUAL( slow.nRefs_, 2 );
+    slow.drain();
+    BOOST_REQUIRE_EQUAL( slow.nRefs_, 0 );
+    BOOST_REQUIRE_EQUAL( size_t( slow.nPendingNotifications_ ), 0 );
+    BOOST_REQUIRE_EQUAL( slow.vecEvictedFrom_.size(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( failedSendUnsubscribes ) {
+    FakeSubscriber broken;
+    TestHub hub;
+    broken.bSendOK_ = false;
+    hub.subscribeNewHeads( broken );
+    hub.notifyNewHeads( "{}" );
+    BOOST_REQUIRE_EQUAL( hub.stat( "newHeads" ), 1 );
+    broken.drain();
+    BOOST_REQUIRE_EQUAL( broken.vecSent_.size(), 1 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "newHeads" ), 0 );
+    BOOST_REQUIRE_EQUAL( hub.stat( "deliveredNotifications" ), 0 );
+    BOOST_REQUIRE_EQUAL( broken.nRefs_, 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file StateReadSet.cpp
+ * Tests for recording what a call reads and checking it against later commits.
+ */
+
+#include <libskale/State.h>
+#include <libskale/StateReadSet.h>
+#include <test/tools/libtesteth/ExtVMFixture.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+using skale::State;
+using skale::StateReadSet;
+using skale::StateWriteLog;
+using skale::StateWriteSet;
+
+namespace {
+
+class StateReadSetFixture : public ExtVMFixture {
+public:
+    StateReadSetFixture() : ExtVMFixture( false ) {
+        commit( [&]( State& _s ) {
+            // sload(0) + sload(1) returned as a word
+            _s.createContract( contract );
+            _s.setCode( contract, fromHex( "6001546000540160005260206000f3" ), 0 );
+            _s.setStorage( contract, 0, 1 );
+            _s.setStorage( contract, 1, 2 );
+            _s.setStorage( contract, 2, 3 );
+            // block number returned as a word
+            _s.createContract( numberContract );
+            _s.setCode( numberContract, fromHex( "4360005260206000f3" ), 0 );
+            _s.addBalance( holder, 100 );
+        } );
+    }
+
+    template < class F >
+    void commit( F _change ) {
+        State writer = state.createStateModifyCopy();
+        writer.setStorageLimit( 1 << 30 );
+        _change( writer );
+        writer.commit( CommitBehaviour::KeepEmptyAccounts );
+        writer.releaseWriteLock();
+    }
+
+    /// Calls @a _to at the latest version, @returns what the call read.
+    std::shared_ptr< StateReadSet > call( Address const& _to ) {
+        auto reads = std::make_shared< StateReadSet >();
+        State overlay = state.createReadOnlyOverlay();
+        overlay.recordReads( reads );
+        Transaction t( 0, 0, 1000000, _to, bytes(), overlay.getNonce( sender ) );
+        t.forceSender( sender );
+        t.forceChainId( se->chainParams().chainID );
+        t.checkOutExternalGas( ~u256( 0 ) );
+        overlay.execute( envInfo, *se, t, skale::Permanence::Reverted );
+        return reads;
+    }
+
+    Address contract{ KeyPair::create().address() };
+    Address numberContract{ KeyPair::create().address() };
+    Address holder{ KeyPair::create().address() };
+    Address sender{ KeyPair::create().address() };
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( StateReadSetSuite, StateReadSetFixture )
+
+BOOST_AUTO_TEST_CASE( unrelatedCommitsKeepReads ) {
+    auto reads = call( contract );
+    BOOST_CHECK( reads->exact() );
+    BOOST_CHECK( reads->current() );
+
+    commit( [&]( State& _s ) {
+        _s.setStorage( contract, 2, 30 );
+        _s.addBalance( holder, 1 );
+    } );
+    BOOST_CHECK( reads->current() );
+    commit( [&]( State& _s ) { _s.setStorage( numberContract, 0, 1 ); } );
+    BOOST_CHECK( reads->current() );
+}
+
+BOOST_AUTO_TEST_CASE( storageWriteInvalidates ) {
+    auto reads = call( contract );
+    commit( [&]( State& _s ) { _s.addBalance( holder, 1 ); } );
+    BOOST_CHECK( reads->current() );
+    commit( [&]( State& _s ) { _s.setStorage( contract, 1, 20 ); } );
+    BOOST_CHECK( !reads->current() );
+    BOOST_CHECK( call( contract )->current() );
+}
+
+BOOST_AUTO_TEST_CASE( accountWriteInvalidates ) {
+    auto reads = call( contract );
+    commit( [&]( State& _s ) { _s.addBalance( contract, 1 ); } );
+    BOOST_CHECK( !reads->current() );
+
+    // the sender is read too
+    reads = call( contract );
+    commit( [&]( State& _s ) { _s.addBalance( sender, 1 ); } );
+    BOOST_CHECK( !reads->current() );
+}
+
+BOOST_AUTO_TEST_CASE( unchangedRecordKeepsAccountReads ) {
+    auto reads = std::make_shared< StateReadSet >();
+    {
+        State overlay = state.createReadOnlyOverlay();
+        overlay.recordReads( reads );
+        BOOST_CHECK_EQUAL( overlay.balance( contract ), 0 );
+    }
+    // storage changes make the account dirty but leave its record as it is
+    commit( [&]( State& _s ) { _s.setStorage( contract, 0, 10 ); } );
+    BOOST_CHECK( reads->current() );
+}
+
+BOOST_AUTO_TEST_CASE( blockContextIsInexact ) {
+    auto reads = call( numberContract );
+    BOOST_CHECK( !reads->exact() );
+    BOOST_CHECK( !reads->current() );
+}
+
+BOOST_AUTO_TEST_CASE( tooManyKeysIsInexact ) {
+    StateReadSet reads;
+    for ( size_t i = 0; i < StateReadSet::c_maxKeys; ++i )
+        reads.noteStorage( contract, i );
+    BOOST_CHECK( reads.exact() );
+    BOOST_CHECK_EQUAL( reads.size(), StateReadSet::c_maxKeys );
+    reads.noteAccount( holder );
+    BOOST_CHECK( !reads.exact() );
+}
+
+BOOST_AUTO_TEST_CASE( writeLogKeepsLatestCommits ) {
+    auto log = std::make_shared< StateWriteLog >();
+    StateReadSet reads;
+    reads.start( 0, log );
+    reads.noteAccount( holder );
+
+    auto const unrelated = std::make_shared< StateWriteSet >();
+    unrelated->accounts.insert( contract );
+    for ( size_t version = 1; version <= StateWriteLog::c_maxVersions; ++version )
+        log->note( version, unrelated );
+    BOOST_CHECK( reads.current() );
+    BOOST_CHECK_EQUAL( reads.version(), StateWriteLog::c_maxVersions );
+
+    StateReadSet behind;
+    behind.start( 0, log );
+    log->note( StateWriteLog::c_maxVersions + 1, unrelated );
+    // the first commit after version 0 is not kept any more
+    BOOST_CHECK( !behind.current() );
+    BOOST_CHECK( reads.current() );
+
+    // a commit made while logging was off breaks the log
+    log->note( StateWriteLog::c_maxVersions + 2, nullptr );
+    log->note( StateWriteLog::c_maxVersions + 3, unrelated );
+    BOOST_CHECK( !reads.current() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
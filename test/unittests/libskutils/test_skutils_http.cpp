@@ -118,5 +118,34 @@ BOOST_AUTO_TEST_CASE( https_busy_port ) {
     skutils::test::test_protocol_busy_port( "https", skutils::test::g_nDefaultPort );
 }
 
+BOOST_AUTO_TEST_CASE( stream_producer_chunks ) {
+    skutils::test::test_print_header_name( "SkUtils/http/stream_producer_chunks" );
+    static const size_t nBufferSize = 16, nElements = 100;
+    size_t i = 0;
+    skutils::http::response res;
+    res.set_content_producer(
+        [&]( skutils::http::stream_writer& w ) -> bool {
+            for ( ; i < nElements && !w.full(); ++i )
+                w.write( std::to_string( i ) + "," );
+            return i < nElements;
+        },
+        "application/json", nBufferSize );
+    BOOST_REQUIRE( res.body_.empty() );
+    BOOST_REQUIRE( res.streamcb_ );
+    std::string strAll, strExpected;
+    for ( size_t j = 0; j < nElements; ++j )
+        strExpected += std::to_string( j ) + ",";
+    uint64_t nOffset = 0;
+    for ( ;; ) {
+        std::string strChunk = res.streamcb_( nOffset );
+        if ( strChunk.empty() )
+            break;
+        BOOST_REQUIRE( strChunk.size() < nBufferSize + 4 );  // at most one element over buffer
+        nOffset += strChunk.size();
+        strAll += strChunk;
+    }
+    BOOST_REQUIRE( strAll == strExpected );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+#include "test_skutils_helper.h"
+#include <boost/test/unit_test.hpp>
+#include <skutils/task_trace.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( trace, *boost::unit_test::precondition( dev::test::option_all_tests ) )
+
+BOOST_AUTO_TEST_CASE( ring_push_drain_and_overflow ) {
+    skutils::task::trace::ring r( 4 );
+    BOOST_REQUIRE( r.capacity() == 4 );
+    skutils::task::trace::record_t rec;
+    for ( size_t i = 0; i < 4; ++i ) {
+        rec.nTaskNumber_ = uint32_t( i );
+        BOOST_REQUIRE( r.push( rec ) );
+    }
+    BOOST_REQUIRE( !r.push( rec ) );
+    BOOST_REQUIRE( r.dropped() == 1 );
+    std::vector< uint32_t > vec;
+    BOOST_REQUIRE( r.drain( [&]( const skutils::task::trace::record_t& x ) {
+        vec.push_back( x.nTaskNumber_ );
+    } ) == 4 );
+    BOOST_REQUIRE( ( vec == std::vector< uint32_t >{ 0, 1, 2, 3 } ) );
+    BOOST_REQUIRE( r.push( rec ) );
+}
+
+BOOST_AUTO_TEST_CASE( names_are_interned_once ) {
+    skutils::task::trace::id_type id1 = skutils::task::trace::intern( "test/eth_call" );
+    skutils::task::trace::id_type id2 = skutils::task::trace::intern( "test/eth_call" );
+    skutils::task::trace::id_type id3 = skutils::task::trace::intern( "test/eth_getLogs" );
+    BOOST_REQUIRE( id1 != skutils::task::trace::c_invalid_id );
+    BOOST_REQUIRE( id1 == id2 );
+    BOOST_REQUIRE( id1 != id3 );
+    BOOST_REQUIRE(
+        skutils::task::trace::get_default_name_registry().name_of( id3 ) == "test/eth_getLogs" );
+}
+
+BOOST_AUTO_TEST_CASE( histograms_from_many_threads ) {
+    skutils::task::trace::collector& c = skutils::task::trace::get_default_collector();
+    c.reset();
+    skutils::task::trace::id_type idChannel = skutils::task::trace::intern( "test/channel" );
+    skutils::task::trace::id_type idMethod = skutils::task::trace::intern( "test/method" );
+    static const size_t nThreads = 4, nCallsPerThread = 1000;
+    std::vector< std::thread > vecThreads;
+    for ( size_t i = 0; i < nThreads; ++i ) {
+        vecThreads.emplace_back( [&]() {
+            for ( size_t j = 0; j < nCallsPerThread; ++j ) {
+                skutils::task::trace::scope a( idChannel, idMethod, 10 );
+                a.set_response_size( 20 );
+                if ( j % 10 == 0 )
+                    a.set_error();
+            }
+        } );
+    }
+    for ( std::thread& t : vecThreads )
+        t.join();
+    nlohmann::json jo = c.compose_json();
+    const nlohmann::json& joHistogram = jo["channels"]["test/channel"]["test/method"];
+    BOOST_REQUIRE( joHistogram["count"].get< uint64_t >() == nThreads * nCallsPerThread );
+    BOOST_REQUIRE( joHistogram["errors"].get< uint64_t >() == nThreads * nCallsPerThread / 10 );
+    BOOST_REQUIRE( joHistogram["requestBytes"].get< uint64_t >() == 10 * nThreads * nCallsPerThread );
+    BOOST_REQUIRE(
+        joHistogram["responseBytes"].get< uint64_t >() == 20 * nThreads * nCallsPerThread );
+}
+
+BOOST_AUTO_TEST_CASE( rings_of_finished_threads_are_forgotten ) {
+    // own collector, so rings of threads other tests leave running do not count
+    skutils::task::trace::collector c;
+    skutils::task::trace::record_t rec;
+    std::thread t( [&]() { c.thread_ring().push( rec ); } );
+    t.join();
+    BOOST_REQUIRE( c.drain() == 1 );
+    nlohmann::json jo = c.compose_json();
+    BOOST_REQUIRE( jo["threadRings"].get< size_t >() == 0 );
+    BOOST_REQUIRE( jo["drained"].get< uint64_t >() == 1 );
+}
+
+BOOST_AUTO_TEST_CASE( records_feed_performance_timeline ) {
+    skutils::task::trace::collector& c = skutils::task::trace::get_default_collector();
+    skutils::task::performance::tracker_ptr pTracker =
+        skutils::task::performance::get_default_tracker();
+    pTracker->set_enabled( true );
+    pTracker->cancel();
+    pTracker->start();
+    {
+        skutils::task::trace::scope a( skutils::task::trace::intern( "test/timeline" ),
+            skutils::task::trace::intern( "eth_blockNumber" ), 42, 7 );
+    }
+    c.drain();
+    nlohmann::json jo = pTracker->stop();
+    const nlohmann::json& jarr = jo["queues"]["test/timeline"];
+    BOOST_REQUIRE( jarr.size() == 1 );
+    BOOST_REQUIRE( jarr[0]["name"].get< std::string >() == "task 7, eth_blockNumber" );
+    BOOST_REQUIRE( jarr[0]["jsnIn"]["requestSize"].get< uint64_t >() == 42 );
+    BOOST_REQUIRE( jarr[0]["fin"].get< bool >() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,6 +29,7 @@
 #include <libethcore/KeyManager.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/ClientTest.h>
+#include <libethereum/LogIndex.h>
 #include <libethereum/TransactionQueue.h>
 #include <libp2p/Network.h>
 #include <libskale/httpserveroverride.h>
@@ -243,7 +244,7 @@ private:
 };
 
 struct JsonRpcFixture : public TestOutputHelperFixture {
-    JsonRpcFixture( const std::string& _config = "", bool _owner = true, bool _deploymentControl = true, bool _generation2 = false, bool _mtmEnabled = false ) {
+    JsonRpcFixture( const std::string& _config = "", bool _owner = true, bool _deploymentControl = true, bool _generation2 = false, bool _mtmEnabled = false, bool _logIndex = false ) {
         dev::p2p::NetworkPreferences nprefs;
         ChainParams chainParams;
 
@@ -291,6 +292,7 @@ struct JsonRpcFixture : public TestOutputHelperFixture {
             chainParams.sChain.nodes[0].port = chainParams.sChain.nodes[0].port6 = rand_port;
         }
         chainParams.sChain.multiTransactionMode = _mtmEnabled;
+        chainParams.nodeInfo.logIndex = _logIndex;
 
         //        web3.reset( new WebThreeDirect(
         //            "eth tests", tempDir.path(), "", chainParams, WithExisting::Kill, {"eth"},
@@ -1800,6 +1802,91 @@ contract Logger{
     logs = fixture.rpcClient->eth_getLogs(t);
     BOOST_REQUIRE(logs.isArray());
     BOOST_REQUIRE_EQUAL(logs.size(), 24);
+
+    // 11 bad filter gets error answer instead of streamed one
+    t["address"] = "0x1234";
+    BOOST_REQUIRE_THROW(fixture.rpcClient->eth_getLogs(t), jsonrpc::JsonRpcException);
+}
+
+// eth_getLogs answered from the log index matches the bloom scan, pages add up to the whole
+BOOST_AUTO_TEST_CASE( logs_index_and_pagination ) {
+    JsonRpcFixture fixture( "", true, true, false, false, true );
+    dev::eth::simulateMining( *( fixture.client ), 1 );
+
+    // Logger contract of the logs test: log3(block.number, block.number, i, j)
+    string bytecode = "6080604052348015600f57600080fd5b50609b8061001e6000396000f3fe608060405260015460001b60005460001b4360001b4360001b6040518082815260200191505060405180910390a3600160008154809291906001019190505550600a6001541415606357600060018190555060008081548092919060010191905055505b00fea2646970667358221220fdf2f98961b803b6b32dfc9be766990cbdb17559d9a03724d12fc672e33804b164736f6c634300060c0033";
+
+    Json::Value create;
+    create["code"] = bytecode;
+    create["gas"] = "180000";
+    string deployHash = fixture.rpcClient->eth_sendTransaction( create );
+    dev::eth::mineTransaction( *( fixture.client ), 1 );
+    string contractAddress = fixture.rpcClient->eth_getTransactionReceipt( deployHash )["contractAddress"].asString();
+
+    for ( int i = 0; i <= 23; ++i ) {
+        Json::Value t;
+        t["from"] = toJS( fixture.coinbase.address() );
+        t["value"] = jsToDecimal( "0" );
+        t["to"] = contractAddress;
+        t["gas"] = "99000";
+        BOOST_REQUIRE( !fixture.rpcClient->eth_sendTransaction( t ).empty() );
+        dev::eth::mineTransaction( *( fixture.client ), 1 );
+    }
+    BOOST_REQUIRE_EQUAL( fixture.client->number(), 26 );
+
+    // genesis is not indexed, so queries from block 0 scan blooms and from block 1 use the index
+    LogIndex const* index = fixture.client->blockChain().logIndex();
+    BOOST_REQUIRE( index );
+    BOOST_REQUIRE( !index->covers( 0, 26 ) );
+    BOOST_REQUIRE( index->covers( 1, 26 ) );
+
+    std::vector< Json::Value > filters;
+    Json::Value t;
+    t["toBlock"] = 26;
+    filters.push_back( t );
+    t["address"] = contractAddress;
+    filters.push_back( t );
+    t["topics"] = Json::Value( Json::arrayValue );
+    t["topics"][1] = u256_to_js( dev::u256( 1 ) );
+    filters.push_back( t );
+    t["topics"][1] = Json::Value( Json::arrayValue );
+    t["topics"][1][0] = u256_to_js( dev::u256( 1 ) );
+    t["topics"][1][1] = u256_to_js( dev::u256( 2 ) );
+    t["topics"][2] = u256_to_js( dev::u256( 3 ) );
+    filters.push_back( t );
+    t["address"] = "0x2adc25665018aa1fe0e6bc666dac8fc2697ff9ba";
+    filters.push_back( t );
+
+    for ( Json::Value filter : filters ) {
+        filter["fromBlock"] = 0;
+        Json::Value const scanned = fixture.rpcClient->eth_getLogs( filter );
+        filter["fromBlock"] = 1;
+        Json::Value const indexed = fixture.rpcClient->eth_getLogs( filter );
+        BOOST_REQUIRE( scanned.isArray() );
+        BOOST_REQUIRE_EQUAL( scanned, indexed );
+
+        for ( unsigned from : { 0, 1 } ) {
+            for ( unsigned limit : { 1, 5, 24, 100 } ) {
+                filter["fromBlock"] = from;
+                filter["limit"] = limit;
+                filter["cursor"] = Json::Value();
+                Json::Value pages( Json::arrayValue );
+                for ( unsigned n = 0;; ++n ) {
+                    BOOST_REQUIRE_LE( n, scanned.size() );
+                    Json::Value const page = fixture.rpcClient->eth_getLogs( filter );
+                    BOOST_REQUIRE( page["logs"].isArray() );
+                    BOOST_REQUIRE_LE( page["logs"].size(), limit );
+                    for ( Json::Value const& log : page["logs"] )
+                        pages.append( log );
+                    if ( page["cursor"].isNull() )
+                        break;
+                    BOOST_REQUIRE_EQUAL( page["logs"].size(), limit );
+                    filter["cursor"] = page["cursor"];
+                }
+                BOOST_REQUIRE_EQUAL( pages, scanned );
+            }
+        }
+    }
 }
 
 BOOST_AUTO_TEST_CASE( storage_limit_contract ) {
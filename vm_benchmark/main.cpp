@@ -0,0 +1,113 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include <evmc/evmc.hpp>
+#include <libdevcore/CommonData.h>
+#include <libskale-interpreter/interpreter.h>
+
+using namespace dev;
+
+// Calls per second of _code, run for about _seconds.
+double measure_performance( function< void() > code, double _seconds = 1 ) {
+    using clock = chrono::steady_clock;
+    size_t total_count = 0;
+    auto const start = clock::now();
+    chrono::duration< double > elapsed{ 0 };
+    for ( size_t count = 1; elapsed.count() < _seconds; count *= 2 ) {
+        for ( size_t i = 0; i < count; ++i )
+            code();
+        total_count += count;
+        elapsed = clock::now() - start;
+    }
+    return total_count / elapsed.count();
+}
+
+// Host of a contract touching nothing but its stack and memory.
+class NullHost : public evmc::Host {
+public:
+    bool account_exists( const evmc::address& ) noexcept override { return false; }
+    evmc::bytes32 get_storage( const evmc::address&, const evmc::bytes32& ) noexcept override {
+        return {};
+    }
+    evmc_storage_status set_storage(
+        const evmc::address&, const evmc::bytes32&, const evmc::bytes32& ) noexcept override {
+        return EVMC_STORAGE_MODIFIED;
+    }
+    evmc::uint256be get_balance( const evmc::address& ) noexcept override { return {}; }
+    size_t get_code_size( const evmc::address& ) noexcept override { return 0; }
+    evmc::bytes32 get_code_hash( const evmc::address& ) noexcept override { return {}; }
+    size_t copy_code( const evmc::address&, size_t, uint8_t*, size_t ) noexcept override {
+        return 0;
+    }
+    void selfdestruct( const evmc::address&, const evmc::address& ) noexcept override {}
+    evmc::result call( const evmc_message& _msg ) noexcept override {
+        return evmc::result( EVMC_SUCCESS, _msg.gas, nullptr, 0 );
+    }
+    evmc_tx_context get_tx_context() noexcept override { return {}; }
+    evmc::bytes32 get_block_hash( int64_t ) noexcept override { return {}; }
+    void emit_log( const evmc::address&, const uint8_t*, size_t, const evmc::bytes32[],
+        size_t ) noexcept override {}
+};
+
+struct Program {
+    string name;
+    string code;
+};
+
+// Each counts down from 10000 in a loop over one kind of instructions.
+vector< Program > const c_programs = {
+    // loop: PUSH1 3 MUL PUSH1 5 ADD PUSH1 255 AND PUSH1 2 XOR PUSH1 1 SHL PUSH1 11 MOD
+    //       DUP1 PUSH1 9 LT POP SWAP1 PUSH1 1 SWAP1 SUB DUP1 ISZERO PUSH2 exit JUMPI
+    //       SWAP1 PUSH2 loop JUMP
+    { "arithmetic", "61271060075b60030260050160ff1660021860011b600b0680600910509060019003801561"
+                    "002d5790610005565b00" },
+    // loop: DUP4 DUP4 DUP4 DUP4 SWAP3 SWAP1 SWAP2 SWAP1 POP POP POP POP DUP2 DUP2 SWAP2 SWAP1
+    //       POP SWAP1 POP SWAP4 PUSH1 1 SWAP1 SUB DUP1 ISZERO PUSH2 exit JUMPI SWAP4
+    //       PUSH2 loop JUMP
+    { "stack", "61271060016002600360045b838383839290919050505050818191905090509360019003801561"
+               "002f579361000b565b00" },
+    // loop: mstore(and(i, 31) << 5, i) mstore(64, add(mload(64), mload(and(i, 31) << 5)))
+    { "memory",
+        "6127105b80601f1660051b818152516040510160405260019003801561002457610003565b00" },
+    // loop: if i & 1 goto odd else goto join; odd: goto join; join: goto next; next: i--
+    { "jumps", "6127105b8060011661001057610018565b600050610018565b61001d565b600190038061000357"
+               "00" },
+    // loop: mstore(0, i) mstore(32, keccak256(0, 64))
+    { "sha3", "6127105b80600052604060002060205260019003806100035700" },
+    // loop: GAS PUSH1 1 ADD POP GAS POP
+    { "gas", "6127105b5a600101505a5060019003806100035700" },
+};
+
+int main() {
+    evmc::vm interpreter{ evmc_create_interpreter() };
+    evmc::vm interpreterFast{ evmc_create_interpreter_fast() };
+    NullHost host;
+    int64_t const gas = 100000000;
+
+    int ret = 0;
+    for ( Program const& program : c_programs ) {
+        bytes const code = fromHex( program.code );
+        evmc_message msg = {};
+        msg.gas = gas;
+        int64_t gasUsed[2];
+        for ( size_t i = 0; i < 2; ++i ) {
+            evmc::vm& vm = i ? interpreterFast : interpreter;
+            gasUsed[i] =
+                gas - vm.execute( host, EVMC_PETERSBURG, msg, code.data(), code.size() ).gas_left;
+            double const runsPerSecond = measure_performance(
+                [&]() { vm.execute( host, EVMC_PETERSBURG, msg, code.data(), code.size() ); } );
+            cout << program.name << " " << vm.name() << ": " << 1e6 / runsPerSecond
+                 << " us/run, gas used " << gasUsed[i] << endl;
+        }
+        if ( gasUsed[0] != gasUsed[1] ) {
+            cout << program.name << ": gas used differs" << endl;
+            ret = 1;
+        }
+    }
+    return ret;
+}